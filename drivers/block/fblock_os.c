@@ -0,0 +1,833 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_os.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the block device layer used in FreeRTOS, requests of
+ * the file systems are queued per device, adjacent ones are merged and dispatched to
+ * the disk driver by a task of the device.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   64 bit sector numbers
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <FreeRTOS.h>
+#include "task.h"
+#include "ftypes.h"
+#include "fdebug.h"
+#include "fdrivers_port.h"
+#include "fblock_os.h"
+
+#define FBLOCK_DEBUG_TAG "FFreeRTOSBlock"
+#define FBLOCK_ERROR(format, ...) FT_DEBUG_PRINT_E(FBLOCK_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FBLOCK_WARN(format, ...)  FT_DEBUG_PRINT_W(FBLOCK_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FBLOCK_DEBUG(format, ...) FT_DEBUG_PRINT_D(FBLOCK_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#if (FFREERTOS_BLOCK_MAX_QUEUE_DEPTH < 1) || (FFREERTOS_BLOCK_MAX_QUEUE_DEPTH > 32)
+#error "CONFIG_FREERTOS_BLOCK_MAX_QUEUE_DEPTH should be 1 ~ 32"
+#endif
+
+/* ios in flight and nothing completed for this long, let the backend poll */
+#define FBLOCK_POLL_TICKS   pdMS_TO_TICKS(1000UL)
+
+static FFreeRTOSBlockDev *block_dev[CONFIG_FREERTOS_BLOCK_MAX_DEVICES];
+static u32 block_dev_num = 0;
+
+typedef struct
+{
+    TaskHandle_t task;      /* task blocked on the request */
+    volatile boolean done;
+    int result;
+} FBlockWait;
+
+static inline boolean FBlockOverlap(u64 a_sector, u32 a_count, u64 b_sector, u32 b_count)
+{
+    return (a_sector < b_sector + b_count) && (b_sector < a_sector + a_count);
+}
+
+/* reordering the two is not allowed if one of them writes to a sector the other one accesses */
+static boolean FBlockHazard(FFreeRTOSBlockOp op, u64 sector, u32 count, const FFreeRTOSBlockReq *req)
+{
+    if ((op != FFREERTOS_BLOCK_OP_WRITE) && (req->op != FFREERTOS_BLOCK_OP_WRITE))
+    {
+        return FALSE;
+    }
+
+    return FBlockOverlap(sector, count, req->sector, req->merge_count);
+}
+
+static boolean FBlockHazardAfter(const FFreeRTOSBlockReq *from, const FFreeRTOSBlockReq *req)
+{
+    const FFreeRTOSBlockReq *r;
+
+    for (r = from; r != NULL; r = r->next)
+    {
+        if (FBlockHazard(r->op, r->sector, r->merge_count, req))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* try to merge req into a queued request after the last flush, call with the queue locked */
+static boolean FBlockMerge(FFreeRTOSBlockDev *dev, FFreeRTOSBlockReq *req)
+{
+    FFreeRTOSBlockReq *first = dev->queue_head;
+    FFreeRTOSBlockReq *prev = NULL;
+    FFreeRTOSBlockReq *cur;
+    FFreeRTOSBlockReq *tail;
+    u32 size;
+
+    if (req->op == FFREERTOS_BLOCK_OP_FLUSH)
+    {
+        return FALSE;
+    }
+
+    /* requests before a flush are not merged with those after it */
+    for (cur = dev->queue_head; cur != NULL; cur = cur->next)
+    {
+        if (cur->op == FFREERTOS_BLOCK_OP_FLUSH)
+        {
+            first = cur->next;
+        }
+    }
+
+    for (cur = first; cur != NULL; prev = cur, cur = cur->next)
+    {
+        if ((cur->op != req->op) ||
+            ((dev->max_sectors != 0) && (cur->merge_count + req->count > dev->max_sectors)))
+        {
+            continue;
+        }
+
+        /* the merged request runs at the place of cur, before the requests queued after cur */
+        if (FBlockHazardAfter(cur->next, req))
+        {
+            continue;
+        }
+
+        size = cur->merge_count * dev->sector_size;
+        if ((cur->sector + cur->merge_count == req->sector) && (cur->buf + size == req->buf))
+        {
+            /* back merge */
+            for (tail = cur; tail->merge_next != NULL; tail = tail->merge_next)
+                ;
+            tail->merge_next = req;
+            cur->merge_count += req->count;
+            dev->stats.merges[req->op]++;
+            return TRUE;
+        }
+
+        size = req->count * dev->sector_size;
+        if ((req->sector + req->count == cur->sector) && (req->buf + size == cur->buf))
+        {
+            /* front merge, req takes the place of cur in the queue */
+            req->merge_next = cur;
+            req->merge_count = req->count + cur->merge_count;
+            req->next = cur->next;
+            if ((BaseType_t)(cur->deadline - req->deadline) < 0)
+            {
+                req->deadline = cur->deadline;
+            }
+            cur->next = NULL;
+
+            if (prev == NULL)
+            {
+                dev->queue_head = req;
+            }
+            else
+            {
+                prev->next = req;
+            }
+
+            if (dev->queue_tail == cur)
+            {
+                dev->queue_tail = req;
+            }
+
+            dev->stats.merges[req->op]++;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* req is not dispatched before an earlier request or in flight io it depends on */
+static boolean FBlockConflict(FFreeRTOSBlockDev *dev, const FFreeRTOSBlockReq *req)
+{
+    const FFreeRTOSBlockReq *r;
+    const FFreeRTOSBlockIo *io;
+    u32 i;
+
+    for (r = dev->queue_head; r != req; r = r->next)
+    {
+        if (FBlockHazard(r->op, r->sector, r->merge_count, req))
+        {
+            return TRUE;
+        }
+    }
+
+    for (i = 0; i < dev->queue_depth; i++)
+    {
+        io = &dev->io[i];
+        if ((dev->io_busy & BIT(i)) && FBlockHazard(io->op, io->sector, io->count, req))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* choose the next request to dispatch, call with the queue locked */
+static FFreeRTOSBlockReq *FBlockPick(FFreeRTOSBlockDev *dev)
+{
+    FFreeRTOSBlockReq *head = dev->queue_head;
+    FFreeRTOSBlockReq *cur;
+    FFreeRTOSBlockReq *pick = NULL;
+#ifdef CONFIG_FREERTOS_BLOCK_DEADLINE
+    FFreeRTOSBlockReq *expired = NULL;
+    FFreeRTOSBlockReq *wrap = NULL;
+    TickType_t now = xTaskGetTickCount();
+#endif
+
+    if (head == NULL)
+    {
+        return NULL;
+    }
+
+    /* flush is a barrier, it starts when all the ios before it are done */
+    if (head->op == FFREERTOS_BLOCK_OP_FLUSH)
+    {
+        return (dev->stats.in_flight == 0) ? head : NULL;
+    }
+
+    for (cur = head; (cur != NULL) && (cur->op != FFREERTOS_BLOCK_OP_FLUSH); cur = cur->next)
+    {
+        if (FBlockConflict(dev, cur))
+        {
+            continue;
+        }
+
+#ifdef CONFIG_FREERTOS_BLOCK_DEADLINE
+        /* oldest request past its deadline first */
+        if ((BaseType_t)(now - cur->deadline) >= 0)
+        {
+            if ((expired == NULL) || ((BaseType_t)(cur->deadline - expired->deadline) < 0))
+            {
+                expired = cur;
+            }
+            continue;
+        }
+
+        /* else one way elevator from the end of the last io, then wrap to the lowest sector */
+        if (cur->sector >= dev->next_sector)
+        {
+            if ((pick == NULL) || (cur->sector < pick->sector))
+            {
+                pick = cur;
+            }
+        }
+        else if ((wrap == NULL) || (cur->sector < wrap->sector))
+        {
+            wrap = cur;
+        }
+#else
+        pick = cur;
+        break;
+#endif
+    }
+
+#ifdef CONFIG_FREERTOS_BLOCK_DEADLINE
+    if (expired != NULL)
+    {
+        dev->stats.expired++;
+        return expired;
+    }
+
+    if (pick == NULL)
+    {
+        pick = wrap;
+    }
+#endif
+
+    return pick;
+}
+
+static void FBlockUnlink(FFreeRTOSBlockDev *dev, FFreeRTOSBlockReq *req)
+{
+    FFreeRTOSBlockReq *prev = NULL;
+    FFreeRTOSBlockReq *cur;
+
+    for (cur = dev->queue_head; cur != req; prev = cur, cur = cur->next)
+        ;
+
+    if (prev == NULL)
+    {
+        dev->queue_head = req->next;
+    }
+    else
+    {
+        prev->next = req->next;
+    }
+
+    if (dev->queue_tail == req)
+    {
+        dev->queue_tail = prev;
+    }
+
+    req->next = NULL;
+    dev->stats.queued--;
+}
+
+/* start queued requests on the free io slots, returns when the queue is blocked or the slots are used up */
+static void FBlockDispatch(FFreeRTOSBlockDev *dev)
+{
+    FFreeRTOSBlockReq *req;
+    FFreeRTOSBlockIo *io;
+    UBaseType_t mask;
+    u32 slot;
+    int ret;
+
+    for (;;)
+    {
+        for (slot = 0; slot < dev->queue_depth; slot++)
+        {
+            if (!(dev->io_busy & BIT(slot)))
+            {
+                break;
+            }
+        }
+
+        if (slot == dev->queue_depth)
+        {
+            return;
+        }
+
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        req = FBlockPick(dev);
+        if (req != NULL)
+        {
+            FBlockUnlink(dev, req);
+        }
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+
+        if (req == NULL)
+        {
+            return;
+        }
+
+        io = &dev->io[slot];
+        io->op = req->op;
+        io->sector = req->sector;
+        io->count = req->merge_count;
+        io->buf = req->buf;
+        io->priv = NULL;
+        io->dev = dev;
+        io->req = req;
+        io->next = NULL;
+        io->result = 0;
+        io->start_time = FDriverGetTimerTick();
+
+        dev->io_busy |= BIT(slot);
+        dev->stats.in_flight++;
+        dev->stats.ios[io->op]++;
+        if (io->op != FFREERTOS_BLOCK_OP_FLUSH)
+        {
+            dev->next_sector = io->sector + io->count;
+        }
+
+        ret = dev->ops->submit(dev, io);
+        if (ret == 0)
+        {
+            continue;
+        }
+
+        if (((ret == -EBUSY) || (ret == -ENOMEM)) && (dev->stats.in_flight > 1))
+        {
+            /* backend resources are held by the ios in flight, retry after one of them is done,
+               req did not conflict with the requests before it, so it can go back to the head */
+            dev->io_busy &= ~BIT(slot);
+            dev->stats.in_flight--;
+            dev->stats.ios[io->op]--;
+
+            mask = taskENTER_CRITICAL_FROM_ISR();
+            req->next = dev->queue_head;
+            dev->queue_head = req;
+            if (dev->queue_tail == NULL)
+            {
+                dev->queue_tail = req;
+            }
+            dev->stats.queued++;
+            taskEXIT_CRITICAL_FROM_ISR(mask);
+            return;
+        }
+
+        FBLOCK_ERROR("%s: start op %d at sector %llu (count %u) failed, %d.",
+                     dev->name, io->op, (unsigned long long)io->sector, io->count, ret);
+        FFreeRTOSBlockIoDone(io, ret);
+    }
+}
+
+/* free the slots of the finished ios and complete their requests */
+static void FBlockReap(FFreeRTOSBlockDev *dev)
+{
+    FFreeRTOSBlockIo *io;
+    FFreeRTOSBlockIo *io_next;
+    FFreeRTOSBlockReq *req;
+    FFreeRTOSBlockReq *req_next;
+    UBaseType_t mask;
+    u64 now;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    io = dev->done_list;
+    dev->done_list = NULL;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    now = FDriverGetTimerTick();
+    for (; io != NULL; io = io_next)
+    {
+        io_next = io->next;
+        req = io->req;
+
+        dev->stats.io_time[io->op] += now - io->start_time;
+        if (io->result != 0)
+        {
+            dev->stats.errors++;
+        }
+
+        /* the slot is free before the callbacks, which may submit new requests */
+        dev->io_busy &= ~BIT(io - dev->io);
+        dev->stats.in_flight--;
+
+        for (; req != NULL; req = req_next)
+        {
+            req_next = req->merge_next;
+            req->merge_next = NULL;
+
+            dev->stats.reqs[req->op]++;
+            dev->stats.sectors[req->op] += req->count;
+            dev->stats.wait_time[req->op] += now - req->submit_time;
+            req->done(req, io->result);
+        }
+    }
+}
+
+static void FBlockDispatchTask(void *args)
+{
+    FFreeRTOSBlockDev *dev = (FFreeRTOSBlockDev *)args;
+
+    for (;;)
+    {
+        FBlockReap(dev);
+        FBlockDispatch(dev);
+
+        if (dev->done_list != NULL)
+        {
+            continue;
+        }
+
+        if (dev->stats.in_flight == 0)
+        {
+            (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        else if ((ulTaskNotifyTake(pdTRUE, FBLOCK_POLL_TICKS) == 0) && (dev->ops->poll != NULL))
+        {
+            dev->ops->poll(dev);
+        }
+    }
+}
+
+static void FBlockNotify(FFreeRTOSBlockDev *dev)
+{
+    BaseType_t xhigher_priority_task_woken = pdFALSE;
+
+    if (xPortIsInsideInterrupt())
+    {
+        vTaskNotifyGiveFromISR(dev->task, &xhigher_priority_task_woken);
+        portYIELD_FROM_ISR(xhigher_priority_task_woken);
+    }
+    else
+    {
+        xTaskNotifyGive(dev->task);
+    }
+}
+
+/**
+ * @name: FFreeRTOSBlockRegister
+ * @msg: 注册块设备并创建设备的请求分发任务
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备, 后端驱动先填好name, sector_size, sector_count, queue_depth, max_sectors和ops
+ * @note: dev在注册后一直被使用, 不能在栈上分配
+ */
+int FFreeRTOSBlockRegister(FFreeRTOSBlockDev *dev)
+{
+    BaseType_t xret;
+    int ret = 0;
+
+    if ((dev == NULL) || (dev->ops == NULL) || (dev->ops->submit == NULL) ||
+        (dev->sector_size == 0) || (dev->name[0] == '\0'))
+    {
+        return -EINVAL;
+    }
+
+    if ((dev->queue_depth == 0) || (dev->queue_depth > FFREERTOS_BLOCK_MAX_QUEUE_DEPTH))
+    {
+        dev->queue_depth = FFREERTOS_BLOCK_MAX_QUEUE_DEPTH;
+    }
+
+    dev->name[FFREERTOS_BLOCK_NAME_LEN - 1] = '\0';
+    dev->queue_head = NULL;
+    dev->queue_tail = NULL;
+    dev->done_list = NULL;
+    dev->io_busy = 0;
+    dev->next_sector = 0;
+    memset(&dev->stats, 0, sizeof(dev->stats));
+
+    vTaskSuspendAll();
+
+    if (FFreeRTOSBlockFind(dev->name) != NULL)
+    {
+        ret = -EEXIST;
+    }
+    else if (block_dev_num == CONFIG_FREERTOS_BLOCK_MAX_DEVICES)
+    {
+        ret = -ENOSPC;
+    }
+    else
+    {
+        xret = xTaskCreate(FBlockDispatchTask, dev->name, CONFIG_FREERTOS_BLOCK_STACK_DEPTH,
+                           dev, CONFIG_FREERTOS_BLOCK_TASK_PRIORITY, &dev->task);
+        if (xret != pdPASS)
+        {
+            ret = -ENOMEM;
+        }
+        else
+        {
+            block_dev[block_dev_num++] = dev;
+        }
+    }
+
+    (void)xTaskResumeAll();
+
+    if (ret != 0)
+    {
+        FBLOCK_ERROR("Register %s failed, %d.", dev->name, ret);
+        return ret;
+    }
+
+    FBLOCK_DEBUG("%s: %llu sectors of %u bytes, queue depth %u.",
+                 dev->name, (unsigned long long)dev->sector_count, dev->sector_size, dev->queue_depth);
+    return 0;
+}
+
+/**
+ * @name: FFreeRTOSBlockFind
+ * @msg: 按名称查找已注册的块设备
+ * @return {FFreeRTOSBlockDev *} 块设备, 未找到时为NULL
+ * @param {char} *name, 设备名称
+ */
+FFreeRTOSBlockDev *FFreeRTOSBlockFind(const char *name)
+{
+    u32 i;
+
+    for (i = 0; i < block_dev_num; i++)
+    {
+        if (strncmp(block_dev[i]->name, name, FFREERTOS_BLOCK_NAME_LEN) == 0)
+        {
+            return block_dev[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @name: FFreeRTOSBlockGet
+ * @msg: 按注册顺序获取块设备, 用于遍历
+ * @return {FFreeRTOSBlockDev *} 块设备, index超出已注册数量时为NULL
+ * @param {u32} index, 注册序号
+ */
+FFreeRTOSBlockDev *FFreeRTOSBlockGet(u32 index)
+{
+    return (index < block_dev_num) ? block_dev[index] : NULL;
+}
+
+/**
+ * @name: FFreeRTOSBlockSubmit
+ * @msg: 异步提交块设备请求, 与队列中相邻的同类请求合并后由设备的分发任务下发
+ * @return {int} 0表示已入队, 负数为errno错误码, 此时不会调用req->done
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {FFreeRTOSBlockReq} *req, 请求, 填好op, sector, count, buf, done和args
+ * @note: 请求在req->done调用前由块设备层持有, done在分发任务中调用, 可以在其中提交新请求
+ */
+int FFreeRTOSBlockSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockReq *req)
+{
+    UBaseType_t mask;
+
+    FASSERT(dev && req && dev->task);
+
+    if ((req->op >= FFREERTOS_BLOCK_OP_NUM) || (req->done == NULL))
+    {
+        return -EINVAL;
+    }
+
+    if (req->op != FFREERTOS_BLOCK_OP_FLUSH)
+    {
+        if ((req->count == 0) || (req->buf == NULL) ||
+            (req->sector >= dev->sector_count) || (req->count > dev->sector_count - req->sector))
+        {
+            return -EINVAL;
+        }
+    }
+    else
+    {
+        req->count = 0;
+    }
+
+    req->next = NULL;
+    req->merge_next = NULL;
+    req->merge_count = req->count;
+    req->submit_time = FDriverGetTimerTick();
+#ifdef CONFIG_FREERTOS_BLOCK_DEADLINE
+    req->deadline = xTaskGetTickCount() + ((req->op == FFREERTOS_BLOCK_OP_READ) ?
+                                           pdMS_TO_TICKS(CONFIG_FREERTOS_BLOCK_READ_EXPIRE_MS) :
+                                           pdMS_TO_TICKS(CONFIG_FREERTOS_BLOCK_WRITE_EXPIRE_MS));
+#else
+    req->deadline = 0;
+#endif
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    if (!FBlockMerge(dev, req))
+    {
+        if (dev->queue_tail == NULL)
+        {
+            dev->queue_head = req;
+        }
+        else
+        {
+            dev->queue_tail->next = req;
+        }
+        dev->queue_tail = req;
+
+        dev->stats.queued++;
+        if (dev->stats.queued > dev->stats.max_queued)
+        {
+            dev->stats.max_queued = dev->stats.queued;
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    FBlockNotify(dev);
+    return 0;
+}
+
+/**
+ * @name: FFreeRTOSBlockIoDone
+ * @msg: 后端驱动完成一次传输后调用, 唤醒设备的分发任务完成其中的请求
+ * @return {void}
+ * @param {FFreeRTOSBlockIo} *io, ops->submit传入的传输
+ * @param {int} result, 0表示成功, 负数为errno错误码
+ * @note: 可以在中断中调用, 也可以在ops->submit返回前调用
+ */
+void FFreeRTOSBlockIoDone(FFreeRTOSBlockIo *io, int result)
+{
+    FFreeRTOSBlockDev *dev = io->dev;
+    UBaseType_t mask;
+
+    io->result = result;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    io->next = dev->done_list;
+    dev->done_list = io;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    FBlockNotify(dev);
+}
+
+static void FBlockWaitDone(FFreeRTOSBlockReq *req, int result)
+{
+    FBlockWait *wait = (FBlockWait *)req->args;
+
+    wait->result = result;
+    wait->done = TRUE;
+    xTaskNotifyGive(wait->task);
+}
+
+static int FBlockSubmitWait(FFreeRTOSBlockDev *dev, FFreeRTOSBlockOp op, u8 *buf, u64 sector, u32 count)
+{
+    FFreeRTOSBlockReq req;
+    FBlockWait wait;
+    int ret;
+
+    wait.task = xTaskGetCurrentTaskHandle();
+    wait.done = FALSE;
+    wait.result = -EIO;
+
+    req.op = op;
+    req.sector = sector;
+    req.count = count;
+    req.buf = buf;
+    req.done = FBlockWaitDone;
+    req.args = &wait;
+
+    ret = FFreeRTOSBlockSubmit(dev, &req);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    /* the notification is given after done is set, take it even if done is seen first,
+       so that it is not left to the next user of the task notification */
+    do
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    while (!wait.done);
+
+    return wait.result;
+}
+
+/**
+ * @name: FFreeRTOSBlockRead
+ * @msg: 读取块设备扇区, 调用任务阻塞等待请求完成
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {u8} *buf, 读缓冲区
+ * @param {u64} sector, 起始扇区
+ * @param {u32} count, 扇区数
+ * @note: 使用调用任务的任务通知, 不能在中断或设备的分发任务中调用
+ */
+int FFreeRTOSBlockRead(FFreeRTOSBlockDev *dev, u8 *buf, u64 sector, u32 count)
+{
+    return FBlockSubmitWait(dev, FFREERTOS_BLOCK_OP_READ, buf, sector, count);
+}
+
+/**
+ * @name: FFreeRTOSBlockWrite
+ * @msg: 写入块设备扇区, 调用任务阻塞等待请求完成
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {u8} *buf, 写缓冲区
+ * @param {u64} sector, 起始扇区
+ * @param {u32} count, 扇区数
+ */
+int FFreeRTOSBlockWrite(FFreeRTOSBlockDev *dev, const u8 *buf, u64 sector, u32 count)
+{
+    return FBlockSubmitWait(dev, FFREERTOS_BLOCK_OP_WRITE, (u8 *)buf, sector, count);
+}
+
+/**
+ * @name: FFreeRTOSBlockFlush
+ * @msg: 等待之前提交的请求完成, 再将设备写缓存中的数据写入介质
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ */
+int FFreeRTOSBlockFlush(FFreeRTOSBlockDev *dev)
+{
+    return FBlockSubmitWait(dev, FFREERTOS_BLOCK_OP_FLUSH, NULL, 0, 0);
+}
+
+/**
+ * @name: FFreeRTOSBlockGetStats
+ * @msg: 获取块设备的i/o统计
+ * @return {void}
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {FFreeRTOSBlockStats} *stats, 统计的拷贝
+ * @param {boolean} reset, TRUE则在拷贝后清零计数, queued和in_flight保留
+ * @note: io_time和wait_time为generic timer计数, 除以GenericTimerFrequecy()换算为秒
+ */
+void FFreeRTOSBlockGetStats(FFreeRTOSBlockDev *dev, FFreeRTOSBlockStats *stats, boolean reset)
+{
+    UBaseType_t mask;
+    u32 queued;
+    u32 in_flight;
+
+    FASSERT(dev && stats);
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    *stats = dev->stats;
+    if (reset)
+    {
+        queued = dev->stats.queued;
+        in_flight = dev->stats.in_flight;
+        memset(&dev->stats, 0, sizeof(dev->stats));
+        dev->stats.queued = queued;
+        dev->stats.max_queued = queued;
+        dev->stats.in_flight = in_flight;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+static int FBlockRamSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io)
+{
+    u8 *addr = (u8 *)dev->priv + (uintptr)io->sector * dev->sector_size;
+    size_t size = (size_t)io->count * dev->sector_size;
+
+    if (io->op == FFREERTOS_BLOCK_OP_READ)
+    {
+        memcpy(io->buf, addr, size);
+    }
+    else if (io->op == FFREERTOS_BLOCK_OP_WRITE)
+    {
+        memcpy(addr, io->buf, size);
+    }
+
+    FFreeRTOSBlockIoDone(io, 0);
+    return 0;
+}
+
+static const FFreeRTOSBlockOps block_ram_ops =
+{
+    .submit = FBlockRamSubmit,
+    .poll = NULL
+};
+
+/**
+ * @name: FFreeRTOSBlockRamInit
+ * @msg: 以一段内存作为块设备注册
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {char} *name, 设备名称
+ * @param {void} *base, 内存起始地址
+ * @param {u32} sector_size, 扇区大小
+ * @param {u32} sector_count, 扇区数
+ */
+int FFreeRTOSBlockRamInit(FFreeRTOSBlockDev *dev, const char *name, void *base,
+                          u32 sector_size, u32 sector_count)
+{
+    FASSERT(dev && name && base);
+
+    memset(dev, 0, sizeof(*dev));
+    strncpy(dev->name, name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    dev->sector_size = sector_size;
+    dev->sector_count = sector_count;
+    dev->queue_depth = 1;
+    dev->max_sectors = 0;
+    dev->ops = &block_ram_ops;
+    dev->priv = base;
+
+    return FFreeRTOSBlockRegister(dev);
+}
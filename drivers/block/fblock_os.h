@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_os.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for providing the block device layer used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   64 bit sector numbers
+ */
+
+#ifndef FBLOCK_OS_H
+#define FBLOCK_OS_H
+
+#include <FreeRTOS.h>
+#include "task.h"
+#include "ftypes.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FFREERTOS_BLOCK_NAME_LEN        configMAX_TASK_NAME_LEN
+
+/* backend transfers in flight per device */
+#define FFREERTOS_BLOCK_MAX_QUEUE_DEPTH CONFIG_FREERTOS_BLOCK_MAX_QUEUE_DEPTH
+
+typedef enum
+{
+    FFREERTOS_BLOCK_OP_READ = 0,
+    FFREERTOS_BLOCK_OP_WRITE,
+    FFREERTOS_BLOCK_OP_FLUSH, /* barrier, runs after all the requests before it are done */
+
+    FFREERTOS_BLOCK_OP_NUM
+} FFreeRTOSBlockOp;
+
+typedef struct FFreeRTOSBlockReq FFreeRTOSBlockReq;
+typedef struct FFreeRTOSBlockIo FFreeRTOSBlockIo;
+typedef struct FFreeRTOSBlockDev FFreeRTOSBlockDev;
+
+/* request done callback, runs in the dispatch task of the device, result is 0 or negative errno */
+typedef void (*FFreeRTOSBlockDoneHandler)(FFreeRTOSBlockReq *req, int result);
+
+/* a read, write or flush request, owned by the block layer from submit until done is called */
+struct FFreeRTOSBlockReq
+{
+    FFreeRTOSBlockOp op;
+    u64 sector;                     /* start sector */
+    u32 count;                      /* sector count, 0 for flush */
+    u8 *buf;                        /* data buffer, count * sector_size bytes */
+    FFreeRTOSBlockDoneHandler done;
+    void *args;                     /* free for the submitter */
+
+    /* private */
+    FFreeRTOSBlockReq *next;        /* queue link */
+    FFreeRTOSBlockReq *merge_next;  /* requests merged behind this one, in sector order */
+    u32 merge_count;                /* sectors of this request and the merged ones */
+    TickType_t deadline;
+    u64 submit_time;
+};
+
+/* one backend transfer, a request and the adjacent requests merged into it */
+struct FFreeRTOSBlockIo
+{
+    FFreeRTOSBlockOp op;
+    u64 sector;
+    u32 count;
+    u8 *buf;
+    void *priv;                     /* free for the backend */
+
+    /* private */
+    FFreeRTOSBlockDev *dev;
+    FFreeRTOSBlockReq *req;
+    FFreeRTOSBlockIo *next;         /* done list link */
+    u64 start_time;
+    int result;
+};
+
+typedef struct
+{
+    /* start io, call FFreeRTOSBlockIoDone when it finishes, which may happen before return,
+       return 0 if started, or negative errno if io was not started */
+    int (*submit)(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io);
+    /* optional, called by the dispatch task when ios are in flight but nothing completed for a while */
+    void (*poll)(FFreeRTOSBlockDev *dev);
+} FFreeRTOSBlockOps;
+
+typedef struct
+{
+    u32 reqs[FFREERTOS_BLOCK_OP_NUM];       /* completed requests */
+    u32 ios[FFREERTOS_BLOCK_OP_NUM];        /* backend transfers */
+    u32 merges[FFREERTOS_BLOCK_OP_NUM];     /* requests merged into an adjacent one */
+    u64 sectors[FFREERTOS_BLOCK_OP_NUM];
+    u64 io_time[FFREERTOS_BLOCK_OP_NUM];    /* backend time of the transfers, generic timer counts */
+    u64 wait_time[FFREERTOS_BLOCK_OP_NUM];  /* submit to done time of the requests, generic timer counts */
+    u32 errors;
+    u32 expired;                            /* requests dispatched because their deadline passed */
+    u32 queued;                             /* requests waiting in the queue */
+    u32 max_queued;
+    u32 in_flight;                          /* ios started on the backend */
+} FFreeRTOSBlockStats;
+
+struct FFreeRTOSBlockDev
+{
+    char name[FFREERTOS_BLOCK_NAME_LEN];
+    u32 sector_size;
+    u64 sector_count;
+    u32 queue_depth;                /* ios the backend runs at once, 1 ~ FFREERTOS_BLOCK_MAX_QUEUE_DEPTH */
+    u32 max_sectors;                /* sectors per io, limits merging, 0 for no limit */
+    const FFreeRTOSBlockOps *ops;
+    void *priv;                     /* free for the backend */
+
+    /* private */
+    FFreeRTOSBlockReq *queue_head;
+    FFreeRTOSBlockReq *queue_tail;
+    FFreeRTOSBlockIo *done_list;
+    FFreeRTOSBlockIo io[FFREERTOS_BLOCK_MAX_QUEUE_DEPTH];
+    u32 io_busy;                    /* each bit indicate io is in flight */
+    u64 next_sector;                /* end of the last dispatched io, the deadline elevator position */
+    TaskHandle_t task;
+    FFreeRTOSBlockStats stats;
+};
+
+/* register dev and start its dispatch task, the backend fills name, sizes, queue_depth and ops first */
+int FFreeRTOSBlockRegister(FFreeRTOSBlockDev *dev);
+
+/* find a registered device by name */
+FFreeRTOSBlockDev *FFreeRTOSBlockFind(const char *name);
+
+/* get the index-th registered device, NULL after the last one */
+FFreeRTOSBlockDev *FFreeRTOSBlockGet(u32 index);
+
+/* queue req and return, req->done is called from the dispatch task when it finishes */
+int FFreeRTOSBlockSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockReq *req);
+
+/* called by the backend when io finishes, task or interrupt context */
+void FFreeRTOSBlockIoDone(FFreeRTOSBlockIo *io, int result);
+
+/* blocking read, write and flush, the calling task sleeps until the request is done */
+int FFreeRTOSBlockRead(FFreeRTOSBlockDev *dev, u8 *buf, u64 sector, u32 count);
+int FFreeRTOSBlockWrite(FFreeRTOSBlockDev *dev, const u8 *buf, u64 sector, u32 count);
+int FFreeRTOSBlockFlush(FFreeRTOSBlockDev *dev);
+
+/* copy the statistics of dev, reset them if reset is TRUE */
+void FFreeRTOSBlockGetStats(FFreeRTOSBlockDev *dev, FFreeRTOSBlockStats *stats, boolean reset);
+
+/* ram backend, sectors are copied with memcpy in the dispatch task */
+int FFreeRTOSBlockRamInit(FFreeRTOSBlockDev *dev, const char *name, void *base,
+                          u32 sector_size, u32 sector_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_sata.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the sata backend of the block device layer used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <FreeRTOS.h>
+#include "ftypes.h"
+#include "fdebug.h"
+#include "fassert.h"
+#include "fkernel.h"
+#include "fblock_sata.h"
+
+#define FBLOCK_SATA_DEBUG_TAG "FFreeRTOSSataBlock"
+#define FBLOCK_SATA_ERROR(format, ...) FT_DEBUG_PRINT_E(FBLOCK_SATA_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FBLOCK_SATA_INFO(format, ...)  FT_DEBUG_PRINT_I(FBLOCK_SATA_DEBUG_TAG, format, ##__VA_ARGS__)
+
+/* same limit as FSataReadWriteAsync */
+#ifndef MAX_SATA_BLOCKS_READ_WRITE
+#define MAX_SATA_BLOCKS_READ_WRITE 0x80
+#endif
+
+/* command done, FSataIrqHandler or FSataAhciPortComplete in the dispatch task */
+static void FFreeRTOSSataBlockDone(void *args, FError result)
+{
+    FFreeRTOSBlockIo *io = (FFreeRTOSBlockIo *)args;
+
+    FFreeRTOSBlockIoDone(io, (result == FSATA_SUCCESS) ? 0 :
+                         ((result == FSATA_ERR_TIMEOUT) ? -ETIMEDOUT : -EIO));
+}
+
+static int FFreeRTOSSataBlockSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io)
+{
+    FFreeRTOSSataBlock *blk = (FFreeRTOSSataBlock *)dev->priv;
+    FError ret;
+
+    switch (io->op)
+    {
+        case FFREERTOS_BLOCK_OP_READ:
+        case FFREERTOS_BLOCK_OP_WRITE:
+            ret = FSataReadWriteAsync(blk->ctrl, blk->port, (u32)io->sector, (u16)io->count, io->buf,
+                                      blk->is_ncq, (io->op == FFREERTOS_BLOCK_OP_WRITE),
+                                      FFreeRTOSSataBlockDone, io);
+            if (ret == FSATA_SUCCESS)
+            {
+                return 0;
+            }
+            return (ret == FSATA_ERR_BUSY) ? -EBUSY :
+                   ((ret == FSATA_ERR_INVALID_PARAMETER) ? -EINVAL : -EIO);
+        case FFREERTOS_BLOCK_OP_FLUSH:
+            /* the driver has no cache flush command, like CTRL_SYNC of the sata diskio ports,
+               the barrier still orders the ios around it */
+            FFreeRTOSBlockIoDone(io, 0);
+            return 0;
+        default:
+            return -EINVAL;
+    }
+}
+
+/* completions missed without the port irq */
+static void FFreeRTOSSataBlockPoll(FFreeRTOSBlockDev *dev)
+{
+    FFreeRTOSSataBlock *blk = (FFreeRTOSSataBlock *)dev->priv;
+
+    FSataAhciPortComplete(blk->ctrl, blk->port, 0);
+}
+
+static const FFreeRTOSBlockOps sata_block_ops =
+{
+    .submit = FFreeRTOSSataBlockSubmit,
+    .poll = FFreeRTOSSataBlockPoll
+};
+
+/**
+ * @name: FFreeRTOSSataBlockInit
+ * @msg: 将sata控制器端口上的磁盘注册为块设备, 请求由块设备层合并后异步提交到ahci命令槽, 设备支持时以ncq命令排队
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSSataBlock} *blk, sata块设备
+ * @param {char} *name, 设备名称
+ * @param {FSataCtrl} *ctrl, 已完成端口启动和FSataAhciReadInfo的控制器, 需使能端口中断
+ * @param {u8} port, 端口号
+ * @note: 端口由块设备独占, 同时使用FSataReadWrite会使提交返回忙, 数据缓冲区需4字节对齐
+ */
+int FFreeRTOSSataBlockInit(FFreeRTOSSataBlock *blk, const char *name, FSataCtrl *ctrl, u8 port)
+{
+    FFreeRTOSBlockDev *dev = &blk->dev;
+    FSataAhciPorts *port_info;
+
+    FASSERT(blk && name && ctrl);
+
+    if ((ctrl->is_ready != FT_COMPONENT_IS_READY) || (port >= ctrl->n_ports) ||
+        !(ctrl->link_port_map & BIT(port)) || (ctrl->port[port].dev_info.lba == 0))
+    {
+        return -ENODEV;
+    }
+    port_info = &ctrl->port[port];
+
+    memset(blk, 0, sizeof(*blk));
+    strncpy(dev->name, name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    blk->ctrl = ctrl;
+    blk->port = port;
+    blk->is_ncq = FSataIsNcqSupported(ctrl, port);
+
+    dev->sector_size = FSATA_SECT_SIZE;
+    /* the start block of a command is 32 bits */
+    dev->sector_count = min((u64)port_info->dev_info.lba, (u64)0x100000000ULL);
+    /* a normal command runs alone on the port, ncq commands queue up to the device depth */
+    dev->queue_depth = blk->is_ncq ? min(port_info->ncq_depth, (u32)FFREERTOS_BLOCK_MAX_QUEUE_DEPTH) : 1;
+    dev->max_sectors = MAX_SATA_BLOCKS_READ_WRITE;
+    dev->ops = &sata_block_ops;
+    dev->priv = blk;
+
+    FBLOCK_SATA_INFO("%s: %llu sectors of %u bytes, queue depth %u.", name,
+                     (unsigned long long)dev->sector_count, dev->sector_size, dev->queue_depth);
+
+    return FFreeRTOSBlockRegister(dev);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_sata.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the sata backend of the block device layer used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FBLOCK_SATA_H
+#define FBLOCK_SATA_H
+
+#include "fblock_os.h"
+#include "fsata.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    FFreeRTOSBlockDev dev;
+    FSataCtrl *ctrl;
+    u8 port;
+    boolean is_ncq;             /* ios are issued as first party dma commands */
+} FFreeRTOSSataBlock;
+
+/* register the disk on port of an initialized sata controller as a block device, its ios are issued on the ahci slots */
+int FFreeRTOSSataBlockInit(FFreeRTOSSataBlock *blk, const char *name, FSataCtrl *ctrl, u8 port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
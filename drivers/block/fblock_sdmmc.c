@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_sdmmc.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the sd/emmc backend of the block device layer used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <FreeRTOS.h>
+#include "task.h"
+#include "ftypes.h"
+#include "fdebug.h"
+#include "fassert.h"
+#include "fblock_sdmmc.h"
+
+#define FBLOCK_SDMMC_DEBUG_TAG "FFreeRTOSSdmmcBlock"
+#define FBLOCK_SDMMC_ERROR(format, ...) FT_DEBUG_PRINT_E(FBLOCK_SDMMC_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FBLOCK_SDMMC_INFO(format, ...)  FT_DEBUG_PRINT_I(FBLOCK_SDMMC_DEBUG_TAG, format, ##__VA_ARGS__)
+
+/* the card programs the data written before a flush, wait it not busy */
+#define FBLOCK_SDMMC_BUSY_TIMEOUT_MS    5000U
+
+/* request done, interrupt of the fsdif host or FSDIFHOST_AsyncPoll in the workqueue */
+static void FFreeRTOSSdmmcBlockDone(fsdifhost_async_req_t *req, status_t status)
+{
+    FFreeRTOSBlockIo *io = (FFreeRTOSBlockIo *)req->userData;
+
+    FFreeRTOSBlockIoDone(io, (status == kStatus_Success) ? 0 :
+                         ((status == kStatus_Timeout) ? -ETIMEDOUT : -EIO));
+}
+
+/* host asks for FSDIFHOST_AsyncPoll from interrupt, wait the card not busy from the next tick */
+static void FFreeRTOSSdmmcBlockKick(void *param)
+{
+    FFreeRTOSSdmmcBlock *blk = (FFreeRTOSSdmmcBlock *)param;
+
+    (void)xWorkQueueDelayed(&blk->kick_work, 1);
+}
+
+static void FFreeRTOSSdmmcBlockKickWork(void *args)
+{
+    FFreeRTOSSdmmcBlock *blk = (FFreeRTOSSdmmcBlock *)args;
+
+    FSDIFHOST_AsyncPoll(blk->host);
+}
+
+/* flush is a barrier, the ios before it are done and the host is idle */
+static int FFreeRTOSSdmmcBlockFlush(FFreeRTOSSdmmcBlock *blk)
+{
+    sdmmchost_t *host = blk->host;
+    u32 wait_ms;
+
+    for (wait_ms = 0; SDMMCHOST_IsCardBusy(host); wait_ms++)
+    {
+        if (wait_ms >= FBLOCK_SDMMC_BUSY_TIMEOUT_MS)
+        {
+            FBLOCK_SDMMC_ERROR("%s: wait card not busy timeout.", blk->dev.name);
+            return -ETIMEDOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1) ? pdMS_TO_TICKS(1) : 1);
+    }
+
+#if defined(CONFIG_FSL_SDMMC_ENABLE_MMC)
+    if (host->config.cardType == kSDMMCHOST_CARD_TYPE_EMMC)
+    {
+        mmc_card_t *card = (mmc_card_t *)host->card;
+
+        /* no volatile cache to write back */
+        if ((card->extendedCsd.cacheSize == 0U) || (card->extendedCsd.cacheCtrl != MMC_CACHE_CONTROL_ENABLE))
+        {
+            return 0;
+        }
+
+        if (MMC_FlushCache(card) != kStatus_Success)
+        {
+            FBLOCK_SDMMC_ERROR("%s: flush cache failed.", blk->dev.name);
+            return -EIO;
+        }
+    }
+#endif
+
+    return 0;
+}
+
+static int FFreeRTOSSdmmcBlockSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io)
+{
+    FFreeRTOSSdmmcBlock *blk = (FFreeRTOSSdmmcBlock *)dev->priv;
+    fsdifhost_async_req_t *req = &blk->req[io - dev->io];
+
+    switch (io->op)
+    {
+        case FFREERTOS_BLOCK_OP_READ:
+        case FFREERTOS_BLOCK_OP_WRITE:
+            req->write = (io->op == FFREERTOS_BLOCK_OP_WRITE);
+            req->block = (uint32_t)io->sector; /* sd and emmc block counts fit in 32 bits */
+            req->blockCount = io->count;
+            req->buffer = io->buf;
+            req->callback = FFreeRTOSSdmmcBlockDone;
+            req->userData = io;
+            return (FSDIFHOST_AsyncSubmit(blk->host, req) == kStatus_Success) ? 0 : -EINVAL;
+        case FFREERTOS_BLOCK_OP_FLUSH:
+            FFreeRTOSBlockIoDone(io, FFreeRTOSSdmmcBlockFlush(blk));
+            return 0;
+        default:
+            return -EINVAL;
+    }
+}
+
+static void FFreeRTOSSdmmcBlockPoll(FFreeRTOSBlockDev *dev)
+{
+    FFreeRTOSSdmmcBlock *blk = (FFreeRTOSSdmmcBlock *)dev->priv;
+
+    FSDIFHOST_AsyncPoll(blk->host);
+}
+
+static const FFreeRTOSBlockOps sdmmc_block_ops =
+{
+    .submit = FFreeRTOSSdmmcBlockSubmit,
+    .poll = FFreeRTOSSdmmcBlockPoll
+};
+
+/**
+ * @name: FFreeRTOSSdmmcBlockInit
+ * @msg: 将已初始化的sd/emmc卡注册为块设备, 请求由块设备层合并后异步提交到fsdif控制器的请求队列
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSSdmmcBlock} *blk, sd/emmc块设备
+ * @param {char} *name, 设备名称
+ * @param {sdmmchost_t} *host, 已完成卡初始化的控制器, 需使能DMA和中断
+ * @note: 注册后控制器的同步传输在请求执行期间返回忙, 卡忙等待与错误恢复在工作队列中进行
+ */
+int FFreeRTOSSdmmcBlockInit(FFreeRTOSSdmmcBlock *blk, const char *name, sdmmchost_t *host)
+{
+    FFreeRTOSBlockDev *dev = &blk->dev;
+    fsdifhost_async_config_t config;
+    status_t status;
+    int ret;
+
+    FASSERT(blk && name && host && host->card);
+
+    memset(blk, 0, sizeof(*blk));
+    memset(&config, 0, sizeof(config));
+    strncpy(dev->name, name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    blk->host = host;
+
+    if (host->config.cardType == kSDMMCHOST_CARD_TYPE_EMMC)
+    {
+#if defined(CONFIG_FSL_SDMMC_ENABLE_MMC)
+        mmc_card_t *card = (mmc_card_t *)host->card;
+
+        dev->sector_size = card->blockSize;
+        dev->sector_count = card->userPartitionBlocks;
+        config.byteAddress = !(card->flags & kMMC_SupportHighCapacityFlag);
+        config.setBlockCount = true;
+#if defined(CONFIG_FREERTOS_BLOCK_SDMMC_PACKED)
+        /* packed commands come with eMMC 4.5 */
+        if (card->extendedCsd.extendecCsdVersion >= kMMC_ExtendedCsdRevision16)
+        {
+            config.maxPackedWrites = card->extendedCsd.maxPackedWriteCmd;
+            config.maxPackedReads = card->extendedCsd.maxPackedReadCmd;
+        }
+#endif
+#else
+        return -ENODEV;
+#endif
+    }
+    else if ((host->config.cardType == kSDMMCHOST_CARD_TYPE_STANDARD_SD) ||
+             (host->config.cardType == kSDMMCHOST_CARD_TYPE_MICRO_SD))
+    {
+#if defined(CONFIG_FSL_SDMMC_ENABLE_SD)
+        sd_card_t *card = (sd_card_t *)host->card;
+
+        dev->sector_size = card->blockSize;
+        dev->sector_count = card->blockCount;
+        config.byteAddress = !(card->flags & kSD_SupportHighCapacityFlag);
+        /* CMD23 is optional for sd card */
+        config.setBlockCount = !!(card->flags & kSD_SupportSetBlockCountCmd);
+#else
+        return -ENODEV;
+#endif
+    }
+    else
+    {
+        return -ENODEV;
+    }
+
+    if (xWorkQueueInit() != pdPASS)
+    {
+        return -ENOMEM;
+    }
+    vWorkInit(&blk->kick_work, FFreeRTOSSdmmcBlockKickWork, blk, WORKQUEUE_HIGH);
+
+    config.blockSize = dev->sector_size;
+    config.kick = FFreeRTOSSdmmcBlockKick;
+    config.kickParam = blk;
+    status = FSDIFHOST_AsyncEnable(host, &config);
+    if (status != kStatus_Success)
+    {
+        FBLOCK_SDMMC_ERROR("%s: enable async transfer failed, 0x%x.", name, status);
+        return (status == kStatus_OutOfRange) ? -ENOMEM : -EINVAL;
+    }
+
+    /* one request in flight and one prepared keep the bus busy, more are queued to be packed */
+    dev->queue_depth = FFREERTOS_BLOCK_MAX_QUEUE_DEPTH;
+    dev->max_sectors = host->maxBlockCount;
+    dev->ops = &sdmmc_block_ops;
+    dev->priv = blk;
+
+    FBLOCK_SDMMC_INFO("%s: %llu sectors of %u bytes.", name, (unsigned long long)dev->sector_count, dev->sector_size);
+    ret = FFreeRTOSBlockRegister(dev);
+    if (ret != 0)
+    {
+        (void)FSDIFHOST_AsyncDisable(host);
+    }
+
+    return ret;
+}
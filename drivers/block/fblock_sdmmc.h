@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fblock_sdmmc.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the sd/emmc backend of the block device layer used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FBLOCK_SDMMC_H
+#define FBLOCK_SDMMC_H
+
+#include "fblock_os.h"
+#include "fsl_sdmmc.h"
+#include "fsl_hc_fsdif.h"
+#include "freertos_workqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    FFreeRTOSBlockDev dev;
+    sdmmchost_t *host;
+    fsdifhost_async_req_t req[FFREERTOS_BLOCK_MAX_QUEUE_DEPTH];    /* one for each io slot of dev */
+    Work_t kick_work;           /* runs FSDIFHOST_AsyncPoll when the card is busy or a transfer failed */
+} FFreeRTOSSdmmcBlock;
+
+/* register the initialized sd/emmc card of host as a block device, its ios are queued on the fsdif host */
+int FFreeRTOSSdmmcBlockInit(FFreeRTOSSdmmcBlock *blk, const char *name, sdmmchost_t *host);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,14 @@
+ifdef CONFIG_FREERTOS_USE_BLOCK
+DRIVERS_CSRCS += \
+    block/fblock_os.c
+endif
+
+ifdef CONFIG_FREERTOS_BLOCK_SDMMC
+DRIVERS_CSRCS += \
+    block/fblock_sdmmc.c
+endif
+
+ifdef CONFIG_FREERTOS_BLOCK_SATA
+DRIVERS_CSRCS += \
+    block/fblock_sata.c
+endif
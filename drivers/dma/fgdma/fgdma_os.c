@@ -56,6 +56,28 @@ static FGdmaBdlDesc *channel_first_desc_addr[FFREERTOS_GDMA_NUM_OF_CHAN];
 /************************** Function Prototypes ******************************/
 
 /*****************************************************************************/
+static void GdmaChannelNotifyTransferEnd(uint32_t ctrl_id, uint32_t channel_id)
+{
+    FreeRTOSGdmaChanEvtHandler usr_evt_handler = gdma_instance[ctrl_id].os_evt_handler[channel_id][FFREERTOS_GDMA_CHAN_EVT_TRANS_END];
+    void *usr_evt_handler_arg = gdma_instance[ctrl_id].os_evt_handler_arg[channel_id][FFREERTOS_GDMA_CHAN_EVT_TRANS_END];
+
+    if (usr_evt_handler != NULL)
+    {
+        usr_evt_handler(channel_id, usr_evt_handler_arg);
+    }
+    FGDMA_INFO("Channel: %d Transfer completed.\n", channel_id);
+}
+
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+/* GDMA transfer end bottom half, runs in the worker task */
+static void GdmaChannelTransferEndWork(void *args)
+{
+    FFreeRTOSGdmaChanWork *chan_work = (FFreeRTOSGdmaChanWork *)args;
+
+    GdmaChannelNotifyTransferEnd(chan_work->ctrl_id, chan_work->channel_id);
+}
+#endif
+
 /* GDMA transfer end irq response function */
 static void GdmaChannelTransferEnd(FGdmaChanIrq *const chan_irq_info_p, void *args)
 {   
@@ -63,14 +85,15 @@ static void GdmaChannelTransferEnd(FGdmaChanIrq *const chan_irq_info_p, void *ar
 
     FGdmaChanIndex channel_id = chan_irq_info_p->chan_id;
     uint32_t ctrl_id = chan_irq_info_p->gdma_instance->config.instance_id;
-    FreeRTOSGdmaChanEvtHandler usr_evt_handler = gdma_instance[ctrl_id].os_evt_handler[channel_id][FFREERTOS_GDMA_CHAN_EVT_TRANS_END];
-    void *usr_evt_handler_arg = gdma_instance[ctrl_id].os_evt_handler_arg[channel_id][FFREERTOS_GDMA_CHAN_EVT_TRANS_END];
 
-    if (usr_evt_handler != NULL)
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    if (gdma_instance[ctrl_id].trans_end_work[channel_id].deferred)
     {
-        usr_evt_handler(channel_id, usr_evt_handler_arg);
+        (void)xWorkQueue(&gdma_instance[ctrl_id].trans_end_work[channel_id].work);
+        return;
     }
-    FGDMA_INFO("Channel: %d Transfer completed.\n", channel_id);
+#endif
+    GdmaChannelNotifyTransferEnd(ctrl_id, channel_id);
 
     return;
 }
@@ -171,6 +194,23 @@ void FFreeRTOSGdmaChanRegisterEvtHandler(FFreeRTOSGdma *const instance_p,
     return;
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+/* GDMA channel transfer end handler in interrupt or in the worker task */
+void FFreeRTOSGdmaChanDeferEvtHandler(FFreeRTOSGdma *const instance_p, uint32_t channel_id, boolean defer)
+{
+    FASSERT(instance_p);
+    FASSERT(channel_id < FFREERTOS_GDMA_NUM_OF_CHAN);
+
+    instance_p->trans_end_work[channel_id].deferred = defer;
+    if (!defer)
+    {
+        (void)xWorkCancel(&instance_p->trans_end_work[channel_id].work);
+    }
+
+    return;
+}
+#endif
+
 /* GDMA ctrl(controller) init function */
 FFreeRTOSGdma *FFreeRTOSGdmaInit(uint32_t ctrl_id)
 {
@@ -184,6 +224,24 @@ FFreeRTOSGdma *FFreeRTOSGdmaInit(uint32_t ctrl_id)
     void *memp_buf_end = (void *)instance_p->memp_buf + sizeof(instance_p->memp_buf);
     FError err = FFREERTOS_GDMA_OK;
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* worker tasks are created outside the critical section below */
+    if (pdPASS != xWorkQueueInit())
+    {
+        FGDMA_ERROR("Create workqueue failed.");
+        return NULL;
+    }
+
+    for (uint32_t chan = 0; chan < FFREERTOS_GDMA_NUM_OF_CHAN; chan++)
+    {
+        instance_p->trans_end_work[chan].ctrl_id = ctrl_id;
+        instance_p->trans_end_work[chan].channel_id = chan;
+        instance_p->trans_end_work[chan].deferred = FALSE;
+        vWorkInit(&instance_p->trans_end_work[chan].work, GdmaChannelTransferEndWork,
+                  &instance_p->trans_end_work[chan], WORKQUEUE_HIGH);
+    }
+#endif
+
     taskENTER_CRITICAL(); /* forbidden scheduler during init */
 
     ctrl_config = *FGdmaLookupConfig(ctrl_id);
@@ -234,6 +292,13 @@ FError FFreeRTOSGdmaDeInit(FFreeRTOSGdma *const instance_p)
         taskEXIT_CRITICAL();
         return err;
     }
+
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    for (uint32_t chan = 0; chan < FFREERTOS_GDMA_NUM_OF_CHAN; chan++)
+    {
+        (void)xWorkCancel(&instance_p->trans_end_work[chan].work);
+    }
+#endif
     FMempDeinit(memp);
     FGdmaDeInitialize(ctrl_p);
 
@@ -35,6 +35,10 @@
 #include "fparameters.h"
 #include "fgdma.h"
 #include "fmemory_pool.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+#include "freertos_workqueue.h"
+#endif
 /************************** Constant Definitions *****************************/
 #ifdef __cplusplus
 extern "C"
@@ -69,6 +73,16 @@ typedef enum
 
 typedef void (*FreeRTOSGdmaChanEvtHandler)(uint32_t channel_id, void *arg);
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+typedef struct
+{
+    Work_t   work;        /* runs the transfer end handler in the high priority worker task */
+    uint32_t ctrl_id;
+    uint32_t channel_id;
+    boolean  deferred;    /* the channel asked for its handler in task context */
+} FFreeRTOSGdmaChanWork;
+#endif
+
 typedef struct
 {
     FGdma                      ctrl;
@@ -77,6 +91,9 @@ typedef struct
     uint8_t                    memp_buf[SZ_16K];                                                       /* buffer used to support dynamic memory */
     FreeRTOSGdmaChanEvtHandler os_evt_handler[FGDMA_NUM_OF_CHAN][FFREERTOS_GDMA_CHAN_NUM_OF_EVT];
     void                       *os_evt_handler_arg[FGDMA_NUM_OF_CHAN][FFREERTOS_GDMA_CHAN_NUM_OF_EVT];
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    FFreeRTOSGdmaChanWork      trans_end_work[FGDMA_NUM_OF_CHAN];
+#endif
 } FFreeRTOSGdma; /* GDMA instance in FreeRTOS */
 
 typedef struct
@@ -113,12 +130,20 @@ FError FFreeRTOSGdmaChanStop(FFreeRTOSGdma *const instance_p, uint32_t channel_i
 /* GDMA channel deconfigure function */
 FError FFreeRTOSGdmaChanDeconfigure(FFreeRTOSGdma *const instance_p, uint32_t channel_id);
 
+/* register a channel event handler, it runs in the interrupt unless the channel is deferred */
 void FFreeRTOSGdmaChanRegisterEvtHandler(FFreeRTOSGdma *const instance_p,
                                          uint32_t channel_id,
                                          FFreeRTOSGdmaChanEvtType evt,
                                          FreeRTOSGdmaChanEvtHandler os_evt_handler, 
                                          void *os_evt_handler_arg);
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+/* run the transfer end handler of channel in the high priority worker task instead of the
+   interrupt, transfers ending before it runs are reported once, the handler shall not use
+   the FromISR APIs then */
+void FFreeRTOSGdmaChanDeferEvtHandler(FFreeRTOSGdma *const instance_p, uint32_t channel_id, boolean defer);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huangjin  2025/10/21            first release
+ *  1.1  phytium   2026/10/19            move the receive path to the workqueue
  */
 
 #include "fparameters.h"
@@ -68,49 +69,6 @@ FPcieMsiVector msi_vector[FE1000E_NUM][PCIE_MSI_DEVICE_MAX_NUM] = {0};
 /*max support 16 ahci controllers*/
 static FPcieEcam pcie_device;
 
-/* queue */
-
-void FE1000EQueueInit(PqQueue *q)
-{
-    FASSERT(q != NULL);
-    q->head = q->tail = q->len = 0;
-}
-
-int FE1000EPqEnqueue(PqQueue *q, void *p)
-{
-    if (q->len == PQ_QUEUE_SIZE)
-    {
-        return -1;
-    }
-
-    q->data[q->head] = (uintptr)p;
-    q->head = (q->head + 1) % PQ_QUEUE_SIZE;
-    q->len++;
-
-    return 0;
-}
-
-void *FE1000EPqDequeue(PqQueue *q)
-{
-    int ptail;
-
-    if (q->len == 0)
-    {
-        return NULL;
-    }
-
-    ptail = q->tail;
-    q->tail = (q->tail + 1) % PQ_QUEUE_SIZE;
-    q->len--;
-
-    return (void *)q->data[ptail];
-}
-
-int FE1000EPqQlength(PqQueue *q)
-{
-    return q->len;
-}
-
 int FE1000ELwipPortRxComplete(FE1000EOs *instance_p)
 {
     FE1000ECtrl *e1000e_p = &instance_p->instance;
@@ -359,13 +317,27 @@ static void FE1000ETransDoneCallback(void *param)
 static void FE1000EReceiveDoneCallBack(void *args)
 {
     FE1000E_OS_PRINT_D("FE1000EReceiveDoneCallBack called");
-    struct LwipPort *e1000e_netif_p;
     FE1000EOs *instance_p = (FE1000EOs *)args;
-    e1000e_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     FE1000EIrqDisable(&instance_p->instance, IMS_RXQ0);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* receive completions before the work runs are handled by the same pass */
+    (void)xWorkQueue(&instance_p->rx_work);
+#else
+    struct LwipPort *e1000e_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     sys_sem_signal(&(e1000e_netif_p->sem_rx_data_available));
+#endif
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+static void FE1000EReceiveWork(void *args)
+{
+    FE1000EOs *instance_p = (FE1000EOs *)args;
+
+    /* the input pass of the lwip port unmasks the receive interrupt and drains the ring */
+    LwipPortInput((struct netif *)instance_p->netif);
+}
+#endif
+
 static void FE1000ELinkChangeCallBack(void *args)
 {
     u32 ctrl;
@@ -497,6 +469,14 @@ FError FE1000ELwipPortInit(FE1000EOs *instance_p)
                                          __func__);
     }
 
+    status = FSpscRingInit(&instance_p->recv_q, instance_p->recv_q_buffer,
+                           sizeof(instance_p->recv_q_buffer[0]), PQ_QUEUE_SIZE);
+    if (status != FT_SUCCESS)
+    {
+        FE1000E_OS_PRINT_E("Init recv queue failed.");
+        return FE1000E_ERR_FAILED;
+    }
+
     /* pcie init */
     status = FPcieInit(&pcie_device);
     if (status != FE1000E_SUCCESS)
@@ -573,6 +553,15 @@ FError FE1000ELwipPortInit(FE1000EOs *instance_p)
         FASSERT(FT_SUCCESS == status);
     }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    if (xWorkQueueInit() != pdPASS)
+    {
+        FE1000E_OS_PRINT_E("Create workqueue failed.");
+        return FREERTOS_E1000E_INIT_ERROR;
+    }
+    vWorkInit(&instance_p->rx_work, FE1000EReceiveWork, instance_p, WORKQUEUE_HIGH);
+#endif
+
     FNetPcieMsiIrqInstall(e1000e_p, &pcie_device, bus, device, function,
                           (FPcieMsiVector *)&msi_vector[FE1000E0_ID]);
     FE1000EIrqEnable(e1000e_p, IMS_LSC | IMS_RXQ0);
@@ -621,7 +610,7 @@ void *FE1000ELwipPortRx(FE1000EOs *instance_p)
         FCacheDCacheInvalidateRange((uintptr)p->payload, length);
 
         /* entry queue */
-        if (FE1000EPqEnqueue(&instance_p->recv_q, (void *)p) < 0)
+        if (!FSpscRingPush(&instance_p->recv_q, &p))
         {
 #if LINK_STATS
             lwip_stats.link.memerr++;
@@ -655,13 +644,11 @@ void *FE1000ELwipPortQueueRx(FE1000EOs *instance_p)
     FASSERT(instance_p != NULL);
     struct pbuf *p;
 
-    /* see if there is data to process */
-    if (FE1000EPqQlength(&instance_p->recv_q) == 0)
+    /* return one packet from receive q, if there is one */
+    if (!FSpscRingPop(&instance_p->recv_q, &p))
     {
         return NULL;
     }
-    /* return one packet from receive q */
-    p = (struct pbuf *)FE1000EPqDequeue(&instance_p->recv_q);
 
     return p;
 }
@@ -735,22 +722,20 @@ static void FreeOnlyRxPbufs(FE1000EOs *instance_p)
 
 void FE1000ELwipPortStop(FE1000EOs *instance_p)
 {
-    u32 rx_queue_len = 0;
     struct pbuf *p;
     FASSERT(instance_p != NULL);
 
     /* close mac controler */
     FE1000EStop(&instance_p->instance);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    (void)xWorkCancel(&instance_p->rx_work);
+#endif
 
     /*  */
-    rx_queue_len = FE1000EPqQlength(&instance_p->recv_q);
-    while (rx_queue_len)
+    while (FSpscRingPop(&instance_p->recv_q, &p))
     {
-        /* return one packet from receive q */
-        p = (struct pbuf *)FE1000EPqDequeue(&instance_p->recv_q);
         pbuf_free(p);
         FE1000E_OS_PRINT_W("delete queue %p", p);
-        rx_queue_len--;
     }
 
     /* free all pbuf */
@@ -23,6 +23,7 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huangjin  2025/10/21            first release
+ *  1.1  phytium   2026/10/19            move the receive path to the workqueue
  */
 
 #ifndef FE1000E_OS_H
@@ -34,6 +35,11 @@
 #include "e1000e.h"
 #include "fkernel.h"
 #include "ferror_code.h"
+#include "flockfree.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+#include "freertos_workqueue.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,18 +88,12 @@ extern "C" {
 #define BD_ALIGNMENT (FE1000E_DMABD_MINIMUM_ALIGNMENT*2)
 
 /*  frame queue */
-#define PQ_QUEUE_SIZE 4096
+#define PQ_QUEUE_SIZE 4096 /* power of two */
 
 /*irq priority value*/
 #define E1000E_OS_IRQ_PRIORITY_VALUE (configMAX_API_CALL_INTERRUPT_PRIORITY+1)
 FASSERT_STATIC((E1000E_OS_IRQ_PRIORITY_VALUE <= IRQ_PRIORITY_VALUE_15)&&(E1000E_OS_IRQ_PRIORITY_VALUE >= configMAX_API_CALL_INTERRUPT_PRIORITY));
 
-typedef struct 
-{
-    uintptr data[PQ_QUEUE_SIZE];
-    int head, tail, len;
-} PqQueue;
-
 typedef enum
 {
     FE1000E_OS_INTERFACE_SGMII = 0,
@@ -130,8 +130,8 @@ typedef struct
     FE1000ENetifBuffer buffer;
 
     /* queue to store overflow packets */
-    PqQueue recv_q;
-    PqQueue send_q;
+    FSpscRing recv_q;
+    uintptr recv_q_buffer[PQ_QUEUE_SIZE];
 
     /* indicates whether to enbale e1000e run in special mode,such as jumbo */
     u32 feature;
@@ -139,6 +139,9 @@ typedef struct
     struct LwipPort *stack_pointer; /* Docking data stack data structure */
     u8 hwaddr[FE1000E_MAX_HARDWARE_ADDRESS_LENGTH];
     void * netif; /* Pointing to the netif */
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    Work_t rx_work;                 /* moves received frames into lwip */
+#endif
 } FE1000EOs;
 
 FE1000EOs *FE1000ELwipPortGetInstancePointer(u32 FE1000ELwipPortInstanceID);
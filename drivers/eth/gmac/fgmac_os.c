@@ -23,6 +23,7 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huanghe  2022/11/15    first release
+ *  1.1  phytium  2026/10/19    move the receive path to the workqueue
  */
 
 
@@ -202,12 +203,26 @@ static void EthLinkTransDoneCallback(void *param)
 static void GmacReceiveCallBack(void *args)
 {
     LWIP_ASSERT("args != NULL", (args != NULL));
-    struct LwipPort *gmac_netif_p;
     FGmacOs *instance_p = (FGmacOs *)args;
-    gmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* frames received before the work runs are handled by the same pass */
+    (void)xWorkQueue(&instance_p->rx_work);
+#else
+    struct LwipPort *gmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     sys_sem_signal(&gmac_netif_p->sem_rx_data_available);
+#endif
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+static void GmacReceiveWork(void *args)
+{
+    FGmacOs *instance_p = (FGmacOs *)args;
+
+    /* the input pass of the lwip port drains the rx ring */
+    LwipPortInput((struct netif *)instance_p->netif);
+}
+#endif
+
 
 static int FGmacSetupIsr(FGmac *gmac_p)
 {
@@ -357,6 +372,15 @@ FError FGmacOsInit(FGmacOs *instance_p)
         FASSERT(FT_SUCCESS == status);
     }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    if (xWorkQueueInit() != pdPASS)
+    {
+        OS_MAC_DEBUG_E("Create workqueue failed.");
+        return FREERTOS_GMAC_INIT_ERROR;
+    }
+    vWorkInit(&instance_p->rx_work, GmacReceiveWork, instance_p, WORKQUEUE_HIGH);
+#endif
+
     /* initialize interrupt */
     FGmacSetupIsr(gmac_p);
 
@@ -666,4 +690,7 @@ void FGmacOsStop(FGmacOs *instance_p)
     FASSERT(instance_p != NULL);
     /* step 1 close mac controler  */
     FGmacStopTrans(&instance_p->instance);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    (void)xWorkCancel(&instance_p->rx_work);
+#endif
 }
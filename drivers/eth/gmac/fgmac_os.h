@@ -23,6 +23,7 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huanghe  2022/11/15    first release
+ *  1.1  phytium  2026/10/19    move the receive path to the workqueue
  */
 
 #ifndef FGMAC_OS_H
@@ -37,6 +38,10 @@
 #include "fgmac_phy.h"
 #include "fparameters.h"
 #include "lwip/netif.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+#include "freertos_workqueue.h"
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -108,6 +113,10 @@ typedef struct
     u32 feature;
     struct LwipPort *stack_pointer; /* Docking data stack data structure */
     u8 hwaddr[FGMAX_MAX_HARDWARE_ADDRESS_LENGTH];
+    void *netif; /* Pointing to the netif */
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    Work_t rx_work;                 /* moves received frames into lwip */
+#endif
 } FGmacOs;
 
 
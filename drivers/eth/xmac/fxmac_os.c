@@ -31,12 +31,14 @@
 #include "fxmac_phy.h"
 #include "fxmac.h"
 #include "fcache.h"
+#include "fdrivers_port.h"
 #include "fxmac_bdring.h"
 #include "lwip_port.h"
 #include "netif/etharp.h"
 #include "eth_ieee_reg.h"
 #include "fcpu_info.h"
 #include "faarch.h"
+#include "fperf_stat.h"
 
 #include "FreeRTOS.h"
 #include "semphr.h"
@@ -71,49 +73,6 @@ static FXmacOs fxmac_os_instace[FXMAC_NUM] =
 
 int isr_calling_flg = 0;
 
-/* queue */
-
-void FXmacQueueInit(PqQueue *q)
-{
-    FASSERT(q != NULL);
-    q->head = q->tail = q->len = 0;
-}
-
-int FXmacPqEnqueue(PqQueue *q, void *p)
-{
-    if (q->len == PQ_QUEUE_SIZE)
-    {
-        return -1;
-    }
-
-    q->data[q->head] = (uintptr)p;
-    q->head = (q->head + 1) % PQ_QUEUE_SIZE;
-    q->len++;
-
-    return 0;
-}
-
-void *FXmacPqDequeue(PqQueue *q)
-{
-    int ptail;
-
-    if (q->len == 0)
-    {
-        return NULL;
-    }
-
-    ptail = q->tail;
-    q->tail = (q->tail + 1) % PQ_QUEUE_SIZE;
-    q->len--;
-
-    return (void *)q->data[ptail];
-}
-
-int FXmacPqQlength(PqQueue *q)
-{
-    return q->len;
-}
-
 /* dma */
 
 /**
@@ -218,6 +177,7 @@ FError FXmacSgsend(FXmacOs *instance_p, struct pbuf *p)
     u32 bdindex;
     u32 max_fr_size;
 
+    FPERF_STAT_BEGIN(FXmacSgsend);
     txring = &(FXMAC_GET_TXRING(instance_p->instance));
 
     /* first count the number of pbufs */
@@ -231,6 +191,7 @@ FError FXmacSgsend(FXmacOs *instance_p, struct pbuf *p)
     if (status != FT_SUCCESS)
     {
         FXMAC_OS_XMAC_PRINT_I("sgsend: Error allocating TxBD.");
+        FPERF_STAT_END(FXmacSgsend);
         return ERR_GENERAL;
     }
 
@@ -243,6 +204,7 @@ FError FXmacSgsend(FXmacOs *instance_p, struct pbuf *p)
             FXMAC_OS_XMAC_PRINT_I("txbd %p, txring->base_bd_addr %p", txbd, txring->base_bd_addr);
             FXMAC_OS_XMAC_PRINT_I("PBUFS not available bdindex is %d ", bdindex);
             FXMAC_OS_XMAC_PRINT_I("instance_p->buffer.tx_pbufs_storage[bdindex] %p ", instance_p->buffer.tx_pbufs_storage[bdindex]);
+            FPERF_STAT_END(FXmacSgsend);
             return ERR_GENERAL;
         }
 
@@ -299,6 +261,7 @@ FError FXmacSgsend(FXmacOs *instance_p, struct pbuf *p)
     if (status != FT_SUCCESS)
     {
         FXMAC_OS_XMAC_PRINT_I("sgsend: Error submitting TxBD.");
+        FPERF_STAT_END(FXmacSgsend);
         return ERR_GENERAL;
     }
     /* Start transmit */
@@ -307,6 +270,7 @@ FError FXmacSgsend(FXmacOs *instance_p, struct pbuf *p)
                      (FXMAC_READREG32(instance_p->instance.config.base_address,
                                       FXMAC_NWCTRL_OFFSET) |
                       FXMAC_NWCTRL_STARTTX_MASK));
+    FPERF_STAT_END(FXmacSgsend);
     return status;
 }
 
@@ -395,14 +359,17 @@ void SetupRxBds(FXmacOs *instance_p, FXmacBdRing *rxring)
 }
 void FXmacRecvSemaphoreHandler(void *arg)
 {
-    struct LwipPort *xmac_netif_p;
     FXmacOs *instance_p;
     
     instance_p = (FXmacOs *)arg;
-    xmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     FXMAC_WRITEREG32(instance_p->instance.config.base_address, FXMAC_IDR_OFFSET, FXMAC_IXR_RXCOMPL_MASK); 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* receive completions before the work runs are handled by the same pass */
+    (void)xWorkQueue(&instance_p->rx_work);
+#else
+    struct LwipPort *xmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     sys_sem_signal(&(xmac_netif_p->sem_rx_data_available));
-
+#endif
 }
 
 
@@ -424,10 +391,10 @@ void FXmacRecvHandler(void *arg)
     u32 bdindex;
     u32 regval;
     u32 index;
-    u32 rx_queue_len ;
     FXmacOs *instance_p;
     FASSERT(arg != NULL);
 
+    FPERF_STAT_BEGIN(FXmacRecvHandler);
     instance_p = (FXmacOs *)arg;
     xmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     rxring = &FXMAC_GET_RXRING(instance_p->instance);
@@ -471,7 +438,7 @@ void FXmacRecvHandler(void *arg)
             /* store it in the receive queue,
              * where it'll be processed by a different handler
              */
-            if (FXmacPqEnqueue(&instance_p->recv_q, (void *)p) < 0)
+            if (!FSpscRingPush(&instance_p->recv_q, &p))
             {
 #if LINK_STATS
                 lwip_stats.link.memerr++;
@@ -487,16 +454,14 @@ void FXmacRecvHandler(void *arg)
         FXmacBdRingFree(rxring, bd_processed, rxbdset);
         SetupRxBds(instance_p, rxring);
 
-        rx_queue_len = FXmacPqQlength(&instance_p->recv_q);
-        while (rx_queue_len)
+        /* return the packets from receive q */
+        while (FSpscRingPop(&instance_p->recv_q, &p))
         {
-            /* return one packet from receive q */
-            p = (struct pbuf *)FXmacPqDequeue(&instance_p->recv_q);
-            FXmacOsRx(instance_p,(void *)p); 
-            rx_queue_len--;
+            FXmacOsRx(instance_p, (void *)p);
         }
     }
-       
+
+    FPERF_STAT_END(FXmacRecvHandler);
     return;
 }
 
@@ -516,7 +481,7 @@ void CleanDmaTxdescs(FXmacOs *instance_p)
 
     FXmacBdRingCreate(txringptr, (uintptr)instance_p->buffer.tx_bdspace,
                       (uintptr)instance_p->buffer.tx_bdspace, BD_ALIGNMENT,
-                      sizeof(instance_p->buffer.tx_bdspace));
+                      FXMAC_TX_PBUFS_LENGTH);
 
     FXmacBdRingClone(txringptr, &bdtemplate, FXMAC_SEND);
 }
@@ -700,18 +665,12 @@ static void FreeOnlyRxPbufs(FXmacOs *instance_p)
 
 static void FreeTxRxPbufs(FXmacOs *instance_p)
 {
-    u32 rx_queue_len = 0;
     struct pbuf *p;
-    /* first :free PqQueue data */
-    rx_queue_len = FXmacPqQlength(&instance_p->recv_q);
-
-    while (rx_queue_len)
+    /* first :free recv_q data */
+    while (FSpscRingPop(&instance_p->recv_q, &p))
     {
-        /* return one packet from receive q */
-        p = (struct pbuf *)FXmacPqDequeue(&instance_p->recv_q);
         pbuf_free(p);
         FXMAC_OS_XMAC_PRINT_E("Delete queue %p", p);
-        rx_queue_len--;
     }
     FreeOnlyTxPbufs(instance_p);
     FreeOnlyRxPbufs(instance_p);
@@ -776,13 +735,12 @@ void FXmacHandleTxErrors(FXmacOs *instance_p)
     FXMAC_WRITEREG32(instance_p->instance.config.base_address, FXMAC_NWCTRL_OFFSET, netctrlreg);
 }
 
-void FXmacErrorHandler(void *arg, u8 direction, u32 error_word)
+static void FXmacErrorProcess(FXmacOs *instance_p, u8 direction, u32 error_word)
 {
     FXmacBdRing *rxring;
     FXmacBdRing *txring;
-    FXmacOs *instance_p;
+    void *arg = instance_p;
 
-    instance_p = (FXmacOs *)(arg);
     rxring = &FXMAC_GET_RXRING(instance_p->instance);
     txring = &FXMAC_GET_TXRING(instance_p->instance);
 
@@ -840,6 +798,58 @@ void FXmacErrorHandler(void *arg, u8 direction, u32 error_word)
     }
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+static void FXmacRecvWork(void *arg)
+{
+    FXmacOs *instance_p = (FXmacOs *)arg;
+
+    /* unmask first, a completion during the pass queues the work again */
+    FXMAC_WRITEREG32(instance_p->instance.config.base_address, FXMAC_IER_OFFSET, FXMAC_IXR_RXCOMPL_MASK);
+    FXmacRecvHandler(instance_p);
+}
+
+static void FXmacErrorWork(void *arg)
+{
+    FXmacOs *instance_p = (FXmacOs *)arg;
+    u32 rx_error_word, tx_error_word;
+
+    taskENTER_CRITICAL();
+    rx_error_word = instance_p->rx_error_word;
+    tx_error_word = instance_p->tx_error_word;
+    instance_p->rx_error_word = 0;
+    instance_p->tx_error_word = 0;
+    taskEXIT_CRITICAL();
+
+    FXmacErrorProcess(instance_p, FXMAC_RECV, rx_error_word);
+    FXmacErrorProcess(instance_p, FXMAC_SEND, tx_error_word);
+}
+#endif
+
+void FXmacErrorHandler(void *arg, u8 direction, u32 error_word)
+{
+    FXmacOs *instance_p = (FXmacOs *)(arg);
+
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    UBaseType_t saved_mask;
+
+    /* the recovery refills BDs and calls into lwip, collect the status and do it in the worker */
+    saved_mask = taskENTER_CRITICAL_FROM_ISR();
+    if (direction == FXMAC_RECV)
+    {
+        instance_p->rx_error_word |= error_word;
+    }
+    else
+    {
+        instance_p->tx_error_word |= error_word;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+    (void)xWorkQueue(&instance_p->error_work);
+#else
+    FXmacErrorProcess(instance_p, direction, error_word);
+#endif
+}
+
 void FXmacLinkChange(void *args)
 {
     u32 ctrl;
@@ -1109,6 +1119,29 @@ FError FXmacOsInit(FXmacOs *instance_p)
 
     xmac_p = &instance_p->instance;
     FXMAC_OS_XMAC_PRINT_I("instance_id IS %d", instance_p->mac_config.instance_id);
+    status = FSpscRingInit(&instance_p->recv_q, instance_p->recv_q_buffer,
+                           sizeof(instance_p->recv_q_buffer[0]), PQ_QUEUE_SIZE);
+    if (status != FT_SUCCESS)
+    {
+        FXMAC_OS_XMAC_PRINT_E("Init recv queue failed.");
+        return FREERTOS_XMAC_INIT_ERROR;
+    }
+
+    /* the bd rings stay allocated for the instance, in the dma coherent pool */
+    if (instance_p->buffer.rx_bdspace == NULL)
+    {
+        instance_p->buffer.rx_bdspace = FDriverDmaAllocCoherent(FXMAC_RX_BDSPACE_LENGTH, BD_ALIGNMENT);
+        instance_p->buffer.tx_bdspace = FDriverDmaAllocCoherent(FXMAC_TX_BDSPACE_LENGTH, BD_ALIGNMENT);
+        if ((instance_p->buffer.rx_bdspace == NULL) || (instance_p->buffer.tx_bdspace == NULL))
+        {
+            FXMAC_OS_XMAC_PRINT_E("Allocate bd space failed.");
+            FDriverDmaFreeCoherent(instance_p->buffer.rx_bdspace);
+            FDriverDmaFreeCoherent(instance_p->buffer.tx_bdspace);
+            instance_p->buffer.rx_bdspace = NULL;
+            instance_p->buffer.tx_bdspace = NULL;
+            return FREERTOS_XMAC_INIT_ERROR;
+        }
+    }
     mac_config_p = FXmacLookupConfig(instance_p->mac_config.instance_id);
     if (mac_config_p == NULL)
     {
@@ -1222,6 +1255,17 @@ FError FXmacOsInit(FXmacOs *instance_p)
     FXMAC_WRITEREG32(xmac_p->config.base_address, FXMAC_DMACR_OFFSET, dmacrreg);
     FXmacInitDma(instance_p);
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    if (xWorkQueueInit() != pdPASS)
+    {
+        FXMAC_OS_XMAC_PRINT_E("Create workqueue failed.");
+        return FREERTOS_XMAC_INIT_ERROR;
+    }
+    instance_p->rx_error_word = 0;
+    instance_p->tx_error_word = 0;
+    vWorkInit(&instance_p->rx_work, FXmacRecvWork, instance_p, WORKQUEUE_HIGH);
+    vWorkInit(&instance_p->error_work, FXmacErrorWork, instance_p, WORKQUEUE_HIGH);
+#endif
 
     /* initialize interrupt */
     FXmacSetupIsr(instance_p);
@@ -1359,6 +1403,10 @@ void FXmacOsStop(FXmacOs *instance_p)
     FASSERT(instance_p != NULL);
     /* step 1 close interrupt  */
     FXmacDeinitIsr(instance_p);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    (void)xWorkCancel(&instance_p->rx_work);
+    (void)xWorkCancel(&instance_p->error_work);
+#endif
     /* step 2 close mac controler  */
     FXmacStop(&instance_p->instance);
     /* step 3 free all pbuf */
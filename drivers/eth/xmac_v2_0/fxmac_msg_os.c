@@ -23,12 +23,14 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huangjin  2025/06/24            first release
+ *  1.1  phytium   2026/10/19            move the receive path to the workqueue
  */
 
 #include "fparameters.h"
 #include "fassert.h"
 #include "fdebug.h"
 #include "fcache.h"
+#include "fdrivers_port.h"
 #include "fcpu_info.h"
 #include "faarch.h"
 
@@ -76,49 +78,6 @@ static FXmacMsgOs fxmac_os_instace[FXMAC_MSG_NUM] =
 
 int isr_calling_flg = 0;
 
-/* queue */
-
-void FXmacQueueInit(PqQueue *q)
-{
-    FASSERT(q != NULL);
-    q->head = q->tail = q->len = 0;
-}
-
-int FXmacPqEnqueue(PqQueue *q, void *p)
-{
-    if (q->len == PQ_QUEUE_SIZE)
-    {
-        return -1;
-    }
-
-    q->data[q->head] = (uintptr)p;
-    q->head = (q->head + 1) % PQ_QUEUE_SIZE;
-    q->len++;
-
-    return 0;
-}
-
-void *FXmacPqDequeue(PqQueue *q)
-{
-    int ptail;
-
-    if (q->len == 0)
-    {
-        return NULL;
-    }
-
-    ptail = q->tail;
-    q->tail = (q->tail + 1) % PQ_QUEUE_SIZE;
-    q->len--;
-
-    return (void *)q->data[ptail];
-}
-
-int FXmacPqQlength(PqQueue *q)
-{
-    return q->len;
-}
-
 /* dma */
 
 /**
@@ -412,15 +371,19 @@ void SetupRxBds(FXmacMsgOs *instance_p, FXmacMsgBdRing *rxring)
 }
 void FXmacRecvSemaphoreHandler(void *arg)
 {
-    struct LwipPort *xmac_netif_p;
     FXmacMsgOs *instance_p;
     FXmacMsgCtrl *xmac_p = NULL;
     
     instance_p = (FXmacMsgOs *)arg;
-    xmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     xmac_p = &instance_p->instance;
     FXmacMsgDisableIrq(xmac_p, 0, FXMAC_MSG_INT_RX_COMPLETE);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* receive completions before the work runs are handled by the same pass */
+    (void)xWorkQueue(&instance_p->rx_work);
+#else
+    struct LwipPort *xmac_netif_p = (struct LwipPort *)instance_p->stack_pointer;
     sys_sem_signal(&(xmac_netif_p->sem_rx_data_available));
+#endif
 }
 
 
@@ -440,7 +403,6 @@ void FXmacRecvHandler(void *arg)
     volatile u32 bd_processed;
     u32 rx_bytes, k;
     u32 bdindex = 0;
-    u32 rx_queue_len;
     u32 rx_tail_bd_index = 0;
     FXmacMsgOs *instance_p;
     FASSERT(arg != NULL);
@@ -481,7 +443,7 @@ void FXmacRecvHandler(void *arg)
             /* store it in the receive queue,
              * where it'll be processed by a different handler
              */
-            if (FXmacPqEnqueue(&instance_p->recv_q, (void *)p) < 0)
+            if (!FSpscRingPush(&instance_p->recv_q, &p))
             {
 #if LINK_STATS
                 lwip_stats.link.memerr++;
@@ -498,13 +460,10 @@ void FXmacRecvHandler(void *arg)
         FXmacMsgBdRingFree(rxring, bd_processed, rxbdset);
         SetupRxBds(instance_p, rxring);
 
-        rx_queue_len = FXmacPqQlength(&instance_p->recv_q);
-        while (rx_queue_len)
+        /* return the packets from receive q */
+        while (FSpscRingPop(&instance_p->recv_q, &p))
         {
-            /* return one packet from receive q */
-            p = (struct pbuf *)FXmacPqDequeue(&instance_p->recv_q);
-            FXmacMsgOsRx(instance_p,(void *)p); 
-            rx_queue_len--;
+            FXmacMsgOsRx(instance_p, (void *)p);
         }
     }
 
@@ -520,6 +479,17 @@ void FXmacMsgOsRecvHandler(FXmacMsgOs *instance_p)
     FXmacRecvHandler(instance_p);
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+static void FXmacRecvWork(void *arg)
+{
+    FXmacMsgOs *instance_p = (FXmacMsgOs *)arg;
+
+    /* unmask first, a completion during the pass queues the work again */
+    FXmacMsgEnableIrq(&instance_p->instance, 0, FXMAC_MSG_INT_RX_COMPLETE);
+    FXmacRecvHandler(instance_p);
+}
+#endif
+
 void CleanDmaTxdescs(FXmacMsgOs *instance_p)
 {
     FXmacMsgBd bdtemplate;
@@ -531,7 +501,7 @@ void CleanDmaTxdescs(FXmacMsgOs *instance_p)
 
     FXmacMsgBdRingCreate(txringptr, (uintptr)instance_p->buffer.tx_bdspace,
                       (uintptr)instance_p->buffer.tx_bdspace, BD_ALIGNMENT,
-                      sizeof(instance_p->buffer.tx_bdspace));
+                      FXMAC_MSG_TX_PBUFS_LENGTH);
 
     FXmacMsgBdRingClone(txringptr, &bdtemplate, FXMAC_MSG_SEND);
 }
@@ -715,18 +685,12 @@ static void FreeOnlyRxPbufs(FXmacMsgOs *instance_p)
 
 static void FreeTxRxPbufs(FXmacMsgOs *instance_p)
 {
-    u32 rx_queue_len = 0;
     struct pbuf *p;
-    /* first :free PqQueue data */
-    rx_queue_len = FXmacPqQlength(&instance_p->recv_q);
-
-    while (rx_queue_len)
+    /* first :free recv_q data */
+    while (FSpscRingPop(&instance_p->recv_q, &p))
     {
-        /* return one packet from receive q */
-        p = (struct pbuf *)FXmacPqDequeue(&instance_p->recv_q);
         pbuf_free(p);
         FXMAC_MSG_OS_PRINT_E("Delete queue %p", p);
-        rx_queue_len--;
     }
     FreeOnlyTxPbufs(instance_p);
     FreeOnlyRxPbufs(instance_p);
@@ -1050,6 +1014,29 @@ FError FXmacMsgOsInit(FXmacMsgOs *instance_p)
 
     xmac_p = &instance_p->instance;
     FXMAC_MSG_OS_PRINT_I("instance_id IS %d", instance_p->mac_config.instance_id);
+    status = FSpscRingInit(&instance_p->recv_q, instance_p->recv_q_buffer,
+                           sizeof(instance_p->recv_q_buffer[0]), PQ_QUEUE_SIZE);
+    if (status != FT_SUCCESS)
+    {
+        FXMAC_MSG_OS_PRINT_E("Init recv queue failed.");
+        return FREERTOS_XMAC_MSG_INIT_ERROR;
+    }
+
+    /* the bd rings stay allocated for the instance, in the dma coherent pool */
+    if (instance_p->buffer.rx_bdspace == NULL)
+    {
+        instance_p->buffer.rx_bdspace = FDriverDmaAllocCoherent(FXMAC_MSG_RX_BDSPACE_LENGTH, BD_ALIGNMENT);
+        instance_p->buffer.tx_bdspace = FDriverDmaAllocCoherent(FXMAC_MSG_TX_BDSPACE_LENGTH, BD_ALIGNMENT);
+        if ((instance_p->buffer.rx_bdspace == NULL) || (instance_p->buffer.tx_bdspace == NULL))
+        {
+            FXMAC_MSG_OS_PRINT_E("Allocate bd space failed.");
+            FDriverDmaFreeCoherent(instance_p->buffer.rx_bdspace);
+            FDriverDmaFreeCoherent(instance_p->buffer.tx_bdspace);
+            instance_p->buffer.rx_bdspace = NULL;
+            instance_p->buffer.tx_bdspace = NULL;
+            return FREERTOS_XMAC_MSG_INIT_ERROR;
+        }
+    }
 
     /* 获取默认配置 */
     mac_config_p = FXmacMsgLookupConfig(instance_p->mac_config.instance_id);
@@ -1155,6 +1142,15 @@ FError FXmacMsgOsInit(FXmacMsgOs *instance_p)
     /* 初始化DMA描述符 */
     FXmacMsgInitDma(instance_p);
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    if (xWorkQueueInit() != pdPASS)
+    {
+        FXMAC_MSG_OS_PRINT_E("Create workqueue failed.");
+        return FREERTOS_XMAC_MSG_INIT_ERROR;
+    }
+    vWorkInit(&instance_p->rx_work, FXmacRecvWork, instance_p, WORKQUEUE_HIGH);
+#endif
+
     /* 初始化中断 */
     FXmacMsgSetupIsr(instance_p);
 
@@ -1292,6 +1288,9 @@ void FXmacMsgOsStop(FXmacMsgOs *instance_p)
     FASSERT(instance_p != NULL);
     /* step 1 close interrupt  */
     FXmacDeinitIsr(instance_p);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    (void)xWorkCancel(&instance_p->rx_work);
+#endif
     /* step 2 close mac controler  */
     FXmacMsgStop(&instance_p->instance);
     /* step 3 free all pbuf */
@@ -23,6 +23,7 @@
  *  Ver   Who        Date                   Changes
  * ----- ------    --------     --------------------------------------
  *  1.0  huangjin  2025/06/24            first release
+ *  1.1  phytium   2026/10/19            move the receive path to the workqueue
  */
 
 #ifndef FXMAC_MSG_OS_H
@@ -34,6 +35,11 @@
 #include "fxmac_msg.h"
 #include "fkernel.h"
 #include "ferror_code.h"
+#include "flockfree.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+#include "freertos_workqueue.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,12 +49,13 @@ extern "C" {
 #define FREERTOS_XMAC_MSG_PARAM_ERROR FT_CODE_ERR(ErrModPort, 0, 0x2)
 #define FREERTOS_XMAC_MSG_NO_VALID_SPACE FT_CODE_ERR(ErrModPort, 0, 0x3)
 
-#define FXMAC_MSG_RX_BDSPACE_LENGTH    0x20000 /* default set 128KB*/
-#define FXMAC_MSG_TX_BDSPACE_LENGTH    0x20000 /* default set 128KB*/
-
 #define FXMAC_MSG_TX_PBUFS_LENGTH       128
 #define FXMAC_MSG_RX_PBUFS_LENGTH       128
 
+/* bd rings, allocated from the dma coherent pool */
+#define FXMAC_MSG_RX_BDSPACE_LENGTH    (FXMAC_MSG_RX_PBUFS_LENGTH * sizeof(FXmacMsgBd))
+#define FXMAC_MSG_TX_BDSPACE_LENGTH    (FXMAC_MSG_TX_PBUFS_LENGTH * sizeof(FXmacMsgBd))
+
 #define FXMAC_MSG_MAX_HARDWARE_ADDRESS_LENGTH 6
 
 #define XMAC_PHY_RESET_ENABLE 1
@@ -74,18 +81,12 @@ extern "C" {
 #define BD_ALIGNMENT (FXMAC_MSG_DMABD_MINIMUM_ALIGNMENT*2)
 
 /*  frame queue */
-#define PQ_QUEUE_SIZE 4096
+#define PQ_QUEUE_SIZE 4096 /* power of two */
 
 /*irq priority value*/
 #define XMAC_OS_IRQ_PRIORITY_VALUE (configMAX_API_CALL_INTERRUPT_PRIORITY + 1)
 FASSERT_STATIC((XMAC_OS_IRQ_PRIORITY_VALUE <= IRQ_PRIORITY_VALUE_15)&&(XMAC_OS_IRQ_PRIORITY_VALUE >= configMAX_API_CALL_INTERRUPT_PRIORITY));
 
-typedef struct 
-{
-    uintptr data[PQ_QUEUE_SIZE];
-    int head, tail, len;
-} PqQueue;
-
 typedef enum
 {
     FXMAC_MSG_OS_INTERFACE_SGMII = 0,
@@ -97,8 +98,8 @@ typedef enum
 
 typedef struct
 {
-    u8 rx_bdspace[FXMAC_MSG_RX_BDSPACE_LENGTH] __attribute__((aligned(128))); /* 接收bd 缓冲区 */
-    u8 tx_bdspace[FXMAC_MSG_TX_BDSPACE_LENGTH] __attribute__((aligned(128))); /* 发送bd 缓冲区 */
+    u8 *rx_bdspace; /* 接收bd 缓冲区 */
+    u8 *tx_bdspace; /* 发送bd 缓冲区 */
 
     uintptr rx_pbufs_storage[FXMAC_MSG_RX_PBUFS_LENGTH];
     uintptr tx_pbufs_storage[FXMAC_MSG_TX_PBUFS_LENGTH];
@@ -122,8 +123,8 @@ typedef struct
     FXmacMsgNetifBuffer buffer;
 
     /* queue to store overflow packets */
-    PqQueue recv_q;
-    PqQueue send_q;
+    FSpscRing recv_q;
+    uintptr recv_q_buffer[PQ_QUEUE_SIZE];
 
     /* indicates whether to enbale xmac run in special mode,such as jumbo */
     u32 feature;
@@ -131,6 +132,9 @@ typedef struct
     struct LwipPort *stack_pointer; /* Docking data stack data structure */
     u8 hwaddr[FXMAC_MSG_MAX_HARDWARE_ADDRESS_LENGTH];
     void * netif; /* Pointing to the netif */
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    Work_t rx_work;                 /* moves received frames into lwip */
+#endif
 } FXmacMsgOs;
 
 FXmacMsgOs *FXmacMsgOsGetInstancePointer(FXmacMsgPhyControl *config_p);
@@ -131,6 +131,16 @@ ifdef CONFIG_USE_MEDIA
 		BUILD_INC_PATH_DIR += $(OS_DRV_CUR_DIR)/media
 endif
 
+#block
+ifdef CONFIG_FREERTOS_USE_BLOCK
+	BUILD_INC_PATH_DIR += $(OS_DRV_CUR_DIR)/block
+endif
+
+#nvme
+ifdef CONFIG_FREERTOS_USE_NVME
+	BUILD_INC_PATH_DIR += $(OS_DRV_CUR_DIR)/nvme
+endif
+
 ifdef CONFIG_USE_I2S
 		BUILD_INC_PATH_DIR += $(OS_DRV_CUR_DIR)/i2s
 endif
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fnvme_os.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for required function implementations of nvme driver used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   add the block device layer backend
+ * 1.2   phytium    2026/10/19   abort timed-out commands before their cid is reused
+ * 1.3   phytium    2026/10/19   wait for the done flag, not for any task notification
+ */
+
+#include <FreeRTOS.h>
+#include "task.h"
+#include "ftypes.h"
+#include "fdebug.h"
+#include "nvme.h"
+#include "nvme_intr.h"
+#include "fnvme_os.h"
+#ifdef CONFIG_FREERTOS_USE_BLOCK
+#include <string.h>
+#include "fkernel.h"
+#include "nvme_namespace.h"
+#endif
+
+#define FNVME_DEBUG_TAG "FFreeRTOSNvme"
+#define FNVME_ERROR(format, ...) FT_DEBUG_PRINT_E(FNVME_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FNVME_WARN(format, ...)  FT_DEBUG_PRINT_W(FNVME_DEBUG_TAG, format, ##__VA_ARGS__)
+
+/* a request completes or times out within CONFIG_NVME_REQUEST_TIMEOUT_SEC,
+   wake up a second later to run the timeout check */
+#define FREERTOS_NVME_WAIT_TICKS    pdMS_TO_TICKS((CONFIG_NVME_REQUEST_TIMEOUT_SEC + 1) * 1000UL)
+
+typedef struct
+{
+    TaskHandle_t task;     /* task blocked on the request */
+    volatile boolean done; /* set by the callback before the notification */
+    volatile int result;   /* 0, -EIO or -ETIMEDOUT */
+} FFreeRTOSNvmeWait;
+
+/* completion callback, runs in the msi-x handler of the queue pair or in the timeout check */
+static void FFreeRTOSNvmeDone(void *arg, const struct nvme_completion *cpl)
+{
+    FFreeRTOSNvmeWait *wait = (FFreeRTOSNvmeWait *)arg;
+    BaseType_t xhigher_priority_task_woken = pdFALSE;
+
+    if (cpl == NULL)
+    {
+        wait->result = -ETIMEDOUT;
+    }
+    else if (nvme_completion_is_error(cpl))
+    {
+        nvme_completion_print(cpl);
+        wait->result = -EIO;
+    }
+    else
+    {
+        wait->result = 0;
+    }
+    wait->done = TRUE;
+
+    if (xPortIsInsideInterrupt())
+    {
+        vTaskNotifyGiveFromISR(wait->task, &xhigher_priority_task_woken);
+        portYIELD_FROM_ISR(xhigher_priority_task_woken);
+    }
+    else
+    {
+        xTaskNotifyGive(wait->task);
+    }
+}
+
+static void FFreeRTOSNvmeWaitInit(FFreeRTOSNvmeWait *wait)
+{
+    wait->task = xTaskGetCurrentTaskHandle();
+    wait->done = FALSE;
+    wait->result = -EIO;
+}
+
+static int FFreeRTOSNvmeWaitDone(struct disk_info *disk, FFreeRTOSNvmeWait *wait)
+{
+    struct nvme_namespace *ns = (struct nvme_namespace *)disk->ns;
+
+    /* the callback always runs, either on completion or from the timeout check,
+       so the wait context on the stack is not used after return, a timed-out
+       command is aborted and keeps its cid until the controller returns it.
+       a notification given by someone else does not end the wait, and the one
+       given after done is set is taken even if done is seen first */
+    do
+    {
+        if (ulTaskNotifyTake(pdTRUE, FREERTOS_NVME_WAIT_TICKS) == 0)
+        {
+            nvme_completion_check_timeout(ns->ctrlr);
+        }
+    }
+    while (!wait->done);
+
+    return wait->result;
+}
+
+/**
+ * @name: FFreeRTOSNvmeRead
+ * @msg: 读取nvme磁盘扇区, 调用任务阻塞等待本核i/o队列的完成中断
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {disk_info} *disk, nvme命名空间的磁盘
+ * @param {u8} *data_buf, 读缓冲区, 4字节对齐
+ * @param {u64} start_sector, 起始扇区
+ * @param {u32} num_sector, 扇区数
+ * @note: 使用调用任务的任务通知, 多个任务可以同时提交, 每个核最多CONFIG_NVME_IO_ENTRIES - 1个请求
+ */
+int FFreeRTOSNvmeRead(struct disk_info *disk, u8 *data_buf, u64 start_sector, u32 num_sector)
+{
+    FFreeRTOSNvmeWait wait;
+    int ret;
+
+    FFreeRTOSNvmeWaitInit(&wait);
+    ret = nvme_disk_read_async(disk, data_buf, start_sector, num_sector,
+                               FFreeRTOSNvmeDone, &wait);
+    if (ret != 0)
+    {
+        FNVME_ERROR("Submit read at sector %llu (count %u) failed, %d.",
+                    (unsigned long long)start_sector, num_sector, ret);
+        return ret;
+    }
+
+    ret = FFreeRTOSNvmeWaitDone(disk, &wait);
+    if (ret != 0)
+    {
+        FNVME_WARN("Read at sector %llu (count %u) failed, %d.",
+                   (unsigned long long)start_sector, num_sector, ret);
+    }
+
+    return ret;
+}
+
+/**
+ * @name: FFreeRTOSNvmeWrite
+ * @msg: 写入nvme磁盘扇区, 调用任务阻塞等待本核i/o队列的完成中断
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {disk_info} *disk, nvme命名空间的磁盘
+ * @param {u8} *data_buf, 写缓冲区, 4字节对齐
+ * @param {u64} start_sector, 起始扇区
+ * @param {u32} num_sector, 扇区数
+ */
+int FFreeRTOSNvmeWrite(struct disk_info *disk, const u8 *data_buf, u64 start_sector, u32 num_sector)
+{
+    FFreeRTOSNvmeWait wait;
+    int ret;
+
+    FFreeRTOSNvmeWaitInit(&wait);
+    ret = nvme_disk_write_async(disk, data_buf, start_sector, num_sector,
+                                FFreeRTOSNvmeDone, &wait);
+    if (ret != 0)
+    {
+        FNVME_ERROR("Submit write at sector %llu (count %u) failed, %d.",
+                    (unsigned long long)start_sector, num_sector, ret);
+        return ret;
+    }
+
+    ret = FFreeRTOSNvmeWaitDone(disk, &wait);
+    if (ret != 0)
+    {
+        FNVME_WARN("Write at sector %llu (count %u) failed, %d.",
+                   (unsigned long long)start_sector, num_sector, ret);
+    }
+
+    return ret;
+}
+
+/**
+ * @name: FFreeRTOSNvmeFlush
+ * @msg: 将nvme磁盘易失写缓存中的数据写入介质
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {disk_info} *disk, nvme命名空间的磁盘
+ */
+int FFreeRTOSNvmeFlush(struct disk_info *disk)
+{
+    FFreeRTOSNvmeWait wait;
+    int ret;
+
+    FFreeRTOSNvmeWaitInit(&wait);
+    ret = nvme_disk_flush_async(disk, FFreeRTOSNvmeDone, &wait);
+    if (ret != 0)
+    {
+        FNVME_ERROR("Submit flush failed, %d.", ret);
+        return ret;
+    }
+
+    return FFreeRTOSNvmeWaitDone(disk, &wait);
+}
+
+#ifdef CONFIG_FREERTOS_USE_BLOCK
+/* completion callback of a block layer io, msi-x handler or timeout check */
+static void FFreeRTOSNvmeBlockDone(void *arg, const struct nvme_completion *cpl)
+{
+    FFreeRTOSBlockIo *io = (FFreeRTOSBlockIo *)arg;
+    int result = 0;
+
+    if (cpl == NULL)
+    {
+        result = -ETIMEDOUT;
+    }
+    else if (nvme_completion_is_error(cpl))
+    {
+        nvme_completion_print(cpl);
+        result = -EIO;
+    }
+
+    FFreeRTOSBlockIoDone(io, result);
+}
+
+static int FFreeRTOSNvmeBlockSubmit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io)
+{
+    struct disk_info *disk = (struct disk_info *)dev->priv;
+
+    switch (io->op)
+    {
+        case FFREERTOS_BLOCK_OP_READ:
+            return nvme_disk_read_async(disk, io->buf, io->sector, io->count,
+                                        FFreeRTOSNvmeBlockDone, io);
+        case FFREERTOS_BLOCK_OP_WRITE:
+            return nvme_disk_write_async(disk, io->buf, io->sector, io->count,
+                                         FFreeRTOSNvmeBlockDone, io);
+        case FFREERTOS_BLOCK_OP_FLUSH:
+            return nvme_disk_flush_async(disk, FFreeRTOSNvmeBlockDone, io);
+        default:
+            return -EINVAL;
+    }
+}
+
+static void FFreeRTOSNvmeBlockPoll(FFreeRTOSBlockDev *dev)
+{
+    struct disk_info *disk = (struct disk_info *)dev->priv;
+    struct nvme_namespace *ns = (struct nvme_namespace *)disk->ns;
+
+    nvme_completion_check_timeout(ns->ctrlr);
+}
+
+static const FFreeRTOSBlockOps nvme_block_ops =
+{
+    .submit = FFreeRTOSNvmeBlockSubmit,
+    .poll = FFreeRTOSNvmeBlockPoll
+};
+
+/**
+ * @name: FFreeRTOSNvmeBlockInit
+ * @msg: 将nvme命名空间注册为块设备, 请求由块设备层合并后异步提交到本核i/o队列
+ * @return {int} 0表示成功, 负数为errno错误码
+ * @param {FFreeRTOSBlockDev} *dev, 块设备
+ * @param {char} *name, 设备名称
+ * @param {disk_info} *disk, nvme命名空间的磁盘
+ * @note: 块设备的分发任务运行在调用核上, 与FFreeRTOSNvmeRead等接口共用本核i/o队列
+ */
+int FFreeRTOSNvmeBlockInit(FFreeRTOSBlockDev *dev, const char *name, struct disk_info *disk)
+{
+    struct nvme_namespace *ns = (struct nvme_namespace *)disk->ns;
+
+    memset(dev, 0, sizeof(*dev));
+    strncpy(dev->name, name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    dev->sector_size = nvme_namespace_get_sector_size(ns);
+    dev->sector_count = nvme_namespace_get_num_sectors(ns);
+    /* one queue entry stays empty to tell a full queue from an empty one */
+    dev->queue_depth = min((u32)(CONFIG_NVME_IO_ENTRIES - 1), (u32)FFREERTOS_BLOCK_MAX_QUEUE_DEPTH);
+    dev->max_sectors = ns->ctrlr->max_xfer_size / dev->sector_size;
+    dev->ops = &nvme_block_ops;
+    dev->priv = disk;
+
+    return FFreeRTOSBlockRegister(dev);
+}
+#endif
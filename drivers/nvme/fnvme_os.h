@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fnvme_os.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for providing function related definitions of nvme driver used in FreeRTOS.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   add the block device layer backend
+ */
+
+#ifndef FNVME_OS_H
+#define FNVME_OS_H
+
+#include "ftypes.h"
+#include "sdkconfig.h"
+#include "nvme_disk.h"
+#ifdef CONFIG_FREERTOS_USE_BLOCK
+#include "fblock_os.h"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* read num_sector sectors from start_sector, the calling task blocks until the completion interrupt */
+int FFreeRTOSNvmeRead(struct disk_info *disk, u8 *data_buf, u64 start_sector, u32 num_sector);
+
+/* write num_sector sectors from start_sector, the calling task blocks until the completion interrupt */
+int FFreeRTOSNvmeWrite(struct disk_info *disk, const u8 *data_buf, u64 start_sector, u32 num_sector);
+
+/* flush the volatile write cache of the namespace */
+int FFreeRTOSNvmeFlush(struct disk_info *disk);
+
+#ifdef CONFIG_FREERTOS_USE_BLOCK
+/* register the namespace as a block device, its ios go to the i/o queue pair of the calling core */
+int FFreeRTOSNvmeBlockInit(FFreeRTOSBlockDev *dev, const char *name, struct disk_info *disk);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
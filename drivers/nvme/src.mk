@@ -0,0 +1,4 @@
+ifdef CONFIG_FREERTOS_USE_NVME
+DRIVERS_CSRCS += \
+    nvme/fnvme_os.c
+endif
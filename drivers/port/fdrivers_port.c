@@ -30,15 +30,37 @@
 #include "fsleep.h"
 #include "fgeneric_timer.h"
 #include "fparameters.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+#include "freertos_hrtimer.h"
+#endif
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+#include "fdma_coherent.h"
+#else
+#include "FreeRTOS.h"
+#endif
 
 /* cache */
 void FDriverDCacheRangeFlush(uintptr_t adr,size_t len)
 {
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+    /* descriptors in the non-cacheable pool need no maintenance */
+    if (FDmaIsCoherent(adr, len))
+    {
+        return;
+    }
+#endif
     FCacheDCacheFlushRange(adr,len);
 }
 
 void FDriverDCacheRangeInvalidate(uintptr_t adr,size_t len)
 {
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+    if (FDmaIsCoherent(adr, len))
+    {
+        return;
+    }
+#endif
     FCacheDCacheInvalidateRange(adr,len);
 }
 
@@ -49,11 +71,52 @@ void FDriverICacheRangeInvalidate(void)
 }
 
 
+/* dma memory */
+
+void *FDriverDmaAllocCoherent(size_t size, size_t align)
+{
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+    return FDmaAllocCoherent(size, align);
+#else
+    uintptr raw;
+    uintptr aligned;
+
+    /* keep the heap block address in front of the aligned buffer */
+    raw = (uintptr)pvPortMalloc(size + align + sizeof(uintptr));
+    if (raw == 0)
+    {
+        return NULL;
+    }
+
+    aligned = (raw + sizeof(uintptr) + align - 1) & ~((uintptr)align - 1);
+    ((uintptr *)aligned)[-1] = raw;
+
+    return (void *)aligned;
+#endif
+}
+
+void FDriverDmaFreeCoherent(void *ptr)
+{
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+    FDmaFreeCoherent(ptr);
+#else
+    if (ptr != NULL)
+    {
+        vPortFree((void *)((uintptr *)ptr)[-1]);
+    }
+#endif
+}
+
 /* time delay */
 
 void FDriverUdelay(u32 usec)
 {
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+    /* blocks the calling task, falls back to busy waiting where it cannot block */
+    vTaskDelayUs(usec);
+#else
     fsleep_microsec(usec);
+#endif
 }
 
 void FDriverMdelay(u32 msec)
@@ -51,6 +51,12 @@ void FDriverDCacheRangeInvalidate(uintptr_t adr,size_t len);
 void FDriverICacheRangeInvalidate(void);
 
 
+/* dma memory, descriptors and queues shared with the device */
+void *FDriverDmaAllocCoherent(size_t size, size_t align);
+
+void FDriverDmaFreeCoherent(void *ptr);
+
+
 /* memory barrier */
 
 #define FDRIVER_DSB() DSB()
@@ -58,6 +58,67 @@ static void FPl011IrqEnableReciveTimeOut(FPl011 *uart_p)
     FPl011SetInterruptMask(uart_p, reg_temp);
 }
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+/* uart event bottom half, runs in the worker task */
+static void FtFreeRtosUartEventWork(void *args)
+{
+    FtFreertosUart *uart_p = (FtFreertosUart *)args;
+    EventBits_t rx_bits, tx_bits;
+
+    taskENTER_CRITICAL();
+    rx_bits = uart_p->rx_pending;
+    tx_bits = uart_p->tx_pending;
+    uart_p->rx_pending = 0;
+    uart_p->tx_pending = 0;
+    taskEXIT_CRITICAL();
+
+    if (rx_bits)
+    {
+        xEventGroupSetBits(uart_p->rx_event, rx_bits);
+    }
+
+    if (tx_bits)
+    {
+        xEventGroupSetBits(uart_p->tx_event, tx_bits);
+    }
+}
+
+static void FtFreeRtosUartCallback(void *args, u32 event, u32 event_data)
+{
+    FtFreertosUart *uart_p = (FtFreertosUart *)args;
+    UBaseType_t saved_mask;
+
+    /* collect the event bits, repeated events before the worker runs set them once */
+    saved_mask = taskENTER_CRITICAL_FROM_ISR();
+    if (FPL011_EVENT_RECV_DATA == event || FPL011_EVENT_RECV_TOUT == event)
+    {
+        uart_p->rx_pending |= RTOS_UART_COMPLETE;
+    }
+    else if (FPL011_EVENT_RECV_ERROR == event)
+    {
+        uart_p->rx_pending |= RTOS_UART_RECV_ERROR;
+    }
+    else if (FPL011_EVENT_SENT_DATA == event)
+    {
+        uart_p->tx_pending |= RTOS_UART_COMPLETE;
+    }
+    else if (FPL011_EVENT_PARE_FRAME_BRKE == event)
+    {
+        uart_p->rx_pending |= RTOS_UART_RECV_ERROR;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+    if (FPL011_EVENT_SENT_DATA != event)
+    {
+        FPl011IrqClearReciveTimeOut(&uart_p->bsp_uart);
+    }
+
+    if ((uart_p->rx_pending != 0) || (uart_p->tx_pending != 0))
+    {
+        (void)xWorkQueue(&uart_p->event_work);
+    }
+}
+#else
 static void FtFreeRtosUartCallback(void *args, u32 event, u32 event_data)
 {
 
@@ -98,6 +159,7 @@ static void FtFreeRtosUartCallback(void *args, u32 event, u32 event_data)
     }
 
 }
+#endif
 
 void FtFreertosUartInit(FtFreertosUart *uart_p, FtFreertosUartConfig *config_p)
 {
@@ -121,6 +183,12 @@ void FtFreertosUartInit(FtFreertosUart *uart_p, FtFreertosUartConfig *config_p)
     FASSERT((uart_p->tx_semaphore = xSemaphoreCreateMutex()) != NULL);
     FASSERT((uart_p->tx_event = xEventGroupCreate()) != NULL);
     FASSERT((uart_p->rx_event = xEventGroupCreate()) != NULL);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    FASSERT(xWorkQueueInit() == pdPASS);
+    uart_p->rx_pending = 0;
+    uart_p->tx_pending = 0;
+    vWorkInit(&uart_p->event_work, FtFreeRtosUartEventWork, uart_p, WORKQUEUE_HIGH);
+#endif
 
     GetCpuId(&cpu_id);
     InterruptSetTargetCpus(bsp_uart_p->config.irq_num, cpu_id);
@@ -35,6 +35,10 @@
 #include "fpl011_hw.h"
 #include "ftypes.h"
 #include "ferror_code.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+#include "freertos_workqueue.h"
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -93,6 +97,11 @@ typedef struct
     SemaphoreHandle_t tx_semaphore; /*!< TX semaphore for resource sharing */
     EventGroupHandle_t rx_event;    /*!< RX completion event */
     EventGroupHandle_t tx_event;    /*!< TX completion event */
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    Work_t event_work;              /*!< sets the event bits below in the worker task */
+    volatile EventBits_t rx_pending;
+    volatile EventBits_t tx_pending;
+#endif
 } FtFreertosUart;
 
 void FtFreertosUartInit(FtFreertosUart *uart_p, FtFreertosUartConfig *config_p);
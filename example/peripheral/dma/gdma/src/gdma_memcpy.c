@@ -83,9 +83,16 @@ static void GdmaMemcpyAckChanXEnd(uint32_t channel_id, void *args)
 
     FGDMA_INFO("FreeRTOS ack: GDMA channel-%d transfer end.", channel_id);
 
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    /* the channel is deferred, the handler runs in the worker task */
+    (void)xhigher_priority_task_woken;
+    xTaskNotifyGiveIndexed(gdma_trans_task, gdma_trans_task_index);
+    gdma_trans_task = NULL;
+#else
     vTaskNotifyGiveIndexedFromISR(gdma_trans_task, gdma_trans_task_index, &xhigher_priority_task_woken);
     gdma_trans_task = NULL; /* 将目标任务句柄清空，防止产生不必要的通知 */
     portYIELD_FROM_ISR(xhigher_priority_task_woken); /* 如果中断触发了更高优先级的任务，确保更高优先级的任务尽快执行 */
+#endif
 }
 
 static FError GdmaInit(void)
@@ -127,6 +134,9 @@ static FError GdmaMemcpy(void)
                                         FFREERTOS_GDMA_CHAN_EVT_TRANS_END,
                                         GdmaMemcpyAckChanXEnd,
                                         NULL);
+#ifdef CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE
+    FFreeRTOSGdmaChanDeferEvtHandler(gdma_instance_p, GDMA_CHANNEL_ID, TRUE);
+#endif
 
     memset((void *)src_data, 'A', GDMA_TRANS_LEN);
     memset((void *)dst_data, 0, GDMA_TRANS_LEN);
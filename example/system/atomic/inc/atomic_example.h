@@ -35,6 +35,7 @@ extern "C"
 #endif
 
 BaseType_t FFreeRTOSAtomicTaskCreate(void);
+BaseType_t FFreeRTOSAtomicBench(void);
 #ifdef __cplusplus
 }
 #endif
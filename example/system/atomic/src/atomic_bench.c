@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: atomic_bench.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the benchmark of the atomic operations and lock-free primitives
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "ftypes.h"
+#include "fparameters.h"
+#include "fgeneric_timer.h"
+#include "fatomic.h"
+#include "flockfree.h"
+#include "atomic_example.h"
+
+#define ATOMIC_BENCH_OPS            100000U
+#define ATOMIC_BENCH_TASK_NUM       4U
+#define ATOMIC_BENCH_TASK_PRIORITY  3
+#define ATOMIC_BENCH_STACK_SIZE     1024
+#define ATOMIC_BENCH_TIMEOUT        (pdMS_TO_TICKS(60000UL))
+
+typedef void (*AtomicBenchOp)(u32 ops);
+
+typedef struct
+{
+    const char *name;
+    AtomicBenchOp run;
+    boolean need_lse;
+} AtomicBenchCase;
+
+/* the shared data of the cases, each on its own cache line */
+static volatile u64 bench_counter __attribute__((aligned(FLOCKFREE_CACHE_LINE)));
+static volatile u32 bench_flag __attribute__((aligned(FLOCKFREE_CACHE_LINE)));
+static FTicketLock bench_ticket __attribute__((aligned(FLOCKFREE_CACHE_LINE))) = FTICKET_LOCK_INIT;
+static FSeqLock bench_seq __attribute__((aligned(FLOCKFREE_CACHE_LINE))) = FSEQ_LOCK_INIT;
+static FPerCpuCounter bench_percpu;
+static FSpscRing bench_ring;
+static u32 bench_ring_buf[64];
+static FMpscQueue bench_queue;
+static FMpscNode bench_node;
+
+static SemaphoreHandle_t bench_done = NULL;
+static AtomicBenchOp bench_task_op = NULL;
+
+static void BenchSyncAdd(u32 ops)
+{
+    while (ops--)
+    {
+        (void)FATOMIC_ADD(bench_counter, 1);
+    }
+}
+
+static void BenchRelaxedAdd(u32 ops)
+{
+    while (ops--)
+    {
+        (void)FATOMIC_FETCH_ADD(bench_counter, 1, FATOMIC_RELAXED);
+    }
+}
+
+static void BenchCasLoop(u32 ops)
+{
+    u64 old;
+
+    while (ops--)
+    {
+        old = FATOMIC_LOAD(bench_counter, FATOMIC_RELAXED);
+        while (!FATOMIC_COMPARE_EXCHANGE(bench_counter, &old, old + 1, FATOMIC_RELAXED))
+        {
+        }
+    }
+}
+
+#if defined(__aarch64__)
+/* the exclusive monitor loop, whatever the build selected */
+static void BenchLlscAdd(u32 ops)
+{
+    u64 value;
+    u32 fail;
+
+    while (ops--)
+    {
+        __asm__ __volatile__("1: ldxr %0, [%2]\n"
+                             "   add %0, %0, #1\n"
+                             "   stxr %w1, %0, [%2]\n"
+                             "   cbnz %w1, 1b\n"
+                             : "=&r"(value), "=&r"(fail)
+                             : "r"(&bench_counter)
+                             : "memory");
+    }
+}
+
+/* the ARMv8.1 far atomic, only run when the core has it */
+static void BenchLseAdd(u32 ops)
+{
+    u64 one = 1;
+    u64 old;
+
+    while (ops--)
+    {
+        __asm__ __volatile__(".arch_extension lse\n"
+                             "ldadd %1, %0, [%2]\n"
+                             : "=r"(old)
+                             : "r"(one), "r"(&bench_counter)
+                             : "memory");
+    }
+}
+#endif
+
+static void BenchTasLock(u32 ops)
+{
+    while (ops--)
+    {
+        while (FATOMIC_LOCK(bench_flag, 1))
+        {
+            FATOMIC_CPU_RELAX();
+        }
+        bench_counter++;
+        FATOMIC_UNLOCK(bench_flag);
+    }
+}
+
+static void BenchTicketLock(u32 ops)
+{
+    while (ops--)
+    {
+        FTicketLockAcquire(&bench_ticket);
+        bench_counter++;
+        FTicketLockRelease(&bench_ticket);
+    }
+}
+
+static void BenchSeqLockRead(u32 ops)
+{
+    u32 sequence;
+    u64 value;
+
+    while (ops--)
+    {
+        do
+        {
+            sequence = FSeqLockReadBegin(&bench_seq);
+            value = bench_counter;
+        } while (FSeqLockReadRetry(&bench_seq, sequence));
+    }
+    (void)value;
+}
+
+static void BenchPerCpuAdd(u32 ops)
+{
+    while (ops--)
+    {
+        FPerCpuCounterAdd(&bench_percpu, 1);
+    }
+}
+
+static void BenchSpscRing(u32 ops)
+{
+    u32 item = 0;
+
+    while (ops--)
+    {
+        (void)FSpscRingPush(&bench_ring, &item);
+        (void)FSpscRingPop(&bench_ring, &item);
+    }
+}
+
+static void BenchMpscQueue(u32 ops)
+{
+    FMpscNode *node = &bench_node;
+
+    while (ops--)
+    {
+        FMpscQueuePush(&bench_queue, node);
+        while ((node = FMpscQueuePop(&bench_queue)) == NULL)
+        {
+        }
+    }
+}
+
+static const AtomicBenchCase bench_single[] =
+{
+    {"sync_add (seq_cst)", BenchSyncAdd, FALSE},
+    {"fetch_add relaxed", BenchRelaxedAdd, FALSE},
+    {"cas loop", BenchCasLoop, FALSE},
+#if defined(__aarch64__)
+    {"ldxr/stxr add", BenchLlscAdd, FALSE},
+    {"lse ldadd", BenchLseAdd, TRUE},
+#endif
+    {"test-and-set lock", BenchTasLock, FALSE},
+    {"ticket lock", BenchTicketLock, FALSE},
+    {"seqlock read", BenchSeqLockRead, FALSE},
+    {"per-cpu add", BenchPerCpuAdd, FALSE},
+    {"spsc push+pop", BenchSpscRing, FALSE},
+    {"mpsc push+pop", BenchMpscQueue, FALSE},
+};
+
+/* contended cases, the tasks share the counter or the lock */
+static const AtomicBenchCase bench_contended[] =
+{
+    {"sync_add (seq_cst)", BenchSyncAdd, FALSE},
+    {"cas loop", BenchCasLoop, FALSE},
+#if defined(__aarch64__)
+    {"ldxr/stxr add", BenchLlscAdd, FALSE},
+    {"lse ldadd", BenchLseAdd, TRUE},
+#endif
+    {"test-and-set lock", BenchTasLock, FALSE},
+    {"ticket lock", BenchTicketLock, FALSE},
+    {"per-cpu add", BenchPerCpuAdd, FALSE},
+};
+
+static u64 BenchNow(void)
+{
+    return GenericTimerRead(GENERIC_TIMER_ID0);
+}
+
+static void BenchPrint(const char *name, u64 ticks, u32 ops)
+{
+    u64 ps_per_op = ticks * (1000000000000ULL / GenericTimerFrequecy()) / ops;
+
+    printf("  %-22s %6llu.%02llu ns/op\r\n", name, (unsigned long long)(ps_per_op / 1000ULL),
+           (unsigned long long)((ps_per_op % 1000ULL) / 10ULL));
+}
+
+static void BenchTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    bench_task_op(ATOMIC_BENCH_OPS);
+    xSemaphoreGive(bench_done);
+
+    vTaskDelete(NULL);
+}
+
+static BaseType_t BenchContended(const AtomicBenchCase *bench)
+{
+    u64 start;
+    u32 i;
+
+    bench_counter = 0;
+    bench_task_op = bench->run;
+
+    start = BenchNow();
+    for (i = 0; i < ATOMIC_BENCH_TASK_NUM; i++)
+    {
+        if (xTaskCreate(BenchTask, "atomic_bench", ATOMIC_BENCH_STACK_SIZE, NULL,
+                        ATOMIC_BENCH_TASK_PRIORITY, NULL) != pdPASS)
+        {
+            printf("atomic bench task create failed.\r\n");
+            return pdFAIL;
+        }
+    }
+
+    for (i = 0; i < ATOMIC_BENCH_TASK_NUM; i++)
+    {
+        if (xSemaphoreTake(bench_done, ATOMIC_BENCH_TIMEOUT) != pdTRUE)
+        {
+            printf("atomic bench %s timeout.\r\n", bench->name);
+            return pdFAIL;
+        }
+    }
+
+    BenchPrint(bench->name, BenchNow() - start, ATOMIC_BENCH_OPS * ATOMIC_BENCH_TASK_NUM);
+
+    if ((bench->run != BenchPerCpuAdd) &&
+        (bench_counter != (u64)ATOMIC_BENCH_OPS * ATOMIC_BENCH_TASK_NUM))
+    {
+        printf("atomic bench %s lost updates, counter %llu.\r\n", bench->name,
+               (unsigned long long)bench_counter);
+        return pdFAIL;
+    }
+
+    return pdPASS;
+}
+
+/**
+ * @name: FFreeRTOSAtomicBench
+ * @msg: Measure the cost of the atomic operations and lock-free primitives,
+ *       first from one task, then from tasks sharing the data
+ * @return {BaseType_t} pdPASS, or pdFAIL if a contended case lost updates
+ * @note: each core runs its own image, the contending tasks time-slice on this
+ *        core and are preempted by the tick, also while holding a lock
+ */
+BaseType_t FFreeRTOSAtomicBench(void)
+{
+    boolean lse = FAtomicLseSupported() ? TRUE : FALSE;
+    BaseType_t ret = pdPASS;
+    u64 start;
+    u32 i;
+
+    printf("atomic bench: lse %s on this core, fatomic.h built with %s\r\n",
+           lse ? "supported" : "not supported", FATOMIC_USE_LSE ? "lse" : "ldxr/stxr");
+
+    (void)FSpscRingInit(&bench_ring, bench_ring_buf, sizeof(bench_ring_buf[0]),
+                        sizeof(bench_ring_buf) / sizeof(bench_ring_buf[0]));
+    FMpscQueueInit(&bench_queue);
+    FPerCpuCounterReset(&bench_percpu);
+
+    printf("one task, %u operations:\r\n", ATOMIC_BENCH_OPS);
+    for (i = 0; i < sizeof(bench_single) / sizeof(bench_single[0]); i++)
+    {
+        if (bench_single[i].need_lse && !lse)
+        {
+            continue;
+        }
+
+        start = BenchNow();
+        bench_single[i].run(ATOMIC_BENCH_OPS);
+        BenchPrint(bench_single[i].name, BenchNow() - start, ATOMIC_BENCH_OPS);
+    }
+
+    bench_done = xSemaphoreCreateCounting(ATOMIC_BENCH_TASK_NUM, 0);
+    if (bench_done == NULL)
+    {
+        printf("atomic bench semaphore create failed.\r\n");
+        return pdFAIL;
+    }
+
+    printf("%u tasks sharing the data, %u operations each:\r\n", ATOMIC_BENCH_TASK_NUM, ATOMIC_BENCH_OPS);
+    for (i = 0; i < sizeof(bench_contended) / sizeof(bench_contended[0]); i++)
+    {
+        if (bench_contended[i].need_lse && !lse)
+        {
+            continue;
+        }
+
+        if (BenchContended(&bench_contended[i]) != pdPASS)
+        {
+            ret = pdFAIL;
+            break;
+        }
+    }
+
+    vSemaphoreDelete(bench_done);
+    bench_done = NULL;
+
+    return ret;
+}
@@ -38,6 +38,8 @@ static void CreateAtomicCmdUsage(void)
     printf("Usage:\r\n");
     printf(" atomic cre \r\n");
     printf("    -- Create atomic test task now.\r\n");
+    printf(" atomic bench \r\n");
+    printf("    -- Compare the atomic operations and lock-free primitives with and without contention.\r\n");
 }
 
 int CreateAtomicCmd(int argc, char *argv[])
@@ -52,6 +54,10 @@ int CreateAtomicCmd(int argc, char *argv[])
     {
         FFreeRTOSAtomicTaskCreate();
     }
+    else if (!strcmp(argv[1], "bench"))
+    {
+        FFreeRTOSAtomicBench();
+    }
     else
     {
         printf("Error: Invalid arguments. \r\n");
@@ -29,6 +29,7 @@
 #include "ftypes.h"
 #include "fcache.h"
 #include "faarch.h"
+#include "fperf_stat.h"
 
 
 #define FREG_CONTROL_DCACHE_BIT (0x00000001U << 2U)
@@ -308,6 +309,7 @@ void FCacheDCacheFlushRange(intptr adr, intptr len)
     u32 tempend;
     u32 currmask;
 
+    FPERF_STAT_BEGIN(FCacheDCacheFlushRange);
     currmask = MFCPSR();
     MTCPSR(currmask | IRQ_FIQ_MASK);
     if (len != 0U)
@@ -338,6 +340,7 @@ void FCacheDCacheFlushRange(intptr adr, intptr len)
         }
     }
     MTCPSR(currmask);
+    FPERF_STAT_END(FCacheDCacheFlushRange);
 }
 
 /*  Icache */
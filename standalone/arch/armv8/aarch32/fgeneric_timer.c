@@ -59,6 +59,27 @@ void GenericTimerSetTimerCompareValue(u32 id, u64 timeout)
     }
 }
 
+/**
+ * @name: GenericTimerGetTimerCompareValue
+ * @msg:  Get generic timer CompareValue
+ * @param {u32} id, id of generic timer, non-secoure physical timer or virtual timer
+ * @return {u64} compare value
+ */
+u64 GenericTimerGetTimerCompareValue(u32 id)
+{
+    FASSERT_MSG((id == GENERIC_TIMER_ID0) || (id == GENERIC_TIMER_ID1),
+                "Please use correct int id");
+
+    if (id == GENERIC_TIMER_ID0)
+    {
+        return AARCH32_READ_SYSREG_64(CNTP_CVAL_64);
+    }
+    else
+    {
+        return AARCH32_READ_SYSREG_64(CNTV_CVAL_64);
+    }
+}
+
 /**
  * @name: GenericTimerSetTimerValue
  * @msg:  Set generic timer TimerValue
@@ -55,6 +55,9 @@ extern "C"
 /* Set generic timer CompareValue */
 void GenericTimerSetTimerCompareValue(u32 id, u64 timeout);
 
+/* Get generic timer CompareValue */
+u64 GenericTimerGetTimerCompareValue(u32 id);
+
 /* Set generic timer TimerValue */
 void GenericTimerSetTimerValue(u32 id, u32 timeout);
 
@@ -70,6 +70,10 @@ ifdef CONFIG_ARM_CRC
 ARCH_CPU_MARCH := $(ARCH_CPU_MARCH)+crc
 endif
 
+ifdef CONFIG_ARM_LSE
+ARCH_CPU_MARCH := $(ARCH_CPU_MARCH)+lse
+endif
+
 ifdef CONFIG_ARM_CRYPTO
 ARCH_CPU_MARCH := $(ARCH_CPU_MARCH)+crypto
 else
@@ -23,12 +23,14 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   huanghe     2021/7/3     first release
+ * 1.1   phytium     2026/10/19   range maintenance set/way threshold, none with the l3 cache
  */
 
 #include "fcache.h"
 #include "ftypes.h"
 #include "faarch.h"
 #include "fparameters.h"
+#include "fperf_stat.h"
 
 
 /***************************** Include Files *********************************/
@@ -45,6 +47,49 @@
 #define FREG_CONTROL_ICACHE_BIT (0x00000001U << 12U)
 #define IRQ_FIQ_MASK            0xC0U /* Mask IRQ and FIQ interrupts in cpsr */
 
+#define CTR_DMINLINE_SHIFT      16U
+#define CTR_DMINLINE_MASK       0xFU
+
+/* ranges from this size on take the whole cache by set/way, 0 never does,
+   set/way does not reach the system l3 cache, which only the by address operations clean to poc */
+#ifndef CONFIG_FCACHE_RANGE_THRESHOLD
+#if defined(CONFIG_USE_L3CACHE)
+#define CONFIG_FCACHE_RANGE_THRESHOLD 0x0
+#else
+#define CONFIG_FCACHE_RANGE_THRESHOLD 0x400000
+#endif
+#endif
+
+#if defined(GUEST)
+/* set/way operations trap to the hypervisor at EL1 */
+#define FCACHE_RANGE_THRESHOLD_DEFAULT 0U
+#else
+#define FCACHE_RANGE_THRESHOLD_DEFAULT CONFIG_FCACHE_RANGE_THRESHOLD
+#endif
+
+/* clean or clean and invalidate [adr, end) to the point of coherency, four lines per round */
+#define FCACHE_RANGE_LOOP(op, adr, end, line)      \
+    do                                             \
+    {                                              \
+        while ((adr) + 4 * (line) <= (end))        \
+        {                                          \
+            MTCPDC(op, (adr));                     \
+            MTCPDC(op, (adr) + (line));            \
+            MTCPDC(op, (adr) + 2 * (line));        \
+            MTCPDC(op, (adr) + 3 * (line));        \
+            (adr) += 4 * (line);                   \
+        }                                          \
+        while ((adr) < (end))                      \
+        {                                          \
+            MTCPDC(op, (adr));                     \
+            (adr) += (line);                       \
+        }                                          \
+    } while (0)
+
+/* line size and threshold of the range operations */
+static intptr dcache_line_size = 0;
+static fsize_t dcache_range_threshold = FCACHE_RANGE_THRESHOLD_DEFAULT;
+
 /************************** Function Prototypes ******************************/
 
 
@@ -293,34 +338,71 @@ void FCacheDCacheInvalidateLine(intptr adr)
     MTCPSR(currmask);
 }
 
+/**
+ * @name: FCacheDCacheLineSize
+ * @msg:  The smallest data cache line of the cores, CTR_EL0.DminLine read on first use.
+ * @return {intptr} line size in bytes
+ */
+static inline intptr FCacheDCacheLineSize(void)
+{
+    if (dcache_line_size == 0)
+    {
+        u64 ctr = AARCH64_READ_SYSREG(CTR_EL0);
+        dcache_line_size = (intptr)4 << ((ctr >> CTR_DMINLINE_SHIFT) & CTR_DMINLINE_MASK);
+    }
+
+    return dcache_line_size;
+}
+
+static inline boolean FCacheRangeUseSetWay(fsize_t len)
+{
+    return (dcache_range_threshold != 0U) && (len >= dcache_range_threshold);
+}
+
+static inline void FCacheRangeCivac(intptr adr, fsize_t len)
+{
+    const intptr line = FCacheDCacheLineSize();
+    intptr end = adr + (intptr)len;
+
+    adr &= ~(line - 1);
+    FCACHE_RANGE_LOOP(CIVAC, adr, end, line);
+}
+
+static inline void FCacheRangeCvac(intptr adr, fsize_t len)
+{
+    const intptr line = FCacheDCacheLineSize();
+    intptr end = adr + (intptr)len;
+
+    adr &= ~(line - 1);
+    FCACHE_RANGE_LOOP(CVAC, adr, end, line);
+}
+
 /**
  * @name: FCacheDCacheInvalidateRange
- * @msg:
+ * @msg:  Clean and invalidate the data cache lines of a range to the point of coherency.
  * @param {intptr} adr 64bit start address of the range to be invalidated.
  * @param {intptr} len Length of the range to be invalidated in bytes.
- * @note:
+ * @note: from FCacheDCacheGetRangeThreshold() bytes on the whole cache is cleaned and
+ *        invalidated by set/way instead, that is cheaper than one operation per line
  */
 void FCacheDCacheInvalidateRange(intptr adr, fsize_t len)
 {
-    const intptr cacheline = CACHE_LINE;
-    intptr end = adr + (intptr)len;
-    adr = adr & (~CACHE_LINE_ADDR_MASK);
-    u32 currmask = MFCPSR();
-    MTCPSR(currmask | IRQ_FIQ_MASK);
-    if (len != 0U)
+    if (len == 0U)
     {
-        while (adr < end)
-        {
-            MTCPDC(CIVAC, adr); /* Clean and Invalidate data cache by address to Point of Coherency */
-            adr += cacheline;
-        }
+        return;
     }
+
+    if (FCacheRangeUseSetWay(len))
+    {
+        FCacheDCacheFlush();
+        return;
+    }
+
+    FCacheRangeCivac(adr, len);
     /* Wait for invalidate to complete */
     DSB();
-    MTCPSR(currmask);
 }
 
-
 void FCacheDCacheFlush(void)
 {
     register u32 csid_reg, c7reg;
@@ -435,24 +517,126 @@ void FCacheDCacheFlushLine(intptr adr)
 }
 
 
+/**
+ * @name: FCacheDCacheFlushRange
+ * @msg:  Clean the data cache lines of a range to the point of coherency.
+ * @param {intptr} adr 64bit start address of the range to be flushed.
+ * @param {intptr} len Length of the range to be flushed in bytes.
+ * @note: from FCacheDCacheGetRangeThreshold() bytes on the whole cache is cleaned and
+ *        invalidated by set/way instead
+ */
 void FCacheDCacheFlushRange(intptr adr, fsize_t len)
 {
-    const intptr cacheline = CACHE_LINE;
-    intptr end = adr + (intptr)len;
-    adr = adr & (~CACHE_LINE_ADDR_MASK);
-    u32 currmask = MFCPSR();
-    MTCPSR(currmask | IRQ_FIQ_MASK);
-    if (len != 0U)
+    if (len == 0U)
     {
-        while (adr < end)
-        {
-            MTCPDC(CVAC, adr); /* Clean data cache by address to Point of Coherency */
-            adr += cacheline;
-        }
+        return;
+    }
+
+    FPERF_STAT_BEGIN(FCacheDCacheFlushRange);
+    if (FCacheRangeUseSetWay(len))
+    {
+        FCacheDCacheFlush();
+    }
+    else
+    {
+        FCacheRangeCvac(adr, len);
+        /* Wait for Clean to complete */
+        DSB();
+    }
+    FPERF_STAT_END(FCacheDCacheFlushRange);
+}
+
+static fsize_t FCacheRangesLength(const FCacheRange *ranges, u32 num)
+{
+    fsize_t total = 0U;
+    u32 i;
+
+    for (i = 0U; i < num; i++)
+    {
+        total += ranges[i].len;
+    }
+
+    return total;
+}
+
+/**
+ * @name: FCacheDCacheFlushRanges
+ * @msg:  Clean the data cache lines of a scatter list, one barrier for all of them.
+ * @param {FCacheRange} *ranges the ranges
+ * @param {u32} num number of ranges
+ * @note: the threshold applies to the total length of the list
+ */
+void FCacheDCacheFlushRanges(const FCacheRange *ranges, u32 num)
+{
+    u32 i;
+
+    if (FCacheRangeUseSetWay(FCacheRangesLength(ranges, num)))
+    {
+        FCacheDCacheFlush();
+        return;
+    }
+
+    for (i = 0U; i < num; i++)
+    {
+        FCacheRangeCvac(ranges[i].adr, ranges[i].len);
     }
-    /* Wait for Clean to complete */
     DSB();
-    MTCPSR(currmask);
+}
+
+/**
+ * @name: FCacheDCacheInvalidateRanges
+ * @msg:  Clean and invalidate the data cache lines of a scatter list, one barrier for all of them.
+ * @param {FCacheRange} *ranges the ranges
+ * @param {u32} num number of ranges
+ * @note: the threshold applies to the total length of the list
+ */
+void FCacheDCacheInvalidateRanges(const FCacheRange *ranges, u32 num)
+{
+    u32 i;
+
+    if (FCacheRangeUseSetWay(FCacheRangesLength(ranges, num)))
+    {
+        FCacheDCacheFlush();
+        return;
+    }
+
+    for (i = 0U; i < num; i++)
+    {
+        FCacheRangeCivac(ranges[i].adr, ranges[i].len);
+    }
+    DSB();
+}
+
+/**
+ * @name: FCacheDCacheSetRangeThreshold
+ * @msg:  Set the range length from which the range operations take the whole cache by set/way.
+ * @param {fsize_t} threshold length in bytes, 0 to always work by address
+ * @note: set/way only reaches the caches of this cluster, keep it 0 when the
+ *        system has a cache before the point of coherency
+ */
+void FCacheDCacheSetRangeThreshold(fsize_t threshold)
+{
+    dcache_range_threshold = threshold;
+}
+
+/**
+ * @name: FCacheDCacheGetRangeThreshold
+ * @msg:  Get the range length from which the range operations take the whole cache by set/way.
+ * @return {fsize_t} length in bytes, 0 if they always work by address
+ */
+fsize_t FCacheDCacheGetRangeThreshold(void)
+{
+    return dcache_range_threshold;
+}
+
+/**
+ * @name: FCacheDCacheGetLineSize
+ * @msg:  Get the smallest data cache line size, the stride of the range operations.
+ * @return {u32} line size in bytes
+ */
+u32 FCacheDCacheGetLineSize(void)
+{
+    return (u32)FCacheDCacheLineSize();
 }
 
 /* Icache */
@@ -37,6 +37,13 @@ extern "C"
 {
 #endif
 
+/**************************** Type Definitions *******************************/
+typedef struct
+{
+    intptr adr;   /* start address of the range */
+    fsize_t len;  /* length of the range in bytes */
+} FCacheRange;  /* one entry of a scatter list */
+
 /************************** Function Prototypes ******************************/
 void FCacheDCacheEnable(void);
 void FCacheDCacheDisable(void);
@@ -46,6 +53,11 @@ void FCacheDCacheInvalidateRange(intptr adr, fsize_t len);
 void FCacheDCacheFlush(void);
 void FCacheDCacheFlushLine(intptr adr);
 void FCacheDCacheFlushRange(intptr adr, fsize_t len);
+void FCacheDCacheFlushRanges(const FCacheRange *ranges, u32 num);
+void FCacheDCacheInvalidateRanges(const FCacheRange *ranges, u32 num);
+void FCacheDCacheSetRangeThreshold(fsize_t threshold);
+fsize_t FCacheDCacheGetRangeThreshold(void);
+u32 FCacheDCacheGetLineSize(void);
 
 void FCacheICacheEnable(void);
 void FCacheICacheDisable(void);
@@ -58,6 +58,27 @@ void GenericTimerSetTimerCompareValue(u32 id, u64 timeout)
     }
 }
 
+/**
+ * @name: GenericTimerGetTimerCompareValue
+ * @msg:  Get generic timer CompareValue
+ * @param {u32} id, id of generic timer, non-secoure physical timer or virtual timer
+ * @return {u64} compare value
+ */
+u64 GenericTimerGetTimerCompareValue(u32 id)
+{
+    FASSERT_MSG((id == GENERIC_TIMER_ID0) || (id == GENERIC_TIMER_ID1),
+                "Please use correct int id");
+
+    if (id == GENERIC_TIMER_ID0)
+    {
+        return AARCH64_READ_SYSREG(cntp_cval_el0);
+    }
+    else
+    {
+        return AARCH64_READ_SYSREG(cntv_cval_el0);
+    }
+}
+
 /**
  * @name: GenericTimerSetTimerValue
  * @msg:  Set generic timer TimerValue
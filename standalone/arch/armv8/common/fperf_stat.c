@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fperf_stat.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for counting PMU events over named code regions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   share the pmu, do not reset the counters of other users
+ */
+#include <string.h>
+#include "ftypes.h"
+#include "fkernel.h"
+#include "faarch.h"
+#include "fpmu.h"
+#include "fpmu_perf.h"
+#include "fdebug.h"
+#include "fperf_stat.h"
+
+#define FPERF_STAT_DEBUG_TAG "FPERF_STAT"
+#define FPERF_STAT_ERROR(format, ...) FT_DEBUG_PRINT_E(FPERF_STAT_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FPERF_STAT_DEBUG_I(format, ...) FT_DEBUG_PRINT_I(FPERF_STAT_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#define FPERF_STAT_IRQ_FIQ_MASK     0xC0U /* Mask IRQ and FIQ interrupts in cpsr */
+
+typedef struct
+{
+    const char *name;
+    u32 event_id;
+} FPerfStatEventInfo;
+
+static const FPerfStatEventInfo perf_stat_events[FPERF_STAT_EVENT_NUM] =
+{
+    [FPERF_STAT_CYCLES] = {"cycles", FPMU_CPU_CYCLES_ID},
+    [FPERF_STAT_INSTRUCTIONS] = {"instructions", FPMU_INST_RETIRED_ID},
+    [FPERF_STAT_L1D_REFILL] = {"l1d-refill", FPMU_L1D_CACHE_REFILL_ID},
+    [FPERF_STAT_L2D_REFILL] = {"l2d-refill", FPMU_L2D_CACHE_REFILL_ID},
+    [FPERF_STAT_BRANCH_MISS] = {"branch-miss", FPMU_BR_MIS_PRED_ID},
+    [FPERF_STAT_BUS_ACCESS] = {"bus-access", FPMU_BUS_ACCESS_ID},
+};
+
+/* each core runs its own image, so the counters and the regions are per core */
+static FPmu perf_stat_pmu;
+static u32 perf_stat_ready = 0;
+static u32 perf_stat_event_mask = 0;
+static u32 perf_stat_counter[FPERF_STAT_EVENT_NUM];
+static FPerfStatRegion *perf_stat_regions = NULL;
+
+/**
+ * @name: FPerfStatInit
+ * @msg: Take the PMU counters for the region statistics
+ * @return {FError} FT_SUCCESS, or the error of FPmuCfgProbe
+ * @note: the pmu is not reset, the cycle counter keeps its value for the run
+ *        time statistics, the last event counter is left to the sampling profiler
+ */
+FError FPerfStatInit(void)
+{
+    u32 event_counters;
+    u32 next_counter = 0;
+    u32 counter_id;
+    u32 currmask;
+    FError ret;
+    u32 i;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | FPERF_STAT_IRQ_FIQ_MASK);
+
+    if (perf_stat_ready)
+    {
+        MTCPSR(currmask);
+        return FT_SUCCESS;
+    }
+
+    /* FPmuCfgInitialize would reset and stop the counters of the other pmu users */
+    ret = FPmuCfgProbe(&perf_stat_pmu);
+    if (ret != FPMU_SUCCESS)
+    {
+        /* a failed init is tried again by the next region */
+        MTCPSR(currmask);
+        FPERF_STAT_ERROR("PMU init failed 0x%x", ret);
+        return ret;
+    }
+
+    /* counter_num includes the cycle counter */
+    event_counters = (perf_stat_pmu.counter_num > 2U) ? (perf_stat_pmu.counter_num - 2U) : 0U;
+
+    for (i = 0; i < FPERF_STAT_EVENT_NUM; i++)
+    {
+        if (i == FPERF_STAT_CYCLES)
+        {
+            counter_id = FPMU_CYCLE_COUNT_IDX;
+        }
+        else if (next_counter < event_counters)
+        {
+            counter_id = next_counter;
+        }
+        else
+        {
+            FPERF_STAT_DEBUG_I("No counter left for %s", perf_stat_events[i].name);
+            continue;
+        }
+
+        if ((FPmuCounterConfig(&perf_stat_pmu, counter_id, perf_stat_events[i].event_id, NULL, NULL) != FPMU_SUCCESS) ||
+            (FPmuCounterEnable(&perf_stat_pmu, counter_id) != FPMU_SUCCESS))
+        {
+            FPERF_STAT_DEBUG_I("Event %s not supported", perf_stat_events[i].name);
+            continue;
+        }
+
+        /* the counters wrap silently, the deltas are taken modulo their width */
+        FPmuDisableIntens(1U << counter_id);
+        perf_stat_counter[i] = counter_id;
+        perf_stat_event_mask |= BIT(i);
+        if (counter_id != FPMU_CYCLE_COUNT_IDX)
+        {
+            next_counter++;
+        }
+    }
+
+    FPmuStart();
+
+    perf_stat_ready = 1;
+    MTCPSR(currmask);
+
+    return FT_SUCCESS;
+}
+
+u32 FPerfStatEventMask(void)
+{
+    return perf_stat_event_mask;
+}
+
+const char *FPerfStatEventName(FPerfStatEvent event)
+{
+    return (event < FPERF_STAT_EVENT_NUM) ? perf_stat_events[event].name : "unknown";
+}
+
+static void FPerfStatRead(u64 *value)
+{
+    u32 i;
+
+    for (i = 0; i < FPERF_STAT_EVENT_NUM; i++)
+    {
+        value[i] = 0;
+        if (perf_stat_event_mask & BIT(i))
+        {
+            (void)FPmuReadCounter(&perf_stat_pmu, perf_stat_counter[i], &value[i]);
+        }
+    }
+}
+
+/**
+ * @name: FPerfStatBegin
+ * @msg: Sample the counters at the beginning of a region
+ * @param {FPerfStatSnapshot} *start, counter values, passed to FPerfStatEnd
+ */
+void FPerfStatBegin(FPerfStatSnapshot *start)
+{
+    if (!perf_stat_ready)
+    {
+        (void)FPerfStatInit();
+    }
+
+    FPerfStatRead(start->value);
+}
+
+/**
+ * @name: FPerfStatEnd
+ * @msg: Add the events counted since FPerfStatBegin to a region
+ * @param {FPerfStatRegion} *region, region statistics
+ * @param {FPerfStatSnapshot} *start, counter values from FPerfStatBegin
+ */
+void FPerfStatEnd(FPerfStatRegion *region, const FPerfStatSnapshot *start)
+{
+    u64 end[FPERF_STAT_EVENT_NUM];
+    u64 delta;
+    u32 currmask;
+    u32 i;
+
+    FPerfStatRead(end);
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | FPERF_STAT_IRQ_FIQ_MASK);
+
+    if (!region->listed)
+    {
+        region->next = perf_stat_regions;
+        perf_stat_regions = region;
+        region->listed = 1;
+    }
+
+    region->count++;
+    for (i = 0; i < FPERF_STAT_EVENT_NUM; i++)
+    {
+        delta = end[i] - start->value[i];
+        if (perf_stat_counter[i] != FPMU_CYCLE_COUNT_IDX)
+        {
+            delta = (u32)delta; /* event counters are 32 bit */
+        }
+
+        region->sum[i] += delta;
+        if ((region->count == 1) || (delta < region->min[i]))
+        {
+            region->min[i] = delta;
+        }
+        if (delta > region->max[i])
+        {
+            region->max[i] = delta;
+        }
+    }
+
+    MTCPSR(currmask);
+}
+
+FPerfStatRegion *FPerfStatRegionList(void)
+{
+    return perf_stat_regions;
+}
+
+void FPerfStatReset(void)
+{
+    FPerfStatRegion *region;
+    u32 currmask;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | FPERF_STAT_IRQ_FIQ_MASK);
+
+    for (region = perf_stat_regions; region != NULL; region = region->next)
+    {
+        region->count = 0;
+        memset(region->sum, 0, sizeof(region->sum));
+        memset(region->min, 0, sizeof(region->min));
+        memset(region->max, 0, sizeof(region->max));
+    }
+
+    MTCPSR(currmask);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fperf_stat.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for counting PMU events over named code regions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#ifndef FPERF_STAT_H
+#define FPERF_STAT_H
+
+#include "ftypes.h"
+#include "ferror_code.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+    FPERF_STAT_CYCLES = 0,
+    FPERF_STAT_INSTRUCTIONS,
+    FPERF_STAT_L1D_REFILL,
+    FPERF_STAT_L2D_REFILL,
+    FPERF_STAT_BRANCH_MISS,
+    FPERF_STAT_BUS_ACCESS,
+
+    FPERF_STAT_EVENT_NUM
+} FPerfStatEvent;
+
+/* counter values at the beginning of a region */
+typedef struct
+{
+    u64 value[FPERF_STAT_EVENT_NUM];
+} FPerfStatSnapshot;
+
+typedef struct FPerfStatRegion_
+{
+    const char *name;
+    u64 count;                          /* times the region ran */
+    u64 sum[FPERF_STAT_EVENT_NUM];
+    u64 min[FPERF_STAT_EVENT_NUM];
+    u64 max[FPERF_STAT_EVENT_NUM];
+    struct FPerfStatRegion_ *next;      /* regions are listed once they ran */
+    u32 listed;
+} FPerfStatRegion;
+
+/* take the PMU counters for the statistics, done on the first FPerfStatBegin */
+FError FPerfStatInit(void);
+
+/* bit mask of the FPerfStatEvent the PMU counts */
+u32 FPerfStatEventMask(void);
+
+const char *FPerfStatEventName(FPerfStatEvent event);
+
+void FPerfStatBegin(FPerfStatSnapshot *start);
+
+/* add the events since start to the region */
+void FPerfStatEnd(FPerfStatRegion *region, const FPerfStatSnapshot *start);
+
+/* first region that ran, follow region->next for the others */
+FPerfStatRegion *FPerfStatRegionList(void);
+
+/* clear the results of all regions */
+void FPerfStatReset(void);
+
+/*
+ * Annotate a code region, every pair of FPERF_STAT_BEGIN(x)/FPERF_STAT_END(x)
+ * within one function adds to the region named x. The counters are per core
+ * and keep counting when the region is preempted or interrupted.
+ */
+#ifdef CONFIG_USE_PERF_STAT
+#define FPERF_STAT_BEGIN(region)                                    \
+    static FPerfStatRegion region##_perf_stat = {.name = #region};  \
+    FPerfStatSnapshot region##_perf_start;                          \
+    FPerfStatBegin(&region##_perf_start)
+
+#define FPERF_STAT_END(region) \
+    FPerfStatEnd(&region##_perf_stat, &region##_perf_start)
+#else
+#define FPERF_STAT_BEGIN(region)
+#define FPERF_STAT_END(region)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,6 +24,7 @@
  * -----  ----------  --------  ---------------------------------
  * 1.0      huanghe     2023-11-10      first release
  * 1.1     zhangyan   2024/08/15       fix misra_c_2012_rule_10_7
+ * 1.2     phytium    2026-10-19       add FPmuCfgProbe, initialize without resetting the pmu
  */
 #include <string.h>
 #include <string.h>
@@ -245,6 +246,30 @@ FError FPmuCfgInitialize(FPmu *instance_p)
     return FPMU_SUCCESS;
 }
 
+/**
+ * @name: FPmuCfgProbe
+ * @msg: Initializes the FPmu configuration and checks features, without resetting the PMU controller.
+ * @param {FPmu*} instance_p - Pointer to the FPmu instance to initialize.
+ * @return {FError} - Status of the initialization process.
+ * @note: for a user sharing the PMU, the counters it does not enable keep their configuration and value
+ */
+FError FPmuCfgProbe(FPmu *instance_p)
+{
+    FError ret;
+    memset(instance_p, 0, sizeof(FPmu));
+    /* feature check */
+    ret = FPmuFeatureProbe(instance_p);
+    if (ret != FPMU_SUCCESS)
+    {
+        FPMU_DEBUG_E("Soc not support pmu");
+        return ret;
+    }
+
+    instance_p->is_ready = FT_COMPONENT_IS_READY;
+
+    return FPMU_SUCCESS;
+}
+
 /**
  * @name: FPmuCounterConfig
  * @msg: Configures a counter in the FPmu instance for a specific event ID and period count.
@@ -23,6 +23,7 @@
  *  Ver      Who        Date               Changes
  * -----  ----------  --------  ---------------------------------
  * 1.0      huanghe     2023-11-10      first release
+ * 1.1      phytium     2026-10-19      add FPmuCfgProbe
  */
 #ifndef FPMU_PERF_H
 #define FPMU_PERF_H
@@ -145,6 +146,8 @@ void FPmuReset(FPmu *instance_p);
 
 FError FPmuCfgInitialize(FPmu *instance_p);
 
+FError FPmuCfgProbe(FPmu *instance_p);
+
 FError FPmuCounterConfig(FPmu *instance_p, u32 counter_id, u32 event_id,
                          FPmuEventCB irq_cb, void *args);
 
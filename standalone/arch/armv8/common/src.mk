@@ -10,6 +10,10 @@ ifeq ($(CONFIG_SOC_NAME),"pd1904")
 ARCH_CSRCS += common/fl3cache.c
 endif
 
+ifeq ($(CONFIG_USE_PERF_STAT),y)
+ARCH_CSRCS += common/fperf_stat.c
+endif
+
 ifeq ($(CONFIG_ENABLE_GIC_ITS),y)
 ARCH_CSRCS += common/fgic_its.c
 endif
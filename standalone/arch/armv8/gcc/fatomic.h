@@ -23,6 +23,7 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   wangxiaodong    2023/6/6       first release
+ * 1.1   phytium         2026/10/19     memory ordered atomics on the __atomic builtins
  */
 
 #ifndef FATOMIC_H
@@ -33,52 +34,128 @@ extern "C"
 {
 #endif
 
+/*
+ * The operations below are built on the __atomic builtins. With ARM_LSE the
+ * compiler emits the ARMv8.1 LSE instructions (LDADD, CAS, SWP) for them,
+ * otherwise LDXR/STXR loops, in both cases with only the barriers the memory
+ * order asks for.
+ */
+
+/* memory order of the FATOMIC_LOAD ... FATOMIC_COMPARE_EXCHANGE operations, as C11 memory_order */
+#define FATOMIC_RELAXED     __ATOMIC_RELAXED
+#define FATOMIC_ACQUIRE     __ATOMIC_ACQUIRE
+#define FATOMIC_RELEASE     __ATOMIC_RELEASE
+#define FATOMIC_ACQ_REL     __ATOMIC_ACQ_REL
+#define FATOMIC_SEQ_CST     __ATOMIC_SEQ_CST
+
+/* a failed compare exchange only loads, so it can not release */
+#define FATOMIC_FAIL_ORDER(order)                          \
+    (((order) == FATOMIC_RELEASE) ? FATOMIC_RELAXED :      \
+     ((order) == FATOMIC_ACQ_REL) ? FATOMIC_ACQUIRE : (order))
+
 /************************** Function Prototypes ******************************/
 
+/* atomic read of data */
+#define FATOMIC_LOAD(data, order)               __atomic_load_n(&(data), (order))
+/* atomic write of data */
+#define FATOMIC_STORE(data, val, order)         __atomic_store_n(&(data), (val), (order))
+
+/* data op= val, return initial data */
+#define FATOMIC_FETCH_ADD(data, val, order)     __atomic_fetch_add(&(data), (val), (order))
+#define FATOMIC_FETCH_SUB(data, val, order)     __atomic_fetch_sub(&(data), (val), (order))
+#define FATOMIC_FETCH_OR(data, val, order)      __atomic_fetch_or(&(data), (val), (order))
+#define FATOMIC_FETCH_AND(data, val, order)     __atomic_fetch_and(&(data), (val), (order))
+#define FATOMIC_FETCH_XOR(data, val, order)     __atomic_fetch_xor(&(data), (val), (order))
+
+/* data = val, return initial data */
+#define FATOMIC_EXCHANGE(data, val, order)      __atomic_exchange_n(&(data), (val), (order))
+
+/*
+atomic compare data and *expected_p
+if not equal, *expected_p = data, return false
+if equal, data = newval, return true
+*/
+#define FATOMIC_COMPARE_EXCHANGE(data, expected_p, newval, order) \
+    __atomic_compare_exchange_n(&(data), (expected_p), (newval), 0, (order), FATOMIC_FAIL_ORDER(order))
+
+/* memory barrier of the given order */
+#define FATOMIC_FENCE(order)    __atomic_thread_fence(order)
+
+/* let the other hardware thread run while spinning on a lock */
+#define FATOMIC_CPU_RELAX()     __asm__ __volatile__("yield" ::: "memory")
+
 /* data atomic add val, return initial data */
-#define FATOMIC_ADD(data, val)  __sync_fetch_and_add(&(data), (val))
+#define FATOMIC_ADD(data, val)  FATOMIC_FETCH_ADD(data, val, FATOMIC_SEQ_CST)
 /* data atomic add 1, return initial data */
 #define FATOMIC_INC(data)       FATOMIC_ADD(data, 1)
 
 /* data atomic subtract val, return initial data */
-#define FATOMIC_SUB(data, val)  __sync_fetch_and_sub(&(data), (val))
+#define FATOMIC_SUB(data, val)  FATOMIC_FETCH_SUB(data, val, FATOMIC_SEQ_CST)
 /* data atomic subtract 1, return initial data */
 #define FATOMIC_DEC(data)       FATOMIC_SUB(data, 1)
 
 /* data atomic or val, return initial data */
-#define FATOMIC_OR(data, val)   __sync_fetch_and_or(&(data), (val))
+#define FATOMIC_OR(data, val)   FATOMIC_FETCH_OR(data, val, FATOMIC_SEQ_CST)
 /* data atomic xor val, return initial data */
-#define FATOMIC_XOR(data, val)  __sync_fetch_and_xor(&(data), (val))
+#define FATOMIC_XOR(data, val)  FATOMIC_FETCH_XOR(data, val, FATOMIC_SEQ_CST)
 
 /* data atomic and val, return initial data */
-#define FATOMIC_AND(data, val)  __sync_fetch_and_and(&(data), (val))
+#define FATOMIC_AND(data, val)  FATOMIC_FETCH_AND(data, val, FATOMIC_SEQ_CST)
 /* data atomic nand val, return initial data */
-#define FATOMIC_NAND(data, val) __sync_fetch_and_nand(&(data), (val))
+#define FATOMIC_NAND(data, val) __atomic_fetch_nand(&(data), (val), FATOMIC_SEQ_CST)
 
 /* 
 atomic compare data and cmpval
 if not equal, return false
 if equal, data = newval, return true 
 */
-#define FATOMIC_CAS_BOOL(data, cmpval, newval) \
-    __sync_bool_compare_and_swap(&(data), (cmpval), (newval))
+#define FATOMIC_CAS_BOOL(data, cmpval, newval)                  \
+    ({                                                          \
+        __typeof__(data) fatomic_expected_ = (cmpval);          \
+        FATOMIC_COMPARE_EXCHANGE(data, &fatomic_expected_, (newval), FATOMIC_SEQ_CST); \
+    })
 
 /* 
 atomic compare data and cmpval
 if not equal, return data
 if equal, data = newval, return initial data
 */
-#define FATOMIC_CAS_VAL(data, cmpval, newval) \
-    __sync_val_compare_and_swap(&(data), (cmpval), (newval))
+#define FATOMIC_CAS_VAL(data, cmpval, newval)                   \
+    ({                                                          \
+        __typeof__(data) fatomic_expected_ = (cmpval);          \
+        (void)FATOMIC_COMPARE_EXCHANGE(data, &fatomic_expected_, (newval), FATOMIC_SEQ_CST); \
+        fatomic_expected_;                                      \
+    })
 
 /* full memory barrier */
-#define FATOMIC_MEM_BARRIER(data) __sync_synchronize()
+#define FATOMIC_MEM_BARRIER(data) FATOMIC_FENCE(FATOMIC_SEQ_CST)
 
-/* set data = val, and lock data */
-#define FATOMIC_LOCK(data, val)   __sync_lock_test_and_set(&(data), val)
+/* set data = val, and lock data, return initial data */
+#define FATOMIC_LOCK(data, val)   FATOMIC_EXCHANGE(data, val, FATOMIC_ACQUIRE)
 
 /* release data, set data = 0 */
-#define FATOMIC_UNLOCK(data)      __sync_lock_release(&(data))
+#define FATOMIC_UNLOCK(data)      FATOMIC_STORE(data, 0, FATOMIC_RELEASE)
+
+/* whether the core implements the ARMv8.1 LSE atomic instructions */
+static inline int FAtomicLseSupported(void)
+{
+#if defined(__aarch64__)
+    unsigned long isar0;
+
+    __asm__ __volatile__("mrs %0, ID_AA64ISAR0_EL1" : "=r"(isar0));
+
+    return ((isar0 >> 20) & 0xFUL) >= 2UL; /* ID_AA64ISAR0_EL1.Atomic */
+#else
+    return 0;
+#endif
+}
+
+/* whether this image was built with the LSE atomic instructions */
+#if defined(__ARM_FEATURE_ATOMICS)
+#define FATOMIC_USE_LSE     1
+#else
+#define FATOMIC_USE_LSE     0
+#endif
 
 #ifdef __cplusplus
 }
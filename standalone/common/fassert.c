@@ -24,6 +24,7 @@
  * ----- ------     --------    --------------------------------------
  * 1.0   huanghe    2021/4/5       init commit
  * 1.1   zhugengyu  2022/3/7       re-define assert macro
+ * 1.2   phytium    2026/10/19      mark the unused callback parameter
  */
 
 /***************************** Include Files *********************************/
@@ -82,6 +83,7 @@ FAssertStatus FAssertGetStatus(void)
  */
 static void FAssertCallback(const char *file, s32 line, int ret)
 {
+    FUNUSED(ret);
     FASSERT_PRINT("Assert Error at %s : %" PRIu32 " \r\n", file, line);
 }
 
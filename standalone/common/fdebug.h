@@ -181,10 +181,11 @@ typedef enum
 void FDebugMcsLockNodeInit(uintptr addr);
 void FDebugMcsLock(void);
 void FDebugMcsUnlock(void);
-_WEAK void FtDumpLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
-                         const char *fmt, ...);
-_WEAK void FtDumpExtraLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
-                              const char *FILENAME, u32 line, const char *fmt, ...);
+/* weak in fdebug.c, a backend such as the FreeRTOS deferred log replaces them */
+void FtDumpLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
+                   const char *fmt, ...);
+void FtDumpExtraLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
+                        const char *FILENAME, u32 line, const char *fmt, ...);
 void FtDumpHexWord(const u32 *ptr, u32 buflen);
 void FtDumpHexByte(const u8 *ptr, u32 buflen);
 void FtDumpHexByteDebug(const u8 *ptr, u32 buflen);
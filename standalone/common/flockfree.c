@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: flockfree.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for lock-free queues, spinlocks and counters built on fatomic.h
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include "ftypes.h"
+#include "fkernel.h"
+#include "flockfree.h"
+
+void FMpscQueueInit(FMpscQueue *queue)
+{
+    queue->stub.next = NULL;
+    queue->tail = &queue->stub;
+    FATOMIC_STORE(queue->head, &queue->stub, FATOMIC_RELEASE);
+}
+
+/**
+ * @name: FMpscQueuePop
+ * @msg: Take the oldest node of the queue
+ * @param {FMpscQueue} *queue, queue to pop from
+ * @return {FMpscNode *} the node, or NULL if the queue is empty
+ * @note: consumer side only. NULL is also returned while a producer was
+ *        interrupted between taking the head and linking its node, the node
+ *        shows up once the producer continues
+ */
+FMpscNode *FMpscQueuePop(FMpscQueue *queue)
+{
+    FMpscNode *tail = queue->tail;
+    FMpscNode *next = FATOMIC_LOAD(tail->next, FATOMIC_ACQUIRE);
+
+    /* the stub keeps the queue non-empty for the producers, skip it */
+    if (tail == &queue->stub)
+    {
+        if (next == NULL)
+        {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = FATOMIC_LOAD(tail->next, FATOMIC_ACQUIRE);
+    }
+
+    if (next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != FATOMIC_LOAD(queue->head, FATOMIC_ACQUIRE))
+    {
+        /* a push is in progress */
+        return NULL;
+    }
+
+    /* tail is the last node, put the stub behind it so it can be taken */
+    FMpscQueuePush(queue, &queue->stub);
+    next = FATOMIC_LOAD(tail->next, FATOMIC_ACQUIRE);
+    if (next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
+
+u64 FPerCpuCounterRead(const FPerCpuCounter *counter)
+{
+    u64 sum = 0;
+    u32 i;
+
+    for (i = 0; i < FCORE_NUM; i++)
+    {
+        sum += FATOMIC_LOAD(counter->core[i].value, FATOMIC_RELAXED);
+    }
+
+    return sum;
+}
+
+void FPerCpuCounterReset(FPerCpuCounter *counter)
+{
+    u32 i;
+
+    for (i = 0; i < FCORE_NUM; i++)
+    {
+        FATOMIC_STORE(counter->core[i].value, 0ULL, FATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: flockfree.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for lock-free queues, spinlocks and counters built on fatomic.h
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#ifndef FLOCKFREE_H
+#define FLOCKFREE_H
+
+#include <string.h>
+#include "ftypes.h"
+#include "ferror_code.h"
+#include "fparameters.h"
+#include "fcpu_info.h"
+#include "fatomic.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FLOCKFREE_SUCCESS           FT_SUCCESS
+#define FLOCKFREE_ERR_INVAL_PARM    FT_MAKE_ERRCODE(ErrorModGeneral, ErrCommGeneral, 1)
+
+#define FLOCKFREE_CACHE_LINE        64U
+
+/*
+ * Single producer single consumer ring of fixed size items. The producer only
+ * writes head and the consumer only writes tail, so neither needs a lock or
+ * an atomic read-modify-write. Indexes are free running, the slot is
+ * index & (capacity - 1). The ring is safe between a task and an interrupt
+ * handler or between cores, and needs no code outside this header.
+ */
+typedef struct
+{
+    volatile u32 head;                          /* items pushed, written by the producer */
+    u8 reserved0[FLOCKFREE_CACHE_LINE - 4];
+    volatile u32 tail;                          /* items popped, written by the consumer */
+    u8 reserved1[FLOCKFREE_CACHE_LINE - 4];
+    u32 capacity;                               /* power of two */
+    u32 item_size;
+    u8 *buffer;                                 /* capacity * item_size bytes */
+} __attribute__((aligned(FLOCKFREE_CACHE_LINE))) FSpscRing;
+
+/* empty the ring, buffer holds capacity * item_size bytes, capacity is a power of two */
+static inline FError FSpscRingInit(FSpscRing *ring, void *buffer, u32 item_size, u32 capacity)
+{
+    if ((ring == NULL) || (buffer == NULL) || (item_size == 0U) ||
+        (capacity == 0U) || ((capacity & (capacity - 1U)) != 0U))
+    {
+        return FLOCKFREE_ERR_INVAL_PARM;
+    }
+
+    ring->buffer = (u8 *)buffer;
+    ring->item_size = item_size;
+    ring->capacity = capacity;
+    FATOMIC_STORE(ring->tail, 0U, FATOMIC_RELAXED);
+    FATOMIC_STORE(ring->head, 0U, FATOMIC_RELEASE);
+
+    return FLOCKFREE_SUCCESS;
+}
+
+/* copy num items starting at index between the ring and items, wrapping at the end of the buffer */
+static inline void FSpscRingCopy(FSpscRing *ring, u32 index, void *items, u32 num, boolean to_ring)
+{
+    u32 slot = index & (ring->capacity - 1U);
+    u32 first = ring->capacity - slot;
+    u8 *ring_p = ring->buffer + slot * ring->item_size;
+    u8 *items_p = (u8 *)items;
+
+    if (first > num)
+    {
+        first = num;
+    }
+
+    if (to_ring)
+    {
+        memcpy(ring_p, items_p, first * ring->item_size);
+        memcpy(ring->buffer, items_p + first * ring->item_size, (num - first) * ring->item_size);
+    }
+    else
+    {
+        memcpy(items_p, ring_p, first * ring->item_size);
+        memcpy(items_p + first * ring->item_size, ring->buffer, (num - first) * ring->item_size);
+    }
+}
+
+/* append up to num items, returns the number appended, producer side only */
+static inline u32 FSpscRingPushBatch(FSpscRing *ring, const void *items, u32 num)
+{
+    u32 head = FATOMIC_LOAD(ring->head, FATOMIC_RELAXED);
+    u32 space = ring->capacity - (head - FATOMIC_LOAD(ring->tail, FATOMIC_ACQUIRE));
+
+    if (num > space)
+    {
+        num = space;
+    }
+
+    FSpscRingCopy(ring, head, (void *)items, num, TRUE);
+    /* the consumer sees the new head only after the items */
+    FATOMIC_STORE(ring->head, head + num, FATOMIC_RELEASE);
+
+    return num;
+}
+
+/* take up to num of the oldest items, returns the number taken, consumer side only */
+static inline u32 FSpscRingPopBatch(FSpscRing *ring, void *items, u32 num)
+{
+    u32 tail = FATOMIC_LOAD(ring->tail, FATOMIC_RELAXED);
+    u32 count = FATOMIC_LOAD(ring->head, FATOMIC_ACQUIRE) - tail;
+
+    if (num > count)
+    {
+        num = count;
+    }
+
+    FSpscRingCopy(ring, tail, items, num, FALSE);
+    /* the producer reuses the slots only after they were copied out */
+    FATOMIC_STORE(ring->tail, tail + num, FATOMIC_RELEASE);
+
+    return num;
+}
+
+/* append an item, returns FALSE if the ring is full, producer side only */
+static inline boolean FSpscRingPush(FSpscRing *ring, const void *item)
+{
+    u32 head = FATOMIC_LOAD(ring->head, FATOMIC_RELAXED);
+
+    if (head - FATOMIC_LOAD(ring->tail, FATOMIC_ACQUIRE) == ring->capacity)
+    {
+        return FALSE;
+    }
+
+    memcpy(ring->buffer + (head & (ring->capacity - 1U)) * ring->item_size, item, ring->item_size);
+    FATOMIC_STORE(ring->head, head + 1U, FATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+/* take the oldest item, returns FALSE if the ring is empty, consumer side only */
+static inline boolean FSpscRingPop(FSpscRing *ring, void *item)
+{
+    u32 tail = FATOMIC_LOAD(ring->tail, FATOMIC_RELAXED);
+
+    if (FATOMIC_LOAD(ring->head, FATOMIC_ACQUIRE) == tail)
+    {
+        return FALSE;
+    }
+
+    memcpy(item, ring->buffer + (tail & (ring->capacity - 1U)) * ring->item_size, ring->item_size);
+    FATOMIC_STORE(ring->tail, tail + 1U, FATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+/* number of items in the ring, exact only on the producer or the consumer side */
+static inline u32 FSpscRingCount(const FSpscRing *ring)
+{
+    return FATOMIC_LOAD(ring->head, FATOMIC_ACQUIRE) - FATOMIC_LOAD(ring->tail, FATOMIC_ACQUIRE);
+}
+
+/*
+ * Multiple producer single consumer queue of intrusive nodes. Producers
+ * only swap the head, the consumer follows the next links from the tail,
+ * embed FMpscNode in the queued object.
+ */
+typedef struct FMpscNode_
+{
+    struct FMpscNode_ *volatile next;
+} FMpscNode;
+
+typedef struct
+{
+    FMpscNode *volatile head;                   /* last pushed node, written by the producers */
+    u8 reserved0[FLOCKFREE_CACHE_LINE - sizeof(void *)];
+    FMpscNode *tail;                            /* next node to pop, consumer only */
+    FMpscNode stub;
+} __attribute__((aligned(FLOCKFREE_CACHE_LINE))) FMpscQueue;
+
+void FMpscQueueInit(FMpscQueue *queue);
+
+/* append a node, any number of producers, also from interrupt handlers */
+static inline void FMpscQueuePush(FMpscQueue *queue, FMpscNode *node)
+{
+    FMpscNode *prev;
+
+    FATOMIC_STORE(node->next, NULL, FATOMIC_RELAXED);
+    prev = FATOMIC_EXCHANGE(queue->head, node, FATOMIC_ACQ_REL);
+    /* the node is reachable from the consumer only after this store */
+    FATOMIC_STORE(prev->next, node, FATOMIC_RELEASE);
+}
+
+/* take the oldest node, consumer side only */
+FMpscNode *FMpscQueuePop(FMpscQueue *queue);
+
+/*
+ * Ticket spinlock, the waiters get the lock in the order they asked for it.
+ * The lock does not mask interrupts, callers sharing it with an interrupt
+ * handler of the same core mask them around it.
+ */
+typedef struct
+{
+    volatile u32 next;                          /* next ticket to hand out */
+    volatile u32 owner;                         /* ticket holding the lock */
+} FTicketLock;
+
+#define FTICKET_LOCK_INIT   {0U, 0U}
+
+static inline void FTicketLockInit(FTicketLock *lock)
+{
+    FATOMIC_STORE(lock->next, 0U, FATOMIC_RELAXED);
+    FATOMIC_STORE(lock->owner, 0U, FATOMIC_RELEASE);
+}
+
+static inline void FTicketLockAcquire(FTicketLock *lock)
+{
+    u32 ticket = FATOMIC_FETCH_ADD(lock->next, 1U, FATOMIC_RELAXED);
+
+    while (FATOMIC_LOAD(lock->owner, FATOMIC_ACQUIRE) != ticket)
+    {
+        FATOMIC_CPU_RELAX();
+    }
+}
+
+/* take the lock only if it is free, returns TRUE on success */
+static inline boolean FTicketLockTryAcquire(FTicketLock *lock)
+{
+    u32 owner = FATOMIC_LOAD(lock->owner, FATOMIC_RELAXED);
+    u32 ticket = owner;
+
+    return FATOMIC_COMPARE_EXCHANGE(lock->next, &ticket, owner + 1U, FATOMIC_ACQUIRE) ? TRUE : FALSE;
+}
+
+static inline void FTicketLockRelease(FTicketLock *lock)
+{
+    /* only the holder writes owner */
+    FATOMIC_STORE(lock->owner, lock->owner + 1U, FATOMIC_RELEASE);
+}
+
+/*
+ * Sequence lock for data read much more often than written. Readers never
+ * block the writer, they retry when a write overlapped their read. Writers
+ * are serialized by the caller, e.g. with a FTicketLock.
+ */
+typedef struct
+{
+    volatile u32 sequence;                      /* odd while a write is in progress */
+} FSeqLock;
+
+#define FSEQ_LOCK_INIT      {0U}
+
+static inline void FSeqLockWriteBegin(FSeqLock *lock)
+{
+    FATOMIC_STORE(lock->sequence, lock->sequence + 1U, FATOMIC_RELAXED);
+    /* the odd sequence is visible before the data changes */
+    FATOMIC_FENCE(FATOMIC_RELEASE);
+}
+
+static inline void FSeqLockWriteEnd(FSeqLock *lock)
+{
+    FATOMIC_STORE(lock->sequence, lock->sequence + 1U, FATOMIC_RELEASE);
+}
+
+/* returns the sequence to pass to FSeqLockReadRetry */
+static inline u32 FSeqLockReadBegin(const FSeqLock *lock)
+{
+    u32 sequence;
+
+    while ((sequence = FATOMIC_LOAD(lock->sequence, FATOMIC_ACQUIRE)) & 1U)
+    {
+        FATOMIC_CPU_RELAX();
+    }
+
+    return sequence;
+}
+
+/* TRUE if a write overlapped the read and the data must be read again */
+static inline boolean FSeqLockReadRetry(const FSeqLock *lock, u32 sequence)
+{
+    /* the data reads complete before the sequence is read again */
+    FATOMIC_FENCE(FATOMIC_ACQUIRE);
+
+    return (FATOMIC_LOAD(lock->sequence, FATOMIC_RELAXED) != sequence) ? TRUE : FALSE;
+}
+
+/*
+ * Counter with one cache line per core, a core only adds to its own line so
+ * the updates do not bounce between the caches. Place it in memory shared by
+ * the cores to count across images.
+ */
+typedef struct
+{
+    struct
+    {
+        volatile u64 value;
+        u8 reserved[FLOCKFREE_CACHE_LINE - 8];
+    } core[FCORE_NUM];
+} __attribute__((aligned(FLOCKFREE_CACHE_LINE))) FPerCpuCounter;
+
+static inline void FPerCpuCounterAdd(FPerCpuCounter *counter, u64 value)
+{
+    u32 cpu_id = 0;
+
+    GetCpuId(&cpu_id);
+    /* atomic against the interrupt handlers of the core, not ordered */
+    (void)FATOMIC_FETCH_ADD(counter->core[cpu_id].value, value, FATOMIC_RELAXED);
+}
+
+/* sum of all cores */
+u64 FPerCpuCounterRead(const FPerCpuCounter *counter);
+
+void FPerCpuCounterReset(FPerCpuCounter *counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,180 +28,167 @@
 #include <string.h>
 #include <stdio.h>
 #include "fkernel.h"
-#include "faarch.h"
 #include "ftypes.h"
 #include "fprintf.h"
 #include "fprintk.h"
-#include "fearly_uart.h"
 #include "sdkconfig.h"
-#include "fmmu.h"
+#include "fcpu_info.h"
+#include "ftrace_ring.h"
 #include "ftrace_printk.h"
-#include "fgeneric_timer.h"
 
-#define SHARED_MEM_BASE 0xC8000000
-#define TRACE_BUFFER_SIZE (1024 * 1024) /* 1MB共享内存 */
-
-typedef struct {
-    volatile u32 write_index;
-    volatile u32 read_index;
-    volatile u32 overflow_count;
-    char buffer[TRACE_BUFFER_SIZE - 12]; /* 减去索引和计数的大小 */
-} FTraceBuffer;
-
-/* 共享内存指针 */
-static FTraceBuffer *trace_buffer = (FTraceBuffer *)SHARED_MEM_BASE;
-static boolean trace_initialized = FALSE;
+/* 读取记录时每次拷贝的条数 */
+#define TRACE_READ_BATCH 8
 
 /**
- * @brief 初始化共享内存Trace Buffer
- * 
- * 此函数初始化共享内存区域，重置所有索引和计数器。
- * 应在系统启动时调用一次。
+ * @brief 按格式串取出可变参数的原始值
+ *
+ * 格式化推迟到读取端完成，这里只解析转换说明符，按实际类型取参数，
+ * 浮点数保存其二进制表示，最多保存 max_num 个参数。
+ *
+ * @param fmt 格式化字符串
+ * @param ap 可变参数列表
+ * @param args 保存参数原始值
+ * @param max_num args 的大小
+ * @return u32 保存的参数个数
  */
-void trace_buffer_init(void)
+static u32 trace_collect_args(const char *fmt, va_list ap, u64 *args, u32 max_num)
 {
-    /* 初始化共享内存中的索引 */
-    FMmuMap(SHARED_MEM_BASE,SHARED_MEM_BASE,TRACE_BUFFER_SIZE,MT_NORMAL | MT_P_RW_U_RW | MT_NS);
-    trace_buffer->write_index = 0;
-    trace_buffer->read_index = 0;
-    trace_buffer->overflow_count = 0;
-    trace_initialized = TRUE;
-    /* 确保内存同步 */
-    DSB();
-}
+    u32 num = 0;
+    int longs;
+    double dval;
 
-/**
- * @brief 将字符串写入共享内存
- * 
- * 此函数将字符串数据写入共享内存的环形缓冲区，
- * 处理缓冲区环绕和溢出情况。
- * 
- * @param str 要写入的字符串
- * @param level 消息级别
- * @param function_name 产生消息的函数名称
- */
-static void trace_putstring(const char *str, FTraceLevel level, const char *function_name)
-{
-    if (!trace_initialized) 
+    while ((*fmt != '\0') && (num < max_num))
     {
-        return;
-    }
+        if (*fmt++ != '%')
+        {
+            continue;
+        }
 
-    u32 timestamp = GenericTimerRead(GENERIC_TIMER_ID0); /* 获取时间戳 */
-    u32 buffer_size = TRACE_BUFFER_SIZE - 12; /* 实际缓冲区大小 */
-    
-    /* 格式化消息前缀 [时间戳] [级别] [函数]: */
-    char prefix[128];
-    const char *level_str;
-    
-    switch (level) 
-    {
-        case TRACE_LEVEL_DEBUG: level_str = "DEBUG"; break;
-        case TRACE_LEVEL_INFO: level_str = "INFO"; break;
-        case TRACE_LEVEL_WARN: level_str = "WARN"; break;
-        case TRACE_LEVEL_ERROR: level_str = "ERROR"; break;
-        case TRACE_LEVEL_CRITICAL: level_str = "CRITICAL"; break;
-        default: level_str = "UNKNOWN"; break;
-    }
-    
-    int prefix_len = snprintf(prefix, sizeof(prefix), 
-                             "[%u] [%s] [%s]: ", timestamp, level_str, function_name);
-    
-    /* 计算总消息长度 (前缀 + 内容 + 换行符) */
-    u32 total_len = prefix_len + strlen(str) + 1;
-    
-    /* 检查是否有足够空间 */
-    u32 write_idx = trace_buffer->write_index;
-    u32 read_idx = trace_buffer->read_index;
-    u32 space_available;
-    
-    if (write_idx >= read_idx) 
-    {
-        space_available = buffer_size - (write_idx - read_idx);
-    } 
-    else 
-    {
-        space_available = read_idx - write_idx;
-    }
-    
-    if (total_len > space_available) 
-    {
-        /* 空间不足，增加溢出计数 */
-        trace_buffer->overflow_count++;
-        return;
-    }
-    
-    /* 写入消息前缀 */ 
-    for (u32 i = 0; i < prefix_len; i++) 
-    {
-        trace_buffer->buffer[write_idx] = prefix[i];
-        write_idx = (write_idx + 1) % buffer_size;
-    }
-    
-    /* 写入消息内容 */
-    const char *p = str;
-    while (*p) 
-    {
-        trace_buffer->buffer[write_idx] = *p;
-        write_idx = (write_idx + 1) % buffer_size;
-        p++;
+        /* 标志 */
+        while ((*fmt == '-') || (*fmt == '+') || (*fmt == ' ') || (*fmt == '#') || (*fmt == '0'))
+        {
+            fmt++;
+        }
+
+        /* 宽度和精度，'*' 也占一个参数 */
+        while (((*fmt >= '0') && (*fmt <= '9')) || (*fmt == '.') || (*fmt == '*'))
+        {
+            if ((*fmt == '*') && (num < max_num))
+            {
+                args[num++] = (u64)(s64)va_arg(ap, int);
+            }
+            fmt++;
+        }
+
+        /* 长度修饰 */
+        longs = 0;
+        while ((*fmt == 'l') || (*fmt == 'h') || (*fmt == 'z') || (*fmt == 'j') || (*fmt == 't') || (*fmt == 'L'))
+        {
+            if ((*fmt == 'l') || (*fmt == 'z') || (*fmt == 'j') || (*fmt == 't'))
+            {
+                longs++;
+            }
+            fmt++;
+        }
+
+        if (num >= max_num)
+        {
+            break;
+        }
+
+        switch (*fmt)
+        {
+            case 'd':
+            case 'i':
+            case 'c':
+                if (longs >= 2)
+                {
+                    args[num++] = (u64)va_arg(ap, long long);
+                }
+                else if (longs == 1)
+                {
+                    args[num++] = (u64)va_arg(ap, long);
+                }
+                else
+                {
+                    args[num++] = (u64)(s64)va_arg(ap, int);
+                }
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                if (longs >= 2)
+                {
+                    args[num++] = (u64)va_arg(ap, unsigned long long);
+                }
+                else if (longs == 1)
+                {
+                    args[num++] = (u64)va_arg(ap, unsigned long);
+                }
+                else
+                {
+                    args[num++] = (u64)va_arg(ap, unsigned int);
+                }
+                break;
+            case 'p':
+            case 's':
+                args[num++] = (u64)(uintptr)va_arg(ap, void *);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                dval = va_arg(ap, double);
+                memcpy(&args[num++], &dval, sizeof(dval));
+                break;
+            case '\0':
+                return num;
+            default:
+                break;
+        }
+        fmt++;
     }
-    
-    /* 添加换行符 */
-    trace_buffer->buffer[write_idx] = '\n';
-    write_idx = (write_idx + 1) % buffer_size;
-    
-    /* 更新写索引 */ 
-    trace_buffer->write_index = write_idx;
-    
-    /* 确保内存写入完成 */
-    DSB();
+
+    return num;
 }
 
 /**
- * @brief 自定义的vprintf函数，将输出重定向到共享内存
- * 
- * 此函数替代标准的vprintf，将格式化后的字符串写入共享内存。
- * 
+ * @brief 记录一条消息到本核的 trace ring
+ *
+ * 只保存格式串地址和参数原始值，不做格式化，可在中断中调用。
+ * %s 参数只保存指针，字符串需在镜像中常驻才能被解码。
+ *
  * @param fmt 格式化字符串
  * @param arg 可变参数列表
  * @param level 消息级别
- * @param function_name 调用函数名称
- * @return int 写入的字符数
+ * @param function_name 调用函数名称，为NULL时不记录
  */
-static int trace_vprintf(const char *fmt, va_list arg, FTraceLevel level, const char *function_name)
+static void trace_vrecord(const char *fmt, va_list arg, FTraceLevel level, const char *function_name)
 {
-    char buffer[256]; /* 本地缓冲区 */ 
-    int len;
-    
-    /* 第一次使用时初始化共享内存 */
-    if (!trace_initialized) 
-    {
-        trace_buffer_init();
-    }
-    
-    /* 格式化字符串到本地缓冲区 */
-    len = vsnprintf(buffer, sizeof(buffer), fmt, arg);
-    
-    /* 如果格式化后的字符串超过本地缓冲区大小，处理截断 */
-    if (len >= (int)sizeof(buffer)) 
+    u64 args[FTRACE_RING_MAX_ARGS];
+    u32 num = 0;
+
+    if (function_name != NULL)
     {
-        len = sizeof(buffer) - 1;
-        buffer[len] = '\0';
+        args[num++] = (u64)(uintptr)function_name;
     }
-    
-    /* 将格式化后的字符串写入共享内存 */
-    trace_putstring(buffer, level, function_name);
-    
-    return len;
+
+    num += trace_collect_args(fmt, arg, &args[num], FTRACE_RING_MAX_ARGS - num);
+
+    FTraceRingWrite((function_name != NULL) ? FTRACE_EVENT_PRINTF : FTRACE_EVENT_PRINTK,
+                    (u8)level, fmt, num, args);
 }
 
 /**
  * @brief 重定向的ftrace_printk函数
- * 
- * 此函数替代原有的ftrace_printk，将输出重定向到共享内存。
- * 默认使用INFO级别。
- * 
+ *
+ * 此函数将消息以二进制记录写入本核的 trace ring，默认使用INFO级别。
+ *
  * @param fmt 格式化字符串
  * @param ... 可变参数
  */
@@ -209,8 +196,7 @@ void ftrace_printk(const char *fmt, ...)
 {
     va_list ap;
     va_start(ap, fmt);
-    /* 使用我们的trace_vprintf替代原来的f_vprintf */
-    trace_vprintf(fmt, ap, TRACE_LEVEL_INFO, "ftrace_printk");
+    trace_vrecord(fmt, ap, TRACE_LEVEL_INFO, NULL);
     va_end(ap);
 }
 
@@ -220,9 +206,9 @@ void f_printk(const char *fmt, ...) __attribute__((alias("ftrace_printk")));
 #endif
 /**
  * @brief 带级别的调试输出函数
- * 
+ *
  * 此函数提供带级别的调试输出，可以指定消息的重要性。
- * 
+ *
  * @param level 消息级别
  * @param function_name 调用函数名称
  * @param fmt 格式化字符串
@@ -232,287 +218,188 @@ void ftrace_printf(FTraceLevel level, const char *function_name, const char *fmt
 {
     va_list ap;
     va_start(ap, fmt);
-    
-    trace_vprintf(fmt, ap, level, function_name);
-    
+
+    trace_vrecord(fmt, ap, level, function_name);
+
     va_end(ap);
 }
 
+static const char *trace_level_string(u8 level)
+{
+    switch (level)
+    {
+        case TRACE_LEVEL_DEBUG: return "DEBUG";
+        case TRACE_LEVEL_INFO: return "INFO";
+        case TRACE_LEVEL_WARN: return "WARN";
+        case TRACE_LEVEL_ERROR: return "ERROR";
+        case TRACE_LEVEL_CRITICAL: return "CRITICAL";
+        default: return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief 打印一条记录
+ *
+ * 目标端不做格式化，只打印格式串和参数的原始值，
+ * 完整的消息由主机端 standalone/tools/trace/ftrace_decode.py 还原。
+ */
+static void trace_print_record(const FTraceRecord *record, u32 index)
+{
+    u32 i = 0;
+
+    f_printf("[%u] [%llu] [%s] ", index, (unsigned long long)record->timestamp, trace_level_string(record->level));
+    if ((record->event_id == FTRACE_EVENT_PRINTF) && (record->nargs > 0))
+    {
+        f_printf("[%s]: ", (const char *)(uintptr)record->args[0]);
+        i = 1;
+    }
+    f_printf("fmt@0x%llx \"", (unsigned long long)record->fmt);
+    for (const char *p = (const char *)(uintptr)record->fmt; (p != NULL) && (*p != '\0'); p++)
+    {
+        if ((*p != '\n') && (*p != '\r'))
+        {
+            putchar(*p);
+        }
+    }
+    f_printf("\"");
+    for (; i < record->nargs; i++)
+    {
+        f_printf(" 0x%llx", (unsigned long long)record->args[i]);
+    }
+    f_printf("\r\n");
+}
+
+static u32 trace_this_core(void)
+{
+    u32 cpu_id = 0;
+
+    (void)GetCpuId(&cpu_id);
+    return cpu_id;
+}
+
 /**
- * @brief 调试函数：打印共享内存内容
- * 
- * 此函数通过printf输出共享内存中的全部内容，
- * 用于调试和验证Trace Buffer功能。
+ * @brief 调试函数：打印本核 trace ring 的内容
+ *
+ * 只打印不消费，用于调试和验证 trace ring 功能。
  */
 void ftrace_print_shared_memory(void)
 {
-    if (!trace_initialized) 
+    FTraceRingHeader *ring = FTraceRingGetHeader(trace_this_core());
+    FTraceRecord record;
+    u32 head, tail, idx;
+
+    if ((ring == NULL) || (ring->magic != FTRACE_RING_MAGIC))
     {
         f_printf("Trace buffer not initialized\n");
         return;
     }
 
-    u32 read_idx = trace_buffer->read_index;
-    u32 write_idx = trace_buffer->write_index;
-    u32 buffer_size = TRACE_BUFFER_SIZE - 12;
-    
-    f_printf("=== Shared Memory Trace Buffer Contents ===\r\n");
-    f_printf("Write Index: %u, Read Index: %u, Overflow Count: %u\r\n",
-           write_idx, read_idx, trace_buffer->overflow_count);
-    
-    if (read_idx == write_idx) 
+    head = ring->head;
+    tail = ring->tail;
+    if (head - tail > ring->capacity)
+    {
+        tail = head - ring->capacity;
+    }
+
+    f_printf("=== Trace Ring of Core %u ===\r\n", ring->core_id);
+    f_printf("Head: %u, Tail: %u, Capacity: %u, Dropped: %u, Timer: %llu Hz\r\n",
+             head, ring->tail, ring->capacity, ring->dropped, (unsigned long long)ring->timer_freq);
+
+    if (head == tail)
     {
         f_printf("No messages in buffer.\n");
         return;
     }
-    
-    f_printf("Messages:\r\n");
-    
-    /* 临时变量用于遍历缓冲区 */
-    u32 current_idx = read_idx;
-    int message_count = 0;
-    
-    while (current_idx != write_idx) 
+
+    for (idx = tail; idx != head; idx++)
     {
-        /* 查找消息结束位置（换行符） */
-        u32 message_start = current_idx;
-        u32 message_length = 0;
-        boolean found_end = FALSE;
-        
-        /* 查找消息结束 */
-        while (current_idx != write_idx) 
-        {
-            char c = trace_buffer->buffer[current_idx];
-            current_idx = (current_idx + 1) % buffer_size;
-            message_length++;
-            
-            if (c == '\n') 
-            {
-                found_end = TRUE;
-                break;
-            }
-        }
-        
-        /* 如果找到完整的消息，打印它 */
-        if (found_end) 
-        {
-            f_printf("[%d] ", ++message_count);
-            for (u32 i = 0; i < message_length; i++) 
-            {
-                u32 idx = (message_start + i) % buffer_size;
-                putchar(trace_buffer->buffer[idx]);
-            }
-            f_printf("\n");
-        } 
-        else 
-        {
-            /* 不完整的消息（可能由于缓冲区环绕） */
-            f_printf("[Partial] ");
-            for (u32 i = 0; i < message_length; i++) 
-            {
-                u32 idx = (message_start + i) % buffer_size;
-                putchar(trace_buffer->buffer[idx]);
-            }
-            f_printf("\n");
-            break;
-        }
+        memcpy(&record, (const u8 *)ring + sizeof(FTraceRingHeader) + (idx & (ring->capacity - 1)) * sizeof(FTraceRecord),
+               sizeof(record));
+        trace_print_record(&record, idx - tail + 1);
     }
-    
-    f_printf("=== End of Shared Memory Contents ===\n");
+
+    f_printf("=== End of Trace Ring ===\n");
 }
 
 /**
  * @brief 调试函数：打印指定数量的最新消息
- * 
- * 此函数通过printf输出共享内存中指定数量的最新消息，
- * 可以灵活控制显示的消息数量。
- * 
+ *
+ * 较早的未读消息被丢弃，打印过的消息标记为已读。
+ *
  * @param count 要显示的消息数量
  */
 void ftrace_print_recent_messages(u32 count)
 {
-    if (!trace_initialized) 
-    {
-        f_printf("Trace buffer not initialized\n");
-        return;
-    }
-    
-    if (count == 0) 
+    u32 core = trace_this_core();
+    FTraceRecord records[TRACE_READ_BATCH];
+    u32 pending, skip, num, lost, i;
+    u32 printed = 0;
+
+    if (count == 0)
     {
         return;
     }
-    u32 read_idx = trace_buffer->read_index;
-    u32 write_idx = trace_buffer->write_index;
-    u32 buffer_size = TRACE_BUFFER_SIZE - 12;
-    
-    f_printf("=== Reading %u Messages from Shared Memory ===\n", count);
-    f_printf("Initial - Write Index: %u, Read Index: %u, Overflow Count: %u\n",
-           write_idx, read_idx, trace_buffer->overflow_count);
-    
-    if (read_idx == write_idx) 
+
+    pending = FTraceRingPending(core);
+    if (pending == 0)
     {
         f_printf("No messages in buffer.\n");
         return;
     }
-    
-    /* 计算消息总数 */
-    u32 total_messages = 0;
-    u32 temp_idx = read_idx;
-    
-    while (temp_idx != write_idx) 
-    {
-        if (trace_buffer->buffer[temp_idx] == '\n') 
-        {
-            total_messages++;
-        }
-        temp_idx = (temp_idx + 1) % buffer_size;
-    }
-    
-    /* 如果请求的消息数量超过总数，调整count */
-    if (count > total_messages) 
+
+    if (count > pending)
     {
-        count = total_messages;
+        count = pending;
         f_printf("Only %u messages available, adjusting count\n", count);
     }
-    
-    /* 找到第(total_messages - count)个消息的起始位置 */
-    u32 target_message = total_messages - count;
-    u32 message_count = 0;
-    u32 message_start = read_idx;
-    
-    /* 先找到起始消息的位置 */
-    temp_idx = read_idx;
-    while (temp_idx != write_idx && message_count < target_message) 
+
+    /* 跳过较早的消息 */
+    skip = pending - count;
+    while (skip > 0)
     {
-        if (trace_buffer->buffer[temp_idx] == '\n') {
-            message_count++;
-            message_start = (temp_idx + 1) % buffer_size; /* 下一个消息的开始 */
+        num = FTraceRingRead(core, records, min(skip, (u32)TRACE_READ_BATCH), &lost);
+        if (num == 0)
+        {
+            break;
         }
-        temp_idx = (temp_idx + 1) % buffer_size;
+        skip -= num;
     }
-    
-    /* 记录新的读索引位置（将在处理完所有消息后更新） */
-    u32 new_read_index = message_start;
-    
-    /* 打印指定数量的消息 */
-    u32 printed = 0;
-    u32 current_idx = message_start;
-    
-    while (current_idx != write_idx && printed < count) 
+
+    f_printf("=== Reading %u Messages from Trace Ring ===\n", count);
+    while (printed < count)
     {
-        /* 查找消息结束 */
-        u32 line_start = current_idx;
-        u32 line_length = 0;
-        boolean found_end = FALSE;
-        
-        while (current_idx != write_idx) 
+        num = FTraceRingRead(core, records, min(count - printed, (u32)TRACE_READ_BATCH), &lost);
+        if (lost != 0)
         {
-            char c = trace_buffer->buffer[current_idx];
-            current_idx = (current_idx + 1) % buffer_size;
-            line_length++;
-            
-            if (c == '\n') 
-            {
-                found_end = TRUE;
-                /* 更新新的读索引位置（指向下一个消息的开始） */
-                new_read_index = current_idx;
-                break;
-            }
+            f_printf("[%u messages overwritten]\r\n", lost);
         }
-        
-        /* 打印消息 */
-        if (found_end) 
+        if (num == 0)
         {
-            f_printf("[%u/%u] ", ++printed, count);
-            for (u32 i = 0; i < line_length; i++) 
-            {
-                u32 idx = (line_start + i) % buffer_size;
-                putchar(trace_buffer->buffer[idx]);
-            }
-            f_printf("\n");
-        } 
-        else 
+            break;
+        }
+        for (i = 0; i < num; i++)
         {
-            /* 不完整的消息（不应该发生，因为我们已经计算了完整的消息数量） */
-            f_printf("[Partial %u/%u] ", ++printed, count);
-            for (u32 i = 0; i < line_length; i++) 
-            {
-                u32 idx = (line_start + i) % buffer_size;
-                putchar(trace_buffer->buffer[idx]);
-            }
-            f_printf("\n");
-            /* 更新新的读索引位置 */
-            new_read_index = current_idx;
+            trace_print_record(&records[i], ++printed);
         }
     }
-    /* 更新读索引，标记这些消息为已读 */
-    trace_buffer->read_index = new_read_index;
-    // 确保内存同步
-    DSB();
-    f_printf("Final - Write Index: %u, Read Index: %u\n", 
-           trace_buffer->write_index, trace_buffer->read_index);
     f_printf("============================================\n");
 }
 
 /**
  * @brief 获取未读消息数量
- * 
- * 此函数计算并返回共享内存中未读消息的数量。
- * 未读消息是指从当前读索引到写索引之间的所有完整消息。
- * 
- * @return u32 未读消息数量，如果出错返回0
+ *
+ * @return u32 本核 trace ring 中未读消息的数量
  */
 u32 fget_unread_message_count(void)
 {
-    if (!trace_initialized) 
-    {
-        f_printf("Trace buffer not initialized\n");
-        return 0;
-    }
-    
-    u32 read_idx = trace_buffer->read_index;
-    u32 write_idx = trace_buffer->write_index;
-    u32 buffer_size = TRACE_BUFFER_SIZE - 12;
- 
-    if (read_idx == write_idx) 
-        return 0;
-    /* 计算未读消息数量 */
-    u32 unread_count = 0;
-    u32 current_idx = read_idx;
-    
-    while (current_idx != write_idx) 
-    {
-        /* 查找消息结束位置（换行符） */ 
-        while (current_idx != write_idx) 
-        {
-            if (trace_buffer->buffer[current_idx] == '\n') 
-            {
-                unread_count++;
-                current_idx = (current_idx + 1) % buffer_size;
-                break;
-            }
-            current_idx = (current_idx + 1) % buffer_size;
-        }
-    }
-    return unread_count;
+    return FTraceRingPending(trace_this_core());
 }
 
 /**
  * @brief 标记所有消息为已读
- * 
- * 此函数将读索引设置为当前写索引的位置，
- * 从而标记所有消息为已读状态。
  */
 void fmark_all_messages_read(void)
 {
-    if (!trace_initialized) 
-    {
-        f_printf("Trace buffer not initialized\n");
-        return;
-    }
-    
-    /* 将读索引设置为写索引，标记所有消息为已读 */
-    trace_buffer->read_index = trace_buffer->write_index;
-    DSB();
+    FTraceRingFlush(trace_this_core());
     f_printf("All messages marked as read\n");
 }
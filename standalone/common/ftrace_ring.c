@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ftrace_ring.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the per-core binary trace ring.
+ *
+ * Modify History:
+ *  Ver     Who           Date                  Changes
+ * -----   ------       --------     --------------------------------------
+ *  1.0    phytium      2026/10/19            first release
+ */
+
+#include <string.h>
+#include "fkernel.h"
+#include "faarch.h"
+#include "ftypes.h"
+#include "sdkconfig.h"
+#include "fmmu.h"
+#include "fparameters.h"
+#include "fcpu_info.h"
+#include "fgeneric_timer.h"
+#include "ftrace_ring.h"
+
+#ifndef CONFIG_TRACE_RING_BASE
+#define CONFIG_TRACE_RING_BASE      0xC8000000
+#endif
+
+#ifndef CONFIG_TRACE_RING_SIZE
+#define CONFIG_TRACE_RING_SIZE      0x100000 /* shared by all cores */
+#endif
+
+#define FTRACE_RING_REGION_SIZE     (CONFIG_TRACE_RING_SIZE / FCORE_NUM)
+#define FTRACE_IRQ_FIQ_MASK         0xC0U    /* mask IRQ and FIQ interrupts */
+
+/* the ring of this core, set on the first use */
+static FTraceRingHeader *trace_ring_p = NULL;
+static boolean trace_memory_mapped = FALSE;
+
+static inline FTraceRecord *FTraceRingRecords(FTraceRingHeader *ring_p)
+{
+    return (FTraceRecord *)((uintptr)ring_p + sizeof(FTraceRingHeader));
+}
+
+FTraceRingHeader *FTraceRingGetHeader(u32 core_id)
+{
+    if (core_id >= FCORE_NUM)
+    {
+        return NULL;
+    }
+
+    if (!trace_memory_mapped)
+    {
+        FMmuMap(CONFIG_TRACE_RING_BASE, CONFIG_TRACE_RING_BASE, CONFIG_TRACE_RING_SIZE,
+                MT_NORMAL | MT_P_RW_U_RW | MT_NS);
+        trace_memory_mapped = TRUE;
+    }
+
+    return (FTraceRingHeader *)((uintptr)CONFIG_TRACE_RING_BASE + core_id * FTRACE_RING_REGION_SIZE);
+}
+
+/**
+ * @name: FTraceRingInit
+ * @msg: map the trace memory and reset the ring of the calling core
+ * @return {*}
+ * @note: other cores keep their rings, each core only ever writes its own region
+ */
+void FTraceRingInit(void)
+{
+    FTraceRingHeader *ring_p;
+    u32 cpu_id = 0;
+    u32 capacity;
+
+    (void)GetCpuId(&cpu_id);
+    ring_p = FTraceRingGetHeader(cpu_id);
+    if (ring_p == NULL)
+    {
+        return;
+    }
+
+    /* largest power of two number of records that fits the region */
+    capacity = (FTRACE_RING_REGION_SIZE - sizeof(FTraceRingHeader)) / sizeof(FTraceRecord);
+    while (capacity & (capacity - 1))
+    {
+        capacity &= capacity - 1;
+    }
+
+    ring_p->magic = 0;
+    DSB();
+
+    ring_p->version = FTRACE_RING_VERSION;
+    ring_p->record_size = sizeof(FTraceRecord);
+    ring_p->region_size = FTRACE_RING_REGION_SIZE;
+    ring_p->capacity = capacity;
+#ifdef CONFIG_TRACE_RING_DROP
+    ring_p->flags = 0;
+#else
+    ring_p->flags = FTRACE_RING_FLAG_OVERWRITE;
+#endif
+    ring_p->core_id = cpu_id;
+    ring_p->timer_freq = GenericTimerFrequecy();
+    ring_p->head = 0;
+    ring_p->dropped = 0;
+    ring_p->tail = 0;
+    DSB();
+
+    ring_p->magic = FTRACE_RING_MAGIC;
+    DSB();
+
+    trace_ring_p = ring_p;
+}
+
+/**
+ * @name: FTraceRingWrite
+ * @msg: append one record to the ring of this core
+ * @param {u16} event_id, id of the event, FTRACE_EVENT_xxx
+ * @param {u8} level, level of printf events, 0 otherwise
+ * @param {const char} *fmt, format string, must stay valid in the image
+ * @param {u32} nargs, number of raw arguments
+ * @param {const u64} *args, raw arguments
+ * @return {*}
+ * @note: interrupts are only masked while the record is filled in, the producer
+ *        of a ring is always its own core, so no lock is taken
+ */
+void FTraceRingWrite(u16 event_id, u8 level, const char *fmt, u32 nargs, const u64 *args)
+{
+    FTraceRingHeader *ring_p;
+    FTraceRecord *record_p;
+    u32 currmask;
+    u32 head;
+    u32 i;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | FTRACE_IRQ_FIQ_MASK);
+
+    ring_p = trace_ring_p;
+    if (ring_p == NULL)
+    {
+        FTraceRingInit();
+        ring_p = trace_ring_p;
+        if (ring_p == NULL)
+        {
+            MTCPSR(currmask);
+            return;
+        }
+    }
+
+    head = ring_p->head;
+    if (!(ring_p->flags & FTRACE_RING_FLAG_OVERWRITE) &&
+        (head - ring_p->tail >= ring_p->capacity))
+    {
+        ring_p->dropped++;
+        MTCPSR(currmask);
+        return;
+    }
+
+    if (nargs > FTRACE_RING_MAX_ARGS)
+    {
+        nargs = FTRACE_RING_MAX_ARGS;
+    }
+
+    record_p = &FTraceRingRecords(ring_p)[head & (ring_p->capacity - 1)];
+    record_p->timestamp = GenericTimerRead(GENERIC_TIMER_ID0);
+    record_p->event_id = event_id;
+    record_p->nargs = (u8)nargs;
+    record_p->level = level;
+    record_p->seq = head;
+    record_p->fmt = (u64)(uintptr)fmt;
+    for (i = 0; i < nargs; i++)
+    {
+        record_p->args[i] = args[i];
+    }
+
+    /* publish the record before the new head */
+    DMB();
+    ring_p->head = head + 1;
+
+    MTCPSR(currmask);
+}
+
+/**
+ * @name: FTraceRingRead
+ * @msg: consume the oldest records of a core
+ * @param {u32} core_id, core that produced the records
+ * @param {FTraceRecord} *records, buffer for the records
+ * @param {u32} max_num, size of the buffer in records
+ * @param {u32} *lost_p, if not NULL, number of records overwritten before they were read
+ * @return {u32} number of records copied
+ * @note: there must be only one reader per ring
+ */
+u32 FTraceRingRead(u32 core_id, FTraceRecord *records, u32 max_num, u32 *lost_p)
+{
+    FTraceRingHeader *ring_p = FTraceRingGetHeader(core_id);
+    u32 head, tail, lost = 0;
+    u32 num = 0;
+
+    if ((ring_p == NULL) || (ring_p->magic != FTRACE_RING_MAGIC))
+    {
+        if (lost_p != NULL)
+        {
+            *lost_p = 0;
+        }
+        return 0;
+    }
+
+    tail = ring_p->tail;
+    head = ring_p->head;
+    DMB();
+
+    if (head - tail > ring_p->capacity)
+    {
+        lost = head - tail - ring_p->capacity;
+        tail = head - ring_p->capacity;
+    }
+
+    while ((tail != head) && (num < max_num))
+    {
+        memcpy(&records[num], &FTraceRingRecords(ring_p)[tail & (ring_p->capacity - 1)], sizeof(FTraceRecord));
+        DMB();
+
+        /* in overwrite mode the producer may be filling this slot again while it is copied */
+        if ((records[num].seq != tail) ||
+            ((ring_p->flags & FTRACE_RING_FLAG_OVERWRITE) && (ring_p->head - tail >= ring_p->capacity)))
+        {
+            lost++;
+        }
+        else
+        {
+            num++;
+        }
+        tail++;
+    }
+
+    ring_p->tail = tail;
+    DSB();
+
+    if (lost_p != NULL)
+    {
+        *lost_p = lost;
+    }
+
+    return num;
+}
+
+u32 FTraceRingPending(u32 core_id)
+{
+    FTraceRingHeader *ring_p = FTraceRingGetHeader(core_id);
+    u32 pending;
+
+    if ((ring_p == NULL) || (ring_p->magic != FTRACE_RING_MAGIC))
+    {
+        return 0;
+    }
+
+    pending = ring_p->head - ring_p->tail;
+
+    return (pending > ring_p->capacity) ? ring_p->capacity : pending;
+}
+
+void FTraceRingFlush(u32 core_id)
+{
+    FTraceRingHeader *ring_p = FTraceRingGetHeader(core_id);
+
+    if ((ring_p == NULL) || (ring_p->magic != FTRACE_RING_MAGIC))
+    {
+        return;
+    }
+
+    ring_p->tail = ring_p->head;
+    DSB();
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ftrace_ring.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the per-core binary trace ring.
+ *
+ * Modify History:
+ *  Ver     Who           Date                  Changes
+ * -----   ------       --------     --------------------------------------
+ *  1.0    phytium      2026/10/19            first release
+ */
+
+#ifndef FTRACE_RING_H
+#define FTRACE_RING_H
+
+#include "ftypes.h"
+#include "fkernel.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FTRACE_RING_MAGIC           0x42525446U /* "FTRB" */
+#define FTRACE_RING_VERSION         1U
+#define FTRACE_RING_MAX_ARGS        5U
+
+/* ring header flags */
+#define FTRACE_RING_FLAG_OVERWRITE  BIT(0)
+
+/* event ids, ids from FTRACE_EVENT_USER on are free for the application */
+#define FTRACE_EVENT_PRINTK         0U  /* fmt and args */
+#define FTRACE_EVENT_PRINTF         1U  /* fmt and args, args[0] is the function name */
+#define FTRACE_EVENT_KERNEL         0x80U /* 0x80 - 0xff are reserved for the rtos kernel events */
+#define FTRACE_EVENT_USER           0x100U
+
+/*
+ * Each core owns one region of the shared memory: a header followed by a
+ * power of two number of records. The core is the only producer and writes
+ * head, one reader (on any core or the host) writes tail. Indexes are free
+ * running, the slot is index & (capacity - 1).
+ */
+typedef struct
+{
+    u32 magic;
+    u16 version;
+    u16 record_size;
+    u32 region_size;                /* bytes of this region, the next core follows */
+    u32 capacity;                   /* number of records */
+    u32 flags;
+    u32 core_id;
+    u64 timer_freq;                 /* frequency of the record timestamps */
+    volatile u32 head;              /* records written */
+    volatile u32 dropped;           /* records the producer dropped when full */
+    u8 reserved0[24];
+    volatile u32 tail;              /* records consumed, on its own cache line */
+    u8 reserved1[60];
+} __attribute__((aligned(64))) FTraceRingHeader;
+
+/* one cache line per record, formatting is done by the reader */
+typedef struct
+{
+    u64 timestamp;                  /* generic counter */
+    u16 event_id;
+    u8 nargs;
+    u8 level;
+    u32 seq;                        /* low bits of the index, lets the reader spot overwritten slots */
+    u64 fmt;                        /* address of the format string in the image */
+    u64 args[FTRACE_RING_MAX_ARGS]; /* raw argument values, doubles are stored as bits */
+} __attribute__((aligned(64))) FTraceRecord;
+
+/* map the trace memory and reset the ring of this core, done on first use otherwise */
+void FTraceRingInit(void);
+
+/* append one record to the ring of this core, safe in interrupt context */
+void FTraceRingWrite(u16 event_id, u8 level, const char *fmt, u32 nargs, const u64 *args);
+
+/* consume up to max_num records of a core, returns the number copied, *lost_p counts overwritten ones */
+u32 FTraceRingRead(u32 core_id, FTraceRecord *records, u32 max_num, u32 *lost_p);
+
+/* number of records of a core that were not consumed yet */
+u32 FTraceRingPending(u32 core_id);
+
+/* drop all pending records of a core */
+void FTraceRingFlush(u32 core_id);
+
+FTraceRingHeader *FTraceRingGetHeader(u32 core_id);
+
+/* record an event with up to FTRACE_RING_MAX_ARGS integer or pointer arguments, no formatting at run time */
+#define FTRACE_ARG_(x)              ((u64)(uintptr)(x))
+#define FTRACE_NARGS_(_0, _1, _2, _3, _4, _5, n, ...) n
+#define FTRACE_NARGS(...)           FTRACE_NARGS_(0, ##__VA_ARGS__, 5, 4, 3, 2, 1, 0)
+
+#define FTRACE_ARGS_0()
+#define FTRACE_ARGS_1(a)                    FTRACE_ARG_(a)
+#define FTRACE_ARGS_2(a, b)                 FTRACE_ARG_(a), FTRACE_ARG_(b)
+#define FTRACE_ARGS_3(a, b, c)              FTRACE_ARG_(a), FTRACE_ARG_(b), FTRACE_ARG_(c)
+#define FTRACE_ARGS_4(a, b, c, d)           FTRACE_ARG_(a), FTRACE_ARG_(b), FTRACE_ARG_(c), FTRACE_ARG_(d)
+#define FTRACE_ARGS_5(a, b, c, d, e)        FTRACE_ARG_(a), FTRACE_ARG_(b), FTRACE_ARG_(c), FTRACE_ARG_(d), FTRACE_ARG_(e)
+#define FTRACE_ARGS_N_(n, ...)              FTRACE_ARGS_##n(__VA_ARGS__)
+#define FTRACE_ARGS_N(n, ...)               FTRACE_ARGS_N_(n, ##__VA_ARGS__)
+
+#define FTRACE_EVENT(event_id, fmt, ...)                                                   \
+    do                                                                                      \
+    {                                                                                       \
+        const u64 ftrace_args_[FTRACE_RING_MAX_ARGS + 1] = {FTRACE_ARGS_N(FTRACE_NARGS(__VA_ARGS__), ##__VA_ARGS__)}; \
+        FTraceRingWrite((event_id), 0U, (fmt), FTRACE_NARGS(__VA_ARGS__), ftrace_args_);   \
+    } while (0)
+
+#define FTRACE(fmt, ...)            FTRACE_EVENT(FTRACE_EVENT_PRINTK, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,530 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: flockfree_stress.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the stress test of the spsc ring on linux, a producer and a
+ * consumer thread pass numbered items through the ring and the consumer checks the order
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "flockfree.h"
+
+/* the indexes start close to the u32 limit, so they wrap during the run */
+#define FSTRESS_INDEX_START     0xFFFFF000U
+#define FSTRESS_CHECK_MAGIC     0xA5A5A5A5U
+#define FSTRESS_MAX_BATCH       4096U
+
+/* 12 bytes, the ring copies items of any size */
+typedef struct
+{
+    u32 seq_lo;
+    u32 seq_hi;
+    u32 check;
+} FStressItem;
+
+typedef enum
+{
+    FSTRESS_SINGLE = 0,     /* FSpscRingPush and FSpscRingPop */
+    FSTRESS_BATCH,          /* FSpscRingPushBatch and FSpscRingPopBatch */
+    FSTRESS_PUSH_BATCH,     /* FSpscRingPushBatch and FSpscRingPop */
+    FSTRESS_POP_BATCH,      /* FSpscRingPush and FSpscRingPopBatch */
+
+    FSTRESS_MODE_NUM
+} FStressMode;
+
+static const char *const mode_names[FSTRESS_MODE_NUM] = {"single", "batch", "push_batch", "pop_batch"};
+
+typedef struct
+{
+    u64 items;              /* items passed in each mode */
+    u32 capacity;
+    u32 max_batch;
+    u32 seed;
+    u32 modes;              /* BIT(FStressMode) */
+} FStressOpts;
+
+static FStressOpts opts =
+{
+    .items = 10000000ULL,
+    .capacity = 64U,
+    .max_batch = 96U,
+    .seed = 1U,
+    .modes = (1U << FSTRESS_MODE_NUM) - 1U
+};
+
+typedef struct
+{
+    FSpscRing ring;
+    FStressMode mode;
+    u64 push_wraps;         /* batches split at the end of the buffer */
+    u64 pop_wraps;
+    u64 full_waits;
+    u64 empty_waits;
+    u64 max_count;          /* most items seen in the ring by the consumer */
+    u64 errors;
+} FStressCtx;
+
+static inline u32 FStressRand(u32 *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/* 1 to max_batch items, more than the capacity sometimes to check the clamping */
+static inline u32 FStressBatchSize(u32 *state)
+{
+    return (FStressRand(state) % opts.max_batch) + 1U;
+}
+
+/*
+ * give up the cpu after a burst of random length, otherwise on a single cpu the producer
+ * always fills the ring and the consumer always drains it, and no batch crosses the end
+ */
+static inline void FStressPace(u32 *state, u32 *burst, u32 num)
+{
+    if (*burst > num)
+    {
+        *burst -= num;
+        return;
+    }
+
+    *burst = FStressBatchSize(state);
+    sched_yield();
+}
+
+static inline void FStressFill(FStressItem *item, u64 seq)
+{
+    item->seq_lo = (u32)seq;
+    item->seq_hi = (u32)(seq >> 32);
+    item->check = item->seq_lo ^ item->seq_hi ^ FSTRESS_CHECK_MAGIC;
+}
+
+static inline boolean FStressCheck(FStressCtx *ctx, const FStressItem *item, u64 seq)
+{
+    u64 got = ((u64)item->seq_hi << 32) | item->seq_lo;
+
+    if ((got == seq) && (item->check == (item->seq_lo ^ item->seq_hi ^ FSTRESS_CHECK_MAGIC)))
+    {
+        return TRUE;
+    }
+
+    if (ctx->errors++ < 10U)
+    {
+        fprintf(stderr, "%s: expect item %llu, got %llu check 0x%x\n", mode_names[ctx->mode],
+                (unsigned long long)seq, (unsigned long long)got, item->check);
+    }
+
+    return FALSE;
+}
+
+static inline boolean FStressWraps(const FSpscRing *ring, u32 index, u32 num)
+{
+    return ((index & (ring->capacity - 1U)) + num) > ring->capacity;
+}
+
+static void *FStressProducer(void *arg)
+{
+    FStressCtx *ctx = (FStressCtx *)arg;
+    FSpscRing *ring = &ctx->ring;
+    FStressItem items[FSTRESS_MAX_BATCH];
+    u32 state = opts.seed;
+    u64 seq = 0;
+    u32 burst = 0;
+    u32 num, pushed, head, i;
+
+    while (seq < opts.items)
+    {
+        if ((ctx->mode == FSTRESS_SINGLE) || (ctx->mode == FSTRESS_POP_BATCH))
+        {
+            FStressFill(&items[0], seq);
+            if (FSpscRingPush(ring, &items[0]))
+            {
+                seq++;
+                FStressPace(&state, &burst, 1U);
+            }
+            else
+            {
+                ctx->full_waits++;
+                sched_yield();
+            }
+            continue;
+        }
+
+        num = FStressBatchSize(&state);
+        if (num > opts.items - seq)
+        {
+            num = (u32)(opts.items - seq);
+        }
+
+        for (i = 0; i < num; i++)
+        {
+            FStressFill(&items[i], seq + i);
+        }
+
+        /* the producer owns head, it reads its own value */
+        head = ring->head;
+        pushed = FSpscRingPushBatch(ring, items, num);
+        if (pushed == 0U)
+        {
+            ctx->full_waits++;
+            sched_yield();
+            continue;
+        }
+
+        if (FStressWraps(ring, head, pushed))
+        {
+            ctx->push_wraps++;
+        }
+        seq += pushed;
+        FStressPace(&state, &burst, pushed);
+    }
+
+    return NULL;
+}
+
+static void *FStressConsumer(void *arg)
+{
+    FStressCtx *ctx = (FStressCtx *)arg;
+    FSpscRing *ring = &ctx->ring;
+    FStressItem items[FSTRESS_MAX_BATCH];
+    u32 state = opts.seed * 7U + 1U;
+    u64 seq = 0;
+    u32 burst = 0;
+    u32 num, got, tail, count, i;
+
+    while (seq < opts.items)
+    {
+        count = FSpscRingCount(ring);
+        if (count > ring->capacity)
+        {
+            fprintf(stderr, "%s: %u items in a ring of %u\n", mode_names[ctx->mode], count, ring->capacity);
+            ctx->errors++;
+        }
+        if (count > ctx->max_count)
+        {
+            ctx->max_count = count;
+        }
+
+        if ((ctx->mode == FSTRESS_SINGLE) || (ctx->mode == FSTRESS_PUSH_BATCH))
+        {
+            if (FSpscRingPop(ring, &items[0]))
+            {
+                (void)FStressCheck(ctx, &items[0], seq);
+                seq++;
+                FStressPace(&state, &burst, 1U);
+            }
+            else
+            {
+                ctx->empty_waits++;
+                sched_yield();
+            }
+            continue;
+        }
+
+        num = FStressBatchSize(&state);
+        /* the consumer owns tail, it reads its own value */
+        tail = ring->tail;
+        got = FSpscRingPopBatch(ring, items, num);
+        if (got == 0U)
+        {
+            ctx->empty_waits++;
+            sched_yield();
+            continue;
+        }
+
+        if (got > num)
+        {
+            fprintf(stderr, "%s: popped %u items for a batch of %u\n", mode_names[ctx->mode], got, num);
+            ctx->errors++;
+        }
+
+        if (FStressWraps(ring, tail, got))
+        {
+            ctx->pop_wraps++;
+        }
+
+        for (i = 0; i < got; i++)
+        {
+            (void)FStressCheck(ctx, &items[i], seq + i);
+        }
+        seq += got;
+        FStressPace(&state, &burst, got);
+    }
+
+    if (FSpscRingPop(ring, &items[0]))
+    {
+        fprintf(stderr, "%s: ring not empty after the last item\n", mode_names[ctx->mode]);
+        ctx->errors++;
+    }
+
+    return NULL;
+}
+
+static double FStressNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int FStressRun(FStressMode mode)
+{
+    static FStressCtx ctx;
+    FStressItem *buffer;
+    pthread_t producer, consumer;
+    double start, secs;
+    boolean batch_push = (mode == FSTRESS_BATCH) || (mode == FSTRESS_PUSH_BATCH);
+    boolean batch_pop = (mode == FSTRESS_BATCH) || (mode == FSTRESS_POP_BATCH);
+    int ret = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.mode = mode;
+    buffer = calloc(opts.capacity, sizeof(FStressItem));
+    if ((buffer == NULL) ||
+        (FSpscRingInit(&ctx.ring, buffer, sizeof(FStressItem), opts.capacity) != FLOCKFREE_SUCCESS))
+    {
+        fprintf(stderr, "%s: failed to set up the ring\n", mode_names[mode]);
+        free(buffer);
+        return -1;
+    }
+
+    /* both threads start later, plain stores are enough here */
+    ctx.ring.head = FSTRESS_INDEX_START;
+    ctx.ring.tail = FSTRESS_INDEX_START;
+
+    start = FStressNow();
+    if (pthread_create(&consumer, NULL, FStressConsumer, &ctx) ||
+        pthread_create(&producer, NULL, FStressProducer, &ctx))
+    {
+        fprintf(stderr, "%s: failed to create the threads\n", mode_names[mode]);
+        exit(1);
+    }
+    (void)pthread_join(producer, NULL);
+    (void)pthread_join(consumer, NULL);
+    secs = FStressNow() - start;
+
+    printf("%s: items=%llu capacity=%u mitems_per_s=%.1f push_wraps=%llu pop_wraps=%llu "
+           "full_waits=%llu empty_waits=%llu max_count=%llu errors=%llu\n",
+           mode_names[mode], (unsigned long long)opts.items, opts.capacity,
+           (secs > 0) ? (double)opts.items / secs / 1e6 : 0.0,
+           (unsigned long long)ctx.push_wraps, (unsigned long long)ctx.pop_wraps,
+           (unsigned long long)ctx.full_waits, (unsigned long long)ctx.empty_waits,
+           (unsigned long long)ctx.max_count, (unsigned long long)ctx.errors);
+
+    if (ctx.errors != 0U)
+    {
+        ret = -1;
+    }
+
+    /* the batches must have split at the end of the buffer to cover the second memcpy */
+    if ((opts.items >= 100000U) &&
+        ((batch_push && (ctx.push_wraps == 0U)) || (batch_pop && (ctx.pop_wraps == 0U))))
+    {
+        fprintf(stderr, "%s: no batch wrapped at the end of the buffer\n", mode_names[mode]);
+        ret = -1;
+    }
+
+    free(buffer);
+    return ret;
+}
+
+/* the ring refuses bad parameters and stops at full and empty */
+static int FStressBasic(void)
+{
+    FSpscRing ring;
+    u32 buffer[8];
+    u32 items[12];
+    u32 i;
+    int ret = 0;
+
+    if ((FSpscRingInit(&ring, buffer, sizeof(u32), 6U) == FLOCKFREE_SUCCESS) ||
+        (FSpscRingInit(&ring, buffer, 0U, 8U) == FLOCKFREE_SUCCESS) ||
+        (FSpscRingInit(&ring, NULL, sizeof(u32), 8U) == FLOCKFREE_SUCCESS))
+    {
+        fprintf(stderr, "basic: bad parameters accepted\n");
+        ret = -1;
+    }
+
+    (void)FSpscRingInit(&ring, buffer, sizeof(u32), 8U);
+    for (i = 0; i < 12U; i++)
+    {
+        items[i] = i;
+    }
+
+    if ((FSpscRingPushBatch(&ring, items, 12U) != 8U) || FSpscRingPush(&ring, &items[8]) ||
+        (FSpscRingCount(&ring) != 8U))
+    {
+        fprintf(stderr, "basic: push past full\n");
+        ret = -1;
+    }
+
+    memset(items, 0xFF, sizeof(items));
+    if ((FSpscRingPopBatch(&ring, items, 12U) != 8U) || FSpscRingPop(&ring, &items[8]) ||
+        (FSpscRingCount(&ring) != 0U))
+    {
+        fprintf(stderr, "basic: pop past empty\n");
+        ret = -1;
+    }
+
+    for (i = 0; i < 8U; i++)
+    {
+        if (items[i] != i)
+        {
+            fprintf(stderr, "basic: item %u is %u\n", i, items[i]);
+            ret = -1;
+        }
+    }
+
+    printf("basic: %s\n", (ret == 0) ? "ok" : "failed");
+    return ret;
+}
+
+static void FStressUsage(const char *prog)
+{
+    u32 i;
+
+    printf("usage: %s [options]\n", prog);
+    printf("    -m list    modes, comma separated:");
+    for (i = 0; i < FSTRESS_MODE_NUM; i++)
+    {
+        printf(" %s", mode_names[i]);
+    }
+    printf(",all (default all)\n");
+    printf("    -n items   items passed in each mode (default %llu)\n", (unsigned long long)opts.items);
+    printf("    -c items   capacity of the ring, a power of two (default %u)\n", opts.capacity);
+    printf("    -b items   largest batch, up to %u (default %u)\n", FSTRESS_MAX_BATCH, opts.max_batch);
+    printf("    -S seed    seed of the batch sizes (default %u)\n", opts.seed);
+}
+
+static int FStressParseModes(char *list)
+{
+    char *name;
+    char *save = NULL;
+    u32 i;
+
+    opts.modes = 0;
+    for (name = strtok_r(list, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save))
+    {
+        if (!strcmp(name, "all"))
+        {
+            opts.modes = (1U << FSTRESS_MODE_NUM) - 1U;
+            continue;
+        }
+
+        for (i = 0; i < FSTRESS_MODE_NUM; i++)
+        {
+            if (!strcmp(name, mode_names[i]))
+            {
+                opts.modes |= 1U << i;
+                break;
+            }
+        }
+
+        if (i == FSTRESS_MODE_NUM)
+        {
+            fprintf(stderr, "unknown mode %s\n", name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int FStressParseArgs(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:n:c:b:S:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'm':
+                if (FStressParseModes(optarg))
+                {
+                    return -1;
+                }
+                break;
+            case 'n':
+                opts.items = strtoull(optarg, NULL, 0);
+                break;
+            case 'c':
+                opts.capacity = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                opts.max_batch = strtoul(optarg, NULL, 0);
+                break;
+            case 'S':
+                opts.seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                FStressUsage(argv[0]);
+                return -1;
+        }
+    }
+
+    if ((opts.capacity < 2U) || (opts.capacity & (opts.capacity - 1U)) ||
+        (opts.max_batch == 0U) || (opts.max_batch > FSTRESS_MAX_BATCH))
+    {
+        fprintf(stderr, "bad capacity or batch size\n");
+        return -1;
+    }
+
+    if (opts.seed == 0U)
+    {
+        opts.seed = 1U;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    u32 mode;
+    int ret;
+
+    if (FStressParseArgs(argc, argv))
+    {
+        return 2;
+    }
+
+    ret = FStressBasic();
+    for (mode = 0; mode < FSTRESS_MODE_NUM; mode++)
+    {
+        if (opts.modes & (1U << mode))
+        {
+            ret |= FStressRun((FStressMode)mode);
+        }
+    }
+
+    printf("status: %s\n", (ret == 0) ? "pass" : "fail");
+    return (ret == 0) ? 0 : 1;
+}
@@ -25,6 +25,7 @@
  * 1.0   zhugengyu  2021/12/2    init
  * 1.1   zhugengyu  2022/6/6     modify according to tech manual.
  * 2.0   zhugengyu  2023/9/16    rename as sdif, support SD 3.0 and rework clock timing
+ * 2.1   phytium    2026/10/19   support 200MHz card clock, add sample phase and HS400 mode setting
  */
 
 /***************************** Include Files *********************************/
@@ -279,7 +280,13 @@ FError FSdifSetClkFreqByCalc(FSdif *const instance_p, boolean is_ddr, u32 input_
         FSDIF_INFO("will change clock, src_clk_rate: %d, input_clk_rate: %d",
                    instance_p->config.src_clk_rate, input_clk_hz);
 
-        if (input_clk_hz >= FSDIF_CLK_SPEED_25_MHZ)
+        if (input_clk_hz > FSDIF_CLK_SPEED_100_MHZ)
+        {
+            /* HS200/HS400/SDR104, the second divider is 1 and the first divider sets the card clock */
+            first_uhs_div = (instance_p->config.src_clk_rate + 2 * input_clk_hz - 1) / (2 * input_clk_hz);
+            tmp_ext_reg = FSDIF_UHS_CLK_DIV(first_uhs_div - 1) | FSDIF_UHS_EXT_CLK_ENA;
+        }
+        else if (input_clk_hz >= FSDIF_CLK_SPEED_25_MHZ)
         {
             tmp_ext_reg = 0x102;
         }
@@ -334,6 +341,12 @@ FError FSdifSetClkFreqByCalc(FSdif *const instance_p, boolean is_ddr, u32 input_
             FSDIF_WRITE_REG(base_addr, FSDIF_CLKDIV_OFFSET,
                             (drv << 8) | (sample << 16) | (div & 0xff));
         }
+        else if (input_clk_hz > FSDIF_CLK_SPEED_100_MHZ)
+        {
+            /* sample and drive phase must be less than the divider, they are set in UHS_REG_EXT */
+            div = 1;
+            FSDIF_WRITE_REG(base_addr, FSDIF_CLKDIV_OFFSET, FSDIF_CLK_DIV(0, 0, div));
+        }
 
         if (!(FSDIF_READ_REG(base_addr, FSDIF_CLKDIV_OFFSET) & 0xff00) && (is_ddr))
         {
@@ -346,7 +359,7 @@ FError FSdifSetClkFreqByCalc(FSdif *const instance_p, boolean is_ddr, u32 input_
             FSDIF_CLR_BIT(base_addr, FSDIF_CNTRL_OFFSET, FSDIF_CNTRL_DRV_SHIFT_EN);
         }
 
-        if (div >= 2)
+        if ((div >= 2) || (input_clk_hz > FSDIF_CLK_SPEED_100_MHZ))
         {
             FSDIF_WRITE_REG(base_addr, FSDIF_FULL_CLK_DIV_OFFSET, ((2 * (div & 0xff)) & 0xffff));
         }
@@ -838,6 +851,88 @@ void FSdifSetCardDDRMode(FSdif *const instance_p, boolean enable)
     FSdifSetDDRMode(instance_p->config.base_addr, enable);
 }
 
+/**
+ * @name: FSdifSetCardHS400Mode
+ * @msg: Set eMMC HS400 mode, the start bit of the data is less than one card clock cycle
+ * @return {NONE}
+ * @param {FSdif} *instance_p, SDIF controller instance
+ * @param {boolean} enable, TRUE if HS400, FALSE if other timing
+ */
+void FSdifSetCardHS400Mode(FSdif *const instance_p, boolean enable)
+{
+    FASSERT(instance_p);
+    FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
+    FSdifSeteMMCDDR(instance_p->config.base_addr, enable);
+}
+
+/**
+ * @name: FSdifGetSamplePhaseNum
+ * @msg: Get the num of sample phases in one card clock period, the sample point moves by one
+ *       source clock cycle in each phase
+ * @return {u32} num of sample phases, 1 if the phase can not be adjusted
+ * @param {FSdif} *instance_p, SDIF controller instance
+ */
+u32 FSdifGetSamplePhaseNum(FSdif *const instance_p)
+{
+    FASSERT(instance_p);
+    uintptr base_addr = instance_p->config.base_addr;
+    u32 first_div = FSDIF_UHS_CLK_DIV_GET(FSDIF_READ_REG(base_addr, FSDIF_CLK_SRC_OFFSET)) + 1;
+    u32 div = FSDIF_CLK_DIVDER_GET(FSDIF_READ_REG(base_addr, FSDIF_CLKDIV_OFFSET));
+    u32 phase_num;
+
+    div = (div == 0) ? 1 : div;
+    phase_num = 2 * first_div * div;
+
+    return (phase_num > FSDIF_MAX_SAMPLE_PHASE_NUM) ? FSDIF_MAX_SAMPLE_PHASE_NUM : phase_num;
+}
+
+/**
+ * @name: FSdifSetSamplePhase
+ * @msg: Set the sample phase of card data and response, the phase is reset when card clock changed
+ * @return {FError} FSDIF_SUCCESS if set success, otherwise failed
+ * @param {FSdif} *instance_p, SDIF controller instance
+ * @param {u32} phase, sample phase, less than FSdifGetSamplePhaseNum
+ */
+FError FSdifSetSamplePhase(FSdif *const instance_p, u32 phase)
+{
+    FASSERT(instance_p);
+    FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
+    uintptr base_addr = instance_p->config.base_addr;
+    u32 uhs_reg_val;
+    FError ret;
+
+    if (phase >= FSdifGetSamplePhaseNum(instance_p))
+    {
+        FSDIF_ERROR("Invalid sample phase %d.", phase);
+        return FSDIF_ERR_INVALID_TIMING;
+    }
+
+    uhs_reg_val = FSDIF_READ_REG(base_addr, FSDIF_CLK_SRC_OFFSET);
+    uhs_reg_val &= ~FSDIF_UHS_CLK_SAMP_MASK;
+    uhs_reg_val |= FSDIF_UHS_CLK_SAMP(phase);
+
+    FSdifSetClock(base_addr, FALSE);
+
+    ret = FSdifUpdateExternalClk(base_addr, uhs_reg_val);
+    if (FSDIF_SUCCESS != ret)
+    {
+        FSDIF_ERROR("update external clock failed");
+        return ret;
+    }
+
+    FSdifSetClock(base_addr, TRUE);
+
+    ret = FSdifSendPrivateCmd(base_addr, FSDIF_CMD_UPD_CLK, 0U);
+    if (FSDIF_SUCCESS != ret)
+    {
+        FSDIF_ERROR("update clock failed");
+        return ret;
+    }
+
+    FSDIF_DEBUG("Sample phase %d, UHS_REG_EXT: 0x%x", phase, uhs_reg_val);
+    return ret;
+}
+
 
 /**
  * @name: FSdifPollWaitTransferEnd
@@ -28,6 +28,8 @@
  * 1.3   zhugengyu  2022/11/23   fix multi-block rw issues
  * 2.0   zhugengyu  2023/9/16    rename as sdif, support SD 3.0 and rework clock timing
  * 2.1   zhugengyu  2023/10/23   add sdio interrupt handler
+ * 2.2   phytium    2026/10/19   add sample phase and HS400 mode setting for tuning
+ * 2.3   phytium    2026/10/19   prepare descriptor lists of scattered segments ahead of transfer
  * 3.0   zhugengyu  2024/12/17   adopt to bsd drivers
  */
 
@@ -92,8 +94,11 @@ typedef enum
     FSDIF_CLK_SPEED_52_MHZ = 52000000U, /* mmc */
     FSDIF_CLK_SPEED_66_MHZ = 66000000U, /* mmc */
     FSDIF_CLK_SPEED_100_MHZ = 100000000U,
+    FSDIF_CLK_SPEED_200_MHZ = 200000000U, /* HS200, HS400 and SDR104 */
 } FSdifClkSpeed;
 
+#define FSDIF_MAX_SAMPLE_PHASE_NUM 128U /* steps of the sample phase field in UHS_REG_EXT */
+
 /**************************** Type Definitions *******************************/
 typedef struct _FSdif FSdif;
 typedef struct _FSdifTiming FSdifTiming;
@@ -144,8 +149,15 @@ typedef struct
 #define FSDIF_BLOCK_SIZE 512U
     u32 blkcnt;  /* num of block in trans */
     u32 datalen; /* bytes in trans */
+    FSdifIDmaDescList *desc_list; /* descriptors prepared by FSdifPrepareDMADescriptor, NULL to use the list of instance */
 } FSdifData;     /* SDIF trans data */
 
+typedef struct
+{
+    uintptr buf_dma; /* physical address of the segment */
+    u32 len;         /* bytes of the segment, multiple of block size */
+} FSdifDMASeg;       /* SDIF DMA data segment */
+
 typedef struct
 {
     u32 cmdidx; /* command index */
@@ -231,11 +243,24 @@ void FSdifSetCardBusWidth(FSdif *const instance_p, uint32_t bus_width);
 /* Set card DDR/SDR mode */
 void FSdifSetCardDDRMode(FSdif *const instance_p, boolean enable);
 
+/* Set eMMC HS400 mode */
+void FSdifSetCardHS400Mode(FSdif *const instance_p, boolean enable);
+
+/* Get the num of sample phases in one card clock period */
+u32 FSdifGetSamplePhaseNum(FSdif *const instance_p);
+
+/* Set the sample phase of card data and response */
+FError FSdifSetSamplePhase(FSdif *const instance_p, u32 phase);
+
 #ifndef FIO_SCATTERED_DMA
 /* Fill transfer descriptors with transfer buffer */
 FError FSdifSetupDMADescriptor(FSdif *const instance_p, FSdifData *data_p);
 #endif
 
+/* Fill a descriptor list with data segments, the list can be prepared while another transfer is in flight */
+FError FSdifPrepareDMADescriptor(FSdif *const instance_p, FSdifIDmaDescList *desc_list,
+                                 const FSdifDMASeg *segs, u32 seg_num, u32 blksz);
+
 /* Start command and data transfer in DMA mode */
 FError FSdifDMATransfer(FSdif *const instance_p, FSdifCmdData *const cmd_data_p);
 
@@ -24,6 +24,7 @@
  * ----- ------     --------    --------------------------------------
  * 1.1   zhugengyu  2022/6/6     modify according to tech manual.
  * 2.0   zhugengyu  2023/9/16    rename as sdif, support SD 3.0 and rework clock timing
+ * 2.1   phytium    2026/10/19   prepare descriptor lists of scattered segments ahead of transfer
  */
 /***************************** Include Files *********************************/
 #include "fdrivers_port.h"
@@ -77,35 +78,51 @@ static void FSdifDumpDMADescriptor(FSdif *const instance_p, u32 desc_in_use)
     }
 }
 
-#ifndef FIO_SCATTERED_DMA
 /**
- * @name: FSdifSetupDMADescriptor
- * @msg: setup DMA descriptor list before do transcation
+ * @name: FSdifPrepareDMADescriptor
+ * @msg: fill descriptor list with data segments, the list is owned by caller and can be
+ *       prepared while another transfer is in flight
  * @return {FError} FSDIF_SUCCESS if setup success
  * @param {FSdif} *instance_p, instance of controller
- * @param {FSdifData} *data_p, data in transcation
+ * @param {FSdifIDmaDescList} *desc_list, descriptor list to fill
+ * @param {FSdifDMASeg} *segs, data segments of the transfer, in order
+ * @param {u32} seg_num, num of data segments
+ * @param {u32} blksz, card block size
  */
-FError FSdifSetupDMADescriptor(FSdif *const instance_p, FSdifData *data_p)
+FError FSdifPrepareDMADescriptor(FSdif *const instance_p, FSdifIDmaDescList *desc_list,
+                                 const FSdifDMASeg *segs, u32 seg_num, u32 blksz)
 {
-    FASSERT(data_p && data_p->buf);
-    FASSERT(instance_p->desc_list.first_desc);
-    FSdifIDmaDescList *desc_list = &instance_p->desc_list;
+    FASSERT(instance_p && desc_list && segs);
+    FASSERT(desc_list->first_desc);
     FSdifIDmaDesc *cur_desc = NULL;
-    u32 desc_num = 1U;
-    /* num of blocks can be transferred by one descriptor */
-    u32 desc_blocks = instance_p->desc_list.desc_trans_sz / data_p->blksz;
-    u32 remain_blocks = data_p->blkcnt; /* blocks still need to transfer */
-    u32 trans_blocks;                   /* blocks that will be transferred this round */
-    uintptr next_desc_addr = 0U;
-    uintptr buff_addr = data_p->buf_dma;
-    boolean is_first = TRUE;
-    boolean is_last = FALSE;
-    u32 loop = 0;
-
-    if (data_p->datalen > instance_p->desc_list.desc_trans_sz)
+    /* max bytes can be transferred by one descriptor, in whole blocks */
+    u32 desc_bytes = (desc_list->desc_trans_sz / blksz) * blksz;
+    u32 desc_num = 0U;
+    u32 seg;
+    u32 remain_bytes;
+    uintptr buff_addr;
+    uintptr next_desc_addr;
+
+    if ((seg_num == 0U) || (desc_bytes == 0U))
     {
-        desc_num = ((data_p->datalen / instance_p->desc_list.desc_trans_sz) +
-                    ((data_p->datalen % instance_p->desc_list.desc_trans_sz) ? 1 : 0));
+        return FSDIF_ERR_INVALID_STATE;
+    }
+
+    for (seg = 0U; seg < seg_num; seg++)
+    {
+        if ((segs[seg].len == 0U) || (segs[seg].len % blksz))
+        {
+            FSDIF_ERROR("Segment length %d is not multiple of block size %d.", segs[seg].len, blksz);
+            return FSDIF_ERR_INVALID_STATE;
+        }
+
+        if (segs[seg].buf_dma % FSDIF_DMA_BUF_ALIGMENT) /* make sure buffer aligned */
+        {
+            FSDIF_ERROR("Data buffer 0x%x do not align to %d.", segs[seg].buf_dma, FSDIF_DMA_BUF_ALIGMENT);
+            return FSDIF_ERR_DMA_BUF_UNALIGN;
+        }
+
+        desc_num += (segs[seg].len + desc_bytes - 1U) / desc_bytes;
     }
 
     if (desc_num > desc_list->desc_num)
@@ -114,70 +131,99 @@ FError FSdifSetupDMADescriptor(FSdif *const instance_p, FSdifData *data_p)
         return FSDIF_ERR_SHORT_BUF;
     }
 
-    FSDIF_DEBUG("DMA transfer 0x%x use %d desc, total %d", data_p->buf_dma, desc_num,
-                desc_list->desc_num);
-
-    /* setup DMA descriptor list, so that we just need to update buffer address
-       in each transaction */
-    memset((void *)desc_list->first_desc, 0, sizeof(FSdifIDmaDesc) * desc_list->desc_num);
-
-    for (loop = 0; loop < desc_num; loop++)
+    /* descriptor address shall align, the next address of each entry bases on it */
+    if (desc_list->first_desc_dma % sizeof(FSdifIDmaDesc))
     {
-        trans_blocks = (remain_blocks <= desc_blocks) ? remain_blocks : desc_blocks;
-        cur_desc = &(desc_list->first_desc[loop]); /* virtual addr of current descriptor */
-        next_desc_addr = desc_list->first_desc_dma + (loop + 1) * sizeof(FSdifIDmaDesc); /* physical addr of next descriptor */
+        FSDIF_ERROR("DMA descriptor 0x%x do not align.", desc_list->first_desc_dma);
+        return FSDIF_ERR_DMA_BUF_UNALIGN;
+    }
 
-        is_first = (0U == loop) ? TRUE : FALSE;
-        is_last = ((desc_num - 1U) == loop) ? TRUE : FALSE;
+    FSDIF_DEBUG("DMA transfer %d segments use %d desc, total %d", seg_num, desc_num,
+                desc_list->desc_num);
 
-        /* set properity of descriptor entry */
-        cur_desc->attribute = FSDIF_IDMAC_DES0_CH | FSDIF_IDMAC_DES0_OWN; /* descriptor list in chain, and set OWN bit  */
-        cur_desc->attribute |= (is_first) ? FSDIF_IDMAC_DES0_FD : 0; /* is it the first entry ? */
-        cur_desc->attribute |= (is_last) ? (FSDIF_IDMAC_DES0_LD | FSDIF_IDMAC_DES0_ER) : 0; /* is it the last entry ? */
+    memset((void *)desc_list->first_desc, 0, sizeof(FSdifIDmaDesc) * desc_num);
 
-        /* set data length in transfer */
-        cur_desc->non1 = 0U;
-        cur_desc->len = (u32)(trans_blocks * data_p->blksz);
+    cur_desc = desc_list->first_desc;
+    for (seg = 0U; seg < seg_num; seg++)
+    {
+        buff_addr = segs[seg].buf_dma;
+        remain_bytes = segs[seg].len;
 
-        /* set data buffer for transfer */
-        if (buff_addr % FSDIF_DMA_BUF_ALIGMENT) /* make sure buffer aligned and not cross page boundary */
+        while (remain_bytes > 0U)
         {
-            FSDIF_ERROR("Data buffer 0x%x do not align to %d.", buff_addr, data_p->blksz);
-            return FSDIF_ERR_DMA_BUF_UNALIGN;
-        }
+            /* set properity of descriptor entry, descriptor list in chain, and set OWN bit */
+            cur_desc->attribute = FSDIF_IDMAC_DES0_CH | FSDIF_IDMAC_DES0_OWN;
+            cur_desc->attribute |= (cur_desc == desc_list->first_desc) ? FSDIF_IDMAC_DES0_FD : 0;
+
+            /* set data length in transfer */
+            cur_desc->non1 = 0U;
+            cur_desc->len = (remain_bytes <= desc_bytes) ? remain_bytes : desc_bytes;
 
 #ifdef __aarch64__
-        cur_desc->addr_hi = UPPER_32_BITS(buff_addr);
-        cur_desc->addr_lo = LOWER_32_BITS(buff_addr);
+            cur_desc->addr_hi = UPPER_32_BITS(buff_addr);
+            cur_desc->addr_lo = LOWER_32_BITS(buff_addr);
 #else
-        cur_desc->addr_hi = 0U;
-        cur_desc->addr_lo = (u32)(buff_addr);
+            cur_desc->addr_hi = 0U;
+            cur_desc->addr_lo = (u32)(buff_addr);
 #endif
 
-        /* set address of next descriptor entry, NULL for last entry */
-        next_desc_addr = is_last ? 0U : next_desc_addr;
-        if (next_desc_addr % sizeof(FSdifIDmaDesc)) /* make sure dma descriptor aligned and not cross page boundary */
-        {
-            FSDIF_ERROR("DMA descriptor 0x%x do not align.", next_desc_addr);
-            return FSDIF_ERR_DMA_BUF_UNALIGN;
-        }
-
+            /* physical addr of next descriptor */
+            next_desc_addr = desc_list->first_desc_dma +
+                             (uintptr)(cur_desc - desc_list->first_desc + 1) * sizeof(FSdifIDmaDesc);
 #ifdef __aarch64__
-        cur_desc->desc_hi = UPPER_32_BITS(next_desc_addr);
-        cur_desc->desc_lo = LOWER_32_BITS(next_desc_addr);
+            cur_desc->desc_hi = UPPER_32_BITS(next_desc_addr);
+            cur_desc->desc_lo = LOWER_32_BITS(next_desc_addr);
 #else
-        cur_desc->desc_hi = 0U;
-        cur_desc->desc_lo = (u32)(next_desc_addr);
+            cur_desc->desc_hi = 0U;
+            cur_desc->desc_lo = (u32)(next_desc_addr);
 #endif
 
-        buff_addr += cur_desc->len;
-        remain_blocks -= trans_blocks;
+            buff_addr += cur_desc->len;
+            remain_bytes -= cur_desc->len;
+            cur_desc++;
+        }
     }
 
+    /* the last entry ends the list, no next descriptor */
+    cur_desc--;
+    cur_desc->attribute |= FSDIF_IDMAC_DES0_LD | FSDIF_IDMAC_DES0_ER;
+    cur_desc->desc_hi = 0U;
+    cur_desc->desc_lo = 0U;
+
     /* flush cache of descripor list and transfer buffer */
     FSDIF_DATA_BARRIER();
 
-    FSdifDumpDMADescriptor(instance_p, desc_num);
+    return FSDIF_SUCCESS;
+}
+
+#ifndef FIO_SCATTERED_DMA
+/**
+ * @name: FSdifSetupDMADescriptor
+ * @msg: setup DMA descriptor list before do transcation
+ * @return {FError} FSDIF_SUCCESS if setup success
+ * @param {FSdif} *instance_p, instance of controller
+ * @param {FSdifData} *data_p, data in transcation
+ */
+FError FSdifSetupDMADescriptor(FSdif *const instance_p, FSdifData *data_p)
+{
+    FASSERT(data_p && data_p->buf);
+    FASSERT(instance_p->desc_list.first_desc);
+    FSdifDMASeg seg;
+    FError ret;
+
+    seg.buf_dma = data_p->buf_dma;
+    seg.len = data_p->datalen;
+
+    FSDIF_DEBUG("DMA transfer 0x%x, total %d desc", data_p->buf_dma, instance_p->desc_list.desc_num);
+
+    ret = FSdifPrepareDMADescriptor(instance_p, &instance_p->desc_list, &seg, 1U, data_p->blksz);
+    if (FSDIF_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    FSdifDumpDMADescriptor(instance_p, (data_p->datalen + instance_p->desc_list.desc_trans_sz - 1U) /
+                                       instance_p->desc_list.desc_trans_sz);
     return FSDIF_SUCCESS;
 }
 #endif
@@ -192,26 +238,27 @@ FError FSdifSetupDMADescriptor(FSdif *const instance_p, FSdifData *data_p)
 static FError FSdifDMATransferData(FSdif *const instance_p, FSdifData *data_p)
 {
     FASSERT(data_p);
-    FASSERT(data_p->buf);
     FError ret = FSDIF_SUCCESS;
     uintptr base_addr = instance_p->config.base_addr;
+    /* use the descriptors prepared for data if any */
+    FSdifIDmaDescList *desc_list = (data_p->desc_list) ? data_p->desc_list : &instance_p->desc_list;
 
     /* enable related interrupt */
     FSdifSetInterruptMask(instance_p, FSDIF_GENERAL_INTR, FSDIF_INTS_DATA_MASK, TRUE);
     FSdifSetInterruptMask(instance_p, FSDIF_IDMA_INTR, FSDIF_DMAC_INTS_MASK, TRUE);
 
-    if ((instance_p->desc_list.first_desc_dma == 0) ||
-        (instance_p->desc_list.first_desc_dma % FSDIF_DMA_DESC_ALIGMENT))
+    if ((desc_list->first_desc_dma == 0) ||
+        (desc_list->first_desc_dma % FSDIF_DMA_DESC_ALIGMENT))
     {
-        FSDIF_ERROR("Invalid descriptor@%p", instance_p->desc_list.first_desc_dma);
+        FSDIF_ERROR("Invalid descriptor@%p", desc_list->first_desc_dma);
         return FSDIF_ERR_DMA_BUF_UNALIGN;
     }
 
     FSDIF_INFO("Descriptor@%p, trans bytes: %d, block size: %d",
-               instance_p->desc_list.first_desc, data_p->datalen, data_p->blksz);
+               desc_list->first_desc, data_p->datalen, data_p->blksz);
 
     /* set transfer info to register */
-    FSdifSetDescriptor(base_addr, instance_p->desc_list.first_desc_dma);
+    FSdifSetDescriptor(base_addr, desc_list->first_desc_dma);
     FSdifSetTransBytes(base_addr, data_p->datalen);
     FSdifSetBlockSize(base_addr, data_p->blksz);
 
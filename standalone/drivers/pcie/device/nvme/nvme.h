@@ -399,19 +399,21 @@ static inline 	void nvme_controller_data_swapbytes(struct nvme_controller_data *
 #define NVME_PCIE_BAR_IDX 0
 
 #define NVME_REQUEST_AMOUNT (CONFIG_NVME_ADMIN_ENTRIES +	\
-			     CONFIG_NVME_IO_ENTRIES)
+			     (CONFIG_NVME_IO_ENTRIES * CONFIG_NVME_IO_QUEUES))
 
 /* admin queue + io queue(s) */
-#define NVME_PCIE_MSIX_VECTORS 1 + CONFIG_NVME_IO_QUEUES
+#define NVME_PCIE_MSIX_VECTORS (1 + CONFIG_NVME_IO_QUEUES)
 
+/* queue alignment, the controller memory page size */
+#define NVME_QUEUE_ALIGN 0x1000
+
+/* cmd and cpl are left NULL, nvme_cmd_qpair_setup() takes them from the
+ * dma coherent memory of the driver port */
 #define NVME_QUEUE_ALLOCATE(name, n_entries)				\
-	static struct nvme_command cmd_##name[n_entries] __aligned(0x1000); \
-	static struct nvme_completion cpl_##name[n_entries] __aligned(0x1000); \
-									\
 	static struct nvme_cmd_qpair name = {				\
 		.num_entries = n_entries,				\
-		.cmd = cmd_##name,					\
-		.cpl = cpl_##name,					\
+		.cmd = NULL,						\
+		.cpl = NULL,						\
 	}
 
 #define NVME_ADMINQ_ALLOCATE(n, n_entries)		\
@@ -419,6 +421,16 @@ static inline 	void nvme_controller_data_swapbytes(struct nvme_controller_data *
 #define NVME_IOQ_ALLOCATE(n, n_entries)			\
 	NVME_QUEUE_ALLOCATE(io_##n, n_entries)
 
+/* one i/o queue pair per core, io_##n is given to nvme_controller.ioq */
+#define NVME_IOQS_ALLOCATE(n, n_entries)				\
+	static struct nvme_cmd_qpair io_##n[CONFIG_NVME_IO_QUEUES] = {	\
+		[0 ... (CONFIG_NVME_IO_QUEUES - 1)] = {			\
+			.num_entries = n_entries,			\
+			.cmd = NULL,					\
+			.cpl = NULL,					\
+		}							\
+	}
+
 struct FNvmeMsixVector
 {
     u32 irq;
@@ -437,6 +449,8 @@ struct nvme_controller {
 	uint32_t id;
 	struct nvme_controller_data cdata;
 
+	/* number of entries in ioq, lowered to what the controller and
+	 * the msi-x vectors allow */
 	uint32_t num_io_queues;
 	struct nvme_cmd_qpair *adminq;
 	struct nvme_cmd_qpair *ioq;
@@ -488,5 +502,8 @@ boolean nvme_controller_has_dataset_mgmt(struct nvme_controller *ctrlr)
 
 int nvme_controller_init(struct nvme_controller *nvme_ctrlr,nvme_msi_x_setup msi_x_setup ,nvme_interrupt_setup interrupt_setup_fun) ;
 
+/* i/o queue pair of the calling core, ioq[cpu id % num_io_queues] */
+struct nvme_cmd_qpair *nvme_controller_get_ioq(struct nvme_controller *nvme_ctrlr);
+
 
 #endif /* NVME_H */
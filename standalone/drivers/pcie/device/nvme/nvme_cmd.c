@@ -144,6 +144,21 @@ static void sys_write32(uint32_t data, uintptr addr)
 	*(uint32_t *)addr = data ;
 }
 
+/* the request pool, the pending list and the sq tail are shared between
+ * the submitting tasks and the completion interrupts of this core */
+static inline u32 nvme_cmd_lock(void)
+{
+	u32 cur = MFCPSR();
+
+	MTCPSR(cur | 0xC0);
+	return cur;
+}
+
+static inline void nvme_cmd_unlock(u32 prev)
+{
+	MTCPSR(prev);
+}
+
 
 static const char *get_status_string(uint16_t sct, uint16_t sc)
 {
@@ -238,6 +253,8 @@ static void nvme_prp_list_free(struct nvme_controller *nvme_ctrlr ,struct nvme_p
 void nvme_cmd_request_free(struct nvme_request *request)
 {
 	struct nvme_controller *nvme_ctrlr = request->qpair->ctrlr ;
+	u32 cur = nvme_cmd_lock();
+
 	if (sys_dnode_is_linked(&request->node)) {
 		sys_dlist_remove(&request->node);
 	}
@@ -248,19 +265,23 @@ void nvme_cmd_request_free(struct nvme_request *request)
 
 	memset(request, 0, sizeof(struct nvme_request));
 	sys_dlist_append(&nvme_ctrlr->free_request, &request->node);
+	nvme_cmd_unlock(cur);
 }
 
 struct nvme_request *nvme_cmd_request_alloc(struct nvme_controller *ctrlr)
 {
 	sys_dnode_t *node;
+	u32 cur = nvme_cmd_lock();
 
 	node = sys_dlist_peek_head(&ctrlr->free_request);
 	if (!node) {
+		nvme_cmd_unlock(cur);
 		NVME_CMD_DEBUG_E("Could not allocate request");
 		return NULL;
 	}
 
 	sys_dlist_remove(node);
+	nvme_cmd_unlock(cur);
 
 	return CONTAINER_OF(node, struct nvme_request, node);
 }
@@ -362,12 +383,22 @@ static void nvme_cmd_request_complete(struct nvme_request *request,
 	}
 
 	if (retry) {
+		nvme_poll_completion_cb cb_fn = request->cb_fn;
+		void *cb_arg = request->cb_arg;
+		u32 cur;
+
 		NVME_CMD_DEBUG_D("Retrying CMD");
 		/* Let's remove it from pending... */
+		cur = nvme_cmd_lock();
 		sys_dlist_remove(&request->node);
-		/* ...and re-submit, thus re-adding to pending */
-		nvme_cmd_qpair_submit_request(request->qpair, request);
+		nvme_cmd_unlock(cur);
 		request->retries++;
+		/* ...and re-submit, thus re-adding to pending, a failed
+		 * submission has freed the request, report the error */
+		if ((nvme_cmd_qpair_submit_request(request->qpair, request) != 0) &&
+		    (cb_fn != NULL)) {
+			cb_fn(cb_arg, cpl);
+		}
 	} else {
 
 		if (request->cb_fn) {
@@ -414,9 +445,17 @@ void nvme_cmd_qpair_process_completion(struct nvme_cmd_qpair *qpair)
 		}
 
 		done++;
-		if (request != NULL) {
+		qpair->sq_head = cpl.sqhd;
+		if ((request != NULL) && (request->qpair == qpair)) {
+			if (request->timed_out) {
+				/* the owner was told at the timeout, only give
+				 * the cid back now that the controller is done */
+				qpair->num_ignored++;
+				NVME_CMD_DEBUG_W("cpl (cid = %u) of a timed-out cmd ignored", cpl.cid);
+			}
 			nvme_cmd_request_complete(request, &cpl);
-			qpair->sq_head = cpl.sqhd;
+		} else if (request != NULL) {
+			NVME_CMD_DEBUG_E("cpl (cid = %u) of a free cmd", cpl.cid);
 		} else {
 			NVME_CMD_DEBUG_E("cpl (cid = %u) does not map to cmd", cpl.cid);
 		}
@@ -449,6 +488,23 @@ int nvme_cmd_qpair_setup(struct nvme_cmd_qpair *qpair,
 	qpair->num_failures = 0;
 	qpair->num_ignored = 0;
 
+	/* queues not given by the caller live in dma coherent memory,
+	 * kept over controller resets */
+	if (qpair->cmd == NULL) {
+		qpair->cmd = FDriverDmaAllocCoherent(qpair->num_entries *
+						     sizeof(struct nvme_command),
+						     NVME_QUEUE_ALIGN);
+	}
+	if (qpair->cpl == NULL) {
+		qpair->cpl = FDriverDmaAllocCoherent(qpair->num_entries *
+						     sizeof(struct nvme_completion),
+						     NVME_QUEUE_ALIGN);
+	}
+	if ((qpair->cmd == NULL) || (qpair->cpl == NULL)) {
+		NVME_CMD_DEBUG_E("CMD Qpair %u queue memory allocate failed", id);
+		return -ENOMEM;
+	}
+
 	qpair->cmd_bus_addr = (uintptr_t)qpair->cmd;
 	qpair->cpl_bus_addr = (uintptr_t)qpair->cpl;
 	/* Submission Queue 0 Tail Doorbell (Admin) */
@@ -593,6 +649,8 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 {
 	uintptr regs = qpair->ctrlr->base;
 	struct nvme_controller *nvme_ctrlr = qpair->ctrlr ;
+	uint32_t sq_tail;
+	u32 cur;
 	int ret;
 
 	request->qpair = qpair;
@@ -600,8 +658,23 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 	request->cmd.cdw0.cid = sys_cpu_to_le16((uint16_t)(request -
 							   nvme_ctrlr->request_pool));
 
+	cur = nvme_cmd_lock();
+
+	/* one entry stays empty to tell a full queue from an empty one */
+	sq_tail = qpair->sq_tail + 1;
+	if (sq_tail == qpair->num_entries) {
+		sq_tail = 0;
+	}
+	if (sq_tail == qpair->sq_head) {
+		nvme_cmd_unlock(cur);
+		NVME_CMD_DEBUG_W("CMD Qpair %u is full", qpair->id);
+		nvme_cmd_request_free(request);
+		return -EBUSY;
+	}
+
 	ret = nvme_cmd_qpair_fill_dptr(qpair, request);
 	if (ret != 0) {
+		nvme_cmd_unlock(cur);
 		nvme_cmd_request_free(request);
 		return ret;
 	}
@@ -611,13 +684,12 @@ int nvme_cmd_qpair_submit_request(struct nvme_cmd_qpair *qpair,
 	memcpy(&qpair->cmd[qpair->sq_tail],
 	       &request->cmd, sizeof(request->cmd));
 
-	qpair->sq_tail++;
-	if (qpair->sq_tail == qpair->num_entries) {
-		qpair->sq_tail = 0;
-	}
+	qpair->sq_tail = sq_tail;
 	sys_write32(qpair->sq_tail, regs + qpair->sq_tdbl_off);
 	qpair->num_cmds++;
 
+	nvme_cmd_unlock(cur);
+
 	return 0;
 }
 
@@ -364,6 +364,8 @@ struct nvme_request {
 	uint32_t			type;
 	uint32_t			req_start;
 	int32_t				retries;
+	/* timed out, the cid stays in use until the controller returns it */
+	bool				timed_out;
 
 	void				*payload;
 	uint32_t			payload_size;
@@ -442,6 +444,10 @@ int nvme_ctrlr_cmd_set_num_queues(struct nvme_controller *ctrlr,
 				  uint32_t num_queues,
 				  nvme_poll_completion_cb cb_fn, void *cb_arg);
 
+int nvme_ctrlr_cmd_abort(struct nvme_controller *ctrlr,
+			 uint16_t sqid, uint16_t cid,
+			 nvme_poll_completion_cb cb_fn, void *cb_arg);
+
 void nvme_cmd_qpair_process_completion(struct nvme_cmd_qpair *qpair) ;
 
 static inline
@@ -527,6 +533,31 @@ void nvme_namespace_read_cmd(struct nvme_command *cmd, uint32_t nsid,
 	nvme_namespace_rw_cmd(cmd, NVME_OPC_READ, nsid, lba, count);
 }
 
+/* dataset management range, see Dataset Management command */
+struct nvme_dsm_range {
+	uint32_t attributes;	/* context attributes */
+	uint32_t length;	/* length in logical blocks */
+	uint64_t starting_lba;	/* starting lba */
+};
+
+/* ranges in one dataset management command */
+#define NVME_DSM_MAX_RANGES		256
+
+/* dword 11 of dataset management */
+#define NVME_DSM_ATTR_INTEGRAL_READ	(1U << 0)
+#define NVME_DSM_ATTR_INTEGRAL_WRITE	(1U << 1)
+#define NVME_DSM_ATTR_DEALLOCATE	(1U << 2)
+
+static inline
+void nvme_namespace_dsm_cmd(struct nvme_command *cmd, uint32_t nsid,
+			    uint32_t num_ranges, uint32_t attributes)
+{
+	cmd->cdw0.opc = NVME_OPC_DATASET_MANAGEMENT;
+	cmd->nsid = sys_cpu_to_le32(nsid);
+	cmd->cdw10 = sys_cpu_to_le32(num_ranges - 1);
+	cmd->cdw11 = sys_cpu_to_le32(attributes);
+}
+
 static inline void nvme_completion_swapbytes(struct nvme_completion *cpl)
 {
 #if _BYTE_ORDER != _LITTLE_ENDIAN
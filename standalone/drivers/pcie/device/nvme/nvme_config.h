@@ -29,14 +29,17 @@
 #define NVME_CONFIG_H
 
 #include "fdebug.h"
+#include "fparameters.h"
 #include <errno.h>
 
 #define CONFIG_NVME_ADMIN_ENTRIES       256
-#define CONFIG_NVME_IO_QUEUES           1
-#define CONFIG_NVME_IO_ENTRIES          16
+/* one i/o queue pair and msi-x vector per core */
+#define CONFIG_NVME_IO_QUEUES           FCORE_NUM
+/* one entry stays empty, the queue depth is CONFIG_NVME_IO_ENTRIES - 1 */
+#define CONFIG_NVME_IO_ENTRIES          32
 #define CONFIG_NVME_RETRY_COUNT         2
 #define CONFIG_NVME_REQUEST_TIMEOUT_SEC 5
-#define CONFIG_NVME_PRP_LIST_AMOUNT     2
+#define CONFIG_NVME_PRP_LIST_AMOUNT     8
 #define CONFIG_NVME_MAX_NAMESPACES      1
 #define CONFIG_NVME_INT_PRIORITY        2
 #define CONFIG_NVME_LOG_LEVEL_DBG
@@ -16,6 +16,7 @@
 #include "nvme_disk.h"
 #include "fdrivers_port.h"
 #include "fpcie_ecam_msix.h"
+#include "fcpu_info.h"
 #include "nvme_intr.h"
 
 #define NVME_DEBUG_TAG "NVME"
@@ -157,8 +158,6 @@ static int nvme_controller_setup_admin_queues(struct nvme_controller *nvme_ctrlr
 
 	uintptr regs = nvme_ctrlr->base;
 	uint32_t aqa, qsize;
-	/* reset admin cmd and completion queue */
-	nvme_cmd_qpair_reset(nvme_ctrlr->adminq);
 
 	/* Admin queue is always id 0 */
 	if (nvme_cmd_qpair_setup(nvme_ctrlr->adminq, nvme_ctrlr, 0) != 0) {
@@ -166,6 +165,9 @@ static int nvme_controller_setup_admin_queues(struct nvme_controller *nvme_ctrlr
 		return -EIO;
 	}
 
+	/* reset admin cmd and completion queue, once they are allocated */
+	nvme_cmd_qpair_reset(nvme_ctrlr->adminq);
+
 	/* set admin submission queue base addr*/
 	nvme_mmio_write_8(regs, asq, nvme_ctrlr->adminq->cmd_bus_addr);
 	NVME_DEBUG_I("Admin Submission Queue set to 0x%lx", nvme_ctrlr->adminq->cmd_bus_addr);
@@ -233,6 +235,10 @@ static int nvme_controller_setup_io_queues(struct nvme_controller *nvme_ctrlr)
 	NVME_DEBUG_I("num_io_queues is %d \r\n",nvme_ctrlr->num_io_queues) ;
 	for (idx = 0; idx < nvme_ctrlr->num_io_queues; idx++) {
 		io_qpair = &nvme_ctrlr->ioq[idx];
+		/* MQES is 0-based */
+		if (io_qpair->num_entries > NVME_CAP_LO_MQES(nvme_ctrlr->cap_lo) + 1) {
+			io_qpair->num_entries = NVME_CAP_LO_MQES(nvme_ctrlr->cap_lo) + 1;
+		}
 		/*  set i/o pair struct */ 
 		if (nvme_cmd_qpair_setup(io_qpair, nvme_ctrlr, idx+1) != 0) {
 			NVME_DEBUG_E("IO cmd qpair %u setup failed", idx+1);
@@ -375,13 +381,21 @@ static int nvme_controller_pcie_configure(struct nvme_controller *nvme_ctrlr)
 		
 		n_vectors = nvme_ctrlr->msi_x_setup(nvme_ctrlr,NVME_PCIE_MSIX_VECTORS,1)  ;
 
-		if( n_vectors != NVME_PCIE_MSIX_VECTORS )
+		/* the admin queue and at least one io queue */
+		if( n_vectors < 2 )
 		{
 			NVME_DEBUG_E("Could not allocate %u MSI-X vectors",
 				NVME_PCIE_MSIX_VECTORS);
 			return -EIO;
 		}
 
+		/* each io queue completes on its own vector */
+		if (nvme_ctrlr->num_io_queues > n_vectors - 1) {
+			NVME_DEBUG_W("Only %u MSI-X vectors, use %u io queues",
+				n_vectors, n_vectors - 1);
+			nvme_ctrlr->num_io_queues = n_vectors - 1;
+		}
+
 
 	return 0;
 }
@@ -442,6 +456,13 @@ int nvme_controller_init(struct nvme_controller *nvme_ctrlr,nvme_msi_x_setup msi
 		return -EINVAL;
 	}
 
+	if ((nvme_ctrlr->num_io_queues == 0) ||
+	    (nvme_ctrlr->num_io_queues > CONFIG_NVME_IO_QUEUES)) {
+		NVME_DEBUG_E("num_io_queues %u out of 1 ~ %u",
+			nvme_ctrlr->num_io_queues, CONFIG_NVME_IO_QUEUES);
+		return -EINVAL;
+	}
+
 	nvme_ctrlr->msi_x_setup = msi_x_setup ;
 	nvme_ctrlr->interrupt_setup_fun = interrupt_setup_fun ;
 
@@ -488,3 +509,13 @@ int nvme_controller_init(struct nvme_controller *nvme_ctrlr,nvme_msi_x_setup msi
 	return 0;
 }
 
+struct nvme_cmd_qpair *nvme_controller_get_ioq(struct nvme_controller *nvme_ctrlr)
+{
+	u32 cpu_id = 0;
+
+	/* each core submits to and completes on its own queue pair, no
+	 * sharing of the sq tail or the cq head between the cores */
+	(void)GetCpuId(&cpu_id);
+
+	return &nvme_ctrlr->ioq[cpu_id % nvme_ctrlr->num_io_queues];
+}
@@ -217,3 +217,22 @@ int nvme_ctrlr_cmd_set_num_queues(struct nvme_controller *ctrlr,
 					  cdw11, 0, 0, 0, 0, NULL, 0,
 					  cb_fn, cb_arg);
 }
+
+int nvme_ctrlr_cmd_abort(struct nvme_controller *ctrlr,
+			 uint16_t sqid, uint16_t cid,
+			 nvme_poll_completion_cb cb_fn, void *cb_arg)
+{
+	struct nvme_request *request;
+	struct nvme_command *cmd;
+
+	request = nvme_allocate_request_null(ctrlr, cb_fn, cb_arg);
+	if (!request) {
+		return -ENOMEM;
+	}
+
+	cmd = &request->cmd;
+	cmd->cdw0.opc = NVME_OPC_ABORT;
+	cmd->cdw10 = sys_cpu_to_le32(((uint32_t)cid << 16) | sqid);
+
+	return nvme_cmd_qpair_submit_request(ctrlr->adminq, request);
+}
@@ -11,6 +11,7 @@
 #include "nvme_intr.h"
 
 #include "fdrivers_port.h"
+#include "fperf_stat.h"
 #define NVME_DISK_DEBUG_TAG "NVME_DISK"
 #define NVME_DISK_DEBUG_I(format, ...) FT_DEBUG_PRINT_I(NVME_DISK_DEBUG_TAG, format, ##__VA_ARGS__)
 #define NVME_DISK_DEBUG_W(format, ...) FT_DEBUG_PRINT_W(NVME_DISK_DEBUG_TAG, format, ##__VA_ARGS__)
@@ -18,24 +19,88 @@
 #define NVME_DISK_DEBUG_D(format, ...) FT_DEBUG_PRINT_D(NVME_DISK_DEBUG_TAG, format, ##__VA_ARGS__)
 
 
-static inline void nvme_lock(struct disk_info *disk)
+int nvme_disk_status(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int nvme_disk_submit_rw(struct disk_info *disk, uint32_t rwcmd,
+			       void *data_buf,
+			       uint64_t start_sector,
+			       uint32_t num_sector,
+			       nvme_poll_completion_cb cb_fn,
+			       void *cb_arg)
 {
+	struct nvme_namespace *ns = CONTAINER_OF(disk->name,
+						 struct nvme_namespace, name[0]);
+	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
+	struct nvme_request *request;
+	uint32_t payload_size;
+
+	if (!NVME_IS_BUFFER_DWORD_ALIGNED(data_buf)) {
+		NVME_DISK_DEBUG_W("Data buffer pointer needs to be 4-bytes aligned");
+		return -EINVAL;
+	}
+
+	payload_size = num_sector * nvme_namespace_get_sector_size(ns);
+	request = nvme_allocate_request_vaddr(nvme_ctrlr, data_buf, payload_size,
+					      cb_fn, cb_arg);
+	if (request == NULL) {
+		return -ENOMEM;
+	}
+
+	nvme_namespace_rw_cmd(&request->cmd, rwcmd, ns->id,
+			      start_sector, num_sector);
 
+	/* the queue pair of this core, the request is freed on failure */
+	return nvme_cmd_qpair_submit_request(nvme_controller_get_ioq(nvme_ctrlr),
+					     request);
 }
 
-static inline void nvme_unlock(struct disk_info *disk)
+int nvme_disk_read_async(struct disk_info *disk,
+			 uint8_t *data_buf,
+			 uint64_t start_sector,
+			 uint32_t num_sector,
+			 nvme_poll_completion_cb cb_fn,
+			 void *cb_arg)
 {
+	return nvme_disk_submit_rw(disk, NVME_OPC_READ, data_buf,
+				   start_sector, num_sector, cb_fn, cb_arg);
+}
 
+int nvme_disk_write_async(struct disk_info *disk,
+			  const uint8_t *data_buf,
+			  uint64_t start_sector,
+			  uint32_t num_sector,
+			  nvme_poll_completion_cb cb_fn,
+			  void *cb_arg)
+{
+	return nvme_disk_submit_rw(disk, NVME_OPC_WRITE, (void *)data_buf,
+				   start_sector, num_sector, cb_fn, cb_arg);
 }
 
-int nvme_disk_status(struct disk_info *disk)
+int nvme_disk_flush_async(struct disk_info *disk,
+			  nvme_poll_completion_cb cb_fn,
+			  void *cb_arg)
 {
-	return 0;
+	struct nvme_namespace *ns = (struct nvme_namespace *)disk->ns;
+	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
+	struct nvme_request *request;
+
+	request = nvme_allocate_request_null(nvme_ctrlr, cb_fn, cb_arg);
+	if (request == NULL) {
+		return -ENOMEM;
+	}
+
+	nvme_namespace_flush_cmd(&request->cmd, ns->id);
+
+	return nvme_cmd_qpair_submit_request(nvme_controller_get_ioq(nvme_ctrlr),
+					     request);
 }
 
 int nvme_disk_read(struct disk_info *disk,
 			  uint8_t *data_buf,
-			  uint32_t start_sector,
+			  uint64_t start_sector,
 			  uint32_t num_sector)
 {
 	struct nvme_namespace *ns = CONTAINER_OF(disk->name,
@@ -44,48 +109,31 @@ int nvme_disk_read(struct disk_info *disk,
 	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
 	struct nvme_completion_poll_status status =
 		NVME_CPL_STATUS_POLL_INIT(status,nvme_ctrlr);
-	struct nvme_request *request;
-	uint32_t payload_size;
-	int ret = 0;
-
-	if (!NVME_IS_BUFFER_DWORD_ALIGNED(data_buf)) {
-		NVME_DISK_DEBUG_W("Data buffer pointer needs to be 4-bytes aligned");
-		return -EINVAL;
-	}
+	int ret;
 
-	nvme_lock(disk);
+	FPERF_STAT_BEGIN(nvme_disk_read);
 
-	payload_size = num_sector * nvme_namespace_get_sector_size(ns);
-	request = nvme_allocate_request_vaddr(nvme_ctrlr,(void *)data_buf, payload_size,
-					      nvme_completion_poll_cb, &status);
-	if (request == NULL) {
-		ret = -ENOMEM;
+	ret = nvme_disk_read_async(disk, data_buf, start_sector, num_sector,
+				   nvme_completion_poll_cb, &status);
+	if (ret != 0) {
 		goto out;
 	}
 
-	nvme_namespace_read_cmd(&request->cmd, ns->id,
-				start_sector, num_sector);
-
-	/* We use only the first ioq atm
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
-
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
-		NVME_DISK_DEBUG_W("Reading at sector %u (count %d) on disk %s failed",
+		NVME_DISK_DEBUG_W("Reading at sector %llu (count %d) on disk %s failed",
 			start_sector, num_sector, ns->name);
 		nvme_completion_print(&status.cpl);
 		ret = -EIO;
 	}
 out:
-	nvme_unlock(disk);
+	FPERF_STAT_END(nvme_disk_read);
 	return ret;
 }
 
 int nvme_disk_write(struct disk_info *disk,
 			   const uint8_t *data_buf,
-			   uint32_t start_sector,
+			   uint64_t start_sector,
 			   uint32_t num_sector)
 {
 	struct nvme_namespace *ns = CONTAINER_OF(disk->name,
@@ -93,43 +141,22 @@ int nvme_disk_write(struct disk_info *disk,
 	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
 	struct nvme_completion_poll_status status =
 		NVME_CPL_STATUS_POLL_INIT(status,nvme_ctrlr);
-	struct nvme_request *request;
-	uint32_t payload_size;
-	int ret = 0;
-
-	if (!NVME_IS_BUFFER_DWORD_ALIGNED(data_buf)) {
-		NVME_DISK_DEBUG_W("Data buffer pointer needs to be 4-bytes aligned");
-		return -EINVAL;
-	}
-
-	nvme_lock(disk);
-
-	payload_size = num_sector * nvme_namespace_get_sector_size(ns);
+	int ret;
 
-	request = nvme_allocate_request_vaddr(nvme_ctrlr,(void *)data_buf, payload_size,
-					      nvme_completion_poll_cb, &status);
-	if (request == NULL) {
-		ret = -ENOMEM;
-		goto out;
+	ret = nvme_disk_write_async(disk, data_buf, start_sector, num_sector,
+				    nvme_completion_poll_cb, &status);
+	if (ret != 0) {
+		return ret;
 	}
 
-	nvme_namespace_write_cmd(&request->cmd, ns->id,
-				 start_sector, num_sector);
-
-	/* We use only the first ioq atm
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
-
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
-		NVME_DISK_DEBUG_W("Writing at sector %u (count %d) on disk %s failed",
+		NVME_DISK_DEBUG_W("Writing at sector %llu (count %d) on disk %s failed",
 			start_sector, num_sector, ns->name);
 		nvme_completion_print(&status.cpl);
 		ret = -EIO;
 	}
-out:
-	nvme_unlock(disk);
+
 	return ret;
 }
 
@@ -140,20 +167,13 @@ int nvme_disk_flush(struct disk_info *disk)
 	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
 	struct nvme_completion_poll_status status =
 		NVME_CPL_STATUS_POLL_INIT(status,nvme_ctrlr);
-	struct nvme_request *request;
+	int ret;
 
-	request = nvme_allocate_request_null(nvme_ctrlr,nvme_completion_poll_cb, &status);
-	if (request == NULL) {
-		return -ENOMEM;
+	ret = nvme_disk_flush_async(disk, nvme_completion_poll_cb, &status);
+	if (ret != 0) {
+		return ret;
 	}
 
-	nvme_namespace_flush_cmd(&request->cmd, ns->id);
-
-	/* We use only the first ioq
-	 * ToDo: use smp cpu id and use it to select ioq
-	 */
-	nvme_cmd_qpair_submit_request(ns->ctrlr->ioq, request);
-
 	nvme_completion_poll(&status);
 	if (nvme_cpl_status_is_error(&status)) {
 		NVME_DISK_DEBUG_E("Flushing disk %s failed", ns->name);
@@ -164,14 +184,81 @@ int nvme_disk_flush(struct disk_info *disk)
 	return 0;
 }
 
+int nvme_disk_trim(struct disk_info *disk,
+		   uint64_t start_sector,
+		   uint64_t num_sector)
+{
+	struct nvme_namespace *ns = (struct nvme_namespace *)disk->ns;
+	struct nvme_controller *nvme_ctrlr = ns->ctrlr;
+	struct nvme_dsm_range ranges[NVME_DISK_TRIM_RANGES]
+		__aligned(sizeof(struct nvme_dsm_range) * NVME_DISK_TRIM_RANGES);
+	struct nvme_request *request;
+	uint32_t num_ranges;
+	uint32_t len;
+	int ret;
+
+	if (!(ns->flags & NVME_NS_DEALLOCATE_SUPPORTED)) {
+		return -ENOTSUP;
+	}
+
+	if ((start_sector + num_sector < start_sector) ||
+	    (start_sector + num_sector > nvme_namespace_get_num_sectors(ns))) {
+		return -EINVAL;
+	}
+
+	while (num_sector > 0) {
+		struct nvme_completion_poll_status status =
+			NVME_CPL_STATUS_POLL_INIT(status, nvme_ctrlr);
+
+		for (num_ranges = 0;
+		     (num_ranges < NVME_DISK_TRIM_RANGES) && (num_sector > 0);
+		     num_ranges++) {
+			len = (num_sector > UINT32_MAX) ? UINT32_MAX :
+				(uint32_t)num_sector;
+			ranges[num_ranges].attributes = 0;
+			ranges[num_ranges].length = sys_cpu_to_le32(len);
+			ranges[num_ranges].starting_lba =
+				sys_cpu_to_le64(start_sector);
+			start_sector += len;
+			num_sector -= len;
+		}
+
+		/* the controller fetches the ranges from memory */
+		FDriverDCacheRangeFlush((uintptr_t)ranges, sizeof(ranges));
+
+		request = nvme_allocate_request_vaddr(nvme_ctrlr, ranges,
+				num_ranges * sizeof(struct nvme_dsm_range),
+				nvme_completion_poll_cb, &status);
+		if (request == NULL) {
+			return -ENOMEM;
+		}
+
+		nvme_namespace_dsm_cmd(&request->cmd, ns->id, num_ranges,
+				       NVME_DSM_ATTR_DEALLOCATE);
+
+		ret = nvme_cmd_qpair_submit_request(
+			nvme_controller_get_ioq(nvme_ctrlr), request);
+		if (ret != 0) {
+			return ret;
+		}
+
+		nvme_completion_poll(&status);
+		if (nvme_cpl_status_is_error(&status)) {
+			NVME_DISK_DEBUG_E("Deallocating disk %s failed", ns->name);
+			nvme_completion_print(&status.cpl);
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
 int nvme_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 {
 	struct nvme_namespace *ns = CONTAINER_OF(disk->name,
 						 struct nvme_namespace, name[0]);
 	int ret = 0;
 
-	nvme_lock(disk);
-
 	switch (cmd) {
 	case DISK_IOCTL_GET_SECTOR_COUNT:
 		if (!buff) {
@@ -211,7 +298,6 @@ int nvme_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 		ret = -EINVAL;
 	}
 
-	nvme_unlock(disk);
 	return ret;
 }
 
@@ -32,6 +32,7 @@
 #define NVME_DISH_H
 
 #include "dlist.h"
+#include "nvme_cmd.h"
 
 /**
  * @brief Possible Cmd Codes for disk_ioctl()
@@ -98,7 +99,7 @@ struct disk_info {
 int nvme_disk_init(struct disk_info *disk,void *ns) ;
 int nvme_disk_read(struct disk_info *disk,
 			  uint8_t *data_buf,
-			  uint32_t start_sector,
+			  uint64_t start_sector,
 			  uint32_t num_sector) ;
 
 int nvme_disk_status(struct disk_info *disk) ;
@@ -106,8 +107,48 @@ int nvme_disk_flush(struct disk_info *disk) ;
 int nvme_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff) ;
 int nvme_disk_write(struct disk_info *disk,
 			   const uint8_t *data_buf,
-			   uint32_t start_sector,
+			   uint64_t start_sector,
 			   uint32_t num_sector) ;
 
+/**
+ * @brief Deallocate num_sector sectors from start_sector
+ *
+ * Dataset Management with the deallocate attribute, up to
+ * NVME_DISK_TRIM_RANGES ranges per command. Returns -ENOTSUP when the
+ * controller has no Dataset Management support.
+ */
+#define NVME_DISK_TRIM_RANGES 16
+
+int nvme_disk_trim(struct disk_info *disk,
+		   uint64_t start_sector,
+		   uint64_t num_sector);
+
+/**
+ * @brief Asynchronous i/o
+ *
+ * The request goes to the i/o queue pair of the calling core and the call
+ * returns once the doorbell is written. cb_fn runs from the completion
+ * interrupt of that queue with the completion entry, or with NULL when the
+ * request timed out. Up to CONFIG_NVME_IO_ENTRIES - 1 requests can be in
+ * flight per queue, -EBUSY is returned when the queue is full. On any error
+ * return cb_fn is not called.
+ */
+int nvme_disk_read_async(struct disk_info *disk,
+			 uint8_t *data_buf,
+			 uint64_t start_sector,
+			 uint32_t num_sector,
+			 nvme_poll_completion_cb cb_fn,
+			 void *cb_arg);
+
+int nvme_disk_write_async(struct disk_info *disk,
+			  const uint8_t *data_buf,
+			  uint64_t start_sector,
+			  uint32_t num_sector,
+			  nvme_poll_completion_cb cb_fn,
+			  void *cb_arg);
+
+int nvme_disk_flush_async(struct disk_info *disk,
+			  nvme_poll_completion_cb cb_fn,
+			  void *cb_arg);
 
 #endif // !
\ No newline at end of file
@@ -23,6 +23,7 @@
  *  Ver      Who        Date               Changes
  * -----  ----------  --------  ---------------------------------
  * v1.0    huanghe		2025-07-22	First Release
+ * v1.1    phytium		2026-10-19	abort a timed-out request and keep its cid until it completes
  */
 
 
@@ -69,6 +70,7 @@ int request_timeout(struct nvme_controller *ctrlr)
 {
     u32 current = TICKS_TO_SECONDS();
     struct nvme_request *request, *next;
+    int ret = 0;
 
     SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ctrlr->pending_request, request, next, node)
     {
@@ -95,9 +97,40 @@ int request_timeout(struct nvme_controller *ctrlr)
         {
             request->cb_fn(request->cb_arg, NULL);
         }
-        return -1;
+
+        /* the controller still owns the cid and may still move the payload,
+           so the request is not freed here: it leaves the pending list, is
+           not retried or reported again, and is freed by its completion,
+           which the abort below asks the controller for */
+        sys_dlist_remove(&request->node);
+        request->cb_fn = NULL;
+        request->cb_arg = NULL;
+        request->retries = CONFIG_NVME_RETRY_COUNT;
+        request->timed_out = true;
+
+        if ((request->qpair == ctrlr->adminq) &&
+            (request->cmd.cdw0.opc == NVME_OPC_ABORT))
+        {
+            /* an abort is not aborted, its cid stays in use */
+            NVME_INTR_DEBUG_E("Abort CID %u timed-out", request->cmd.cdw0.cid);
+        }
+        else if (nvme_ctrlr_cmd_abort(ctrlr, request->qpair->id,
+                                      request->cmd.cdw0.cid, NULL, NULL) != 0)
+        {
+            NVME_INTR_DEBUG_E("Abort of CID %u failed", request->cmd.cdw0.cid);
+        }
+        ret = -1;
     }
-    return 0;
+    return ret;
+}
+
+void nvme_completion_check_timeout(struct nvme_controller *ctrlr)
+{
+    u32 cur;
+
+    cur = nvme_arch_protect();
+    (void)request_timeout(ctrlr);
+    nvme_arch_unprotect(cur);
 }
 
 void nvme_completion_poll(struct nvme_completion_poll_status *status)
@@ -107,12 +140,8 @@ void nvme_completion_poll(struct nvme_completion_poll_status *status)
     while (status->finish_flg == NVME_REQUEST_IS_NOT_FINSH)
     {
         cur = nvme_arch_protect();
-        /* 检查当前注册的pending request 是否被超时 */
-        if (request_timeout(ctrlr) == -1)
-        {
-            nvme_arch_unprotect(cur);
-            break;
-        }
+        /* 检查当前注册的pending request 是否被超时, 超时的request通过回调结束等待 */
+        (void)request_timeout(ctrlr);
         nvme_arch_unprotect(cur);
     }
     status->finish_flg = NVME_REQUEST_IS_NOT_FINSH;
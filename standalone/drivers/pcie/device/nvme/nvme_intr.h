@@ -58,6 +58,7 @@ typedef void (*nvme_timeout_cb)(void *args);
 void nvme_cpl_status_poll_init(struct nvme_controller *ctrlr,
                                struct nvme_completion_poll_status *status);
 void nvme_completion_poll(struct nvme_completion_poll_status *status);
+void nvme_completion_check_timeout(struct nvme_controller *ctrlr);
 void nvme_completion_poll_cb(void *arg, const struct nvme_completion *cpl);
 bool nvme_cpl_status_is_error(struct nvme_completion_poll_status *status);
 void nvme_cmd_qpair_msi_handler(s32 vector, void *arg);
@@ -24,6 +24,8 @@
  * -----  ----------  --------  ---------------------------------
  * 1.0     huanghe    2023/10/17    first release
  */
+#include <malloc.h>
+#include <stdlib.h>
 #include "fdrivers_port.h"
 
 #include "fcache.h"
@@ -49,6 +51,19 @@ void FDriverICacheRangeInvalidate(void)
 }
 
 
+/* dma memory */
+
+void *FDriverDmaAllocCoherent(size_t size, size_t align)
+{
+    /* no pool here, cacheable heap memory aligned as asked */
+    return memalign(align, size);
+}
+
+void FDriverDmaFreeCoherent(void *ptr)
+{
+    free(ptr);
+}
+
 /* time delay */
 
 void FDriverUdelay(u32 usec)
@@ -26,6 +26,8 @@
  * 1.1   wangxiaodong  2022/9/9     improve functions
  * 1.2   wangxiaodong  2022/10/21   improve functions
  * 1.3   zhangyan      2023/8/14    improve functions
+ * 1.4   phytium       2026/10/19   multiple command slots, ncq and async read write
+ * 1.5   phytium       2026/10/19   ncq error log recovery, comreset and reissue of the commands which did not fail
  */
 
 #include <string.h>
@@ -66,6 +68,9 @@
 #define WAIT_MS_DATAIO    20000
 #define WAIT_MS_LINKUP    200
 
+/* times a slot is reissued when a recovery can not tell which command failed */
+#define FSATA_AHCI_RETRY_NUM 3
+
 #define SATA_ALIGNED_BYTE 4
 
 static FError FSataAhciDataIO(FSataCtrl *instance_p, u8 port, u8 *fis, int fis_len,
@@ -434,6 +439,19 @@ FError FSataAhciReadInfo(FSataCtrl *instance_p, u8 port)
     instance_p->port[port].dev_info.blksz = blksz;
     instance_p->port[port].dev_info.if_type = FSATA_IF_TYPE_SCSI;
 
+    /* ncq needs both the hba and the device, queue depth is limited by the command slots,
+       and a slot has to be left for reading the ncq error log */
+    instance_p->port[port].ncq_depth = 0;
+    if ((instance_p->port[port].log_tag >= instance_p->port[port].slot_num) &&
+        (FSATA_READ_REG32(instance_p->config.base_addr, FSATA_HOST_CAP) & FSATA_HOST_CAP_SNCQ) &&
+        (idbuf[FSATA_ID_SATA_CAP] & FSATA_ID_SATA_CAP_NCQ))
+    {
+        instance_p->port[port].ncq_depth = min(instance_p->port[port].slot_num,
+                                               (u32)(idbuf[FSATA_ID_QUEUE_DEPTH] & 0x1f) + 1);
+    }
+    FSATA_DEBUG("Port %d command slots %d, ncq depth %d.", port,
+                instance_p->port[port].slot_num, instance_p->port[port].ncq_depth);
+
     FSataInfoPrint(&(instance_p->port[port].dev_info));
 
     return ret;
@@ -637,6 +655,8 @@ FError FSataAhciPortStart(FSataCtrl *instance_p, u8 port, uintptr mem)
     }
 
     memset((void *)mem, 0, FSATA_AHCI_PORT_PRIV_DMA_SZ);
+    /* write back once, later only the command header and table of the issued slot are flushed */
+    FDriverDCacheRangeFlush((uintptr)mem, FSATA_AHCI_PORT_PRIV_DMA_SZ);
 
     /* First item in chunk of DMA memory: 32 command lists, 32 bytes each in size */
     port_info->cmd_list = (FSataAhciCommandList *)(mem);
@@ -646,13 +666,29 @@ FError FSataAhciPortStart(FSataCtrl *instance_p, u8 port, uintptr mem)
     port_info->rx_fis = (FSataAhciRecvFis *)(mem);
     mem += FSATA_AHCI_RX_FIS_SZ;
 
-    /* Third item: data area for storing a single command and its scatter-gather table */
+    /* Third item: data area for storing one command and its scatter-gather table per slot */
     port_info->cmd_tbl_base_addr = (uintptr)mem;
     mem += FSATA_AHCI_CMD_TABLE_HEADER_SIZE;
 
-    /* command table prdt */
+    /* command table prdt of slot 0 */
     port_info->cmd_tbl_prdt = (FSataAhciCommandTablePrdt *)mem;
 
+    /* usable command slots, cap.ncs is the number of slots the hba supports minus one,
+       the last one is kept for the ncq error log and never allocated */
+    reg_val = FSATA_READ_REG32(instance_p->config.base_addr, FSATA_HOST_CAP);
+    port_info->slot_num = min((u32)FSATA_AHCI_CMD_SLOT_NUM,
+                              (u32)((reg_val & FSATA_HOST_CAP_NCS_MASK) >> FSATA_HOST_CAP_NCS_SHIFT) + 1);
+    port_info->log_tag = port_info->slot_num - 1;
+    if (port_info->slot_num > 1)
+    {
+        port_info->slot_num--;
+    }
+    port_info->ncq_depth = 0;
+    port_info->slot_busy = 0;
+    port_info->slot_issued = 0;
+    port_info->slot_ncq = 0;
+    memset(port_info->slot, 0, sizeof(port_info->slot));
+
     /* set ahci port registers */
     FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_LST_ADDR,
                       (u32)((uintptr)port_info->cmd_list & FSATA_PORT_CMD_LIST_ADDR_MASK));
@@ -685,27 +721,91 @@ FError FSataAhciPortStart(FSataCtrl *instance_p, u8 port, uintptr mem)
     return ret;
 }
 
+/**
+ * @name: FSataLock
+ * @msg: mask irq, the slot bitmaps of a port are shared between the issuing task and FSataIrqHandler
+ * @return {u32} previous irq mask state
+ */
+static inline u32 FSataLock(void)
+{
+    u32 cur = MFCPSR();
+
+    MTCPSR(cur | 0xC0);
+    return cur;
+}
+
+/**
+ * @name: FSataUnlock
+ * @msg: restore irq mask state
+ * @param {u32} prev, irq mask state returned by FSataLock
+ * @return {void}
+ */
+static inline void FSataUnlock(u32 prev)
+{
+    MTCPSR(prev);
+}
+
+/**
+ * @name: FSataAhciSlotAlloc
+ * @msg: allocate a free command slot of port
+ * @param {FSataAhciPorts} *port_info, pointer to the port
+ * @param {u32} *tag, allocated slot number
+ * @return {FError} return FSATA_SUCCESS if successful, return FSATA_ERR_BUSY if all slots are used
+ */
+static FError FSataAhciSlotAlloc(FSataAhciPorts *port_info, u32 *tag)
+{
+    FError ret = FSATA_ERR_BUSY;
+    u32 i;
+    u32 flags = FSataLock();
+
+    for (i = 0; i < port_info->slot_num; i++)
+    {
+        if (!(port_info->slot_busy & BIT(i)))
+        {
+            port_info->slot_busy |= BIT(i);
+            *tag = i;
+            ret = FSATA_SUCCESS;
+            break;
+        }
+    }
+
+    FSataUnlock(flags);
+    return ret;
+}
+
+/**
+ * @name: FSataAhciSlotFree
+ * @msg: release a command slot of port
+ * @param {FSataAhciPorts} *port_info, pointer to the port
+ * @param {u32} tag, slot number
+ * @return {void}
+ */
+static void FSataAhciSlotFree(FSataAhciPorts *port_info, u32 tag)
+{
+    u32 flags = FSataLock();
+
+    port_info->slot_busy &= ~BIT(tag);
+
+    FSataUnlock(flags);
+}
+
 /**
  * @name: FSataAhciFillCmdTablePrdt
  * @msg: allocate ahci command table prdt information
- * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
- * @param {u8} port, port number
+ * @param {FSataAhciCommandTablePrdt} *command_table_prdt, prdt of the slot's command table
  * @param {unsigned char} *buffer, data buffer address
  * @param {int} buf_len, data length
  * @return {int} return item_count if successful, return -1 if failed
  */
-static int FSataAhciFillCmdTablePrdt(FSataCtrl *instance_p, u8 port, unsigned char *buf, int buf_len)
+static int FSataAhciFillCmdTablePrdt(FSataAhciCommandTablePrdt *command_table_prdt,
+                                     unsigned char *buf, int buf_len)
 {
-    FASSERT(instance_p != NULL);
-    FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
     if (!IS_ALIGNED((unsigned long)buf, SATA_ALIGNED_BYTE))
     {
         FSATA_ERROR("Sata do not suopport unaligned address access.");
         return -1;
     }
 
-    FSataAhciPorts *port_info = &(instance_p->port[port]);
-    FSataAhciCommandTablePrdt *command_table_prdt = port_info->cmd_tbl_prdt;
     int item_count;
     int i;
     item_count = ((buf_len - 1) / MAX_DATA_BYTE_COUNT) + 1;
@@ -736,25 +836,668 @@ static int FSataAhciFillCmdTablePrdt(FSataCtrl *instance_p, u8 port, unsigned ch
 /**
  * @name: FSataAhciFillCmdList
  * @msg: allocate ahci command list information
- * @param {FSataAhciPorts} *port_info is a pointer to the FSataAhciPorts instance
+ * @param {FSataAhciCommandList} *cmd_list, command header of the slot
+ * @param {uintptr} cmd_tbl, command table address of the slot
  * @param {u32} description_info, prdtl+flag+cfl
  * @return {void}
  */
-static void FSataAhciFillCmdList(FSataAhciPorts *port_info, u32 description_info)
+static void FSataAhciFillCmdList(FSataAhciCommandList *cmd_list, uintptr cmd_tbl, u32 description_info)
 {
-    FASSERT(port_info != NULL);
+    FASSERT(cmd_list != NULL);
 
-    port_info->cmd_list->description_info = description_info;
-    port_info->cmd_list->status = 0;
-    port_info->cmd_list->tbl_addr = ((u32)(port_info->cmd_tbl_base_addr & FSATA_PORT_CMD_TABLE_ADDR_MASK));
+    cmd_list->description_info = description_info;
+    cmd_list->status = 0;
+    cmd_list->tbl_addr = ((u32)(cmd_tbl & FSATA_PORT_CMD_TABLE_ADDR_MASK));
 #ifdef __aarch64__
-    port_info->cmd_list->tbl_addr_hi = (u32)((port_info->cmd_tbl_base_addr) >> 32);
+    cmd_list->tbl_addr_hi = (u32)(cmd_tbl >> 32);
 #endif
 }
 
+/**
+ * @name: FSataAhciFillSlot
+ * @msg: fill the command table and header of slot tag and write them back for the hba
+ * @param {FSataAhciPorts} *port_info, pointer to the port
+ * @param {u32} tag, slot number
+ * @param {u8} *fis, command fis buffer
+ * @param {int} fis_len, command fis length
+ * @param {u8} *buf, data read/write buffer
+ * @param {int} buf_len, data length
+ * @param {boolean} is_write, FALSE-read, TRUE-write
+ * @return {FError} return FSATA_SUCCESS if successful, return others if failed
+ */
+static FError FSataAhciFillSlot(FSataAhciPorts *port_info, u32 tag, u8 *fis, int fis_len,
+                                u8 *buf, int buf_len, boolean is_write)
+{
+    uintptr cmd_tbl = port_info->cmd_tbl_base_addr + tag * FSATA_AHCI_CMD_TABLE_SIZE;
+    FSataAhciCommandList *cmd_list = port_info->cmd_list + tag;
+
+    /* copy fis command to command table CFIS */
+    memcpy((void *)cmd_tbl, fis, fis_len);
+
+    /* copy data buffer address to command table prdt item */
+    int prdt_length = FSataAhciFillCmdTablePrdt((FSataAhciCommandTablePrdt *)(cmd_tbl + FSATA_AHCI_CMD_TABLE_HEADER_SIZE),
+                                                buf, buf_len);
+    if (prdt_length == -1)
+    {
+        FSATA_ERROR("FSataAhciFillCmdTablePrdt failed, buf_len = %d.\n", buf_len);
+        return FSATA_ERR_INVALID_PARAMETER;
+    }
+
+    /* command list DW0: PRDTL(buf len) + W/R + CFL(fis len, 4 Byte(Dword) aligned) */
+    u32 description_info = (prdt_length << 16) | (is_write << 6) | (fis_len >> 2);
+
+    /* copy data to command list struct */
+    FSataAhciFillCmdList(cmd_list, cmd_tbl, description_info);
+
+    FDriverDCacheRangeFlush((unsigned long)cmd_list, FSATA_AHCI_CMD_LIST_HEADER_SIZE);
+    FDriverDCacheRangeFlush((unsigned long)cmd_tbl,
+                            FSATA_AHCI_CMD_TABLE_HEADER_SIZE + prdt_length * FSATA_AHCI_PRTD_ITEM_SIZE);
+    FDriverDCacheRangeFlush((unsigned long)buf, (unsigned long)buf_len);
+
+    return FSATA_SUCCESS;
+}
+
+/**
+ * @name: FSataAhciIssue
+ * @msg: fill the command table and header of slot tag, then issue it to the hba
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port number
+ * @param {u32} tag, allocated slot number, also the ncq tag
+ * @param {u8} *fis, command fis buffer
+ * @param {int} fis_len, command fis length
+ * @param {u8} *buf, data read/write buffer
+ * @param {int} buf_len, data length
+ * @param {boolean} is_ncq, FALSE-normal command, TRUE-first party dma command
+ * @param {boolean} is_write, FALSE-read, TRUE-write
+ * @param {FSataDoneCallBack} done_cb, called when the slot completes
+ * @param {void} *done_args, argument of done_cb
+ * @return {FError} return FSATA_SUCCESS if successful, return others if failed
+ * @note: the caller keeps the slot if this fails
+ */
+static FError FSataAhciIssue(FSataCtrl *instance_p, u8 port, u32 tag, u8 *fis, int fis_len,
+                             u8 *buf, int buf_len, boolean is_ncq, boolean is_write,
+                             FSataDoneCallBack done_cb, void *done_args)
+{
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    uintptr port_base_addr = port_info->port_base_addr;
+    FSataAhciSlot *slot = &port_info->slot[tag];
+    FError ret = FSATA_SUCCESS;
+    u32 flags;
+
+    u32 reg_val = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_STAT);
+    if ((reg_val & FSATA_PORT_SCR_STAT_DET_MASK) != FSATA_PORT_SCR_STAT_DET_PHYRDY)
+    {
+        FSATA_ERROR("No Link on host %d port %d!", instance_p->config.instance_id, port);
+        return FSATA_ERR_OPERATION;
+    }
+
+    ret = FSataAhciFillSlot(port_info, tag, fis, fis_len, buf, buf_len, is_write);
+    if (ret != FSATA_SUCCESS)
+    {
+        return ret;
+    }
+
+    slot->done_cb = done_cb;
+    slot->done_args = done_args;
+    slot->buf = buf;
+    slot->buf_len = (u32)buf_len;
+    slot->is_write = is_write;
+    slot->retries = 0;
+
+    flags = FSataLock();
+
+    /* normal commands run alone, ncq commands only queue behind other ncq commands */
+    if ((port_info->slot_issued & ~port_info->slot_ncq) ||
+        ((is_ncq == FALSE) && port_info->slot_issued))
+    {
+        ret = FSATA_ERR_BUSY;
+    }
+    else
+    {
+        port_info->slot_issued |= BIT(tag);
+        if (is_ncq == TRUE)
+        {
+            port_info->slot_ncq |= BIT(tag);
+
+            /* set tag bit in SACT register before write CI register when use native cmd */
+            FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_ACT, BIT(tag));
+        }
+
+        /* send cmd */
+        FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE, BIT(tag));
+    }
+
+    FSataUnlock(flags);
+
+    return ret;
+}
+
+/**
+ * @name: FSataAhciPortStop
+ * @msg: stop the port command engine, SActive and CI are cleared by hardware when it stops
+ * @param {uintptr} port_base_addr, port base address
+ * @return {void}
+ */
+static void FSataAhciPortStop(uintptr port_base_addr)
+{
+    FSATA_CLEARBIT(port_base_addr, FSATA_PORT_CMD, FSATA_PORT_CMD_START);
+    if (FSataWaitCmdCompleted(port_base_addr + FSATA_PORT_CMD, WAIT_MS_RESET, FSATA_PORT_CMD_LIST_ON))
+    {
+        FSATA_ERROR("Port command engine does not stop.");
+    }
+}
+
+/**
+ * @name: FSataAhciPortClearError
+ * @msg: clear the SError and the error irq status of port
+ * @param {uintptr} port_base_addr, port base address
+ * @return {void}
+ */
+static void FSataAhciPortClearError(uintptr port_base_addr)
+{
+    u32 reg_val;
+
+    reg_val = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_ERR);
+    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_ERR, reg_val);
+    reg_val = FSATA_READ_REG32(port_base_addr, FSATA_PORT_IRQ_STAT);
+    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_IRQ_STAT, reg_val & FSATA_PORT_IRQ_ERROR);
+}
+
+/**
+ * @name: FSataAhciPortComReset
+ * @msg: reset the device through SControl.DET, it drops every command the device has queued
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @return {FError} return FSATA_SUCCESS if successful, return FSATA_ERR_TIMEOUT if the device does not come back
+ * @note: the command engine must be stopped
+ */
+static FError FSataAhciPortComReset(FSataCtrl *instance_p, u8 port)
+{
+    uintptr port_base_addr = instance_p->port[port].port_base_addr;
+    u32 reg_val;
+
+    reg_val = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_CTL) & ~FSATA_PORT_SCR_CTL_DET_MASK;
+    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_CTL, reg_val | FSATA_PORT_SCR_CTL_DET_COMRESET);
+    /* COMRESET is sent as long as DET is 1, keep it at least 1ms */
+    FDriverMdelay(1);
+    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_CTL, reg_val);
+
+    if ((FSataAhciLinkUp(instance_p, port) != FSATA_SUCCESS) ||
+        FSataWaitCmdCompleted(port_base_addr + FSATA_PORT_TFDATA, WAIT_MS_TFD,
+                              FSATA_PORT_TFDATA_ATA_BUSY | FSATA_PORT_TFDATA_ATA_DRQ))
+    {
+        FSATA_ERROR("Port %d does not come back after comreset.", port);
+        return FSATA_ERR_TIMEOUT;
+    }
+
+    return FSATA_SUCCESS;
+}
+
+/**
+ * @name: FSataAhciPortRestart
+ * @msg: stop the command engine, clear the errors and start it again, with a comreset in between
+ *       if asked for or if the device keeps BSY or DRQ
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {boolean} comreset, TRUE to reset the device
+ * @return {boolean} TRUE if the device has been reset
+ */
+static boolean FSataAhciPortRestart(FSataCtrl *instance_p, u8 port, boolean comreset)
+{
+    uintptr port_base_addr = instance_p->port[port].port_base_addr;
+
+    FSataAhciPortStop(port_base_addr);
+
+    /* ST may only be set again with BSY and DRQ clear, a device hanging in a command needs a comreset */
+    if (FSATA_READ_REG32(port_base_addr, FSATA_PORT_TFDATA) &
+        (FSATA_PORT_TFDATA_ATA_BUSY | FSATA_PORT_TFDATA_ATA_DRQ))
+    {
+        comreset = TRUE;
+    }
+
+    if (comreset == TRUE)
+    {
+        (void)FSataAhciPortComReset(instance_p, port);
+    }
+
+    FSataAhciPortClearError(port_base_addr);
+    FSATA_SETBIT(port_base_addr, FSATA_PORT_CMD, FSATA_PORT_CMD_START);
+
+    return comreset;
+}
+
+/**
+ * @name: FSataAhciReadNcqLog
+ * @msg: read the ncq command error log on the reserved slot, which also takes the device
+ *       out of its ncq error state
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {u32} *tag, tag of the failed queued command
+ * @return {FError} return FSATA_SUCCESS if the log names a failed tag, return others if failed
+ * @note: polled with the command engine running and no other command issued
+ */
+static FError FSataAhciReadNcqLog(FSataCtrl *instance_p, u8 port, u32 *tag)
+{
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    uintptr port_base_addr = port_info->port_base_addr;
+    static u8 log[FSATA_SECT_SIZE] __attribute__((aligned(128)));
+    u8 fis[20];
+    u8 sum = 0;
+    FError ret;
+    u32 i;
+
+    memset(fis, 0, sizeof(fis));
+    fis[0] = FSATA_FIS_REG_HOST_TO_DEVICE;
+    fis[1] = FSATA_FIS_REG_HOST_TO_DEVICE_C;
+    fis[2] = FSATA_CMD_READ_LOG_EXT; /* non-queued, pio data in */
+    fis[4] = FSATA_LOG_NCQ_ERROR;    /* lba 7:0, log address */
+    fis[7] = FSATA_CMD_EXT_DEVICE;
+    fis[12] = 1;                     /* count 7:0, one page */
+
+    ret = FSataAhciFillSlot(port_info, port_info->log_tag, fis, sizeof(fis), log, sizeof(log), FALSE);
+    if (ret != FSATA_SUCCESS)
+    {
+        return ret;
+    }
+
+    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE, BIT(port_info->log_tag));
+
+    /* on an error the hba stops and keeps the ci bit */
+    for (i = 0; FSATA_READ_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE) & BIT(port_info->log_tag); i++)
+    {
+        if ((FSATA_READ_REG32(port_base_addr, FSATA_PORT_IRQ_STAT) & FSATA_PORT_IRQ_ERROR) ||
+            (i >= WAIT_MS_DATAIO))
+        {
+            FSATA_ERROR("Read ncq error log failed, tfd 0x%x.",
+                        FSATA_READ_REG32(port_base_addr, FSATA_PORT_TFDATA));
+            return FSATA_ERR_DEVICE;
+        }
+        FDriverMdelay(1);
+    }
+
+    FDriverDCacheRangeInvalidate((uintptr)log, sizeof(log));
+
+    /* the bytes of the page add up to zero */
+    for (i = 0; i < sizeof(log); i++)
+    {
+        sum += log[i];
+    }
+
+    if ((sum != 0) || (log[0] & FSATA_LOG_NCQ_ERROR_NQ))
+    {
+        FSATA_ERROR("Ncq error log does not name a queued command, byte 0 0x%x, sum 0x%x.", log[0], sum);
+        return FSATA_ERR_DEVICE;
+    }
+
+    *tag = log[0] & FSATA_LOG_NCQ_ERROR_TAG;
+
+    return FSATA_SUCCESS;
+}
+
+/**
+ * @name: FSataAhciPortRecover
+ * @msg: restart the port after an error or a timeout and reissue the outstanding slots which did not fail
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {u32} outstanding, issued slots which have not completed
+ * @param {u32} failed, outstanding slots known to have failed, 0 to find them in the ncq error log
+ * @param {boolean} comreset, TRUE to reset the device, which drops every command it has queued
+ * @return {u32} the outstanding slots which are not reissued
+ * @note: called with the irq masked. after an ncq error the device aborts all its queued commands
+ *        and rejects new ones until the ncq error log is read, the log names the failed tag.
+ *        when the failed slot is not known every outstanding slot is reissued, up to
+ *        FSATA_AHCI_RETRY_NUM times
+ */
+static u32 FSataAhciPortRecover(FSataCtrl *instance_p, u8 port, u32 outstanding, u32 failed, boolean comreset)
+{
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    uintptr port_base_addr = port_info->port_base_addr;
+    u32 reissue;
+    u32 tag;
+
+    comreset = FSataAhciPortRestart(instance_p, port, comreset);
+
+    if ((failed == 0) && (outstanding & port_info->slot_ncq) && (comreset == FALSE))
+    {
+        if (FSataAhciReadNcqLog(instance_p, port, &tag) == FSATA_SUCCESS)
+        {
+            failed = BIT(tag) & outstanding;
+        }
+        else
+        {
+            /* the device stays in its error state, only a comreset takes it out */
+            (void)FSataAhciPortRestart(instance_p, port, TRUE);
+        }
+    }
+
+    reissue = outstanding & ~failed;
+    for (tag = 0; tag < port_info->slot_num; tag++)
+    {
+        if (!(reissue & BIT(tag)))
+        {
+            continue;
+        }
+
+        if (failed == 0)
+        {
+            if (port_info->slot[tag].retries >= FSATA_AHCI_RETRY_NUM)
+            {
+                reissue &= ~BIT(tag);
+                continue;
+            }
+            port_info->slot[tag].retries++;
+        }
+
+        /* command table and prdt are kept, only the transferred byte count is cleared */
+        port_info->cmd_list[tag].status = 0;
+        FDriverDCacheRangeFlush((uintptr)(port_info->cmd_list + tag), FSATA_AHCI_CMD_LIST_HEADER_SIZE);
+    }
+
+    if (reissue != 0)
+    {
+        FSATA_WARN("Port %d reissue slots 0x%x, fail slots 0x%x.", port, reissue, outstanding & ~reissue);
+        if (reissue & port_info->slot_ncq)
+        {
+            FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_ACT, reissue & port_info->slot_ncq);
+        }
+        FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE, reissue);
+    }
+
+    return outstanding & ~reissue;
+}
+
+/**
+ * @name: FSataAhciSlotsDone
+ * @msg: release the done slots of port and call their done callbacks
+ * @param {FSataAhciPorts} *port_info, pointer to the port
+ * @param {u32} done, slots taken off the issued bitmap
+ * @param {u32} failed, slots of done which failed with FSATA_ERR_DEVICE
+ * @param {u32} timed_out, slots of done which failed with FSATA_ERR_TIMEOUT
+ * @return {void}
+ */
+static void FSataAhciSlotsDone(FSataAhciPorts *port_info, u32 done, u32 failed, u32 timed_out)
+{
+    FSataAhciSlot *slot;
+    FSataDoneCallBack done_cb;
+    void *done_args;
+    FError result;
+    u32 tag;
+
+    for (tag = 0; done; tag++)
+    {
+        if (!(done & BIT(tag)))
+        {
+            continue;
+        }
+        done &= ~BIT(tag);
+
+        if (timed_out & BIT(tag))
+        {
+            result = FSATA_ERR_TIMEOUT;
+        }
+        else if (failed & BIT(tag))
+        {
+            result = FSATA_ERR_DEVICE;
+        }
+        else
+        {
+            result = FSATA_SUCCESS;
+        }
+
+        slot = &port_info->slot[tag];
+        if ((slot->is_write == FALSE) && (result == FSATA_SUCCESS))
+        {
+            FDriverDCacheRangeInvalidate((uintptr)slot->buf, slot->buf_len);
+        }
+
+        /* free the slot first, so that the callback can issue the next command */
+        done_cb = slot->done_cb;
+        done_args = slot->done_args;
+        FSataAhciSlotFree(port_info, tag);
+
+        if (done_cb)
+        {
+            done_cb(done_args, result);
+        }
+    }
+}
+
+/**
+ * @name: FSataAhciPortComplete
+ * @msg: reap the completed command slots of port and call their done callbacks
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {u32} irq_status, port irq status already read and cleared by the caller, 0 if polling
+ * @return {void}
+ * @note: a slot is done when its bit leaves both SActive and CI. on an error irq the port is
+ *        recovered, the failed slot completes with FSATA_ERR_DEVICE and the other outstanding
+ *        slots are issued again
+ */
+void FSataAhciPortComplete(FSataCtrl *instance_p, u8 port, u32 irq_status)
+{
+    FASSERT(instance_p != NULL);
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    uintptr port_base_addr = port_info->port_base_addr;
+    u32 failed = 0;
+    u32 outstanding;
+    u32 done;
+    u32 pending;
+    u32 flags;
+
+    flags = FSataLock();
+
+    if (port_info->slot_issued == 0)
+    {
+        FSataUnlock(flags);
+        return;
+    }
+
+    /* the error may be raised without the irq enabled */
+    irq_status |= FSATA_READ_REG32(port_base_addr, FSATA_PORT_IRQ_STAT) & FSATA_PORT_IRQ_ERROR;
+
+    pending = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_ACT) |
+              FSATA_READ_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE);
+    done = port_info->slot_issued & ~pending;
+
+    if (irq_status & FSATA_PORT_IRQ_ERROR)
+    {
+        FSATA_ERROR("Port %d error, irq status 0x%x, tfd 0x%x, issued 0x%x.", port, irq_status,
+                    FSATA_READ_REG32(port_base_addr, FSATA_PORT_TFDATA), port_info->slot_issued);
+
+        /* a normal command runs alone, it is the one which failed */
+        outstanding = port_info->slot_issued & pending;
+        failed = FSataAhciPortRecover(instance_p, port, outstanding,
+                                      (outstanding & port_info->slot_ncq) ? 0 : outstanding, FALSE);
+        done |= failed;
+    }
+
+    port_info->slot_issued &= ~done;
+    port_info->slot_ncq &= ~done;
+
+    FSataUnlock(flags);
+
+    FSataAhciSlotsDone(port_info, done, failed, 0);
+}
+
+/**
+ * @name: FSataAhciPortDrop
+ * @msg: fail all the issued slots of port with FSATA_ERR_DEVICE, without touching the port
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @return {void}
+ * @note: for a port whose commands never complete, such as before the hba is reset
+ */
+void FSataAhciPortDrop(FSataCtrl *instance_p, u8 port)
+{
+    FASSERT(instance_p != NULL);
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    u32 done;
+    u32 flags;
+
+    flags = FSataLock();
+    done = port_info->slot_issued;
+    port_info->slot_issued = 0;
+    port_info->slot_ncq = 0;
+    FSataUnlock(flags);
+
+    FSataAhciSlotsDone(port_info, done, done, 0);
+}
+
+/**
+ * @name: FSataAhciAbort
+ * @msg: fail the issued slots of a caller after its timeout, the slots of other callers are
+ *       issued again after the port restart
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {void} *owner, done_args of the slots which timed out
+ * @return {void}
+ * @note: the device is reset, as it still holds the timed-out command in its queue
+ */
+static void FSataAhciAbort(FSataCtrl *instance_p, u8 port, void *owner)
+{
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    uintptr port_base_addr = port_info->port_base_addr;
+    u32 timed_out = 0;
+    u32 failed;
+    u32 outstanding;
+    u32 done;
+    u32 pending;
+    u32 tag;
+    u32 flags;
+
+    flags = FSataLock();
+
+    pending = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_ACT) |
+              FSATA_READ_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE);
+    done = port_info->slot_issued & ~pending;
+    outstanding = port_info->slot_issued & pending;
+
+    for (tag = 0; tag < port_info->slot_num; tag++)
+    {
+        if ((outstanding & BIT(tag)) && (port_info->slot[tag].done_args == owner))
+        {
+            timed_out |= BIT(tag);
+        }
+    }
+
+    failed = FSataAhciPortRecover(instance_p, port, outstanding, timed_out, TRUE);
+    done |= failed;
+
+    port_info->slot_issued &= ~done;
+    port_info->slot_ncq &= ~done;
+
+    FSataUnlock(flags);
+
+    FSataAhciSlotsDone(port_info, done, failed, timed_out);
+}
+
+/* track the slots issued by a synchronous caller */
+typedef struct
+{
+    volatile u32 pending; /* issued and not completed slots */
+    volatile FError result;
+} FSataAhciWait;
+
+static void FSataAhciWaitDone(void *args, FError result)
+{
+    FSataAhciWait *wait = (FSataAhciWait *)args;
+    u32 flags = FSataLock();
+
+    if (result != FSATA_SUCCESS)
+    {
+        wait->result = result;
+    }
+    wait->pending--;
+
+    FSataUnlock(flags);
+}
+
+/**
+ * @name: FSataAhciWaitFor
+ * @msg: poll the port until no more than max_pending slots of wait are outstanding
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {FSataAhciWait} *wait, slots issued by the caller
+ * @param {u32} max_pending, number of slots allowed to stay outstanding
+ * @return {FError} return FSATA_SUCCESS if successful, return FSATA_ERR_TIMEOUT if timeout
+ * @note: completions are reaped here whether or not the port irq is installed
+ */
+static FError FSataAhciWaitFor(FSataCtrl *instance_p, u8 port, FSataAhciWait *wait, u32 max_pending)
+{
+    u32 i;
+
+    for (i = 0; wait->pending > max_pending; i++)
+    {
+        if (i >= WAIT_MS_DATAIO * 100U)
+        {
+            FSATA_ERROR("Timeout exit!");
+            FSataAhciAbort(instance_p, port, wait);
+            return FSATA_ERR_TIMEOUT;
+        }
+
+        FSataAhciPortComplete(instance_p, port, 0);
+        if (wait->pending > max_pending)
+        {
+            FDriverUdelay(10);
+        }
+    }
+
+    return FSATA_SUCCESS;
+}
+
+/**
+ * @name: FSataAhciSubmit
+ * @msg: allocate a slot and issue the command fis on it
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port number
+ * @param {u8} *fis, command fis buffer, the ncq tag field is filled here
+ * @param {int} fis_len, command fis length
+ * @param {u8} *buf, data read/write buffer
+ * @param {int} buf_len, data length
+ * @param {boolean} is_ncq, FALSE-normal command, TRUE-first party dma command
+ * @param {boolean} is_write, FALSE-read, TRUE-write
+ * @param {FSataDoneCallBack} done_cb, called when the slot completes
+ * @param {void} *done_args, argument of done_cb
+ * @return {FError} return FSATA_SUCCESS if successful, return others if failed
+ */
+static FError FSataAhciSubmit(FSataCtrl *instance_p, u8 port, u8 *fis, int fis_len,
+                              u8 *buf, int buf_len, boolean is_ncq, boolean is_write,
+                              FSataDoneCallBack done_cb, void *done_args)
+{
+    FSataAhciPorts *port_info = &(instance_p->port[port]);
+    FError ret;
+    u32 tag;
+
+    ret = FSataAhciSlotAlloc(port_info, &tag);
+    if (ret != FSATA_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (is_ncq == TRUE)
+    {
+        if (tag >= port_info->ncq_depth)
+        {
+            FSataAhciSlotFree(port_info, tag);
+            return FSATA_ERR_BUSY;
+        }
+
+        fis[12] = (u8)(tag << 3); /* count 7:3, NCQ TAG field */
+    }
+
+    ret = FSataAhciIssue(instance_p, port, tag, fis, fis_len, buf, buf_len,
+                         is_ncq, is_write, done_cb, done_args);
+    if (ret != FSATA_SUCCESS)
+    {
+        FSataAhciSlotFree(port_info, tag);
+    }
+
+    return ret;
+}
+
 /**
  * @name: FSataAhciDataIO
- * @msg: transfer ahci command fis and data buffer
+ * @msg: transfer ahci command fis and data buffer, wait until the command is completed
  * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
  * @param {u8} port number
  * @param {u8} *fis, command fis buffer
@@ -771,9 +1514,9 @@ static FError FSataAhciDataIO(FSataCtrl *instance_p, u8 port, u8 *fis, int fis_l
     FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
     FASSERT(fis != NULL);
 
-    FSataAhciPorts *port_info = &(instance_p->port[port]);
-
-    uintptr port_base_addr = instance_p->port[port].port_base_addr;
+    FSataAhciWait wait = {.pending = 0, .result = FSATA_SUCCESS};
+    FError ret;
+    u32 i;
 
     if (port >= instance_p->n_ports)
     {
@@ -781,49 +1524,88 @@ static FError FSataAhciDataIO(FSataCtrl *instance_p, u8 port, u8 *fis, int fis_l
         return FSATA_ERR_INVALID_PARAMETER;
     }
 
-    u32 reg_val = FSATA_READ_REG32(port_base_addr, FSATA_PORT_SCR_STAT);
-    if ((reg_val & FSATA_PORT_SCR_STAT_DET_MASK) != FSATA_PORT_SCR_STAT_DET_PHYRDY)
+    /* a normal command waits for the outstanding ncq commands of other callers */
+    for (i = 0;; i++)
     {
-        FSATA_ERROR("No Link on host %d port %d!", instance_p->config.instance_id, port);
-        return FSATA_ERR_OPERATION;
+        wait.pending = 1;
+        ret = FSataAhciSubmit(instance_p, port, fis, fis_len, buf, buf_len,
+                              is_ncq, is_write, FSataAhciWaitDone, &wait);
+        if (ret != FSATA_ERR_BUSY)
+        {
+            break;
+        }
+
+        if (i >= WAIT_MS_DATAIO * 100U)
+        {
+            FSATA_ERROR("No free command slot on port %d!", port);
+            return FSATA_ERR_TIMEOUT;
+        }
+
+        FSataAhciPortComplete(instance_p, port, 0);
+        FDriverUdelay(10);
     }
 
-    /* copy fis command to command table CFIS */
-    memcpy((void *)port_info->cmd_tbl_base_addr, fis, fis_len);
+    if (ret != FSATA_SUCCESS)
+    {
+        return ret;
+    }
 
-    /* copy data buffer address to command table prdt item */
-    int prdt_length = FSataAhciFillCmdTablePrdt(instance_p, port, buf, buf_len);
-    if (prdt_length == -1)
+    ret = FSataAhciWaitFor(instance_p, port, &wait, 0);
+    if (ret != FSATA_SUCCESS)
     {
-        FSATA_ERROR("FSataAhciFillCmdTablePrdt failed, buf_len = %d.\n", buf_len);
-        return FSATA_ERR_INVALID_PARAMETER;
+        return ret;
     }
 
-    /* command list DW0: PRDTL(buf len) + W/R + CFL(fis len, 4 Byte(Dword) aligned) */
-    u32 description_info = (prdt_length << 16) | (is_write << 6) | (fis_len >> 2);
+    return wait.result;
+}
 
-    /* copy data to command list struct */
-    FSataAhciFillCmdList(port_info, description_info);
+/**
+ * @name: FSataFillRwFis
+ * @msg: build the read or write command fis of a transfer
+ * @param {u8} *fis, 20 bytes command fis buffer
+ * @param {u32} start, start block
+ * @param {u16} blk_cnt, block count
+ * @param {boolean} is_ncq, FALSE-not support ncq, TRUE-support ncq
+ * @param {boolean} is_write, read or write, FALSE-read, TRUE-write
+ * @return {void}
+ * @note: the ncq tag is filled when the slot is allocated
+ */
+static void FSataFillRwFis(u8 *fis, u32 start, u16 blk_cnt, boolean is_ncq, boolean is_write)
+{
+    memset(fis, 0, 20);
 
-    FDriverDCacheRangeFlush((unsigned long)port_info->cmd_list, FSATA_AHCI_PORT_PRIV_DMA_SZ);
-    FDriverDCacheRangeFlush((unsigned long)buf, (unsigned long)buf_len);
+    fis[0] = FSATA_FIS_REG_HOST_TO_DEVICE;   /* fis type */
+    fis[1] = FSATA_FIS_REG_HOST_TO_DEVICE_C; /* C and PM Port */
 
-    /* set tag bit in SACT register before write CI register when use native cmd */
-    if (is_ncq == TRUE)
-    {
-        FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_SCR_ACT, FSATA_PORT_SCR_ACT_ENABLE);
-    }
+    /* LBA of first logical sector to be transferred */
+    fis[4] = ((start >> 0) & 0xff);  /* lba 7:0 */
+    fis[5] = ((start >> 8) & 0xff);  /* lba 15:8 */
+    fis[6] = ((start >> 16) & 0xff); /* lba 23:16 */
+    fis[8] = ((start >> 24) & 0xff); /* lba 31:24 */
 
-    /* send cmd */
-    FSATA_WRITE_REG32(port_base_addr, FSATA_PORT_CMD_ISSUE, FSATA_PORT_CMD_ISSUE_ENABLE);
+    /* device reg, bit 6 Shall be set to one */
+    fis[7] = FSATA_CMD_EXT_DEVICE;
 
-    if (FSataWaitCmdCompleted(port_base_addr + FSATA_PORT_CMD_ISSUE, WAIT_MS_DATAIO, FSATA_PORT_CMD_ISSUE_ENABLE))
+    if (is_ncq == FALSE)
     {
-        FSATA_ERROR("Timeout exit!");
-        return FSATA_ERR_TIMEOUT;
+        fis[2] = is_write ? FSATA_CMD_WRITE_EXT : FSATA_CMD_READ_EXT; /* Command */
+
+        /* The number of logical sectors to be transferred. */
+        fis[12] = (blk_cnt >> 0) & 0xff; /* count 7:0 */
+        fis[13] = (blk_cnt >> 8) & 0xff; /* count 15:8 */
     }
+    else
+    {
+        fis[2] = is_write ? FSATA_CMD_FPDMA_WRITE : FSATA_CMD_FPDMA_READ; /* Command */
 
-    return FSATA_SUCCESS;
+        /* FEATURE：The number of logical sectors to be transferred. */
+        fis[3] = (blk_cnt >> 0) & 0xff;  /* features 7:0 */
+        fis[11] = (blk_cnt >> 8) & 0xff; /* features 15:8 */
+
+        /* count */
+        fis[12] = 0; /* count 7:0, NCQ TAG field */
+        fis[13] = 0; /* count 15:8, Normal priority */
+    }
 }
 
 /**
@@ -837,6 +1619,8 @@ static FError FSataAhciDataIO(FSataCtrl *instance_p, u8 port, u8 *fis, int fis_l
  * @param {boolean} is_ncq, FALSE-not support ncq, TRUE-support ncq
  * @param {boolean} is_write, read or write, FALSE-read, TRUE-write
  * @return {FError} return FSATA_SUCCESS if successful, return others if failed
+ * @note: with ncq the transfer is split into MAX_SATA_BLOCKS_READ_WRITE chunks which are
+ *        issued on different tags and overlap on the device, up to ncq_depth at once
  */
 FError FSataReadWrite(FSataCtrl *instance_p, u8 port, u32 start, u16 blk_cnt,
                       u8 *buffer, boolean is_ncq, boolean is_write)
@@ -845,81 +1629,159 @@ FError FSataReadWrite(FSataCtrl *instance_p, u8 port, u32 start, u16 blk_cnt,
     FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
     FASSERT(blk_cnt);
     FError ret = FSATA_SUCCESS;
+    FSataAhciWait wait = {.pending = 0, .result = FSATA_SUCCESS};
+    u32 max_pending;
+    u32 busy_retry = 0;
+    u32 flags;
 
     u16 now_blocks;    /* number of blocks per iteration */
     u32 transfer_size; /* number of bytes per iteration */
 
     u8 fis[20];
-    /* Preset the FIS */
-    memset(fis, 0, sizeof(fis));
 
-    fis[0] = FSATA_FIS_REG_HOST_TO_DEVICE;   /* fis type */
-    fis[1] = FSATA_FIS_REG_HOST_TO_DEVICE_C; /* C and PM Port */
-    if (is_ncq == FALSE)
+    if ((is_ncq == TRUE) && !FSataIsNcqSupported(instance_p, port))
     {
-        fis[2] = is_write ? FSATA_CMD_WRITE_EXT : FSATA_CMD_READ_EXT; /* Command */
+        FSATA_ERROR("Port %d does not support ncq.", port);
+        return FSATA_ERR_INVALID_PARAMETER;
     }
-    else
+
+    if (is_ncq == FALSE)
     {
-        fis[2] = is_write ? FSATA_CMD_FPDMA_WRITE : FSATA_CMD_FPDMA_READ; /* Command */
+        while (blk_cnt)
+        {
+            now_blocks = min((u16)MAX_SATA_BLOCKS_READ_WRITE, blk_cnt);
+            transfer_size = FSATA_SECT_SIZE * now_blocks;
+
+            FSataFillRwFis(fis, start, now_blocks, is_ncq, is_write);
+            ret = FSataAhciDataIO(instance_p, port, fis, sizeof(fis), buffer, transfer_size,
+                                  is_ncq, is_write);
+            if (ret)
+            {
+                FSATA_ERROR("scsi_ahci: SCSI command failure. ret = %#x.", ret);
+                return FSATA_ERR_OPERATION;
+            }
+
+            buffer += transfer_size;
+            blk_cnt -= now_blocks;
+            start += now_blocks;
+        }
+        return ret;
     }
 
+    /* keep one slot out of the ncq depth window free once it is reached */
+    max_pending = instance_p->port[port].ncq_depth - 1;
+
     while (blk_cnt)
     {
         now_blocks = min((u16)MAX_SATA_BLOCKS_READ_WRITE, blk_cnt);
         transfer_size = FSATA_SECT_SIZE * now_blocks;
-        if (is_ncq == FALSE)
-        {
-            /* FEATURE Reserved */
-            fis[3] = 0;  /* features 7:0 */
-            fis[11] = 0; /* features 15:8 */
 
-            /* LBA of first logical sector to be transferred */
-            fis[4] = ((start >> 0) & 0xff);  /* lba 7:0 */
-            fis[5] = ((start >> 8) & 0xff);  /* lba 15:8 */
-            fis[6] = ((start >> 16) & 0xff); /* lba 23:16 */
-            fis[8] = ((start >> 24) & 0xff); /* lba 31:24 */
-
-            /* device reg, bit 6 Shall be set to one in read command */
-            fis[7] = FSATA_CMD_EXT_DEVICE;
-
-            /* The number of logical sectors to be transferred. */
-            fis[12] = (now_blocks >> 0) & 0xff; /* count 7:0 */
-            fis[13] = (now_blocks >> 8) & 0xff; /* count 15:8 */
-        }
-        else
+        ret = FSataAhciWaitFor(instance_p, port, &wait, max_pending);
+        if (ret != FSATA_SUCCESS)
         {
-            /* FEATURE：The number of logical sectors to be transferred. */
-            fis[3] = (now_blocks >> 0) & 0xff;  /* features 7:0 */
-            fis[11] = (now_blocks >> 8) & 0xff; /* features 15:8 */
-
-            /* LBA of first logical sector to be transferred */
-            fis[4] = ((start >> 0) & 0xff);  /* lba 7:0 */
-            fis[5] = ((start >> 8) & 0xff);  /* lba 15:8 */
-            fis[6] = ((start >> 16) & 0xff); /* lba 23:16 */
-            fis[8] = ((start >> 24) & 0xff); /* lba 31:24 */
+            break;
+        }
 
-            /* device reg, bit 6 Shall be set to one */
-            fis[7] = FSATA_CMD_EXT_DEVICE;
+        flags = FSataLock();
+        wait.pending++;
+        FSataUnlock(flags);
 
-            /* count */
-            fis[12] = 0; /* count 7:0, NCQ TAG field */
-            fis[13] = 0; /* count 15:8, Normal priority */
+        FSataFillRwFis(fis, start, now_blocks, is_ncq, is_write);
+        ret = FSataAhciSubmit(instance_p, port, fis, sizeof(fis), buffer, transfer_size,
+                              is_ncq, is_write, FSataAhciWaitDone, &wait);
+        if (ret != FSATA_SUCCESS)
+        {
+            flags = FSataLock();
+            wait.pending--;
+            FSataUnlock(flags);
         }
 
-        ret = FSataAhciDataIO(instance_p, port, fis, sizeof(fis), buffer, transfer_size,
-                              is_ncq, is_write);
-        if (ret)
+        if (ret == FSATA_ERR_BUSY)
         {
-            FSATA_ERROR("scsi_ahci: SCSI command failure. ret = %#x.", ret);
-            return FSATA_ERR_OPERATION;
+            /* slots are held by other callers, retry after some complete */
+            if (++busy_retry > WAIT_MS_DATAIO * 100U)
+            {
+                ret = FSATA_ERR_TIMEOUT;
+                break;
+            }
+
+            FSataAhciPortComplete(instance_p, port, 0);
+            FDriverUdelay(10);
+            continue;
+        }
+        else if (ret != FSATA_SUCCESS)
+        {
+            break;
         }
 
+        busy_retry = 0;
         buffer += transfer_size;
         blk_cnt -= now_blocks;
         start += now_blocks;
     }
-    return ret;
+
+    /* the issued chunks reference buffer and wait, never return before they are done */
+    if (FSataAhciWaitFor(instance_p, port, &wait, 0) != FSATA_SUCCESS)
+    {
+        ret = FSATA_ERR_TIMEOUT;
+    }
+
+    if ((ret == FSATA_SUCCESS) && (wait.result != FSATA_SUCCESS))
+    {
+        ret = wait.result;
+    }
+
+    if (ret)
+    {
+        FSATA_ERROR("scsi_ahci: SCSI command failure. ret = %#x.", ret);
+        return FSATA_ERR_OPERATION;
+    }
+
+    return FSATA_SUCCESS;
+}
+
+/**
+ * @name: FSataReadWriteAsync
+ * @msg: issue a read or write command on a free slot and return without waiting
+ * @param {FSataCtrl} *instance_p, pointer to the FSataCtrl instance
+ * @param {u8} port, port number
+ * @param {u32} start, start block
+ * @param {u16} blk_cnt, block count, no more than MAX_SATA_BLOCKS_READ_WRITE
+ * @param {u8} *buffer, data buffer, 4 bytes aligned, kept until done_cb is called
+ * @param {boolean} is_ncq, FALSE-normal command, TRUE-first party dma command
+ * @param {boolean} is_write, read or write, FALSE-read, TRUE-write
+ * @param {FSataDoneCallBack} done_cb, called with the result when the command completes
+ * @param {void} *done_args, argument of done_cb
+ * @return {FError} return FSATA_SUCCESS if issued, return FSATA_ERR_BUSY if no slot is free
+ *         or the port runs a command of the other kind
+ * @note: completions are reported by FSataIrqHandler if the port irq is enabled,
+ *        otherwise call FSataAhciPortComplete to poll them
+ */
+FError FSataReadWriteAsync(FSataCtrl *instance_p, u8 port, u32 start, u16 blk_cnt,
+                           u8 *buffer, boolean is_ncq, boolean is_write,
+                           FSataDoneCallBack done_cb, void *done_args)
+{
+    FASSERT(instance_p != NULL);
+    FASSERT(instance_p->is_ready == FT_COMPONENT_IS_READY);
+    FASSERT(done_cb != NULL);
+
+    u8 fis[20];
+
+    if ((port >= instance_p->n_ports) || (blk_cnt == 0) ||
+        (blk_cnt > MAX_SATA_BLOCKS_READ_WRITE))
+    {
+        return FSATA_ERR_INVALID_PARAMETER;
+    }
+
+    if ((is_ncq == TRUE) && !FSataIsNcqSupported(instance_p, port))
+    {
+        return FSATA_ERR_INVALID_PARAMETER;
+    }
+
+    FSataFillRwFis(fis, start, blk_cnt, is_ncq, is_write);
+
+    return FSataAhciSubmit(instance_p, port, fis, sizeof(fis), buffer,
+                           FSATA_SECT_SIZE * blk_cnt, is_ncq, is_write, done_cb, done_args);
 }
 
 /**
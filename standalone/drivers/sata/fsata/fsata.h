@@ -25,6 +25,8 @@
  * 1.0   wangxiaodong  2022/2/10    first release
  * 1.1   wangxiaodong  2022/9/9     improve functions
  * 1.2   wangxiaodong  2022/10/21   improve functions
+ * 1.3   phytium       2026/10/19   multiple command slots, ncq and async read write
+ * 1.4   phytium       2026/10/19   ncq error log recovery, reissue the commands which did not fail
  */
 
 #ifndef FSATA_H
@@ -44,6 +46,8 @@ extern "C"
 #define FSATA_ERR_TIMEOUT                FT_MAKE_ERRCODE(ErrModBsp, ErrBspSata, 2)
 #define FSATA_ERR_OPERATION              FT_MAKE_ERRCODE(ErrModBsp, ErrBspSata, 3)
 #define FSATA_UNKNOWN_DEVICE             FT_MAKE_ERRCODE(ErrModBsp, ErrBspSata, 4)
+#define FSATA_ERR_BUSY                   FT_MAKE_ERRCODE(ErrModBsp, ErrBspSata, 5)
+#define FSATA_ERR_DEVICE                 FT_MAKE_ERRCODE(ErrModBsp, ErrBspSata, 6)
 
 /************************** Constant Definitions *****************************/
 #define FSATA_AHCI_MAX_PORTS             32
@@ -58,11 +62,24 @@ extern "C"
 #define FSATA_AHCI_PRTD_ITEM_SIZE        0x10
 #define FSATA_AHCI_PRTD_ITEM_NUM         0x40 /*set 64 item, hardware max is 64K */
 
+/* command slots used per port, each slot owns a command table, also the ncq queue depth,
+   the last slot is kept for reading the ncq error log */
+#ifdef CONFIG_FSATA_AHCI_CMD_SLOTS
+#define FSATA_AHCI_CMD_SLOT_NUM          CONFIG_FSATA_AHCI_CMD_SLOTS
+#else
+#define FSATA_AHCI_CMD_SLOT_NUM          8
+#endif
+
+#if (FSATA_AHCI_CMD_SLOT_NUM < 1) || (FSATA_AHCI_CMD_SLOT_NUM > FSATA_AHCI_CMD_LIST_HEADER_NUM)
+#error "FSATA_AHCI_CMD_SLOT_NUM must be in 1 ~ 32"
+#endif
+
+/* command table size is a multiple of 128 bytes, so every slot's table keeps the alignment */
 #define FSATA_AHCI_CMD_TABLE_SIZE \
     (FSATA_AHCI_CMD_TABLE_HEADER_SIZE + (FSATA_AHCI_PRTD_ITEM_NUM * FSATA_AHCI_PRTD_ITEM_SIZE))
 #define FSATA_AHCI_PORT_PRIV_DMA_SZ                                     \
     (FSATA_AHCI_CMD_LIST_HEADER_SIZE * FSATA_AHCI_CMD_LIST_HEADER_NUM + \
-     FSATA_AHCI_CMD_TABLE_SIZE + FSATA_AHCI_RX_FIS_SZ)
+     FSATA_AHCI_CMD_TABLE_SIZE * FSATA_AHCI_CMD_SLOT_NUM + FSATA_AHCI_RX_FIS_SZ)
 
 #define FSATA_AHCI_CMD_ATAPI    BIT(5)
 #define FSATA_AHCI_CMD_WRITE    BIT(6)
@@ -77,10 +94,18 @@ extern "C"
 #define FSATA_ID_COMPLETE \
     BIT(2) /* IDENTIFY DEVICE word 0, if the content of the IDENTIFY DEVICE data is incomplete  */
 
+#define FSATA_ID_QUEUE_DEPTH 75 /* IDENTIFY DEVICE word 75, bit 4:0 maximum queue depth - 1 */
+#define FSATA_ID_SATA_CAP    76 /* IDENTIFY DEVICE word 76, serial ata capabilities */
+#define FSATA_ID_SATA_CAP_NCQ BIT(8) /* supports the ncq feature set */
+
 #define FSATA_ID_FW_REV 23  /* firmware revision position */
 #define FSATA_ID_PROD   27  /* Model number position */
 #define FSATA_ID_WORDS  256 /* IDENTIFY DEVICE data length */
 
+#define FSATA_LOG_NCQ_ERROR     0x10   /* NCQ Command Error log address */
+#define FSATA_LOG_NCQ_ERROR_NQ  BIT(7) /* byte 0, the error is not for a queued command */
+#define FSATA_LOG_NCQ_ERROR_TAG GENMASK(4, 0) /* byte 0, tag of the failed queued command */
+
 enum
 {
     FSATA_FIS_REG_HOST_TO_DEVICE = 0x27,
@@ -94,6 +119,7 @@ enum
 enum
 {
     FSATA_CMD_READ_EXT = 0x25,
+    FSATA_CMD_READ_LOG_EXT = 0x2F,
     FSATA_CMD_WRITE_EXT = 0x35,
     FSATA_CMD_IDENTIFY_DEVICE = 0xEC,
     FSATA_CMD_FPDMA_READ = 0x60,
@@ -152,6 +178,10 @@ static inline int FSataIdHasLba48(const u16 *id)
 /**************************** Type Definitions *******************************/
 typedef void (*FSataIrqCallBack)(void *args);
 
+/* request done callback, result is FSATA_SUCCESS or the error code of the command,
+   runs in FSataIrqHandler or in the task which polls FSataAhciPortComplete */
+typedef void (*FSataDoneCallBack)(void *args, FError result);
+
 /* sata info */
 typedef struct
 {
@@ -198,15 +228,34 @@ typedef struct
     u32 data_byte; /* DW 3 – Description Information */
 } FSataAhciCommandTablePrdt;
 
+/* outstanding command of a slot */
+typedef struct
+{
+    FSataDoneCallBack done_cb; /* called when the slot completes or fails */
+    void *done_args;
+    u8 *buf;                   /* data buffer, invalidated after a read completes */
+    u32 buf_len;
+    boolean is_write;
+    u32 retries;               /* reissued after a port recovery which could not find the failed slot */
+} FSataAhciSlot;
+
 /* ahci port information structure */
 typedef struct
 {
     uintptr port_base_addr; /* port base address */
     FSataAhciCommandList *cmd_list; /*  Command List structure, will include cmd_tbl's address */
     FSataAhciRecvFis *rx_fis; /* Received FIS Structure */
-    uintptr cmd_tbl_base_addr; /* command table addr, also the command table's first part */
-    FSataAhciCommandTablePrdt *cmd_tbl_prdt; /* command table's second part , cmd_tbl + cmd_tbl_prdt = command table*/
+    uintptr cmd_tbl_base_addr; /* command table addr of slot 0, slot n table follows at n * FSATA_AHCI_CMD_TABLE_SIZE */
+    FSataAhciCommandTablePrdt *cmd_tbl_prdt; /* command table's second part of slot 0, cmd_tbl + cmd_tbl_prdt = command table*/
     FSataInfo dev_info;
+
+    u32 slot_num;               /* command slots usable on this port, limited by cap.ncs */
+    u32 log_tag;                /* slot kept for the ncq error log, not below slot_num if there is one */
+    u32 ncq_depth;              /* ncq queue depth, 0 if the hba or the device does not support ncq */
+    volatile u32 slot_busy;     /* each bit indicate slot is allocated */
+    volatile u32 slot_issued;   /* each bit indicate slot is issued and not completed */
+    volatile u32 slot_ncq;      /* each bit indicate issued slot is a ncq command */
+    FSataAhciSlot slot[FSATA_AHCI_CMD_SLOT_NUM];
 } FSataAhciPorts;
 
 typedef struct
@@ -269,6 +318,23 @@ FError FSataAhciPortStart(FSataCtrl *instance_p, u8 port, uintptr mem);
 FError FSataReadWrite(FSataCtrl *instance_p, u8 port, u32 start, u16 blk_cnt,
                       u8 *buffer, boolean is_ncq, boolean is_write);
 
+/* issue a read or write command and return, done_cb is called when it completes */
+FError FSataReadWriteAsync(FSataCtrl *instance_p, u8 port, u32 start, u16 blk_cnt,
+                           u8 *buffer, boolean is_ncq, boolean is_write,
+                           FSataDoneCallBack done_cb, void *done_args);
+
+/* reap the completed command slots of port, called by FSataIrqHandler or polled */
+void FSataAhciPortComplete(FSataCtrl *instance_p, u8 port, u32 irq_status);
+
+/* fail all the issued command slots of port, before the hba is reset */
+void FSataAhciPortDrop(FSataCtrl *instance_p, u8 port);
+
+/* check if the port can use ncq commands */
+static inline boolean FSataIsNcqSupported(FSataCtrl *instance_p, u8 port)
+{
+    return (instance_p->port[port].ncq_depth > 0) ? TRUE : FALSE;
+}
+
 /* sata all irq handler entry */
 void FSataIrqHandler(s32 vector, void *param);
 
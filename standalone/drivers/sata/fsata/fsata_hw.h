@@ -51,6 +51,9 @@ extern "C"
 
 /* FSATA_HOST_CTL bits */
 #define FSATA_HOST_CAP_NP_MASK          GENMASK(4, 0) /* Number of Ports (NP) */
+#define FSATA_HOST_CAP_NCS_MASK         GENMASK(12, 8) /* Number of Command Slots (NCS) - 1 */
+#define FSATA_HOST_CAP_NCS_SHIFT        8
+#define FSATA_HOST_CAP_SNCQ             BIT(30)       /* Supports Native Command Queuing */
 #define FSATA_HOST_AHCI_EN              BIT(31)       /* AHCI enabled */
 #define FSATA_HOST_CAP_SMPS             BIT(28) /* AHCI Supports Mechanical Presence Switch */
 #define FSATA_HOST_CAP_SSS              BIT(27)       /* AHCI staggered spin-up */
@@ -80,6 +83,10 @@ extern "C"
 #define FSATA_PORT_SCR_STAT_DET_COMINIT 0x1
 #define FSATA_PORT_SCR_STAT_DET_PHYRDY  0x3 /* SATA exist and phy connected */
 
+/* FSATA_PORT_SCR_CTL (SControl) */
+#define FSATA_PORT_SCR_CTL_DET_MASK     GENMASK(3, 0)
+#define FSATA_PORT_SCR_CTL_DET_COMRESET 0x1 /* perform interface communication initialization */
+
 /* PORT_CMD bits */
 #define FSATA_PORT_CMD_LIST_ADDR_MASK   GENMASK(31, 10)
 #define FSATA_PORT_CMD_FIS_ADDR_MASK    GENMASK(31, 8)
@@ -124,8 +131,13 @@ extern "C"
 #define FSATA_PORT_IRQ_PIOS_FIS         BIT(1)  /* PIO Setup FIS rx'd */
 #define FSATA_PORT_IRQ_D2H_REG_FIS      BIT(0)  /* D2H Register FIS rx'd */
 
+/* errors which abort all the outstanding commands of the port */
+#define FSATA_PORT_IRQ_ERROR \
+    (FSATA_PORT_IRQ_TF_ERR | FSATA_PORT_IRQ_HBUS_ERR | FSATA_PORT_IRQ_HBUS_DATA_ERR | FSATA_PORT_IRQ_IF_ERR)
+
 #define FSATA_PORT_IRQ_FREEZE \
-    FSATA_PORT_IRQ_CONNECT | FSATA_PORT_IRQ_SDB_FIS | FSATA_PORT_IRQ_D2H_REG_FIS | FSATA_PORT_IRQ_PIOS_FIS
+    (FSATA_PORT_IRQ_CONNECT | FSATA_PORT_IRQ_SDB_FIS | FSATA_PORT_IRQ_D2H_REG_FIS | \
+     FSATA_PORT_IRQ_PIOS_FIS | FSATA_PORT_IRQ_ERROR)
 
 #define FSATA_PORT_SCR_ACT_ENABLE          BIT(0) /* Port Serial ATA Active */
 #define FSATA_PORT_CMD_ISSUE_ENABLE        BIT(0) /* Port Command Issue enable */
@@ -24,6 +24,8 @@
  * ----- ------     --------    --------------------------------------
  * 1.0   wangxiaodong  2022/2/10    first release
  * 1.1   wangxiaodong  2022/10/21   improve functions
+ * 1.2   phytium       2026/10/19   complete command slots in irq handler
+ * 1.3   phytium       2026/10/19   drop the issued slots before the hba reset
  */
 
 #include "fassert.h"
@@ -214,6 +216,12 @@ void FSataIrqHandler(s32 vector, void *param)
             }
         }
 
+        /* commands finish with a d2h register fis, ncq commands with a set device bits fis */
+        if (status & mask_status & (FSATA_PORT_IRQ_D2H_REG_FIS | FSATA_PORT_IRQ_SDB_FIS | FSATA_PORT_IRQ_ERROR))
+        {
+            FSataAhciPortComplete(instance_p, i, status & FSATA_PORT_IRQ_ERROR);
+        }
+
         if (status & mask_status & FSATA_PORT_IRQ_CONNECT)
         {
             if (instance_p->fsata_pcs_cb)
@@ -221,6 +229,9 @@ void FSataIrqHandler(s32 vector, void *param)
                 instance_p->fsata_pcs_cb(instance_p->pcs_args);
             }
 
+            /* commands issued before the reset never complete */
+            FSataAhciPortDrop(instance_p, i);
+
             /* reset hba */
             FSATA_WRITE_REG32(base_addr, FSATA_HOST_CTL, FSATA_HOST_RESET);
             FSataAhciInit(instance_p);
@@ -3896,7 +3896,28 @@ FRESULT f_read (
 			cc = btr / SS(fs);					/* When remaining bytes >= sector size, */
 			if (cc > 0) {						/* Read maximum contiguous sectors directly */
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
+#if FF_FS_CONTIG_IO
+					UINT rest = csect + cc - fs->csize;	/* Sectors beyond the current cluster */
+
 					cc = fs->csize - csect;
+					while (rest > 0) {			/* Join the following clusters while they are contiguous */
+#if FF_USE_FASTSEEK
+						clst = fp->cltbl ? clmt_clust(fp, fp->fptr + (FSIZE_t)cc * SS(fs)) : get_fat(&fp->obj, fp->clust);
+#else
+						clst = get_fat(&fp->obj, fp->clust);
+#endif
+						if (clst == 0xFFFFFFFF) ABORT(fs, FR_DISK_ERR);
+						if (clst != fp->clust + 1) break;
+						fp->clust = clst;
+						if (rest > fs->csize) {
+							cc += fs->csize; rest -= fs->csize;
+						} else {
+							cc += rest; rest = 0;
+						}
+					}
+#else
+					cc = fs->csize - csect;
+#endif
 				}
 				if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
@@ -4011,7 +4032,32 @@ FRESULT f_write (
 			cc = btw / SS(fs);				/* When remaining bytes >= sector size, */
 			if (cc > 0) {					/* Write maximum contiguous sectors directly */
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
+#if FF_FS_CONTIG_IO
+					UINT rest = csect + cc - fs->csize;	/* Sectors beyond the current cluster */
+
 					cc = fs->csize - csect;
+					while (rest > 0) {			/* Join the following clusters while they are contiguous */
+						if (fp->fptr + (FSIZE_t)cc * SS(fs) > fp->obj.objsize) {	/* The chain on the exFAT volume is looked up by the object size */
+							fp->obj.objsize = fp->fptr + (FSIZE_t)cc * SS(fs);
+						}
+#if FF_USE_FASTSEEK
+						clst = fp->cltbl ? clmt_clust(fp, fp->fptr + (FSIZE_t)cc * SS(fs)) : create_chain(&fp->obj, fp->clust);
+#else
+						clst = create_chain(&fp->obj, fp->clust);	/* Follow or stretch cluster chain on the FAT */
+#endif
+						if (clst == 1) ABORT(fs, FR_INT_ERR);
+						if (clst == 0xFFFFFFFF) ABORT(fs, FR_DISK_ERR);
+						if (clst != fp->clust + 1) break;	/* Disk full or fragmented, left to the next round */
+						fp->clust = clst;
+						if (rest > fs->csize) {
+							cc += fs->csize; rest -= fs->csize;
+						} else {
+							cc += rest; rest = 0;
+						}
+					}
+#else
+					cc = fs->csize - csect;
+#endif
 				}
 				if (disk_write(fs->pdrv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if FF_FS_MINIMIZE <= 2
@@ -36,7 +36,11 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_FASTSEEK	CONFIG_FATFS_USE_FASTSEEK
+#ifdef CONFIG_FATFS_USE_FASTSEEK
+#define FF_USE_FASTSEEK	1
+#else
+#define FF_USE_FASTSEEK	0
+#endif
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
@@ -207,7 +211,11 @@
 
 
 #define FF_MIN_SS		512
+#ifdef CONFIG_FATFS_MAX_SS_4096
+#define FF_MAX_SS		4096
+#else
 #define FF_MAX_SS		512
+#endif
 /* This set of options configures the range of sector size to be supported. (512,
 /  1024, 2048 or 4096) Always set both 512 for most systems, generic memory card and
 /  harddisk, but a larger value may be required for on-board flash memory and some
@@ -216,7 +224,19 @@
 /  GET_SECTOR_SIZE command. */
 
 
+#define FF_FS_CONTIG_IO	1
+/* This option switches the multi-cluster direct transfer. (0:Disable or 1:Enable)
+/  When enabled, a file read or write of whole sectors is not clipped at the cluster
+/  boundary but goes on over the following clusters while they are contiguous on
+/  the volume, so that a large aligned transfer is sent to the disk with one
+/  disk_read() or disk_write() instead of one call per cluster. */
+
+
+#ifdef CONFIG_FATFS_LBA64
+#define FF_LBA64		1
+#else
 #define FF_LBA64		0
+#endif
 /* This option switches support for 64-bit LBA. (0:Disable or 1:Enable)
 /  To enable the 64-bit LBA, also exFAT needs to be enabled. (FF_FS_EXFAT == 1) */
 
@@ -226,7 +246,11 @@
 /  f_fdisk function. 0x100000000 max. This option has no effect when FF_LBA64 == 0. */
 
 
+#ifdef CONFIG_FATFS_USE_TRIM
+#define FF_USE_TRIM		1
+#else
 #define FF_USE_TRIM		0
+#endif
 /* This option switches support for ATA-TRIM. (0:Disable or 1:Enable)
 /  To enable Trim function, also CTRL_TRIM command should be implemented to the
 /  disk_ioctl() function. */
@@ -293,7 +317,11 @@
 
 
 /* #include <somertos.h>	// O/S definitions */
-#ifdef CONFIG_USE_BAREMETAL
+#if defined(CONFIG_USE_FREERTOS) && defined(CONFIG_FATFS_REENTRANT)
+#include "FreeRTOS.h"
+#include "semphr.h"
+#define FF_FS_REENTRANT	1
+#else
 #define FF_FS_REENTRANT	0
 #endif
 
@@ -327,5 +355,6 @@
 #define FF_USB_DISK_MOUNT_POINT           "4:/"
 #define FF_SATA_DISK_MOUNT_POINT          "5:/"
 #define FF_SATA_PCIE_DISK_MOUNT_POINT     "6:/"
+#define FF_NVME_DISK_MOUNT_POINT          "7:/"
 
 /*--- End of configuration options ---*/
@@ -0,0 +1,729 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_host_bench.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the fatfs performance harness on linux, it runs the workloads on the ram disk behind a simulated device and prints the results
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include "sdkconfig.h"
+#include "fassert.h"
+#include "fkernel.h"
+#include "ff.h"
+#include "diskio.h"
+#include "ff_utils.h"
+#include "ff_cache.h"
+#include "ff_host_disk.h"
+
+#define FF_HOST_DRV             0
+#define FF_HOST_MOUNT_POINT     FF_RAM_DISK_MOUNT_POINT
+#define FF_HOST_DISK_SIZE       ((size_t)CONFIG_FATFS_RAM_DISK_SIZE_MB * SZ_1M)
+
+QWORD ff_systimer_get_tick(void);
+
+#define FF_HOST_WL_COMPAT       BIT(0)
+#define FF_HOST_WL_SEQ          BIT(1)
+#define FF_HOST_WL_RAND         BIT(2)
+#define FF_HOST_WL_SMALL        BIT(3)
+#define FF_HOST_WL_DIR          BIT(4)
+#define FF_HOST_WL_ALL          (FF_HOST_WL_SEQ | FF_HOST_WL_RAND | FF_HOST_WL_SMALL | FF_HOST_WL_DIR)
+
+typedef struct
+{
+    ff_host_disk_config disk;
+    DWORD workloads;
+    BYTE fmt;               /* FM_FAT32 or FM_EXFAT, FM_ANY when 0 */
+    DWORD seq_mb;           /* size of the sequential file */
+    UINT io_size;           /* transfer size of the sequential workload */
+    DWORD rand_mb;          /* size of the random file */
+    UINT rand_size;         /* transfer size of the random workload */
+    DWORD rand_ops;
+    DWORD small_files;
+    UINT small_size;
+    DWORD dirs;
+    DWORD dir_files;
+    DWORD seed;
+} ff_host_bench_opts;
+
+static ff_host_bench_opts opts =
+{
+    .disk = {.read_lat_us = 0, .write_lat_us = 0, .sync_lat_us = 0, .bandwidth_mbps = 0, .virtual_time = 0},
+    .workloads = FF_HOST_WL_ALL,
+    .fmt = 0,
+    .seq_mb = 64,
+    .io_size = 64 * 1024,
+    .rand_mb = 16,
+    .rand_size = 4096,
+    .rand_ops = 4096,
+    .small_files = 512,
+    .small_size = 2048,
+    .dirs = 16,
+    .dir_files = 64,
+    .seed = 1
+};
+
+static FATFS host_fs;
+static BYTE *io_buf;
+static DWORD rand_state;
+
+static const struct
+{
+    const char *name;
+    DWORD mask;
+} workload_names[] =
+{
+    {"compat", FF_HOST_WL_COMPAT},
+    {"seq", FF_HOST_WL_SEQ},
+    {"rand", FF_HOST_WL_RAND},
+    {"small", FF_HOST_WL_SMALL},
+    {"dir", FF_HOST_WL_DIR},
+    {"all", FF_HOST_WL_ALL},
+};
+
+static void ff_host_assert_cb(const char *file, s32 line, int ret)
+{
+    FUNUSED(ret);
+    fprintf(stderr, "Assert Error at %s : %d\n", file, (int)line);
+    abort();
+}
+
+static DWORD ff_host_rand(void)
+{
+    /* xorshift32, the same sequence for the same seed on all hosts */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static QWORD ff_host_now(void)
+{
+    return ff_systimer_get_tick();
+}
+
+static double ff_host_rate(double count, QWORD us)
+{
+    return (us == 0) ? 0.0 : count * 1000000.0 / (double)us;
+}
+
+/* the data at ofs of file id, so that a read back can be checked without keeping a copy */
+static void ff_host_fill(BYTE *buf, UINT len, DWORD id, FSIZE_t ofs)
+{
+    UINT i;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = (BYTE)((ofs + i) * 7 + id + ((ofs + i) >> 12));
+    }
+}
+
+static int ff_host_check(const BYTE *buf, UINT len, DWORD id, FSIZE_t ofs)
+{
+    UINT i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] != (BYTE)((ofs + i) * 7 + id + ((ofs + i) >> 12)))
+        {
+            fprintf(stderr, "data mismatch of file %lu at %llu\n", (unsigned long)id, (unsigned long long)(ofs + i));
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void ff_host_dump_disk(const char *workload)
+{
+    ff_host_disk_stats stats;
+
+    ff_host_disk_get_stats(&stats, TRUE);
+    printf("disk: workload=%s read_cmds=%llu read_sectors=%llu write_cmds=%llu write_sectors=%llu sync_cmds=%llu busy_us=%llu\n",
+           workload,
+           (unsigned long long)stats.read_cmds, (unsigned long long)stats.read_sectors,
+           (unsigned long long)stats.write_cmds, (unsigned long long)stats.write_sectors,
+           (unsigned long long)stats.sync_cmds, (unsigned long long)stats.busy_us);
+
+#ifdef CONFIG_FATFS_CACHE
+    ff_cache_stats cache;
+
+    ff_cache_get_stats(FF_HOST_DRV, &cache, TRUE);
+    printf("cache: workload=%s read_hits=%lu read_misses=%lu write_hits=%lu write_misses=%lu readahead=%lu readahead_hits=%lu writebacks=%lu\n",
+           workload,
+           (unsigned long)cache.read_hits, (unsigned long)cache.read_misses,
+           (unsigned long)cache.write_hits, (unsigned long)cache.write_misses,
+           (unsigned long)cache.readahead, (unsigned long)cache.readahead_hits,
+           (unsigned long)cache.writebacks);
+#endif
+}
+
+#define FF_HOST_CHECK(res, what)                                                        \
+    do                                                                                  \
+    {                                                                                   \
+        if ((res) != FR_OK)                                                             \
+        {                                                                               \
+            fprintf(stderr, "%s failed at line %d, res = %d\n", what, __LINE__, res);   \
+            return -1;                                                                  \
+        }                                                                               \
+    } while (0)
+
+/* write a file sequentially, then read it back and check it */
+static int ff_host_seq_test(void)
+{
+    FIL fil;
+    FRESULT res;
+    UINT bw, br;
+    FSIZE_t ofs;
+    FSIZE_t len = (FSIZE_t)opts.seq_mb * SZ_1M;
+    QWORD t_write, t_read;
+
+    res = f_open(&fil, "0:/seq.bin", FA_CREATE_ALWAYS | FA_WRITE);
+    FF_HOST_CHECK(res, "open");
+
+    t_write = ff_host_now();
+    for (ofs = 0; ofs < len; ofs += opts.io_size)
+    {
+        ff_host_fill(io_buf, opts.io_size, 0, ofs);
+        res = f_write(&fil, io_buf, opts.io_size, &bw);
+        FF_HOST_CHECK(res, "write");
+        if (bw != opts.io_size)
+        {
+            fprintf(stderr, "disk full at %llu\n", (unsigned long long)ofs);
+            (void)f_close(&fil);
+            return -1;
+        }
+    }
+    res = f_close(&fil);
+    t_write = ff_host_now() - t_write;
+    FF_HOST_CHECK(res, "close");
+
+    res = f_open(&fil, "0:/seq.bin", FA_OPEN_EXISTING | FA_READ);
+    FF_HOST_CHECK(res, "open");
+
+    t_read = ff_host_now();
+    for (ofs = 0; ofs < len; ofs += opts.io_size)
+    {
+        res = f_read(&fil, io_buf, opts.io_size, &br);
+        FF_HOST_CHECK(res, "read");
+        if ((br != opts.io_size) || ff_host_check(io_buf, br, 0, ofs))
+        {
+            (void)f_close(&fil);
+            return -1;
+        }
+    }
+    t_read = ff_host_now() - t_read;
+    (void)f_close(&fil);
+
+    printf("result: workload=seq bytes=%llu io_size=%u write_us=%llu write_mbps=%.2f read_us=%llu read_mbps=%.2f\n",
+           (unsigned long long)len, opts.io_size,
+           (unsigned long long)t_write, ff_host_rate((double)len / SZ_1M, t_write),
+           (unsigned long long)t_read, ff_host_rate((double)len / SZ_1M, t_read));
+
+    res = f_unlink("0:/seq.bin");
+    FF_HOST_CHECK(res, "unlink");
+    return 0;
+}
+
+/* aligned random reads and writes in a preallocated file */
+static int ff_host_rand_test(void)
+{
+    FIL fil;
+    FRESULT res;
+    UINT bw, br;
+    DWORD i;
+    FSIZE_t ofs;
+    FSIZE_t len = (FSIZE_t)opts.rand_mb * SZ_1M;
+    DWORD blocks = (DWORD)(len / opts.rand_size);
+    QWORD t_read, t_write;
+
+    res = f_open(&fil, "0:/rand.bin", FA_CREATE_ALWAYS | FA_WRITE | FA_READ);
+    FF_HOST_CHECK(res, "open");
+
+    for (ofs = 0; ofs < len; ofs += opts.rand_size)
+    {
+        ff_host_fill(io_buf, opts.rand_size, 1, ofs);
+        res = f_write(&fil, io_buf, opts.rand_size, &bw);
+        FF_HOST_CHECK(res, "write");
+    }
+    res = f_sync(&fil);
+    FF_HOST_CHECK(res, "sync");
+    ff_host_dump_disk("rand-fill");
+
+    t_read = ff_host_now();
+    for (i = 0; i < opts.rand_ops; i++)
+    {
+        ofs = (FSIZE_t)(ff_host_rand() % blocks) * opts.rand_size;
+        res = f_lseek(&fil, ofs);
+        FF_HOST_CHECK(res, "lseek");
+        res = f_read(&fil, io_buf, opts.rand_size, &br);
+        FF_HOST_CHECK(res, "read");
+        if ((br != opts.rand_size) || ff_host_check(io_buf, br, 1, ofs))
+        {
+            (void)f_close(&fil);
+            return -1;
+        }
+    }
+    t_read = ff_host_now() - t_read;
+
+    /* the rewrites keep the content, a later read back still checks */
+    t_write = ff_host_now();
+    for (i = 0; i < opts.rand_ops; i++)
+    {
+        ofs = (FSIZE_t)(ff_host_rand() % blocks) * opts.rand_size;
+        ff_host_fill(io_buf, opts.rand_size, 1, ofs);
+        res = f_lseek(&fil, ofs);
+        FF_HOST_CHECK(res, "lseek");
+        res = f_write(&fil, io_buf, opts.rand_size, &bw);
+        FF_HOST_CHECK(res, "write");
+    }
+    res = f_close(&fil);
+    t_write = ff_host_now() - t_write;
+    FF_HOST_CHECK(res, "close");
+
+    printf("result: workload=rand file_bytes=%llu io_size=%u ops=%lu read_us=%llu read_iops=%.1f write_us=%llu write_iops=%.1f\n",
+           (unsigned long long)len, opts.rand_size, (unsigned long)opts.rand_ops,
+           (unsigned long long)t_read, ff_host_rate(opts.rand_ops, t_read),
+           (unsigned long long)t_write, ff_host_rate(opts.rand_ops, t_write));
+
+    res = f_unlink("0:/rand.bin");
+    FF_HOST_CHECK(res, "unlink");
+    return 0;
+}
+
+/* create, read back and delete many small files */
+static int ff_host_small_test(void)
+{
+    FIL fil;
+    FRESULT res;
+    UINT bw, br;
+    DWORD i;
+    TCHAR path[32];
+    QWORD t_create, t_read, t_delete;
+
+    res = f_mkdir("0:/small");
+    FF_HOST_CHECK(res, "mkdir");
+
+    t_create = ff_host_now();
+    for (i = 0; i < opts.small_files; i++)
+    {
+        snprintf(path, sizeof(path), "0:/small/f%05lu.dat", (unsigned long)i);
+        res = f_open(&fil, path, FA_CREATE_NEW | FA_WRITE);
+        FF_HOST_CHECK(res, "open");
+        ff_host_fill(io_buf, opts.small_size, i, 0);
+        res = f_write(&fil, io_buf, opts.small_size, &bw);
+        FF_HOST_CHECK(res, "write");
+        res = f_close(&fil);
+        FF_HOST_CHECK(res, "close");
+    }
+    t_create = ff_host_now() - t_create;
+
+    t_read = ff_host_now();
+    for (i = 0; i < opts.small_files; i++)
+    {
+        snprintf(path, sizeof(path), "0:/small/f%05lu.dat", (unsigned long)i);
+        res = f_open(&fil, path, FA_OPEN_EXISTING | FA_READ);
+        FF_HOST_CHECK(res, "open");
+        res = f_read(&fil, io_buf, opts.small_size, &br);
+        (void)f_close(&fil);
+        FF_HOST_CHECK(res, "read");
+        if ((br != opts.small_size) || ff_host_check(io_buf, br, i, 0))
+        {
+            return -1;
+        }
+    }
+    t_read = ff_host_now() - t_read;
+
+    t_delete = ff_host_now();
+    for (i = 0; i < opts.small_files; i++)
+    {
+        snprintf(path, sizeof(path), "0:/small/f%05lu.dat", (unsigned long)i);
+        res = f_unlink(path);
+        FF_HOST_CHECK(res, "unlink");
+    }
+    res = f_unlink("0:/small");
+    t_delete = ff_host_now() - t_delete;
+    FF_HOST_CHECK(res, "unlink");
+
+    printf("result: workload=small files=%lu size=%u create_us=%llu create_fps=%.1f read_us=%llu read_fps=%.1f delete_us=%llu delete_fps=%.1f\n",
+           (unsigned long)opts.small_files, opts.small_size,
+           (unsigned long long)t_create, ff_host_rate(opts.small_files, t_create),
+           (unsigned long long)t_read, ff_host_rate(opts.small_files, t_read),
+           (unsigned long long)t_delete, ff_host_rate(opts.small_files, t_delete));
+    return 0;
+}
+
+/* build a directory tree of empty files, list it, stat every entry and remove it */
+static int ff_host_dir_test(void)
+{
+    FIL fil;
+    DIR dir;
+    FILINFO fno;
+    FRESULT res;
+    DWORD d, f, found = 0;
+    TCHAR path[64];
+    QWORD t_create, t_list, t_stat, t_delete;
+    DWORD entries = opts.dirs * opts.dir_files;
+
+    res = f_mkdir("0:/tree");
+    FF_HOST_CHECK(res, "mkdir");
+
+    t_create = ff_host_now();
+    for (d = 0; d < opts.dirs; d++)
+    {
+        snprintf(path, sizeof(path), "0:/tree/dir%03lu", (unsigned long)d);
+        res = f_mkdir(path);
+        FF_HOST_CHECK(res, "mkdir");
+        for (f = 0; f < opts.dir_files; f++)
+        {
+            snprintf(path, sizeof(path), "0:/tree/dir%03lu/entry_with_long_name_%05lu.txt",
+                     (unsigned long)d, (unsigned long)f);
+            res = f_open(&fil, path, FA_CREATE_NEW | FA_WRITE);
+            FF_HOST_CHECK(res, "open");
+            res = f_close(&fil);
+            FF_HOST_CHECK(res, "close");
+        }
+    }
+    t_create = ff_host_now() - t_create;
+
+    t_list = ff_host_now();
+    for (d = 0; d < opts.dirs; d++)
+    {
+        snprintf(path, sizeof(path), "0:/tree/dir%03lu", (unsigned long)d);
+        res = f_opendir(&dir, path);
+        FF_HOST_CHECK(res, "opendir");
+        for (;;)
+        {
+            res = f_readdir(&dir, &fno);
+            if ((res != FR_OK) || (fno.fname[0] == 0))
+            {
+                break;
+            }
+            found++;
+        }
+        (void)f_closedir(&dir);
+        FF_HOST_CHECK(res, "readdir");
+    }
+    t_list = ff_host_now() - t_list;
+    if (found != entries)
+    {
+        fprintf(stderr, "listed %lu entries, expect %lu\n", (unsigned long)found, (unsigned long)entries);
+        return -1;
+    }
+
+    /* reverse order, so that the lookups do not follow the creation */
+    t_stat = ff_host_now();
+    for (d = opts.dirs; d-- > 0;)
+    {
+        for (f = opts.dir_files; f-- > 0;)
+        {
+            snprintf(path, sizeof(path), "0:/tree/dir%03lu/entry_with_long_name_%05lu.txt",
+                     (unsigned long)d, (unsigned long)f);
+            res = f_stat(path, &fno);
+            FF_HOST_CHECK(res, "stat");
+        }
+    }
+    t_stat = ff_host_now() - t_stat;
+
+    t_delete = ff_host_now();
+    for (d = 0; d < opts.dirs; d++)
+    {
+        for (f = 0; f < opts.dir_files; f++)
+        {
+            snprintf(path, sizeof(path), "0:/tree/dir%03lu/entry_with_long_name_%05lu.txt",
+                     (unsigned long)d, (unsigned long)f);
+            res = f_unlink(path);
+            FF_HOST_CHECK(res, "unlink");
+        }
+        snprintf(path, sizeof(path), "0:/tree/dir%03lu", (unsigned long)d);
+        res = f_unlink(path);
+        FF_HOST_CHECK(res, "unlink");
+    }
+    res = f_unlink("0:/tree");
+    t_delete = ff_host_now() - t_delete;
+    FF_HOST_CHECK(res, "unlink");
+
+    printf("result: workload=dir dirs=%lu entries=%lu create_us=%llu create_ops=%.1f list_us=%llu list_ops=%.1f stat_us=%llu stat_ops=%.1f delete_us=%llu delete_ops=%.1f\n",
+           (unsigned long)opts.dirs, (unsigned long)entries,
+           (unsigned long long)t_create, ff_host_rate(entries, t_create),
+           (unsigned long long)t_list, ff_host_rate(entries, t_list),
+           (unsigned long long)t_stat, ff_host_rate(entries, t_stat),
+           (unsigned long long)t_delete, ff_host_rate(entries, t_delete));
+    return 0;
+}
+
+static void ff_host_usage(const char *prog)
+{
+    printf("usage: %s [options]\n", prog);
+    printf("    -w list    workloads, comma separated: compat,seq,rand,small,dir,all (default all but compat)\n");
+    printf("    -f type    format the volume as fat32, exfat or any (default any)\n");
+    printf("    -r us      latency of a read command\n");
+    printf("    -W us      latency of a write command\n");
+    printf("    -y us      latency of a cache flush\n");
+    printf("    -b MB/s    transfer rate of the device, 0 for none\n");
+    printf("    -v         add the device time to the clock instead of waiting\n");
+    printf("    -s MB      size of the sequential file (default %lu)\n", (unsigned long)opts.seq_mb);
+    printf("    -i bytes   transfer size of the sequential workload (default %u)\n", opts.io_size);
+    printf("    -n ops     operations of the random workload (default %lu)\n", (unsigned long)opts.rand_ops);
+    printf("    -N files   files of the small file workload (default %lu)\n", (unsigned long)opts.small_files);
+    printf("    -S seed    seed of the random workload (default %lu)\n", (unsigned long)opts.seed);
+    printf("disk: %u MB, %u bytes/sector\n", CONFIG_FATFS_RAM_DISK_SIZE_MB, CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE);
+}
+
+static int ff_host_parse_workloads(char *list)
+{
+    char *name;
+    char *save = NULL;
+    UINT i;
+
+    opts.workloads = 0;
+    for (name = strtok_r(list, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save))
+    {
+        for (i = 0; i < ARRAY_SIZE(workload_names); i++)
+        {
+            if (!strcmp(name, workload_names[i].name))
+            {
+                opts.workloads |= workload_names[i].mask;
+                break;
+            }
+        }
+
+        if (i == ARRAY_SIZE(workload_names))
+        {
+            fprintf(stderr, "unknown workload %s\n", name);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int ff_host_parse_args(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:f:r:W:y:b:vs:i:n:N:S:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'w':
+                if (ff_host_parse_workloads(optarg))
+                {
+                    return -1;
+                }
+                break;
+            case 'f':
+                if (!strcmp(optarg, "fat32"))
+                {
+                    opts.fmt = FM_FAT32;
+                }
+                else if (!strcmp(optarg, "exfat"))
+                {
+                    opts.fmt = FM_EXFAT;
+                }
+                else if (!strcmp(optarg, "any"))
+                {
+                    opts.fmt = 0;
+                }
+                else
+                {
+                    fprintf(stderr, "unknown format %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'r':
+                opts.disk.read_lat_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'W':
+                opts.disk.write_lat_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'y':
+                opts.disk.sync_lat_us = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                opts.disk.bandwidth_mbps = strtoul(optarg, NULL, 0);
+                break;
+            case 'v':
+                opts.disk.virtual_time = TRUE;
+                break;
+            case 's':
+                opts.seq_mb = strtoul(optarg, NULL, 0);
+                break;
+            case 'i':
+                opts.io_size = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                opts.rand_ops = strtoul(optarg, NULL, 0);
+                break;
+            case 'N':
+                opts.small_files = strtoul(optarg, NULL, 0);
+                break;
+            case 'S':
+                opts.seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                ff_host_usage(argv[0]);
+                return -1;
+        }
+    }
+
+    if ((opts.io_size == 0) || (opts.seq_mb == 0) ||
+        ((QWORD)(opts.seq_mb + opts.rand_mb) * SZ_1M >= FF_HOST_DISK_SIZE))
+    {
+        fprintf(stderr, "bad size, the files must fit in the %u MB disk\n", CONFIG_FATFS_RAM_DISK_SIZE_MB);
+        return -1;
+    }
+
+    rand_state = (opts.seed != 0) ? opts.seed : 1;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *const fs_type[] = {"", "fat12", "fat16", "fat32", "exfat"};
+    MKFS_PARM mkfs_opt = {.fmt = FM_ANY, .n_fat = 1, .align = 0, .n_root = 0, .au_size = 0};
+    BYTE *work;
+    void *disk_mem;
+    FRESULT res;
+    int ret = 0;
+    UINT buf_size;
+
+    FAssertSetCB(ff_host_assert_cb);
+    if (ff_host_parse_args(argc, argv))
+    {
+        return 2;
+    }
+
+    /* the ram disk driver works on the memory at CONFIG_FATFS_RAM_DISK_BASE */
+    disk_mem = mmap((void *)(uintptr)CONFIG_FATFS_RAM_DISK_BASE, FF_HOST_DISK_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (disk_mem != (void *)(uintptr)CONFIG_FATFS_RAM_DISK_BASE)
+    {
+        fprintf(stderr, "failed to map the ram disk at 0x%llx\n", (unsigned long long)CONFIG_FATFS_RAM_DISK_BASE);
+        return 1;
+    }
+
+    buf_size = opts.io_size;
+    buf_size = (opts.rand_size > buf_size) ? opts.rand_size : buf_size;
+    buf_size = (opts.small_size > buf_size) ? opts.small_size : buf_size;
+    io_buf = ff_memalign(buf_size, 64);
+    work = ff_memalign(FF_MAX_SS * 64, 64);
+    FASSERT(io_buf && work);
+
+    ff_diskio_register_ram(FF_HOST_DRV);
+    ff_host_disk_attach(FF_HOST_DRV, &opts.disk);
+
+    printf("config: disk_mb=%u sector_size=%u cache=%d read_lat_us=%lu write_lat_us=%lu sync_lat_us=%lu bandwidth_mbps=%lu virtual_time=%d\n",
+           CONFIG_FATFS_RAM_DISK_SIZE_MB, CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE,
+#ifdef CONFIG_FATFS_CACHE
+           1,
+#else
+           0,
+#endif
+           (unsigned long)opts.disk.read_lat_us, (unsigned long)opts.disk.write_lat_us,
+           (unsigned long)opts.disk.sync_lat_us, (unsigned long)opts.disk.bandwidth_mbps,
+           opts.disk.virtual_time);
+
+    /* the compatibility test writes the raw sectors, so it runs before the format */
+    if (opts.workloads & FF_HOST_WL_COMPAT)
+    {
+        if (ff_cycle_test(FF_HOST_MOUNT_POINT, 1) != 0)
+        {
+            return 1;
+        }
+        ff_host_dump_disk("compat");
+    }
+
+    if ((opts.workloads & FF_HOST_WL_ALL) == 0)
+    {
+        return 0;
+    }
+
+    if (opts.fmt != 0)
+    {
+        mkfs_opt.fmt = opts.fmt;
+    }
+
+    res = f_mkfs(FF_HOST_MOUNT_POINT, &mkfs_opt, work, FF_MAX_SS * 64);
+    if (res == FR_MKFS_ABORTED)
+    {
+        fprintf(stderr, "the %u MB disk does not fit the format, try a larger DISK_MB\n", CONFIG_FATFS_RAM_DISK_SIZE_MB);
+        return 1;
+    }
+
+    if (res == FR_OK)
+    {
+        res = f_mount(&host_fs, FF_HOST_MOUNT_POINT, 1);
+    }
+
+    if (res != FR_OK)
+    {
+        fprintf(stderr, "failed to set up the volume, res = %d\n", res);
+        return 1;
+    }
+
+    printf("volume: format=%s cluster_size=%lu\n", fs_type[host_fs.fs_type],
+           (unsigned long)host_fs.csize * CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE);
+    ff_host_dump_disk("mkfs");
+
+    if (opts.workloads & FF_HOST_WL_SEQ)
+    {
+        ret |= ff_host_seq_test();
+        ff_host_dump_disk("seq");
+    }
+
+    if (opts.workloads & FF_HOST_WL_RAND)
+    {
+        ret |= ff_host_rand_test();
+        ff_host_dump_disk("rand");
+    }
+
+    if (opts.workloads & FF_HOST_WL_SMALL)
+    {
+        ret |= ff_host_small_test();
+        ff_host_dump_disk("small");
+    }
+
+    if (opts.workloads & FF_HOST_WL_DIR)
+    {
+        ret |= ff_host_dir_test();
+        ff_host_dump_disk("dir");
+    }
+
+    res = f_unmount(FF_HOST_MOUNT_POINT);
+    if (res != FR_OK)
+    {
+        ret = -1;
+    }
+
+    ff_memfree(work);
+    ff_memfree(io_buf);
+    (void)munmap(disk_mem, FF_HOST_DISK_SIZE);
+
+    printf("status: %s\n", (ret == 0) ? "pass" : "fail");
+    return (ret == 0) ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_host_disk.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the simulated device of the fatfs host build, it adds the command latency and the transfer time of a device to the ram disk
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <string.h>
+#include <time.h>
+#include "fassert.h"
+#include "fkernel.h"
+#include "ff_host_disk.h"
+
+typedef struct
+{
+    const ff_diskio_driver_t *drv;  /* driver under the simulated device */
+    ff_host_disk_config config;
+    ff_host_disk_stats stats;
+    QWORD virtual_us;
+    WORD ss;
+} ff_host_disk;
+
+static ff_host_disk host_disk;
+
+static QWORD ff_host_disk_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (QWORD)ts.tv_sec * 1000000000ULL + (QWORD)ts.tv_nsec;
+}
+
+/* the device is busy for us, the short waits spin so that they are not stretched by the timer slack */
+static void ff_host_disk_busy(QWORD us)
+{
+    QWORD end;
+
+    if (us == 0)
+    {
+        return;
+    }
+
+    host_disk.stats.busy_us += us;
+    if (host_disk.config.virtual_time)
+    {
+        host_disk.virtual_us += us;
+        return;
+    }
+
+    end = ff_host_disk_now_ns() + us * 1000ULL;
+    if (us > 200)
+    {
+        struct timespec ts = {.tv_sec = (time_t)((us - 100) / 1000000ULL),
+                              .tv_nsec = (long)((us - 100) % 1000000ULL * 1000ULL)};
+        (void)nanosleep(&ts, NULL);
+    }
+
+    while (ff_host_disk_now_ns() < end)
+    {
+        ;
+    }
+}
+
+static QWORD ff_host_disk_transfer_us(UINT count)
+{
+    if (host_disk.config.bandwidth_mbps == 0)
+    {
+        return 0;
+    }
+
+    return (QWORD)count * host_disk.ss * 1000000ULL / ((QWORD)host_disk.config.bandwidth_mbps * SZ_1M);
+}
+
+static DSTATUS ff_host_disk_status(BYTE pdrv)
+{
+    return host_disk.drv->status(pdrv);
+}
+
+static DSTATUS ff_host_disk_initialize(BYTE pdrv)
+{
+    return host_disk.drv->init(pdrv);
+}
+
+static DRESULT ff_host_disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+    host_disk.stats.read_cmds++;
+    host_disk.stats.read_sectors += count;
+    ff_host_disk_busy(host_disk.config.read_lat_us + ff_host_disk_transfer_us(count));
+    return host_disk.drv->read(pdrv, buff, sector, count);
+}
+
+static DRESULT ff_host_disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    host_disk.stats.write_cmds++;
+    host_disk.stats.write_sectors += count;
+    ff_host_disk_busy(host_disk.config.write_lat_us + ff_host_disk_transfer_us(count));
+    return host_disk.drv->write(pdrv, buff, sector, count);
+}
+
+static DRESULT ff_host_disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+    if (cmd == CTRL_SYNC)
+    {
+        host_disk.stats.sync_cmds++;
+        ff_host_disk_busy(host_disk.config.sync_lat_us);
+    }
+
+    return host_disk.drv->ioctl(pdrv, cmd, buff);
+}
+
+static const ff_diskio_driver_t host_disk_drv =
+{
+    .init = &ff_host_disk_initialize,
+    .status = &ff_host_disk_status,
+    .read = &ff_host_disk_read,
+    .write = &ff_host_disk_write,
+    .ioctl = &ff_host_disk_ioctl
+};
+
+void ff_host_disk_attach(BYTE pdrv, const ff_host_disk_config *config)
+{
+    FASSERT(config);
+
+    memset(&host_disk, 0, sizeof(host_disk));
+    host_disk.drv = ff_diskio_get_driver(pdrv);
+    FASSERT_MSG(host_disk.drv != NULL, "No driver registered as drive-%d.", pdrv);
+    host_disk.config = *config;
+    host_disk.ss = FF_MIN_SS;
+    (void)host_disk.drv->ioctl(pdrv, GET_SECTOR_SIZE, &host_disk.ss);
+
+    ff_diskio_register(pdrv, &host_disk_drv);
+}
+
+void ff_host_disk_get_stats(ff_host_disk_stats *stats, BYTE reset)
+{
+    FASSERT(stats);
+
+    *stats = host_disk.stats;
+    if (reset)
+    {
+        memset(&host_disk.stats, 0, sizeof(host_disk.stats));
+    }
+}
+
+QWORD ff_host_disk_virtual_us(void)
+{
+    return host_disk.virtual_us;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_host_disk.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the simulated device of the fatfs host build, it adds the command latency and the transfer time of a device to the ram disk
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FF_HOST_DISK_H
+#define FF_HOST_DISK_H
+
+#include "ff.h"
+#include "diskio.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    DWORD read_lat_us;      /* latency of a read command */
+    DWORD write_lat_us;     /* latency of a write command */
+    DWORD sync_lat_us;      /* latency of CTRL_SYNC */
+    DWORD bandwidth_mbps;   /* transfer rate in MB/s, 0 for no transfer time */
+    BYTE virtual_time;      /* add the device time to the clock instead of waiting */
+} ff_host_disk_config;
+
+typedef struct
+{
+    QWORD read_cmds;
+    QWORD write_cmds;
+    QWORD sync_cmds;
+    QWORD read_sectors;
+    QWORD write_sectors;
+    QWORD busy_us;          /* device time of all commands */
+} ff_host_disk_stats;
+
+/* put the simulated device over the driver registered as pdrv */
+void ff_host_disk_attach(BYTE pdrv, const ff_host_disk_config *config);
+
+void ff_host_disk_get_stats(ff_host_disk_stats *stats, BYTE reset);
+
+/* device time added to the clock in the virtual time mode */
+QWORD ff_host_disk_virtual_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_host_osal.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the os releated functions of the fatfs host build on linux
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "ff_host_disk.h"
+
+void *ff_memalloc(UINT msize)
+{
+    return calloc(1, msize);
+}
+
+void *ff_memalign(UINT msize, UINT align)
+{
+    void *result = NULL;
+
+    if (posix_memalign(&result, align, msize) != 0)
+    {
+        return NULL;
+    }
+
+    memset(result, 0, msize);
+    return result;
+}
+
+void ff_memfree(void *mblock)
+{
+    free(mblock);
+}
+
+DWORD get_fattime(void)
+{
+    time_t now = time(NULL);
+    struct tm tm;
+
+    (void)localtime_r(&now, &tm);
+    return ((DWORD)(tm.tm_year - 80) << 25)
+           | ((DWORD)(tm.tm_mon + 1) << 21)
+           | ((DWORD)tm.tm_mday << 16)
+           | (WORD)(tm.tm_hour << 11)
+           | (WORD)(tm.tm_min << 5)
+           | (WORD)(tm.tm_sec >> 1);
+}
+
+void ff_systimer_start(void)
+{
+}
+
+/* us of the host clock, plus the device time in the virtual time mode */
+QWORD ff_systimer_get_tick(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (QWORD)ts.tv_sec * 1000000ULL + (QWORD)ts.tv_nsec / 1000ULL + ff_host_disk_virtual_us();
+}
+
+QWORD ff_systimer_get_tick_rate(void)
+{
+    return 1000000ULL;
+}
+
+void ff_systimer_tick_to_time(QWORD ticks, DWORD *sec, DWORD *msec)
+{
+    if (sec)
+    {
+        *sec = (DWORD)(ticks / 1000000ULL);
+    }
+
+    if (msec)
+    {
+        *msec = (DWORD)(ticks % 1000000ULL / 1000ULL);
+    }
+}
+
+void ff_systimer_stop(void)
+{
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fdebug.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the debug print of the fatfs host build, the log goes to stdout
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FDEBUG_H
+#define FDEBUG_H
+
+#include <stdio.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "ftypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+    FT_LOG_NONE,
+    FT_LOG_ERROR,
+    FT_LOG_WARN,
+    FT_LOG_INFO,
+    FT_LOG_DEBUG,
+    FT_LOG_VERBOSE
+} ft_log_level_t;
+
+#ifdef CONFIG_LOG_VERBOS
+#define LOG_LOCAL_LEVEL FT_LOG_VERBOSE
+#elif defined(CONFIG_LOG_ERROR)
+#define LOG_LOCAL_LEVEL FT_LOG_ERROR
+#elif defined(CONFIG_LOG_WARN)
+#define LOG_LOCAL_LEVEL FT_LOG_WARN
+#elif defined(CONFIG_LOG_INFO)
+#define LOG_LOCAL_LEVEL FT_LOG_INFO
+#elif defined(CONFIG_LOG_DEBUG)
+#define LOG_LOCAL_LEVEL FT_LOG_DEBUG
+#else
+#define LOG_LOCAL_LEVEL FT_LOG_NONE
+#endif
+
+#define FT_HOST_LOG(level, letter, tag, format, ...)                        \
+    do                                                                      \
+    {                                                                       \
+        if (LOG_LOCAL_LEVEL >= (level))                                     \
+        {                                                                   \
+            printf(letter " %s: " format "\r\n", tag, ##__VA_ARGS__);       \
+        }                                                                   \
+    } while (0)
+
+#define FT_DEBUG_PRINT_E(TAG, format, ...) FT_HOST_LOG(FT_LOG_ERROR, "E", TAG, format, ##__VA_ARGS__)
+#define FT_DEBUG_PRINT_W(TAG, format, ...) FT_HOST_LOG(FT_LOG_WARN, "W", TAG, format, ##__VA_ARGS__)
+#define FT_DEBUG_PRINT_I(TAG, format, ...) FT_HOST_LOG(FT_LOG_INFO, "I", TAG, format, ##__VA_ARGS__)
+#define FT_DEBUG_PRINT_D(TAG, format, ...) FT_HOST_LOG(FT_LOG_DEBUG, "D", TAG, format, ##__VA_ARGS__)
+#define FT_DEBUG_PRINT_V(TAG, format, ...) FT_HOST_LOG(FT_LOG_VERBOSE, "V", TAG, format, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fmmu.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the mmu map of the fatfs host build, the ram disk
+ * memory is mapped by the host harness before the disk is registered
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FMMU_H
+#define FMMU_H
+
+#include "ftypes.h"
+
+#define MT_NORMAL       0U
+#define MT_P_RW_U_RW    0U
+#define MT_NS           0U
+
+static inline int FMmuMap(uintptr virt, uintptr phys, fsize_t size, u32 flags)
+{
+    (void)virt;
+    (void)phys;
+    (void)size;
+    (void)flags;
+    return 0;
+}
+
+#endif
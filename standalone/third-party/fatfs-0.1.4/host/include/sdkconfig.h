@@ -0,0 +1,42 @@
+#ifndef SDK_CONFIG_H__
+#define SDK_CONFIG_H__
+
+/* FATFS Configuration for the host build, see host/makefile */
+
+#define CONFIG_USE_FATFS_0_1_4
+#define CONFIG_FATFS_RAM_DISK
+#define CONFIG_FATFS_RAM_DISK_BASE 0x200000000000
+#ifndef CONFIG_FATFS_RAM_DISK_SIZE_MB
+#define CONFIG_FATFS_RAM_DISK_SIZE_MB 256
+#endif
+#ifndef CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE
+#define CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE 512
+#endif
+#define CONFIG_FATFS_VOLUME_COUNT 7
+#define CONFIG_FATFS_LFN_HEAP
+#define CONFIG_FATFS_MAX_LFN 255
+#define CONFIG_FATFS_FS_LOCK 0
+#define CONFIG_FATFS_TIMEOUT_MS 10000
+#define CONFIG_FATFS_PER_FILE_CACHE
+#define CONFIG_FATFS_USE_FASTSEEK
+#define CONFIG_FATFS_USE_TRIM
+#if CONFIG_FATFS_RAM_DISK_SECTOR_SIZE_BYTE > 512
+#define CONFIG_FATFS_MAX_SS_4096
+#endif
+
+#ifdef CONFIG_FATFS_CACHE
+#ifndef CONFIG_FATFS_CACHE_BLOCK_SECTORS
+#define CONFIG_FATFS_CACHE_BLOCK_SECTORS 8
+#endif
+#ifndef CONFIG_FATFS_CACHE_BLOCKS
+#define CONFIG_FATFS_CACHE_BLOCKS 64
+#endif
+#ifndef CONFIG_FATFS_CACHE_READAHEAD_BLOCKS
+#define CONFIG_FATFS_CACHE_READAHEAD_BLOCKS 4
+#endif
+#endif
+
+/* Log Configuration */
+#define CONFIG_LOG_ERROR
+
+#endif
@@ -13,6 +13,10 @@ ifdef CONFIG_FATFS_SDMMC
 	BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fatfs-0.1.4/port/sdmmc
 endif #CONFIG_FATFS_SDMMC
 
+ifdef CONFIG_FATFS_NVME
+	BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fatfs-0.1.4/port/nvme
+endif #CONFIG_FATFS_NVME
+
 ifdef CONFIG_USE_BAREMETAL
 	BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fatfs-0.1.4/osal
 	ifdef CONFIG_FATFS_USB
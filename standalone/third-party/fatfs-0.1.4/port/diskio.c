@@ -23,6 +23,10 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   add ff_diskio_get_driver
+ * 1.2   phytium    2026/10/19   go through the write-back sector cache
+ * 1.3   phytium    2026/10/19   lock the drive in the disk functions when fatfs is reentrant
+ * 1.4   phytium    2026/10/19   add nvme drive
  */
 
 /*-----------------------------------------------------------------------*/
@@ -42,6 +46,7 @@
 
 #include "ff.h"     /* Obtains integer types */
 #include "diskio.h" /* Declarations of disk functions */
+#include "ff_cache.h"
 
 #define FF_DEBUG_TAG          "FATFS"
 #define FF_ERROR(format, ...) FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
@@ -52,6 +57,18 @@
 
 static const ff_diskio_driver_t *diskio_drv_list[FF_VOLUMES] = {NULL};
 
+#if FF_FS_REENTRANT
+/* the volume lock of fatfs does not cover the partitions sharing a drive,
+   the drive lock serializes the driver and the sector cache of the drive */
+static FF_SYNC_t diskio_lock[FF_VOLUMES];
+
+#define DISKIO_LOCK(pdrv)   ff_req_grant(diskio_lock[pdrv])
+#define DISKIO_UNLOCK(pdrv) ff_rel_grant(diskio_lock[pdrv])
+#else
+#define DISKIO_LOCK(pdrv)   1
+#define DISKIO_UNLOCK(pdrv)
+#endif
+
 #if FF_MULTI_PARTITION /* Multiple partition configuration */
 PARTITION VolToPart[] = {
     {0, 0}, /* Logical drive 0 ==> Physical drive 0, auto detection */
@@ -132,6 +149,13 @@ int ff_diskio_get_available_volume(const TCHAR *mount_point, BYTE *out_pdrv)
         ret = FF_VOL_FOUND;
 #endif
     }
+    else if (!strcmp(mount_point, FF_NVME_DISK_MOUNT_POINT))
+    {
+#if FF_VOLUMES > 7
+        *out_pdrv = 7;
+        ret = FF_VOL_FOUND;
+#endif
+    }
 
     return ret;
 }
@@ -150,6 +174,14 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_driver_t *diskio_drv)
         return;
     }
 
+#if FF_FS_REENTRANT
+    if ((diskio_lock[pdrv] == NULL) && !ff_cre_syncobj(pdrv, &diskio_lock[pdrv]))
+    {
+        FF_ERROR("Create lock of drive-%d failed.", pdrv);
+        return;
+    }
+#endif
+
     diskio_drv_list[pdrv] = diskio_drv;
 
     FF_DEBUG("pdrv = %d", pdrv);
@@ -161,6 +193,13 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_driver_t *diskio_drv)
     return;
 }
 
+const ff_diskio_driver_t *ff_diskio_get_driver(BYTE pdrv)
+{
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+
+    return diskio_drv_list[pdrv];
+}
+
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
@@ -168,8 +207,16 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_driver_t *diskio_drv)
 DSTATUS disk_status(BYTE pdrv /* Physical drive nmuber to identify the drive */
 )
 {
+    DSTATUS stat;
+
     FASSERT_MSG(diskio_drv_list[pdrv] != NULL, "pdrv = %d", pdrv);
-    return diskio_drv_list[pdrv]->status(pdrv); /* init disk */
+    if (!DISKIO_LOCK(pdrv))
+    {
+        return STA_NOINIT;
+    }
+    stat = diskio_drv_list[pdrv]->status(pdrv);
+    DISKIO_UNLOCK(pdrv);
+    return stat;
 }
 
 
@@ -180,8 +227,22 @@ DSTATUS disk_status(BYTE pdrv /* Physical drive nmuber to identify the drive */
 DSTATUS disk_initialize(BYTE pdrv /* Physical drive nmuber to identify the drive */
 )
 {
+    DSTATUS stat;
+
     FASSERT_MSG(diskio_drv_list[pdrv] != NULL, "pdrv = %d", pdrv);
-    return diskio_drv_list[pdrv]->init(pdrv); /* init disk */
+    if (!DISKIO_LOCK(pdrv))
+    {
+        return STA_NOINIT;
+    }
+    stat = diskio_drv_list[pdrv]->init(pdrv); /* init disk */
+#ifdef CONFIG_FATFS_CACHE
+    if (!(stat & STA_NOINIT))
+    {
+        ff_cache_attach(pdrv, diskio_drv_list[pdrv]);
+    }
+#endif
+    DISKIO_UNLOCK(pdrv);
+    return stat;
 }
 
 
@@ -195,8 +256,20 @@ DRESULT disk_read(BYTE pdrv,    /* Physical drive nmuber to identify the drive *
                   UINT count    /* Number of sectors to read */
 )
 {
+    DRESULT res;
+
     FASSERT_MSG(diskio_drv_list[pdrv] != NULL, "pdrv = %d", pdrv);
-    return diskio_drv_list[pdrv]->read(pdrv, buff, sector, count);
+    if (!DISKIO_LOCK(pdrv))
+    {
+        return RES_NOTRDY;
+    }
+#ifdef CONFIG_FATFS_CACHE
+    res = ff_cache_read(pdrv, diskio_drv_list[pdrv], buff, sector, count);
+#else
+    res = diskio_drv_list[pdrv]->read(pdrv, buff, sector, count);
+#endif
+    DISKIO_UNLOCK(pdrv);
+    return res;
 }
 
 
@@ -212,8 +285,20 @@ DRESULT disk_write(BYTE pdrv,        /* Physical drive nmuber to identify the dr
                    UINT count        /* Number of sectors to write */
 )
 {
+    DRESULT res;
+
     FASSERT_MSG(diskio_drv_list[pdrv] != NULL, "pdrv = %d", pdrv);
-    return diskio_drv_list[pdrv]->write(pdrv, buff, sector, count);
+    if (!DISKIO_LOCK(pdrv))
+    {
+        return RES_NOTRDY;
+    }
+#ifdef CONFIG_FATFS_CACHE
+    res = ff_cache_write(pdrv, diskio_drv_list[pdrv], buff, sector, count);
+#else
+    res = diskio_drv_list[pdrv]->write(pdrv, buff, sector, count);
+#endif
+    DISKIO_UNLOCK(pdrv);
+    return res;
 }
 
 #endif
@@ -228,6 +313,28 @@ DRESULT disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
                    void *buff /* Buffer to send/receive control data */
 )
 {
+    DRESULT res = RES_OK;
+
     FASSERT_MSG(diskio_drv_list[pdrv] != NULL, "pdrv = %d", pdrv);
-    return diskio_drv_list[pdrv]->ioctl(pdrv, cmd, buff);
+    if (!DISKIO_LOCK(pdrv))
+    {
+        return RES_NOTRDY;
+    }
+#ifdef CONFIG_FATFS_CACHE
+    if (cmd == CTRL_SYNC)
+    {
+        /* delayed writes go to the disk before the disk cache is flushed */
+        res = ff_cache_sync(pdrv, diskio_drv_list[pdrv]);
+    }
+    else if (cmd == CTRL_TRIM)
+    {
+        ff_cache_discard(pdrv, ((LBA_t *)buff)[0], ((LBA_t *)buff)[1]);
+    }
+#endif
+    if (res == RES_OK)
+    {
+        res = diskio_drv_list[pdrv]->ioctl(pdrv, cmd, buff);
+    }
+    DISKIO_UNLOCK(pdrv);
+    return res;
 }
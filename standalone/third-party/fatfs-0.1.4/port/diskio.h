@@ -24,6 +24,8 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   add block device layer port
+ * 1.2   phytium    2026/10/19   add nvme port
  */
 
 /*-----------------------------------------------------------------------/
@@ -115,6 +117,15 @@ void ff_diskio_register(BYTE pdrv, const ff_diskio_driver_t *diskio_drv);
 
 #define ff_diskio_unregister(pdrv_) ff_diskio_register(pdrv_, NULL)
 
+/**
+ * Get diskio driver registered for given drive number
+ *
+ * @param pdrv          drive number
+ *
+ * @return  pointer to the registered driver, or NULL if none
+ */
+const ff_diskio_driver_t *ff_diskio_get_driver(BYTE pdrv);
+
 /**
  * Get next available drive number
  *
@@ -198,6 +209,49 @@ void ff_diskio_register_sata(BYTE pdrv);
 void ff_diskio_register_sata_pcie(BYTE pdrv);
 #endif
 
+#ifdef CONFIG_FATFS_NVME
+
+struct disk_info;
+
+/**
+ * Register nvme disk
+ *
+ * The controller is initialized by the caller, the disk is the namespace
+ * disk of nvme_controller, e.g. ctrlr->disk. CTRL_SYNC flushes the volatile
+ * write cache and CTRL_TRIM deallocates the sectors.
+ *
+ * @param   BYTE pdrv           drive number
+ * @param   disk                nvme namespace disk
+ */
+void ff_diskio_register_nvme(BYTE pdrv, struct disk_info *disk);
+#endif
+
+#ifdef CONFIG_FATFS_BLOCK_LAYER
+
+struct FFreeRTOSBlockDev;
+
+/**
+ * Queue the disk io of a drive in the block device layer
+ *
+ * The driver registered for pdrv becomes the backend of block device name,
+ * which is registered when the drive is initialized.
+ *
+ * @param   BYTE pdrv           drive number
+ * @param   const char *name    block device name
+ *
+ * @return  0 on success, negative errno if no driver is registered for pdrv
+ */
+int ff_diskio_block_attach(BYTE pdrv, const char *name);
+
+/**
+ * Register block device
+ *
+ * @param   BYTE pdrv           drive number
+ * @param   dev                 registered block device
+ */
+void ff_diskio_register_block(BYTE pdrv, struct FFreeRTOSBlockDev *dev);
+#endif
+
 /* Disk Status Bits (DSTATUS) */
 
 #define STA_NOINIT       0x01 /* Drive not initialized */
@@ -0,0 +1,639 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_cache.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the write-back sector cache between fatfs and the diskio drivers,
+ * each drive keeps an LRU of multi-sector blocks, sequential reads load the following blocks
+ * ahead and dirty blocks go to the disk on eviction or CTRL_SYNC.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   trim keeps the blocks partly outside the range
+ */
+
+#include <string.h>
+#include "fdebug.h"
+#include "fassert.h"
+#include "ff.h"
+#include "diskio.h"
+#include "ff_cache.h"
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FATFS_CACHE
+
+#define FF_DEBUG_TAG "FATFS-CACHE"
+#define FF_ERROR(format, ...) FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_INFO(format, ...)  FT_DEBUG_PRINT_I(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_DEBUG(format, ...) FT_DEBUG_PRINT_D(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_WARN(format, ...)  FT_DEBUG_PRINT_W(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#define FF_CACHE_BLOCK_SECTORS  CONFIG_FATFS_CACHE_BLOCK_SECTORS
+#define FF_CACHE_BLOCKS         CONFIG_FATFS_CACHE_BLOCKS
+/* keep half of the blocks out of one readahead */
+#define FF_CACHE_READAHEAD      ((CONFIG_FATFS_CACHE_READAHEAD_BLOCKS < FF_CACHE_BLOCKS / 2) ? \
+                                 CONFIG_FATFS_CACHE_READAHEAD_BLOCKS : (FF_CACHE_BLOCKS / 2))
+
+#if FF_USE_LFN != 3
+void *ff_memalloc(UINT msize);
+void ff_memfree(void *mblock);
+#endif
+
+typedef struct
+{
+    LBA_t start;    /* first sector, aligned to FF_CACHE_BLOCK_SECTORS */
+    UINT count;     /* sectors, less than FF_CACHE_BLOCK_SECTORS at the end of the disk */
+    BYTE valid;
+    BYTE dirty;
+    BYTE ahead;     /* loaded by readahead and not used yet */
+    DWORD stamp;    /* last use, the smallest one is evicted */
+    BYTE *data;
+} ff_cache_block;
+
+/* the cache of a drive is used under the volume lock of fatfs like the drive itself */
+typedef struct
+{
+    BYTE ready;
+    UINT ss;                /* sector size in bytes */
+    LBA_t sector_count;
+    DWORD clock;
+    LBA_t next_read;        /* sector after the block of the last cached read, a miss here is sequential */
+    BYTE *mem;              /* data of the blocks */
+    BYTE *ra_buf;           /* a block and the readahead blocks in one disk read */
+    ff_cache_block blocks[FF_CACHE_BLOCKS];
+    ff_cache_stats stats;
+} ff_cache;
+
+static ff_cache cache_list[FF_VOLUMES];
+
+static inline LBA_t ff_cache_block_start(LBA_t sector)
+{
+    return sector - (sector % FF_CACHE_BLOCK_SECTORS);
+}
+
+static UINT ff_cache_block_count(const ff_cache *cache, LBA_t start)
+{
+    LBA_t left = cache->sector_count - start;
+
+    return (left < FF_CACHE_BLOCK_SECTORS) ? (UINT)left : FF_CACHE_BLOCK_SECTORS;
+}
+
+static ff_cache_block *ff_cache_lookup(ff_cache *cache, LBA_t start)
+{
+    UINT i;
+
+    for (i = 0; i < FF_CACHE_BLOCKS; i++)
+    {
+        if (cache->blocks[i].valid && (cache->blocks[i].start == start))
+        {
+            return &cache->blocks[i];
+        }
+    }
+
+    return NULL;
+}
+
+static inline void ff_cache_touch(ff_cache *cache, ff_cache_block *blk)
+{
+    blk->stamp = ++cache->clock;
+}
+
+static DRESULT ff_cache_writeback(BYTE pdrv, const ff_diskio_driver_t *drv, ff_cache *cache, ff_cache_block *blk)
+{
+    DRESULT res;
+
+    if (!blk->dirty)
+    {
+        return RES_OK;
+    }
+
+    cache->stats.disk_writes++;
+    res = drv->write(pdrv, blk->data, blk->start, blk->count);
+    if (res != RES_OK)
+    {
+        FF_ERROR("Write back sector %lu (count %u) of drive-%d failed, %d.",
+                 (unsigned long)blk->start, blk->count, pdrv, res);
+        return res;
+    }
+
+    blk->dirty = 0;
+    cache->stats.writebacks++;
+    return RES_OK;
+}
+
+/* take a free block, or write back and take the least recently used one */
+static ff_cache_block *ff_cache_victim(BYTE pdrv, const ff_diskio_driver_t *drv, ff_cache *cache, DRESULT *res)
+{
+    ff_cache_block *victim = NULL;
+    UINT i;
+
+    for (i = 0; i < FF_CACHE_BLOCKS; i++)
+    {
+        if (!cache->blocks[i].valid)
+        {
+            victim = &cache->blocks[i];
+            break;
+        }
+
+        if ((victim == NULL) || ((int)(cache->blocks[i].stamp - victim->stamp) < 0))
+        {
+            victim = &cache->blocks[i];
+        }
+    }
+
+    *res = ff_cache_writeback(pdrv, drv, cache, victim);
+    if (*res != RES_OK)
+    {
+        return NULL;
+    }
+
+    victim->valid = 0;
+    victim->ahead = 0;
+    return victim;
+}
+
+/* load the block at start for a read miss, and the blocks after it if the reads are sequential */
+static ff_cache_block *ff_cache_fill(BYTE pdrv, const ff_diskio_driver_t *drv, ff_cache *cache,
+                                     LBA_t start, DRESULT *res)
+{
+    ff_cache_block *blk[FF_CACHE_READAHEAD + 1];
+    LBA_t next;
+    UINT num = 1;
+    UINT total = 0;
+    UINT i;
+
+    if ((FF_CACHE_READAHEAD > 0) && (start == cache->next_read))
+    {
+        for (next = start + FF_CACHE_BLOCK_SECTORS; num <= FF_CACHE_READAHEAD; num++, next += FF_CACHE_BLOCK_SECTORS)
+        {
+            if ((next >= cache->sector_count) || (ff_cache_lookup(cache, next) != NULL))
+            {
+                break;
+            }
+        }
+    }
+
+    /* the taken blocks get the newest stamps, so they are not taken again */
+    for (i = 0; i < num; i++)
+    {
+        blk[i] = ff_cache_victim(pdrv, drv, cache, res);
+        if (blk[i] == NULL)
+        {
+            goto err_out;
+        }
+
+        blk[i]->start = start + (LBA_t)i * FF_CACHE_BLOCK_SECTORS;
+        blk[i]->count = ff_cache_block_count(cache, blk[i]->start);
+        blk[i]->valid = 1;
+        blk[i]->ahead = (i != 0);
+        ff_cache_touch(cache, blk[i]);
+        total += blk[i]->count;
+    }
+
+    cache->stats.disk_reads++;
+    *res = drv->read(pdrv, (num == 1) ? blk[0]->data : cache->ra_buf, start, total);
+    if (*res != RES_OK)
+    {
+        goto err_out;
+    }
+
+    for (i = 1; i < num; i++)
+    {
+        memcpy(blk[i]->data, cache->ra_buf + (UINT)(blk[i]->start - start) * cache->ss,
+               blk[i]->count * cache->ss);
+    }
+
+    if (num > 1)
+    {
+        memcpy(blk[0]->data, cache->ra_buf, blk[0]->count * cache->ss);
+        cache->stats.readahead += num - 1;
+    }
+
+    return blk[0];
+
+err_out:
+    while (i-- > 0)
+    {
+        blk[i]->valid = 0;
+        blk[i]->ahead = 0;
+    }
+    return NULL;
+}
+
+/* cached blocks in [sector, sector + count) */
+static inline int ff_cache_overlap(const ff_cache_block *blk, LBA_t sector, UINT count)
+{
+    return blk->valid && (blk->start < sector + count) && (sector < blk->start + blk->count);
+}
+
+static void ff_cache_free(ff_cache *cache)
+{
+    if (cache->mem != NULL)
+    {
+        ff_memfree(cache->mem);
+        cache->mem = NULL;
+    }
+
+    if (cache->ra_buf != NULL)
+    {
+        ff_memfree(cache->ra_buf);
+        cache->ra_buf = NULL;
+    }
+}
+
+/**
+ * @name: ff_cache_attach
+ * @msg: 驱动初始化成功后建立驱动器的缓存, 获取扇区大小和扇区数, 分配缓存块
+ * @return {void}
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {ff_diskio_driver_t} *drv, 驱动器的diskio驱动
+ * @note: 缓存内存分配失败或无法获取磁盘大小时, 驱动器不经过缓存直接访问磁盘
+ */
+void ff_cache_attach(BYTE pdrv, const ff_diskio_driver_t *drv)
+{
+    ff_cache *cache;
+    LBA_t sector_count = 0;
+    WORD ss = FF_MAX_SS;
+    UINT i;
+
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+    cache = &cache_list[pdrv];
+
+    if (cache->ready)
+    {
+        /* initialized again, dirty blocks left by a volume that was not synced go to the disk first */
+        (void)ff_cache_sync(pdrv, drv);
+        for (i = 0; i < FF_CACHE_BLOCKS; i++)
+        {
+            cache->blocks[i].valid = 0;
+            cache->blocks[i].dirty = 0;
+            cache->blocks[i].ahead = 0;
+        }
+        cache->ready = 0;
+    }
+
+    if ((drv->ioctl(pdrv, GET_SECTOR_COUNT, &sector_count) != RES_OK) || (sector_count == 0))
+    {
+        FF_WARN("Drive-%d has no sector count, cache disabled.", pdrv);
+        return;
+    }
+
+#if FF_MAX_SS != FF_MIN_SS
+    if ((drv->ioctl(pdrv, GET_SECTOR_SIZE, &ss) != RES_OK) || (ss < FF_MIN_SS) || (ss > FF_MAX_SS))
+    {
+        FF_WARN("Drive-%d has no valid sector size, cache disabled.", pdrv);
+        return;
+    }
+#endif
+
+    if ((cache->mem != NULL) && (cache->ss != ss))
+    {
+        ff_cache_free(cache);
+    }
+
+    if (cache->mem == NULL)
+    {
+        cache->mem = ff_memalloc(FF_CACHE_BLOCKS * FF_CACHE_BLOCK_SECTORS * ss);
+        if (FF_CACHE_READAHEAD > 0)
+        {
+            cache->ra_buf = ff_memalloc((FF_CACHE_READAHEAD + 1) * FF_CACHE_BLOCK_SECTORS * ss);
+        }
+
+        if ((cache->mem == NULL) || ((FF_CACHE_READAHEAD > 0) && (cache->ra_buf == NULL)))
+        {
+            FF_WARN("No memory for the cache of drive-%d, cache disabled.", pdrv);
+            ff_cache_free(cache);
+            return;
+        }
+    }
+
+    for (i = 0; i < FF_CACHE_BLOCKS; i++)
+    {
+        cache->blocks[i].data = cache->mem + i * FF_CACHE_BLOCK_SECTORS * ss;
+    }
+
+    cache->ss = ss;
+    cache->sector_count = sector_count;
+    cache->next_read = (LBA_t)-1;
+    cache->ready = 1;
+
+    FF_INFO("Drive-%d cache, %u blocks of %u sectors, readahead %u blocks.",
+            pdrv, FF_CACHE_BLOCKS, FF_CACHE_BLOCK_SECTORS, FF_CACHE_READAHEAD);
+}
+
+/**
+ * @name: ff_cache_read
+ * @msg: 经缓存读取扇区, 不小于一个缓存块的读取直接访问磁盘
+ * @return {DRESULT} RES_OK表示成功
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {ff_diskio_driver_t} *drv, 驱动器的diskio驱动
+ * @param {BYTE} *buff, 读缓冲区
+ * @param {LBA_t} sector, 起始扇区
+ * @param {UINT} count, 扇区数
+ */
+DRESULT ff_cache_read(BYTE pdrv, const ff_diskio_driver_t *drv, BYTE *buff, LBA_t sector, UINT count)
+{
+    ff_cache *cache = &cache_list[pdrv];
+    ff_cache_block *blk;
+    DRESULT res;
+    LBA_t start;
+    UINT off;
+    UINT num;
+    UINT i;
+
+    if (!cache->ready)
+    {
+        return drv->read(pdrv, buff, sector, count);
+    }
+
+    if (count >= FF_CACHE_BLOCK_SECTORS)
+    {
+        /* file data, read from the disk and take the newer sectors of the dirty blocks */
+        cache->stats.bypass_reads++;
+        cache->stats.disk_reads++;
+        res = drv->read(pdrv, buff, sector, count);
+        if (res != RES_OK)
+        {
+            return res;
+        }
+
+        for (i = 0; i < FF_CACHE_BLOCKS; i++)
+        {
+            blk = &cache->blocks[i];
+            if (blk->dirty && ff_cache_overlap(blk, sector, count))
+            {
+                start = (blk->start > sector) ? blk->start : sector;
+                num = (UINT)(((blk->start + blk->count < sector + count) ? (blk->start + blk->count) : (sector + count)) - start);
+                memcpy(buff + (UINT)(start - sector) * cache->ss,
+                       blk->data + (UINT)(start - blk->start) * cache->ss, num * cache->ss);
+            }
+        }
+
+        return RES_OK;
+    }
+
+    while (count > 0)
+    {
+        start = ff_cache_block_start(sector);
+        if (start >= cache->sector_count)
+        {
+            return RES_PARERR;
+        }
+
+        blk = ff_cache_lookup(cache, start);
+        if (blk != NULL)
+        {
+            cache->stats.read_hits++;
+            if (blk->ahead)
+            {
+                blk->ahead = 0;
+                cache->stats.readahead_hits++;
+            }
+        }
+        else
+        {
+            cache->stats.read_misses++;
+            blk = ff_cache_fill(pdrv, drv, cache, start, &res);
+            if (blk == NULL)
+            {
+                return res;
+            }
+        }
+
+        off = (UINT)(sector - start);
+        if (off >= blk->count)
+        {
+            return RES_PARERR;
+        }
+
+        num = blk->count - off;
+        num = (num < count) ? num : count;
+        memcpy(buff, blk->data + off * cache->ss, num * cache->ss);
+        ff_cache_touch(cache, blk);
+        cache->next_read = blk->start + FF_CACHE_BLOCK_SECTORS;
+
+        buff += num * cache->ss;
+        sector += num;
+        count -= num;
+    }
+
+    return RES_OK;
+}
+
+/**
+ * @name: ff_cache_write
+ * @msg: 写入扇区到缓存块并推迟写回磁盘, 不小于一个缓存块的写入直接写磁盘并更新已缓存的扇区
+ * @return {DRESULT} RES_OK表示成功
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {ff_diskio_driver_t} *drv, 驱动器的diskio驱动
+ * @param {BYTE} *buff, 写缓冲区
+ * @param {LBA_t} sector, 起始扇区
+ * @param {UINT} count, 扇区数
+ */
+DRESULT ff_cache_write(BYTE pdrv, const ff_diskio_driver_t *drv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    ff_cache *cache = &cache_list[pdrv];
+    ff_cache_block *blk;
+    DRESULT res;
+    LBA_t start;
+    UINT off;
+    UINT num;
+    UINT i;
+
+    if (!cache->ready)
+    {
+        return drv->write(pdrv, buff, sector, count);
+    }
+
+    if (count >= FF_CACHE_BLOCK_SECTORS)
+    {
+        /* file data, write to the disk and keep the cached copies up to date */
+        cache->stats.bypass_writes++;
+        cache->stats.disk_writes++;
+        res = drv->write(pdrv, buff, sector, count);
+        if (res != RES_OK)
+        {
+            return res;
+        }
+
+        for (i = 0; i < FF_CACHE_BLOCKS; i++)
+        {
+            blk = &cache->blocks[i];
+            if (ff_cache_overlap(blk, sector, count))
+            {
+                start = (blk->start > sector) ? blk->start : sector;
+                num = (UINT)(((blk->start + blk->count < sector + count) ? (blk->start + blk->count) : (sector + count)) - start);
+                memcpy(blk->data + (UINT)(start - blk->start) * cache->ss,
+                       buff + (UINT)(start - sector) * cache->ss, num * cache->ss);
+            }
+        }
+
+        return RES_OK;
+    }
+
+    while (count > 0)
+    {
+        start = ff_cache_block_start(sector);
+        if (start >= cache->sector_count)
+        {
+            return RES_PARERR;
+        }
+
+        off = (UINT)(sector - start);
+        blk = ff_cache_lookup(cache, start);
+        if (blk != NULL)
+        {
+            cache->stats.write_hits++;
+            blk->ahead = 0;
+        }
+        else
+        {
+            cache->stats.write_misses++;
+            blk = ff_cache_victim(pdrv, drv, cache, &res);
+            if (blk == NULL)
+            {
+                return res;
+            }
+
+            blk->start = start;
+            blk->count = ff_cache_block_count(cache, start);
+            if ((off != 0) || (count < blk->count))
+            {
+                /* partial write, the rest of the block comes from the disk */
+                cache->stats.disk_reads++;
+                res = drv->read(pdrv, blk->data, blk->start, blk->count);
+                if (res != RES_OK)
+                {
+                    return res;
+                }
+            }
+            blk->valid = 1;
+        }
+
+        if (off >= blk->count)
+        {
+            return RES_PARERR;
+        }
+
+        num = blk->count - off;
+        num = (num < count) ? num : count;
+        memcpy(blk->data + off * cache->ss, buff, num * cache->ss);
+        blk->dirty = 1;
+        ff_cache_touch(cache, blk);
+
+        buff += num * cache->ss;
+        sector += num;
+        count -= num;
+    }
+
+    return RES_OK;
+}
+
+/**
+ * @name: ff_cache_sync
+ * @msg: 按扇区顺序将驱动器的脏缓存块写回磁盘
+ * @return {DRESULT} RES_OK表示成功, 失败时其余脏块保留在缓存中
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {ff_diskio_driver_t} *drv, 驱动器的diskio驱动
+ */
+DRESULT ff_cache_sync(BYTE pdrv, const ff_diskio_driver_t *drv)
+{
+    ff_cache *cache = &cache_list[pdrv];
+    ff_cache_block *blk;
+    DRESULT res;
+    UINT i;
+
+    if (!cache->ready)
+    {
+        return RES_OK;
+    }
+
+    for (;;)
+    {
+        blk = NULL;
+        for (i = 0; i < FF_CACHE_BLOCKS; i++)
+        {
+            if (cache->blocks[i].dirty && ((blk == NULL) || (cache->blocks[i].start < blk->start)))
+            {
+                blk = &cache->blocks[i];
+            }
+        }
+
+        if (blk == NULL)
+        {
+            return RES_OK;
+        }
+
+        res = ff_cache_writeback(pdrv, drv, cache, blk);
+        if (res != RES_OK)
+        {
+            return res;
+        }
+    }
+}
+
+/**
+ * @name: ff_cache_discard
+ * @msg: 丢弃驱动器完全落在扇区范围内的缓存块, 用于CTRL_TRIM
+ * @return {void}
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {LBA_t} start, 起始扇区
+ * @param {LBA_t} end, 结束扇区(包含)
+ */
+void ff_cache_discard(BYTE pdrv, LBA_t start, LBA_t end)
+{
+    ff_cache *cache = &cache_list[pdrv];
+    ff_cache_block *blk;
+    UINT i;
+
+    for (i = 0; i < FF_CACHE_BLOCKS; i++)
+    {
+        blk = &cache->blocks[i];
+        /* a block partly in the range keeps the sectors outside it, stale
+           sectors of a trimmed range are never read back by fatfs */
+        if (blk->valid && (start <= blk->start) && (blk->start + blk->count - 1 <= end))
+        {
+            blk->valid = 0;
+            blk->dirty = 0;
+            blk->ahead = 0;
+        }
+    }
+}
+
+/**
+ * @name: ff_cache_get_stats
+ * @msg: 获取驱动器缓存的命中, 预读和写回统计
+ * @return {void}
+ * @param {BYTE} pdrv, 驱动器号
+ * @param {ff_cache_stats} *stats, 统计的拷贝
+ * @param {BYTE} reset, 非0则在拷贝后清零统计
+ */
+void ff_cache_get_stats(BYTE pdrv, ff_cache_stats *stats, BYTE reset)
+{
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+    FASSERT(stats);
+
+    *stats = cache_list[pdrv].stats;
+    if (reset)
+    {
+        memset(&cache_list[pdrv].stats, 0, sizeof(cache_list[pdrv].stats));
+    }
+}
+
+#endif
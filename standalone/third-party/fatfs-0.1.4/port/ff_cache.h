@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_cache.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the write-back sector cache between fatfs and the diskio drivers
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FF_CACHE_H
+#define FF_CACHE_H
+
+#include "sdkconfig.h"
+#include "ff.h"
+#include "diskio.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef CONFIG_FATFS_CACHE
+
+typedef struct
+{
+    DWORD read_hits;        /* sector reads served from the cache */
+    DWORD read_misses;      /* sector reads that loaded a block */
+    DWORD write_hits;       /* sector writes into a cached block */
+    DWORD write_misses;     /* sector writes that allocated a block */
+    DWORD readahead;        /* blocks loaded ahead of a sequential read */
+    DWORD readahead_hits;   /* readahead blocks used later */
+    DWORD writebacks;       /* dirty blocks written to the disk */
+    DWORD bypass_reads;     /* large reads sent to the disk directly */
+    DWORD bypass_writes;    /* large writes sent to the disk directly */
+    DWORD disk_reads;       /* read commands to the disk */
+    DWORD disk_writes;      /* write commands to the disk */
+} ff_cache_stats;
+
+/* set up the cache of the drive after the driver init succeeds */
+void ff_cache_attach(BYTE pdrv, const ff_diskio_driver_t *drv);
+
+DRESULT ff_cache_read(BYTE pdrv, const ff_diskio_driver_t *drv, BYTE *buff, LBA_t sector, UINT count);
+
+DRESULT ff_cache_write(BYTE pdrv, const ff_diskio_driver_t *drv, const BYTE *buff, LBA_t sector, UINT count);
+
+/* write all the dirty blocks of the drive to the disk */
+DRESULT ff_cache_sync(BYTE pdrv, const ff_diskio_driver_t *drv);
+
+/* drop the cached sectors from start to end (inclusive), dirty data in the range is lost */
+void ff_cache_discard(BYTE pdrv, LBA_t start, LBA_t end);
+
+/* copy the statistics of the drive, clear them if reset is not zero */
+void ff_cache_get_stats(BYTE pdrv, ff_cache_stats *stats, BYTE reset);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
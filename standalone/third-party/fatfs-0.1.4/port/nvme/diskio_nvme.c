@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: diskio_nvme.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for fatfs port to nvme namespace
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+/*-----------------------------------------------------------------------*/
+/* Low level disk I/O module skeleton for FatFs     (C)ChaN, 2016        */
+/*-----------------------------------------------------------------------*/
+/* If a working storage control module is available, it should be        */
+/* attached to the FatFs via a glue function rather than modifying it.   */
+/* This is an example of glue functions to attach various exsisting      */
+/* storage control modules to the FatFs module with a defined API.       */
+/*-----------------------------------------------------------------------*/
+
+#include <string.h>
+#include "fdebug.h"
+#include "fassert.h"
+#include "fkernel.h"
+#include "fdrivers_port.h"
+#include "diskio.h"
+#include "ffconf.h"
+#include "ff.h"
+
+#include "nvme.h"
+#include "nvme_disk.h"
+#include "nvme_namespace.h"
+
+#if FF_VOLUMES < 8
+#error "nvme disk is mounted at 7:/, CONFIG_FATFS_VOLUME_COUNT must be at least 8"
+#endif
+
+#define FF_DEBUG_TAG          "DISKIO-NVME"
+#define FF_ERROR(format, ...) FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_INFO(format, ...)  FT_DEBUG_PRINT_I(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_DEBUG(format, ...) FT_DEBUG_PRINT_D(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_WARN(format, ...)  FT_DEBUG_PRINT_W(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#define FF_NVME_BUF_ALIGN     64 /* cache line, the bounce buffer is maintained alone */
+
+/* namespace optimal performance fields npwg/npwa/npdg/npda/nows are valid */
+#define FF_NVME_NSFEAT_OPTPERF (1U << 4)
+
+typedef struct
+{
+    struct disk_info *disk;
+    struct nvme_namespace *ns;
+    LBA_t sector_cnt;
+    UINT sector_sz;
+    UINT max_count;   /* sectors of one command, max transfer size of the controller */
+    BYTE init_ok;
+    BYTE bounce[FF_MAX_SS] __attribute__((aligned(FF_NVME_BUF_ALIGN))); /* for buffers not dword aligned */
+} ff_nvme_disk;
+
+static ff_nvme_disk nvme_disks[FF_VOLUMES];
+
+static ff_nvme_disk *get_nvme_disk(BYTE pdrv)
+{
+    if ((pdrv >= FF_VOLUMES) || (nvme_disks[pdrv].disk == NULL))
+    {
+        return NULL;
+    }
+
+    return &nvme_disks[pdrv];
+}
+
+/*-----------------------------------------------------------------------*/
+/* Get Drive Status                                                      */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS ff_nvme_status(BYTE pdrv /* Physical drive nmuber to identify the drive */
+)
+{
+    ff_nvme_disk *disk = get_nvme_disk(pdrv);
+
+    if ((NULL == disk) || !disk->init_ok)
+    {
+        return STA_NOINIT;
+    }
+
+    return 0;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Inidialize a Drive                                                    */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS ff_nvme_initialize(BYTE pdrv /* Physical drive nmuber to identify the drive */
+)
+{
+    ff_nvme_disk *disk = get_nvme_disk(pdrv);
+    uint64_t sector_cnt;
+
+    if (NULL == disk)
+    {
+        return STA_NOINIT;
+    }
+
+    disk->sector_sz = nvme_namespace_get_sector_size(disk->ns);
+    if ((disk->sector_sz < FF_MIN_SS) || (disk->sector_sz > FF_MAX_SS))
+    {
+        FF_ERROR("Sector size %d of %s is not supported.", disk->sector_sz, disk->ns->name);
+        return STA_NOINIT;
+    }
+
+    sector_cnt = nvme_namespace_get_num_sectors(disk->ns);
+#if !FF_LBA64
+    if (sector_cnt > 0xFFFFFFFFULL)
+    {
+        FF_WARN("%s has %llu sectors, only the first 2^32 are used without FATFS_LBA64.",
+                disk->ns->name, sector_cnt);
+        sector_cnt = 0xFFFFFFFFULL;
+    }
+#endif
+    disk->sector_cnt = (LBA_t)sector_cnt;
+    disk->max_count = disk->ns->ctrlr->max_xfer_size / disk->sector_sz;
+    disk->init_ok = TRUE;
+
+    FF_INFO("%s: %llu sectors of %d bytes, trim %s, volatile write cache %s.",
+            disk->ns->name, sector_cnt, disk->sector_sz,
+            (disk->ns->flags & NVME_NS_DEALLOCATE_SUPPORTED) ? "yes" : "no",
+            (disk->ns->flags & NVME_NS_FLUSH_SUPPORTED) ? "yes" : "no");
+    return 0;
+}
+
+/* transfer the sectors of a dword aligned buffer, max_count sectors per command */
+static int ff_nvme_transfer(ff_nvme_disk *disk, BYTE *buff, LBA_t sector, UINT count, boolean write)
+{
+    UINT len;
+    int ret;
+
+    while (count > 0)
+    {
+        len = min(count, disk->max_count);
+
+        /* write back the data before the controller reads it, and the dirty
+           lines of a read buffer before they could be evicted over the data */
+        FDriverDCacheRangeFlush((uintptr_t)buff, (size_t)len * disk->sector_sz);
+        if (write)
+        {
+            ret = nvme_disk_write(disk->disk, buff, sector, len);
+        }
+        else
+        {
+            ret = nvme_disk_read(disk->disk, buff, sector, len);
+            FDriverDCacheRangeInvalidate((uintptr_t)buff, (size_t)len * disk->sector_sz);
+        }
+
+        if (ret != 0)
+        {
+            return ret;
+        }
+
+        buff += (size_t)len * disk->sector_sz;
+        sector += len;
+        count -= len;
+    }
+
+    return 0;
+}
+
+/* one sector at a time through the bounce buffer */
+static int ff_nvme_transfer_bounce(ff_nvme_disk *disk, BYTE *buff, LBA_t sector, UINT count, boolean write)
+{
+    int ret;
+
+    for (; count > 0; count--, sector++, buff += disk->sector_sz)
+    {
+        if (write)
+        {
+            memcpy(disk->bounce, buff, disk->sector_sz);
+        }
+
+        ret = ff_nvme_transfer(disk, disk->bounce, sector, 1, write);
+        if (ret != 0)
+        {
+            return ret;
+        }
+
+        if (!write)
+        {
+            memcpy(buff, disk->bounce, disk->sector_sz);
+        }
+    }
+
+    return 0;
+}
+
+static DRESULT ff_nvme_rw(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count, boolean write)
+{
+    ff_nvme_disk *disk = get_nvme_disk(pdrv);
+    int ret;
+
+    if ((NULL == disk) || !disk->init_ok)
+    {
+        return RES_NOTRDY;
+    }
+
+    if ((count == 0) || (sector >= disk->sector_cnt) || (count > disk->sector_cnt - sector))
+    {
+        return RES_PARERR;
+    }
+
+    if ((uintptr)buff & 0x3)
+    {
+        ret = ff_nvme_transfer_bounce(disk, buff, sector, count, write);
+    }
+    else
+    {
+        ret = ff_nvme_transfer(disk, buff, sector, count, write);
+    }
+
+    if (ret != 0)
+    {
+        FF_ERROR("%s %s sector [%llu-%llu] failed: %d.", write ? "Write" : "Read",
+                 disk->ns->name, (u64)sector, (u64)sector + count - 1, ret);
+        return RES_ERROR;
+    }
+
+    return RES_OK;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)                                                        */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT ff_nvme_read(BYTE pdrv,    /* Physical drive nmuber to identify the drive */
+                               BYTE *buff,   /* Data buffer to store read data */
+                               LBA_t sector, /* Start sector in LBA */
+                               UINT count    /* Number of sectors to read */
+)
+{
+    return ff_nvme_rw(pdrv, buff, sector, count, FALSE);
+}
+
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT ff_nvme_write(BYTE pdrv,        /* Physical drive nmuber to identify the drive */
+                                const BYTE *buff, /* Data to be written */
+                                LBA_t sector,     /* Start sector in LBA */
+                                UINT count        /* Number of sectors to write */
+)
+{
+    return ff_nvme_rw(pdrv, (BYTE *)buff, sector, count, TRUE);
+}
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT ff_nvme_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
+                                BYTE cmd,  /* Control code */
+                                void *buff /* Buffer to send/receive control data */
+)
+{
+    ff_nvme_disk *disk = get_nvme_disk(pdrv);
+    const struct nvme_namespace_data *data;
+    LBA_t *range;
+    int ret;
+
+    if ((NULL == disk) || !disk->init_ok)
+    {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC: /* Flush the volatile write cache */
+            if (!(disk->ns->flags & NVME_NS_FLUSH_SUPPORTED))
+            {
+                return RES_OK;
+            }
+            ret = nvme_disk_flush(disk->disk);
+            if (ret != 0)
+            {
+                FF_ERROR("Flush %s failed: %d.", disk->ns->name, ret);
+                return RES_ERROR;
+            }
+            return RES_OK;
+
+        case GET_SECTOR_COUNT: /* Get number of sectors on the drive */
+            *(LBA_t *)buff = disk->sector_cnt;
+            return RES_OK;
+
+        case GET_SECTOR_SIZE: /* Get size of sector for generic read/write */
+            *(WORD *)buff = (WORD)disk->sector_sz;
+            return RES_OK;
+
+        case GET_BLOCK_SIZE: /* Preferred deallocate granularity in sectors, f_mkfs aligns the data area to it */
+            data = nvme_namespace_get_data(disk->ns);
+            *(DWORD *)buff = (data->nsfeat & FF_NVME_NSFEAT_OPTPERF) ? (DWORD)data->npdg + 1 : 1;
+            return RES_OK;
+
+        case CTRL_TRIM: /* Deallocate the sectors [range[0], range[1]] */
+            range = (LBA_t *)buff;
+            if (!(disk->ns->flags & NVME_NS_DEALLOCATE_SUPPORTED))
+            {
+                return RES_PARERR;
+            }
+            if ((range[1] < range[0]) || (range[1] >= disk->sector_cnt))
+            {
+                return RES_PARERR;
+            }
+            ret = nvme_disk_trim(disk->disk, range[0], (uint64_t)(range[1] - range[0]) + 1);
+            if (ret != 0)
+            {
+                FF_ERROR("Trim %s sector [%llu-%llu] failed: %d.", disk->ns->name,
+                         (u64)range[0], (u64)range[1], ret);
+                return RES_ERROR;
+            }
+            return RES_OK;
+
+        default:
+            return RES_PARERR;
+    }
+}
+
+static const ff_diskio_driver_t ff_nvme_drv = {.init = &ff_nvme_initialize,
+                                                 .status = &ff_nvme_status,
+                                                 .read = &ff_nvme_read,
+                                                 .write = &ff_nvme_write,
+                                                 .ioctl = &ff_nvme_ioctl};
+
+void ff_diskio_register_nvme(BYTE pdrv, struct disk_info *disk)
+{
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+    FASSERT(disk && disk->ns);
+
+    memset(&nvme_disks[pdrv], 0, sizeof(nvme_disks[pdrv]));
+    nvme_disks[pdrv].disk = disk;
+    nvme_disks[pdrv].ns = (struct nvme_namespace *)disk->ns;
+    ff_diskio_register(pdrv, &ff_nvme_drv);
+
+    printf("Create nvme disk %s as driver-%d\r\n", nvme_disks[pdrv].ns->name, pdrv);
+}
@@ -23,6 +23,8 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   sector and sector count in LBA_t
+ * 1.2   phytium    2026/10/19   mark the unused drive number
  */
 
 /*-----------------------------------------------------------------------*/
@@ -74,6 +76,7 @@ static DSTATUS ram_disk_status(BYTE pdrv /* Physical drive nmuber to identify th
 {
     ff_ram_disk *disk = &ram_disk;
 
+    FUNUSED(pdrv);
     if (FF_DRV_NOT_USED == disk->pdrv)
     {
         return STA_NOINIT;
@@ -89,6 +92,7 @@ static DSTATUS ram_disk_status(BYTE pdrv /* Physical drive nmuber to identify th
 static DSTATUS ram_disk_initialize(BYTE pdrv /* Physical drive nmuber to identify the drive */
 )
 {
+    FUNUSED(pdrv);
     return RES_OK;
 }
 
@@ -98,12 +102,13 @@ static DSTATUS ram_disk_initialize(BYTE pdrv /* Physical drive nmuber to identif
 
 static DRESULT ram_disk_read(BYTE pdrv, /* Physical drive nmuber to identify the drive */
                              BYTE *buff,   /* Data buffer to store read data */
-                             DWORD sector, /* Start sector in LBA */
+                             LBA_t sector, /* Start sector in LBA */
                              UINT count    /* Number of sectors to read */
 )
 {
     ff_ram_disk *disk = &ram_disk;
 
+    FUNUSED(pdrv);
     if ((FF_DRV_NOT_USED != disk->pdrv) && (sector < disk->sector_cnt))
     {
         memcpy(buff, disk->base + sector * disk->sector_sz, count * disk->sector_sz);
@@ -119,12 +124,13 @@ static DRESULT ram_disk_read(BYTE pdrv, /* Physical drive nmuber to identify the
 
 static DRESULT ram_disk_write(BYTE pdrv, /* Physical drive nmuber to identify the drive */
                               const BYTE *buff, /* Data to be written */
-                              DWORD sector,     /* Start sector in LBA */
+                              LBA_t sector,     /* Start sector in LBA */
                               UINT count        /* Number of sectors to write */
 )
 {
     ff_ram_disk *disk = &ram_disk;
 
+    FUNUSED(pdrv);
     if ((FF_DRV_NOT_USED != disk->pdrv) && (sector < disk->sector_cnt))
     {
         memcpy(disk->base + sector * disk->sector_sz, buff, count * disk->sector_sz);
@@ -146,6 +152,7 @@ DRESULT ram_disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
     DRESULT res;
     ff_ram_disk *disk = &ram_disk;
 
+    FUNUSED(pdrv);
     res = RES_PARERR;
     if (FF_DRV_NOT_USED == disk->pdrv)
     {
@@ -159,7 +166,7 @@ DRESULT ram_disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
             break;
 
         case GET_SECTOR_COUNT: /* Get number of sectors on the drive */
-            *(DWORD *)buff = disk->sector_cnt;
+            *(LBA_t *)buff = disk->sector_cnt;
             res = RES_OK;
             break;
 
@@ -25,6 +25,8 @@
  * 1.0   zhugengyu  2022/12/3   init commit
  * 2.0   zhugengyu  2023/9/27   adaptor to fsl_sdmmc
  * 2.1   huangjin   2023/12/22  update according to pd2308
+ * 2.2   phytium    2026/10/19   let emmc select HS200/HS400 timing
+ * 2.3   phytium    2026/10/19   sector and sector count in LBA_t
  */
 
 /*-----------------------------------------------------------------------*/
@@ -144,7 +146,7 @@ static DSTATUS sdmmc_disk_initialize(BYTE pdrv /* Physical drive nmuber to ident
 
 static DRESULT sdmmc_disk_read(BYTE pdrv, /* Physical drive nmuber to identify the drive */
                                BYTE *buff,   /* Data buffer to store read data */
-                               DWORD sector, /* Start sector in LBA */
+                               LBA_t sector, /* Start sector in LBA */
                                UINT count    /* Number of sectors to read */
 )
 {
@@ -197,7 +199,7 @@ static DRESULT sdmmc_disk_read(BYTE pdrv, /* Physical drive nmuber to identify t
 
 static DRESULT sdmmc_disk_write(BYTE pdrv, /* Physical drive nmuber to identify the drive */
                                 const BYTE *buff, /* Data to be written */
-                                DWORD sector,     /* Start sector in LBA */
+                                LBA_t sector,     /* Start sector in LBA */
                                 UINT count        /* Number of sectors to write */
 )
 {
@@ -265,7 +267,7 @@ DRESULT sdmmc_disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
             break;
 
         case GET_SECTOR_COUNT: /* Get number of sectors on the drive */
-            *(DWORD *)buff = disk->sector_cnt;
+            *(LBA_t *)buff = disk->sector_cnt;
             res = RES_OK;
             break;
 
@@ -399,7 +401,7 @@ void ff_diskio_register_fsdif_emmc(BYTE pdrv)
     config->endianMode = kSDMMCHOST_EndianModeLittle;
     config->maxTransSize = 1024 * 512;
     config->defBlockSize = 512;
-    config->cardClock = SD_CLOCK_100MHZ;
+    config->cardClock = MMC_CLOCK_HS200; /* HS400 or HS200 if card and host support, fall back otherwise */
 
     if (kStatus_Success != MMC_CfgInitialize(emmc, config))
     {
@@ -12,6 +12,10 @@ ifdef CONFIG_FATFS_SDMMC
 	CSRCS_RELATIVE_FILES += $(wildcard port/sdmmc/*.c)
 endif #CONFIG_FATFS_SDMMC
 
+ifdef CONFIG_FATFS_NVME
+	CSRCS_RELATIVE_FILES += $(wildcard port/nvme/*.c)
+endif #CONFIG_FATFS_NVME
+
 ifdef CONFIG_USE_BAREMETAL
 	CSRCS_RELATIVE_FILES += $(wildcard osal/*.c)
 
@@ -23,6 +23,8 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   add multi-task file i/o bench
+ * 1.2   phytium    2026/10/19   add streaming recorder bench
  */
 
 #include <string.h>
@@ -32,6 +34,11 @@
 #include "ferror_code.h"
 #include "ff_utils.h"
 #include "diskio.h"
+#include "ff_recorder.h"
+#ifdef CONFIG_USE_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 
 #define FF_DEBUG_TAG "FATFS"
 #define FF_ERROR(format, ...)   FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
@@ -118,14 +125,15 @@ static int test_diskio (
 )
 {
     UINT n, cc, ns;
-    DWORD sz_drv, lba, lba2, sz_eblk, pns = 1;
+    LBA_t sz_drv, lba, lba2;
+    DWORD sz_eblk, pns = 1;
     WORD sz_sect;
     BYTE *pbuff = (BYTE*)buff;
     DSTATUS ds;
     DRESULT dr;
 
 
-    printf("test_diskio(%u, %u, 0x%08X, 0x%08X)\n", pdrv, ncyc, (uintptr)buff, sz_buff);
+    printf("test_diskio(%u, %u, %p, 0x%08X)\n", pdrv, ncyc, buff, sz_buff);
 
     if (sz_buff < FF_MAX_SS + 8) {
         FF_ERROR("Insufficient work area to run the program.");
@@ -145,7 +153,7 @@ static int test_diskio (
         }
 
         printf("**** Get drive size ****\n");
-        printf(" disk_ioctl(%u, GET_SECTOR_COUNT, 0x%08X)", pdrv, (uintptr)&sz_drv);
+        printf(" disk_ioctl(%u, GET_SECTOR_COUNT, %p)", pdrv, (void *)&sz_drv);
         sz_drv = 0;
         dr = disk_ioctl(pdrv, GET_SECTOR_COUNT, &sz_drv);
         if (dr == RES_OK) {
@@ -158,11 +166,11 @@ static int test_diskio (
             FF_ERROR("Failed: Insufficient drive size to test.");
             return 4;
         }
-        printf(" Number of sectors on the drive %u is %lu.\n", pdrv, sz_drv);
+        printf(" Number of sectors on the drive %u is %"PRIu64".\n", pdrv, (QWORD)sz_drv);
 
 #if FF_MAX_SS != FF_MIN_SS
         printf("**** Get sector size ****\n");
-        printf(" disk_ioctl(%u, GET_SECTOR_SIZE, 0x%X)", pdrv, (UINT)&sz_sect);
+        printf(" disk_ioctl(%u, GET_SECTOR_SIZE, %p)", pdrv, (void *)&sz_sect);
         sz_sect = 0;
         dr = disk_ioctl(pdrv, GET_SECTOR_SIZE, &sz_sect);
         if (dr == RES_OK) {
@@ -177,7 +185,7 @@ static int test_diskio (
 #endif
 
         printf("**** Get block size ****\n");
-        printf(" disk_ioctl(%u, GET_BLOCK_SIZE, 0x%X)", pdrv, (uintptr)&sz_eblk);
+        printf(" disk_ioctl(%u, GET_BLOCK_SIZE, %p)", pdrv, (void *)&sz_eblk);
         sz_eblk = 0;
         dr = disk_ioctl(pdrv, GET_BLOCK_SIZE, &sz_eblk);
         if (dr == RES_OK) {
@@ -186,7 +194,7 @@ static int test_diskio (
             FF_ERROR(" - failed.");
         }
         if (dr == RES_OK || sz_eblk >= 2) {
-            printf(" Size of the erase block is %lu sectors.\n", sz_eblk);
+            printf(" Size of the erase block is %"PRIu32" sectors.\n", sz_eblk);
         } else {
             FF_ERROR(" Size of the erase block is unknown.");
         }
@@ -195,7 +203,7 @@ static int test_diskio (
         printf("**** Single sector write test ****\n");
         lba = 0;
         for (n = 0, pn(pns); n < sz_sect; n++) pbuff[n] = (BYTE)pn(0);
-        printf(" disk_write(%u, 0x%X, %lu, 1)", pdrv, (uintptr)pbuff, lba);
+        printf(" disk_write(%u, %p, %"PRIu64", 1)", pdrv, pbuff, (QWORD)lba);
         dr = disk_write(pdrv, pbuff, lba, 1);
         if (dr == RES_OK) {
             printf(" - ok.\n");
@@ -212,7 +220,7 @@ static int test_diskio (
             return 7;
         }
         memset(pbuff, 0, sz_sect);
-        printf(" disk_read(%u, 0x%X, %lu, 1)", pdrv, (uintptr)pbuff, lba);
+        printf(" disk_read(%u, %p, %"PRIu64", 1)", pdrv, pbuff, (QWORD)lba);
         dr = disk_read(pdrv, pbuff, lba, 1);
         if (dr == RES_OK) {
             printf(" - ok.\n");
@@ -234,7 +242,7 @@ static int test_diskio (
         if (ns > 4) ns = 3;
         if (ns > 1) {
             for (n = 0, pn(pns); n < (UINT)(sz_sect * ns); n++) pbuff[n] = (BYTE)pn(0);
-            printf(" disk_write(%u, 0x%X, %lu, %u)", pdrv, (uintptr)pbuff, lba, ns);
+            printf(" disk_write(%u, %p, %"PRIu64", %u)", pdrv, pbuff, (QWORD)lba, ns);
             dr = disk_write(pdrv, pbuff, lba, ns);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -251,7 +259,7 @@ static int test_diskio (
                 return 12;
             }
             memset(pbuff, 0, sz_sect * ns);
-            printf(" disk_read(%u, 0x%X, %lu, %u)", pdrv, (uintptr)pbuff, lba, ns);
+            printf(" disk_read(%u, %p, %"PRIu64", %u)", pdrv, pbuff, (QWORD)lba, ns);
             dr = disk_read(pdrv, pbuff, lba, ns);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -280,7 +288,7 @@ static int test_diskio (
         }
         lba = 5;
         for (n = 0, pn(pns); n < sz_sect; n++) pbuff[n+3] = (BYTE)pn(0);
-        printf(" disk_write(%u, 0x%X, %lu, 1)", pdrv, (uintptr)(pbuff+3), lba);
+        printf(" disk_write(%u, %p, %"PRIu64", 1)", pdrv, pbuff+3, (QWORD)lba);
         dr = disk_write(pdrv, pbuff+3, lba, 1);
         if (dr == RES_OK) {
             printf(" - ok.\n");
@@ -297,7 +305,7 @@ static int test_diskio (
             return 16;
         }
         memset(pbuff+5, 0, sz_sect);
-        printf(" disk_read(%u, 0x%X, %lu, 1)", pdrv, (uintptr)(pbuff+5), lba);
+        printf(" disk_read(%u, %p, %"PRIu64", 1)", pdrv, pbuff+5, (QWORD)lba);
         dr = disk_read(pdrv, pbuff+5, lba, 1);
         if (dr == RES_OK) {
             printf(" - ok.\n");
@@ -318,7 +326,7 @@ static int test_diskio (
         if (sz_drv >= 128 + 0x80000000 / (sz_sect / 2)) {
             lba = 6; lba2 = lba + 0x80000000 / (sz_sect / 2);
             for (n = 0, pn(pns); n < (UINT)(sz_sect * 2); n++) pbuff[n] = (BYTE)pn(0);
-            printf(" disk_write(%u, 0x%X, %lu, 1)", pdrv, (uintptr)pbuff, lba);
+            printf(" disk_write(%u, %p, %"PRIu64", 1)", pdrv, pbuff, (QWORD)lba);
             dr = disk_write(pdrv, pbuff, lba, 1);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -326,7 +334,7 @@ static int test_diskio (
                 FF_ERROR(" - failed.");
                 return 19;
             }
-            printf(" disk_write(%u, 0x%X, %lu, 1)", pdrv, (uintptr)(pbuff+sz_sect), lba2);
+            printf(" disk_write(%u, %p, %"PRIu64", 1)", pdrv, pbuff+sz_sect, (QWORD)lba2);
             dr = disk_write(pdrv, pbuff+sz_sect, lba2, 1);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -343,7 +351,7 @@ static int test_diskio (
                 return 21;
             }
             memset(pbuff, 0, sz_sect * 2);
-            printf(" disk_read(%u, 0x%X, %lu, 1)", pdrv, (uintptr)pbuff, lba);
+            printf(" disk_read(%u, %p, %"PRIu64", 1)", pdrv, pbuff, (QWORD)lba);
             dr = disk_read(pdrv, pbuff, lba, 1);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -351,7 +359,7 @@ static int test_diskio (
                 FF_ERROR(" - failed.");
                 return 22;
             }
-            printf(" disk_read(%u, 0x%X, %lu, 1)", pdrv, (uintptr)(pbuff+sz_sect), lba2);
+            printf(" disk_read(%u, %p, %"PRIu64", 1)", pdrv, pbuff+sz_sect, (QWORD)lba2);
             dr = disk_read(pdrv, pbuff+sz_sect, lba2, 1);
             if (dr == RES_OK) {
                 printf(" - ok.\n");
@@ -424,7 +432,7 @@ int ff_diskio_speed_bench(const TCHAR *mount_point, DWORD start_sector, BYTE *te
     ss = FF_MAX_SS;
 #endif
 
-    printf("Starting disk write test at sector %lu in %u bytes of data chunks...\r\n", lba, sz_buff);
+    printf("Starting disk write test at sector %"PRIu32" in %u bytes of data chunks...\r\n", lba, sz_buff);
     tmr = ff_systimer_get_tick();
     for (ofs = 0; ofs < len / ss; ofs += sz_buff / ss) {
         if (disk_write(pdrv, buff, lba + ofs, sz_buff / ss) != RES_OK) {
@@ -440,10 +448,10 @@ int ff_diskio_speed_bench(const TCHAR *mount_point, DWORD start_sector, BYTE *te
     tmr = ff_systimer_get_tick() - tmr;
     ff_systimer_tick_to_time(tmr, &sec, &msec);
     speed = ((double)test_tot_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate()); 
-    printf("%"PRId64" bytes write and it took %"PRId64" timer ticks, total time: %d.%03dS., speed: %.2fMB/s\n", 
+    printf("%"PRIu64" bytes write and it took %"PRIu64" timer ticks, total time: %"PRIu32".%03"PRIu32"S., speed: %.2fMB/s\n",
             test_tot_len, tmr, sec, msec, speed);
 
-    printf("Starting disk read test at sector %lu in %u bytes of data chunks...\r\n", lba, sz_buff);
+    printf("Starting disk read test at sector %"PRIu32" in %u bytes of data chunks...\r\n", lba, sz_buff);
     tmr = ff_systimer_get_tick();
     for (ofs = 0; ofs < len / ss; ofs += sz_buff / ss) {
         if (disk_read(pdrv, buff, lba + ofs, sz_buff / ss) != RES_OK) {
@@ -455,7 +463,7 @@ int ff_diskio_speed_bench(const TCHAR *mount_point, DWORD start_sector, BYTE *te
 
     ff_systimer_tick_to_time(tmr, &sec, &msec);
     speed = ((double)test_tot_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate()); 
-    printf("%lu bytes read and it took %lu timer ticks, total time: %d.%03dS., speed: %.2fMB/s\n", 
+    printf("%"PRIu64" bytes read and it took %"PRIu64" timer ticks, total time: %"PRIu32".%03"PRIu32"S., speed: %.2fMB/s\n",
             test_tot_len, tmr, sec, msec, speed);
 
     return 0;
@@ -515,11 +523,11 @@ int ff_fileio_speed_test(const TCHAR *mount_point, BYTE *test_buf, QWORD test_bu
     tmr = ff_systimer_get_tick() - tmr;
     ff_systimer_tick_to_time(tmr, &sec, &msec);
     speed = ((double)test_tot_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate()); 
-    printf("%"PRId64" bytes write and it took %"PRId64" timer ticks, total time: %d.%03dS., speed: %.2fMB/s\n", 
+    printf("%"PRIu64" bytes write and it took %"PRIu64" timer ticks, total time: %"PRIu32".%03"PRIu32"S., speed: %.2fMB/s\n",
             test_tot_len, tmr, sec, msec, speed);
 
     /* file read bench */
-    memset(test_buf, 0, sizeof(test_buf));
+    memset(test_buf, 0, test_buf_len);
 
     fr = f_open(&file_handler, (char *)path, FA_READ);
     if (fr != FR_OK)
@@ -552,10 +560,330 @@ int ff_fileio_speed_test(const TCHAR *mount_point, BYTE *test_buf, QWORD test_bu
     tmr = ff_systimer_get_tick() - tmr;
     ff_systimer_tick_to_time(tmr, &sec, &msec);
     speed = ((double)test_tot_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate()); 
-    printf("%"PRId64" bytes Read and it took %"PRId64" timer ticks, total time: %d.%03dS., speed: %.2fMB/s\n", 
+    printf("%"PRIu64" bytes Read and it took %"PRIu64" timer ticks, total time: %"PRIu32".%03"PRIu32"S., speed: %.2fMB/s\n",
             test_tot_len, tmr, sec, msec, speed);
 
     f_unlink((char *)path); /* delete file here */
 
     return FR_OK;
-}
\ No newline at end of file
+}
+
+#ifdef CONFIG_USE_FREERTOS
+
+#define FF_MT_MAX_TASKS         8
+#define FF_MT_TASK_STACK_SIZE   2048
+
+void* ff_memalloc(UINT msize);
+void ff_memfree(void* mblock);
+
+typedef struct
+{
+    FIL file;
+    TCHAR path[64];
+    BYTE *buf;
+    UINT io_size;
+    QWORD file_len;
+    BYTE pattern;
+    BYTE is_write;
+    FRESULT result;
+    DWORD bad_chunks;           /* chunks read back with wrong data */
+    TaskHandle_t waiter;
+} ff_mt_task;
+
+/* the first bytes of a chunk carry its index, so stale data left in the buffer by a read is caught */
+static void ff_mt_stamp(ff_mt_task *task, DWORD chunk)
+{
+    memcpy(task->buf, &chunk, min(task->io_size, (UINT)sizeof(chunk)));
+}
+
+static BYTE ff_mt_check(const ff_mt_task *task, DWORD chunk)
+{
+    UINT stamp = min(task->io_size, (UINT)sizeof(chunk));
+    UINT i;
+
+    if (memcmp(task->buf, &chunk, stamp) != 0)
+    {
+        return FALSE;
+    }
+
+    for (i = stamp; i < task->io_size; i++)
+    {
+        if (task->buf[i] != task->pattern)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* write or read one file in io_size chunks, the write data carries the task pattern and the chunk index */
+static void ff_mt_task_entry(void *args)
+{
+    ff_mt_task *task = (ff_mt_task *)args;
+    FRESULT fr;
+    QWORD remain = task->file_len;
+    DWORD chunk = 0;
+    UINT rw_len;
+
+    fr = f_open(&task->file, task->path, task->is_write ? (FA_CREATE_ALWAYS | FA_WRITE) : FA_READ);
+    while ((fr == FR_OK) && (remain > 0))
+    {
+        if (task->is_write)
+        {
+            ff_mt_stamp(task, chunk);
+            fr = f_write(&task->file, task->buf, task->io_size, &rw_len);
+        }
+        else
+        {
+            fr = f_read(&task->file, task->buf, task->io_size, &rw_len);
+        }
+
+        if ((fr == FR_OK) && (rw_len != task->io_size))
+        {
+            fr = task->is_write ? FR_DENIED : FR_INT_ERR; /* disk full or file too short */
+        }
+
+        if ((fr == FR_OK) && !task->is_write && !ff_mt_check(task, chunk))
+        {
+            task->bad_chunks++;
+        }
+
+        remain -= task->io_size;
+        chunk++;
+    }
+
+    if (task->file.obj.fs != NULL)
+    {
+        FRESULT close_fr = f_close(&task->file);
+        fr = (fr == FR_OK) ? close_fr : fr;
+    }
+
+    task->result = fr;
+    xTaskNotifyGive(task->waiter);
+    vTaskDelete(NULL);
+}
+
+/* run one phase on all tasks in parallel, return the elapsed ticks */
+static FRESULT ff_mt_run_phase(ff_mt_task *tasks, UINT task_num, BYTE is_write, QWORD *ticks)
+{
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    UINT created = 0;
+    FRESULT fr = FR_OK;
+    QWORD tmr;
+    UINT i;
+
+    tmr = ff_systimer_get_tick();
+    for (i = 0; i < task_num; i++)
+    {
+        tasks[i].is_write = is_write;
+        tasks[i].result = FR_OK;
+        tasks[i].waiter = xTaskGetCurrentTaskHandle();
+        if (xTaskCreate(ff_mt_task_entry, "ff_mt", FF_MT_TASK_STACK_SIZE,
+                        &tasks[i], prio, NULL) != pdPASS)
+        {
+            FF_ERROR("Create bench task %u failed.", i);
+            fr = FR_NOT_ENOUGH_CORE;
+            break;
+        }
+        created++;
+    }
+
+    for (i = 0; i < created; i++)
+    {
+        (void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    *ticks = ff_systimer_get_tick() - tmr;
+
+    for (i = 0; i < created; i++)
+    {
+        if (tasks[i].result != FR_OK)
+        {
+            FF_ERROR("%s %s failed, err = %d.", is_write ? "Write" : "Read", tasks[i].path, tasks[i].result);
+            fr = (fr == FR_OK) ? tasks[i].result : fr;
+        }
+    }
+
+    return fr;
+}
+
+static void ff_mt_report(const char *op, UINT task_num, QWORD total_len, QWORD tmr)
+{
+    DWORD sec = 0U;
+    DWORD msec = 0U;
+    double speed;
+
+    ff_systimer_tick_to_time(tmr, &sec, &msec);
+    speed = (tmr == 0) ? 0.0 : ((double)total_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate());
+    printf("%u tasks %s %"PRIu64" bytes, total time: %"PRIu32".%03"PRIu32"S., aggregate speed: %.2fMB/s\n",
+           task_num, op, total_len, sec, msec, speed);
+}
+
+/**
+ * @name: ff_multitask_speed_test
+ * @msg: 多个任务同时读写各自的文件, 测试卷锁下的总吞吐量, 每个任务先写 file_len 字节, 全部写完后再同时读回
+ * @return {int} 0 表示成功
+ * @param {TCHAR} *mount_point, 挂载点
+ * @param {UINT} task_num, 任务数, 1 ~ 8
+ * @param {QWORD} file_len, 每个任务的文件长度, io_size 的整数倍
+ * @param {UINT} io_size, 每次 f_write/f_read 的字节数
+ */
+int ff_multitask_speed_test(const TCHAR *mount_point, UINT task_num, QWORD file_len, UINT io_size)
+{
+    ff_mt_task *tasks;
+    QWORD tmr;
+    FRESULT fr;
+    UINT i;
+
+    if ((task_num == 0) || (task_num > FF_MT_MAX_TASKS) || (io_size == 0) || (file_len % io_size))
+    {
+        FF_ERROR("Invalid bench parameters, tasks = %u, io size = %u.", task_num, io_size);
+        return -1;
+    }
+
+    tasks = ff_memalloc(sizeof(ff_mt_task) * task_num);
+    if (tasks == NULL)
+    {
+        return -2;
+    }
+    /* err_out frees the buffers allocated so far */
+    memset(tasks, 0, sizeof(ff_mt_task) * task_num);
+
+    for (i = 0; i < task_num; i++)
+    {
+        tasks[i].buf = ff_memalloc(io_size);
+        if (tasks[i].buf == NULL)
+        {
+            fr = FR_NOT_ENOUGH_CORE;
+            goto err_out;
+        }
+
+        tasks[i].pattern = (BYTE)(0xA0 + i);
+        memset(tasks[i].buf, tasks[i].pattern, io_size);
+        snprintf(tasks[i].path, sizeof(tasks[i].path), "%s/mt_bench-%u.bin", mount_point, i);
+        tasks[i].io_size = io_size;
+        tasks[i].file_len = file_len;
+    }
+
+    printf("Starting %u tasks file write test, %"PRIu64" bytes each in %u bytes of chunks...\r\n",
+           task_num, file_len, io_size);
+    fr = ff_mt_run_phase(tasks, task_num, TRUE, &tmr);
+    if (fr != FR_OK)
+    {
+        goto err_out;
+    }
+    ff_mt_report("write", task_num, file_len * task_num, tmr);
+
+    for (i = 0; i < task_num; i++)
+    {
+        memset(tasks[i].buf, (BYTE)~tasks[i].pattern, io_size);
+    }
+
+    printf("Starting %u tasks file read test...\r\n", task_num);
+    fr = ff_mt_run_phase(tasks, task_num, FALSE, &tmr);
+    if (fr != FR_OK)
+    {
+        goto err_out;
+    }
+    ff_mt_report("read", task_num, file_len * task_num, tmr);
+
+    for (i = 0; i < task_num; i++)
+    {
+        if (tasks[i].bad_chunks != 0)
+        {
+            FF_ERROR("%"PRIu32" chunks of %s mismatch.", tasks[i].bad_chunks, tasks[i].path);
+            fr = FR_INT_ERR;
+        }
+    }
+
+err_out:
+    for (i = 0; i < task_num; i++)
+    {
+        if (tasks[i].buf != NULL)
+        {
+            (void)f_unlink(tasks[i].path);
+            ff_memfree(tasks[i].buf);
+        }
+    }
+    ff_memfree(tasks);
+
+    return (fr == FR_OK) ? 0 : -3;
+}
+
+#ifdef CONFIG_FATFS_RECORDER
+/**
+ * @name: ff_recorder_speed_test
+ * @msg: 用录制器把 file_len 字节写入连续预分配的文件, 打印吞吐量和每次写盘的延迟分位数
+ * @return {int} 0 表示成功
+ * @param {TCHAR} *mount_point, 挂载点
+ * @param {QWORD} file_len, 录制的字节数
+ * @param {UINT} buf_size, 每个缓冲区的字节数, 扇区大小的整数倍
+ */
+int ff_recorder_speed_test(const TCHAR *mount_point, QWORD file_len, UINT buf_size)
+{
+    static ff_recorder rec;
+    ff_recorder_stats stats;
+    TCHAR path[64];
+    QWORD remain = file_len;
+    QWORD tmr;
+    DWORD sec = 0U;
+    DWORD msec = 0U;
+    double speed;
+    FRESULT fr;
+    BYTE *buf;
+    UINT len;
+
+    snprintf(path, sizeof(path), "%s/recorder.bin", mount_point);
+    fr = ff_recorder_open(&rec, path, file_len, buf_size);
+    if (fr != FR_OK)
+    {
+        FF_ERROR("Open recorder %s failed, err = %d.", path, fr);
+        return -1;
+    }
+
+    printf("Starting recorder write test, %"PRIu64" bytes in %u bytes of buffers...\r\n", file_len, buf_size);
+    tmr = ff_systimer_get_tick();
+    while (remain > 0)
+    {
+        buf = ff_recorder_get_buffer(&rec, portMAX_DELAY);
+        if (buf == NULL)
+        {
+            fr = FR_DISK_ERR;
+            break;
+        }
+
+        len = (remain > buf_size) ? buf_size : (UINT)remain;
+        memset(buf, (int)(remain / buf_size), 64);  /* stands for the sensor data */
+        fr = ff_recorder_submit(&rec, buf, len);
+        if (fr != FR_OK)
+        {
+            break;
+        }
+        remain -= len;
+    }
+
+    if (ff_recorder_close(&rec) != FR_OK)
+    {
+        fr = (fr == FR_OK) ? FR_DISK_ERR : fr;
+    }
+    tmr = ff_systimer_get_tick() - tmr;
+
+    ff_recorder_get_stats(&rec, &stats);
+    if (fr != FR_OK)
+    {
+        FF_ERROR("Record %s failed, err = %d.", path, fr);
+        (void)f_unlink(path);
+        return -2;
+    }
+
+    ff_systimer_tick_to_time(tmr, &sec, &msec);
+    speed = (tmr == 0) ? 0.0 : ((double)file_len / SZ_1M) / ((double)tmr / ff_systimer_get_tick_rate());
+    printf("%"PRIu64" bytes recorded, total time: %"PRIu32".%03"PRIu32"S., speed: %.2fMB/s\n", file_len, sec, msec, speed);
+    ff_recorder_dump_stats(&stats);
+
+    (void)f_unlink(path);
+    return 0;
+}
+#endif
+
+#endif
@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_recorder.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the streaming recorder, the file is preallocated
+ * contiguously by f_expand, the buffers are written to its sectors by a writer task
+ * without cluster allocation and FAT updates in between
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fdebug.h"
+#include "fassert.h"
+#include "ff.h"
+#include "diskio.h"
+#include "ff_recorder.h"
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FATFS_RECORDER
+
+#include "fdrivers_port.h"
+#include "fgeneric_timer.h"
+
+#define FF_DEBUG_TAG "FATFS-REC"
+#define FF_ERROR(format, ...) FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_INFO(format, ...)  FT_DEBUG_PRINT_I(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_DEBUG(format, ...) FT_DEBUG_PRINT_D(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_WARN(format, ...)  FT_DEBUG_PRINT_W(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#if !FF_USE_EXPAND || !FF_USE_FASTSEEK
+#error "the recorder needs f_expand and fast seek"
+#endif
+
+#if FF_USE_LFN != 3
+void *ff_memalloc(UINT msize);
+void ff_memfree(void *mblock);
+#endif
+
+typedef struct
+{
+    BYTE *buf;      /* NULL asks the writer to exit */
+    LBA_t sector;   /* sector offset in the file */
+    UINT count;
+} ff_recorder_req;
+
+static void ff_recorder_add_latency(ff_recorder *rec, DWORD us, DRESULT res)
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+    rec->lat_us[rec->lat_pos] = us;
+    rec->lat_pos = (rec->lat_pos + 1) % CONFIG_FATFS_RECORDER_LAT_SAMPLES;
+    if (rec->lat_num < CONFIG_FATFS_RECORDER_LAT_SAMPLES)
+    {
+        rec->lat_num++;
+    }
+
+    rec->stats.writes++;
+    if (res != RES_OK)
+    {
+        rec->stats.errors++;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+static void ff_recorder_task(void *args)
+{
+    ff_recorder *rec = (ff_recorder *)args;
+    ff_recorder_req req;
+    DRESULT res;
+    u64 start;
+
+    for (;;)
+    {
+        (void)xQueueReceive(rec->write_q, &req, portMAX_DELAY);
+        if (req.buf == NULL)
+        {
+            break;
+        }
+
+        /* after an error the buffers only go back to the producer */
+        if (rec->err == FR_OK)
+        {
+            start = FDriverGetTimerTick();
+            res = disk_write(rec->pdrv, req.buf, rec->start_lba + req.sector, req.count);
+            ff_recorder_add_latency(rec,
+                                    (DWORD)((FDriverGetTimerTick() - start) * 1000000ULL / GenericTimerFrequecy()),
+                                    res);
+            if (res != RES_OK)
+            {
+                FF_ERROR("Write %u sectors at %"PRIu64" failed.", req.count, (QWORD)req.sector);
+                rec->err = FR_DISK_ERR;
+            }
+        }
+
+        (void)xQueueSend(rec->free_q, &req.buf, portMAX_DELAY);
+    }
+
+    xTaskNotifyGive(rec->waiter);
+    vTaskDelete(NULL);
+}
+
+static void ff_recorder_free(ff_recorder *rec)
+{
+    UINT i;
+
+    for (i = 0; i < FF_RECORDER_BUF_NUM; i++)
+    {
+        if (rec->buf[i] != NULL)
+        {
+            ff_memfree(rec->buf[i]);
+            rec->buf[i] = NULL;
+        }
+    }
+
+    if (rec->lat_us != NULL)
+    {
+        ff_memfree(rec->lat_us);
+        rec->lat_us = NULL;
+    }
+
+    if (rec->free_q != NULL)
+    {
+        vQueueDelete(rec->free_q);
+        rec->free_q = NULL;
+    }
+
+    if (rec->write_q != NULL)
+    {
+        vQueueDelete(rec->write_q);
+        rec->write_q = NULL;
+    }
+}
+
+/**
+ * @name: ff_recorder_open
+ * @msg: 创建文件并连续预分配 size 字节, 找到文件在驱动器上的起始扇区, 启动写任务
+ * @return {FRESULT} FR_DENIED 表示卷上没有足够的连续空间
+ * @param {ff_recorder} *rec, 录制器
+ * @param {TCHAR} *path, 文件路径
+ * @param {FSIZE_t} size, 预分配的字节数, 向上取整到扇区
+ * @param {UINT} buf_size, 每个缓冲区的字节数, 扇区大小的整数倍
+ * @note: 预分配后文件大小先设为 size 并写回目录项, 关闭时截断为实际录制的长度
+ */
+FRESULT ff_recorder_open(ff_recorder *rec, const TCHAR *path, FSIZE_t size, UINT buf_size)
+{
+    FATFS *fs;
+    FRESULT fr;
+    UINT i;
+
+    FASSERT(rec);
+    FASSERT(path);
+    memset(rec, 0, sizeof(*rec));
+
+    fr = f_open(&rec->file, path, FA_CREATE_ALWAYS | FA_WRITE | FA_READ);
+    if (fr != FR_OK)
+    {
+        return fr;
+    }
+
+    fs = rec->file.obj.fs;
+#if FF_MAX_SS != FF_MIN_SS
+    rec->ss = fs->ssize;
+#else
+    rec->ss = FF_MAX_SS;
+#endif
+    if ((size == 0) || (buf_size == 0) || (buf_size % rec->ss))
+    {
+        fr = FR_INVALID_PARAMETER;
+        goto err_close;
+    }
+
+    size = (size + rec->ss - 1) / rec->ss * rec->ss;
+    fr = f_expand(&rec->file, size, 1);
+    if (fr == FR_OK)
+    {
+        /* the allocation reaches the disk before any data */
+        fr = f_sync(&rec->file);
+    }
+
+    if (fr != FR_OK)
+    {
+        FF_ERROR("Preallocate %"PRIu64" bytes for %s failed, err = %d.", (QWORD)size, path, fr);
+        goto err_close;
+    }
+
+    /* the link map of a contiguous file is one fragment, {size, clusters, start cluster, 0} */
+    rec->clmt[0] = sizeof(rec->clmt) / sizeof(rec->clmt[0]);
+    rec->file.cltbl = rec->clmt;
+    fr = f_lseek(&rec->file, CREATE_LINKMAP);
+    rec->file.cltbl = NULL;
+    if ((fr != FR_OK) || (rec->clmt[2] != rec->file.obj.sclust) ||
+        ((QWORD)rec->clmt[1] * fs->csize * rec->ss < size))
+    {
+        FF_ERROR("%s is not contiguous, err = %d.", path, fr);
+        fr = (fr != FR_OK) ? fr : FR_INT_ERR;
+        goto err_close;
+    }
+
+    rec->pdrv = fs->pdrv;
+    rec->start_lba = fs->database + (LBA_t)fs->csize * (rec->clmt[2] - 2);
+    rec->total_sectors = size / rec->ss;
+    rec->buf_size = buf_size;
+
+    rec->lat_us = ff_memalloc(CONFIG_FATFS_RECORDER_LAT_SAMPLES * sizeof(DWORD));
+    rec->free_q = xQueueCreate(FF_RECORDER_BUF_NUM, sizeof(BYTE *));
+    rec->write_q = xQueueCreate(FF_RECORDER_BUF_NUM + 1, sizeof(ff_recorder_req));
+    if ((rec->lat_us == NULL) || (rec->free_q == NULL) || (rec->write_q == NULL))
+    {
+        fr = FR_NOT_ENOUGH_CORE;
+        goto err_free;
+    }
+
+    for (i = 0; i < FF_RECORDER_BUF_NUM; i++)
+    {
+        rec->buf[i] = ff_memalign(buf_size, FF_RECORDER_BUF_ALIGN);
+        if (rec->buf[i] == NULL)
+        {
+            fr = FR_NOT_ENOUGH_CORE;
+            goto err_free;
+        }
+        (void)xQueueSend(rec->free_q, &rec->buf[i], 0);
+    }
+
+    if (xTaskCreate(ff_recorder_task, "ff_rec", CONFIG_FATFS_RECORDER_STACK_DEPTH,
+                    rec, CONFIG_FATFS_RECORDER_TASK_PRIORITY, &rec->task) != pdPASS)
+    {
+        fr = FR_NOT_ENOUGH_CORE;
+        goto err_free;
+    }
+
+    FF_INFO("Record %s at sector %"PRIu64", %"PRIu64" sectors, %u bytes per buffer.",
+            path, (QWORD)rec->start_lba, (QWORD)rec->total_sectors, buf_size);
+    return FR_OK;
+
+err_free:
+    ff_recorder_free(rec);
+err_close:
+    (void)f_close(&rec->file);
+    (void)f_unlink(path);
+    return fr;
+}
+
+BYTE *ff_recorder_get_buffer(ff_recorder *rec, TickType_t wait)
+{
+    BYTE *buf = NULL;
+
+    FASSERT(rec);
+    if ((rec->task == NULL) || (rec->err != FR_OK))
+    {
+        return NULL;
+    }
+
+    if (xQueueReceive(rec->free_q, &buf, 0) != pdTRUE)
+    {
+        /* both buffers in the writer, the disk is slower than the producer */
+        rec->stats.stalls++;
+        if (xQueueReceive(rec->free_q, &buf, wait) != pdTRUE)
+        {
+            return NULL;
+        }
+    }
+
+    return buf;
+}
+
+FRESULT ff_recorder_submit(ff_recorder *rec, BYTE *buf, UINT len)
+{
+    ff_recorder_req req;
+
+    FASSERT(rec);
+    FASSERT(buf);
+    if (rec->err != FR_OK)
+    {
+        return rec->err;
+    }
+
+    if ((rec->task == NULL) || rec->tail)
+    {
+        return FR_DENIED;
+    }
+
+    if ((len == 0) || (len > rec->buf_size))
+    {
+        return FR_INVALID_PARAMETER;
+    }
+
+    req.buf = buf;
+    req.sector = rec->next_sector;
+    req.count = (len + rec->ss - 1) / rec->ss;
+    if (rec->next_sector + req.count > rec->total_sectors)
+    {
+        return FR_DENIED; /* the preallocated file is full */
+    }
+
+    if (len % rec->ss)
+    {
+        /* the partial sector is padded, the file is trimmed to len on close */
+        memset(buf + len, 0, req.count * rec->ss - len);
+        rec->tail = 1;
+    }
+
+    rec->next_sector += req.count;
+    rec->data_len += len;
+    rec->stats.bytes += len;
+
+    /* the queue holds all buffers and the exit request, it does not block */
+    (void)xQueueSend(rec->write_q, &req, portMAX_DELAY);
+    return FR_OK;
+}
+
+/**
+ * @name: ff_recorder_close
+ * @msg: 等待写任务写完已提交的缓冲区, 把文件截断为实际录制的长度并关闭, 释放的簇还给卷
+ * @return {FRESULT} 写盘错误或元数据更新的错误
+ * @param {ff_recorder} *rec, 录制器
+ */
+FRESULT ff_recorder_close(ff_recorder *rec)
+{
+    ff_recorder_req req = {NULL, 0, 0};
+    FRESULT fr;
+
+    FASSERT(rec);
+    if (rec->task == NULL)
+    {
+        return FR_INVALID_OBJECT;
+    }
+
+    rec->waiter = xTaskGetCurrentTaskHandle();
+    (void)xQueueSend(rec->write_q, &req, portMAX_DELAY);
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    rec->task = NULL;
+
+    /* final metadata update, the size in the directory entry and the unused clusters */
+    fr = f_lseek(&rec->file, rec->data_len);
+    if (fr == FR_OK)
+    {
+        fr = f_truncate(&rec->file);
+    }
+
+    if (fr == FR_OK)
+    {
+        fr = f_close(&rec->file);
+    }
+    else
+    {
+        (void)f_close(&rec->file);
+    }
+
+    if (rec->err != FR_OK)
+    {
+        fr = rec->err;
+    }
+
+    /* keep the final percentiles for ff_recorder_get_stats after the samples are freed */
+    ff_recorder_get_stats(rec, &rec->stats);
+    ff_recorder_free(rec);
+    return fr;
+}
+
+static int ff_recorder_lat_cmp(const void *a, const void *b)
+{
+    DWORD x = *(const DWORD *)a;
+    DWORD y = *(const DWORD *)b;
+
+    return (x > y) - (x < y);
+}
+
+static inline DWORD ff_recorder_percentile(const DWORD *lat, DWORD num, DWORD permille)
+{
+    return lat[(QWORD)(num - 1) * permille / 1000];
+}
+
+void ff_recorder_get_stats(ff_recorder *rec, ff_recorder_stats *stats)
+{
+    UBaseType_t mask;
+    DWORD *lat = NULL;
+    DWORD num;
+
+    FASSERT(rec);
+    FASSERT(stats);
+
+    if (rec->lat_us != NULL)
+    {
+        lat = ff_memalloc(CONFIG_FATFS_RECORDER_LAT_SAMPLES * sizeof(DWORD));
+    }
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+    *stats = rec->stats;
+    num = rec->lat_num;
+    if (lat != NULL)
+    {
+        memcpy(lat, rec->lat_us, num * sizeof(DWORD));
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    if ((lat == NULL) || (num == 0))
+    {
+        if (lat != NULL)
+        {
+            ff_memfree(lat);
+        }
+        return;
+    }
+
+    qsort(lat, num, sizeof(DWORD), ff_recorder_lat_cmp);
+    stats->lat_min_us = lat[0];
+    stats->lat_max_us = lat[num - 1];
+    stats->lat_p50_us = ff_recorder_percentile(lat, num, 500);
+    stats->lat_p90_us = ff_recorder_percentile(lat, num, 900);
+    stats->lat_p99_us = ff_recorder_percentile(lat, num, 990);
+    stats->lat_p999_us = ff_recorder_percentile(lat, num, 999);
+    ff_memfree(lat);
+}
+
+void ff_recorder_dump_stats(const ff_recorder_stats *stats)
+{
+    FASSERT(stats);
+
+    printf("recorder: %"PRIu32" writes, %"PRIu64" bytes, %"PRIu32" errors, %"PRIu32" stalls\r\n",
+           stats->writes, stats->bytes, stats->errors, stats->stalls);
+    printf("    write latency(us): min %"PRIu32", p50 %"PRIu32", p90 %"PRIu32", "
+           "p99 %"PRIu32", p99.9 %"PRIu32", max %"PRIu32"\r\n",
+           stats->lat_min_us, stats->lat_p50_us, stats->lat_p90_us,
+           stats->lat_p99_us, stats->lat_p999_us, stats->lat_max_us);
+}
+
+#endif
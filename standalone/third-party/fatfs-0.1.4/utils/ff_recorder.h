@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: ff_recorder.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the streaming recorder, it writes the data into a
+ * preallocated contiguous file with direct disk writes
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FF_RECORDER_H
+#define FF_RECORDER_H
+
+#include "sdkconfig.h"
+#include "ff.h"
+
+#ifdef CONFIG_FATFS_RECORDER
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef CONFIG_FATFS_RECORDER
+
+#define FF_RECORDER_BUF_NUM     2   /* one buffer is filled while the other one is written */
+#define FF_RECORDER_BUF_ALIGN   64
+
+typedef struct
+{
+    DWORD writes;           /* disk writes of the buffers */
+    QWORD bytes;            /* data bytes recorded */
+    DWORD errors;           /* failed disk writes */
+    DWORD stalls;           /* times the producer waited for a free buffer */
+    DWORD lat_min_us;       /* latency of the disk writes, over the last samples */
+    DWORD lat_max_us;
+    DWORD lat_p50_us;
+    DWORD lat_p90_us;
+    DWORD lat_p99_us;
+    DWORD lat_p999_us;
+} ff_recorder_stats;
+
+typedef struct
+{
+    FIL file;
+    DWORD clmt[4];              /* link map of the file, a contiguous file has one fragment */
+    BYTE pdrv;
+    UINT ss;                    /* sector size */
+    LBA_t start_lba;            /* first sector of the file on the drive */
+    LBA_t total_sectors;        /* sectors preallocated */
+    LBA_t next_sector;          /* sector offset of the next write */
+    FSIZE_t data_len;           /* bytes recorded */
+    UINT buf_size;
+    BYTE *buf[FF_RECORDER_BUF_NUM];
+    QueueHandle_t free_q;       /* buffers ready to be filled */
+    QueueHandle_t write_q;      /* buffers to be written */
+    TaskHandle_t task;          /* writer task */
+    TaskHandle_t waiter;        /* task waiting for the writer to exit */
+    volatile FRESULT err;       /* first error of the writer */
+    BYTE tail;                  /* a partial sector was written, the recording is closed for data */
+    DWORD *lat_us;              /* ring of the latest write latencies */
+    DWORD lat_num;              /* samples in the ring */
+    DWORD lat_pos;
+    ff_recorder_stats stats;
+} ff_recorder;
+
+/* create path with size bytes preallocated contiguously, buf_size is the bytes of a buffer, a multiple of the sector size */
+FRESULT ff_recorder_open(ff_recorder *rec, const TCHAR *path, FSIZE_t size, UINT buf_size);
+
+/* get an empty buffer of buf_size bytes, wait up to wait ticks for the writer, NULL on timeout or error */
+BYTE *ff_recorder_get_buffer(ff_recorder *rec, TickType_t wait);
+
+/* queue len bytes of buf for writing, a len not aligned to the sector size ends the recording */
+FRESULT ff_recorder_submit(ff_recorder *rec, BYTE *buf, UINT len);
+
+/* wait for the queued writes, trim the file to the recorded length and close it */
+FRESULT ff_recorder_close(ff_recorder *rec);
+
+/* copy the statistics with the latency percentiles, the final ones after the recorder is closed */
+void ff_recorder_get_stats(ff_recorder *rec, ff_recorder_stats *stats);
+
+void ff_recorder_dump_stats(const ff_recorder_stats *stats);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,6 +23,8 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   route the drive through the block device layer
+ * 1.2   phytium    2026/10/19   mount the registered nvme disk
  */
 
 #include <string.h>
@@ -63,7 +65,7 @@ void ff_dump_info(const TCHAR *mount_point)
     fre_sect = fre_clust * fs->csize;
 
     /* Print the free space (assuming 512 bytes/sector) */
-    printf("\t%10lu KiB total drive space.\r\n\t%10lu KiB available.\r\n", 
+    printf("\t%10"PRIu32" KiB total drive space.\r\n\t%10"PRIu32" KiB available.\r\n",
             tot_sect / 2, 
             fre_sect / 2);
 
@@ -175,6 +177,29 @@ else if (!strcmp(mount_point, FF_SATA_PCIE_DISK_MOUNT_POINT))
         return -1;
 #endif      
     }
+    else if (!strcmp(mount_point, FF_NVME_DISK_MOUNT_POINT))
+    {
+#ifdef CONFIG_FATFS_NVME
+        /* the namespace is registered by ff_diskio_register_nvme after the controller is up */
+        if (ff_diskio_get_driver(pvol) == NULL)
+        {
+            FF_ERROR("No nvme disk registered as driver-%d.", pvol);
+            return FR_NOT_READY;
+        }
+        sprintf(label, "%s", "7:nvme");
+#else
+        return -1;
+#endif
+    }
+
+#ifdef CONFIG_FATFS_BLOCK_LAYER
+    /* queue the disk io of the drive in the block device layer */
+    if (ff_diskio_block_attach(pvol, strchr(label, ':') + 1) != 0)
+    {
+        return FR_INT_ERR;
+    }
+#endif
+
     /* force mounted the volume to check if it is ready to work. */
     printf("About to mount. \r\n");
     res = f_mount(fs, mount_point, 1);
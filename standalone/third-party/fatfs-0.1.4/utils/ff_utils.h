@@ -23,6 +23,8 @@
  *  Ver   Who        Date         Changes
  * ----- ------     --------    --------------------------------------
  * 1.0   zhugengyu  2022/12/3   init commit
+ * 1.1   phytium    2026/10/19   add ff_multitask_speed_test
+ * 1.2   phytium    2026/10/19   add ff_recorder_speed_test
  */
 
 #ifndef  FF_UTILS_H
@@ -55,6 +57,12 @@ int ff_cycle_test (const TCHAR *mount_point, UINT ncyc);
 int ff_diskio_speed_bench(const TCHAR *mount_point, DWORD start_sector, BYTE *test_buf, QWORD test_buf_len, QWORD test_tot_len);
 int ff_fileio_speed_test(const TCHAR *mount_point, BYTE *test_buf, QWORD test_buf_len, QWORD test_tot_len);
 FRESULT ff_big_file_test(const TCHAR* path, UINT sz_mb);
+#ifdef CONFIG_USE_FREERTOS
+int ff_multitask_speed_test(const TCHAR *mount_point, UINT task_num, QWORD file_len, UINT io_size);
+#endif
+#ifdef CONFIG_FATFS_RECORDER
+int ff_recorder_speed_test(const TCHAR *mount_point, QWORD file_len, UINT buf_size);
+#endif
 
 #ifdef __cplusplus
 }
@@ -1205,8 +1205,8 @@ typedef struct _mmc_extended_csd
     /*uint8_t contextManageCap;*/              /*!< context management capability[496]*/
     /*uint8_t tagResourceSize;*/               /*!< tag resource size[497]*/
     /*uint8_t tagUnitSize;*/                   /*!< tag unit size[498]*/
-    /*uint8_t maxPackedWriteCmd;*/             /*!< max packed write cmd[500]*/
-    /*uint8_t maxPackedReadCmd;*/              /*!< max packed read cmd[501]*/
+    uint8_t maxPackedWriteCmd;                 /*!< max packed write cmd[500]*/
+    uint8_t maxPackedReadCmd;                  /*!< max packed read cmd[501]*/
     /*uint8_t hpiFeature;*/                    /*!< HPI feature[503]*/
     uint8_t supportedCommandSet;               /*!< Supported Command Sets [504] */
     /*uint8_t extSecurityCmdError;*/           /*!< extended security commands error[505]*/
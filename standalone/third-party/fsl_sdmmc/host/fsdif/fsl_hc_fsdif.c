@@ -12,6 +12,7 @@
 #include "fsdif_hw.h"
 #include "fsdif.h"
 #include "fsdif_timing.h"
+#include "fsl_hc_fsdif.h"
 
 #include "finterrupt.h"
 /*******************************************************************************
@@ -21,9 +22,70 @@
 #define FSDIF_TRANS_ERR_EVENTS      (SDMMC_OSA_EVENT_TRANSFER_CMD_FAIL | \
                                      SDMMC_OSA_EVENT_TRANSFER_DATA_FAIL | \
                                      SDMMC_OSA_EVENT_CARD_REMOVED)
+#define FSDIF_TRANS_EVENTS          (SDMMC_OSA_EVENT_TRANSFER_CMD_SUCCESS | \
+                                     SDMMC_OSA_EVENT_TRANSFER_CMD_FAIL | \
+                                     SDMMC_OSA_EVENT_TRANSFER_DATA_SUCCESS | \
+                                     SDMMC_OSA_EVENT_TRANSFER_DATA_FAIL)
+
+#define FSDIFHOST_ASYNC_STAGE_IDLE   0U /* slot not started */
+#define FSDIFHOST_ASYNC_STAGE_SBC    1U /* CMD23 in flight */
+#define FSDIFHOST_ASYNC_STAGE_DATA   2U /* read/write command in flight */
+#define FSDIFHOST_ASYNC_STAGE_STOP   3U /* CMD12 in flight after open-ended read/write */
+#define FSDIFHOST_ASYNC_STAGE_BUSY   4U /* wait card not busy in FSDIFHOST_AsyncPoll */
+#define FSDIFHOST_ASYNC_STAGE_ERROR  5U /* recover in FSDIFHOST_AsyncPoll */
+#define FSDIFHOST_ASYNC_BUSY_RETRIES 5000U /* polls to wait card not busy */
+
+#define FSDIFHOST_PACKED_CMD         (1UL << 30U) /* packed command flag in CMD23 argument */
+#define FSDIFHOST_PACKED_VERSION     1U
+#define FSDIFHOST_PACKED_READ        1U
+#define FSDIFHOST_PACKED_WRITE       2U
 
 static const char* TAG = "SDMMC:FSdif";
 
+typedef struct
+{
+    uint32_t sbcArg;   /* argument of CMD23, 0 for single block or open-ended transfer */
+    bool stop;         /* open-ended multi-block transfer, stopped by CMD12 */
+    uint32_t cmdIndex; /* read/write command */
+    uint32_t cmdArg;
+    uint32_t blockCount;
+    bool write;
+    FSdifIDmaDescList *descList;
+} fsdifhost_async_phase_t;
+
+typedef struct
+{
+    fsdifhost_async_req_t *reqs; /* requests carried by the slot, NULL if the slot is free */
+    bool packed;
+    uint32_t stage;
+    status_t status;
+    uint32_t phaseNum;  /* packed read writes the header, then reads the data */
+    uint32_t curPhase;
+    fsdifhost_async_phase_t phase[2];
+    FSdifIDmaDescList dataList;
+    FSdifIDmaDescList hdrList;
+    uint32_t *packedHdr; /* one block */
+    FSdifCmdData cmd;
+    FSdifData data;
+} fsdifhost_async_slot_t;
+
+typedef struct
+{
+    fsdifhost_async_config_t config;
+    sdmmc_osa_mutex_t lock; /* serialize the callers in task, interrupt is masked while queue changes */
+    fsdifhost_async_req_t *pendHead;
+    fsdifhost_async_req_t *pendTail;
+    fsdifhost_async_slot_t slot[FSDIFHOST_ASYNC_SLOT_NUM];
+    fsdifhost_async_slot_t *active; /* slot on the bus */
+    fsdifhost_async_slot_t *ready;  /* slot prepared to start after the active one */
+    uint32_t busyPolls;
+    uint32_t progress;     /* stages started, a transfer without progress between two polls times out */
+    uint32_t lastProgress;
+    FSdifIDmaDesc *descs;
+    uint32_t *hdrs;
+    fsdifhost_async_stats_t stats;
+} fsdifhost_async_t;
+
 typedef struct _fsdiohost_dev_
 {
     sdmmchost_t *instance;
@@ -34,6 +96,11 @@ typedef struct _fsdiohost_dev_
     FSdifIDmaDesc *rw_desc;
     uint32_t desc_num;
     sdmmc_osa_event_t hc_evt;
+    bool tuning; /* errors are expected when sweep the sample phases */
+    uint32_t tuned_phase; /* sample phase found by tuning */
+    uint32_t tuned_phase_num; /* num of sample phases when tuning */
+    bool hs400;
+    fsdifhost_async_t *async; /* asynchronous transfer, NULL if not enabled */
 } fsdifhost_dev_t;
 /*******************************************************************************
  * Prototypes
@@ -51,6 +118,11 @@ static void FSDIFHOST_Relax(void)
     SDMMC_OSADelayUs(10);
 }
 
+static inline bool FSDIFHOST_AsyncBusy(fsdifhost_dev_t *dev)
+{
+    return (dev->async != NULL) && (dev->async->active != NULL);
+}
+
 static void FSDIFHOST_SetCardBusWidth(sdmmchost_t *host, uint32_t dataBusWidth)
 {
     if (host->currBusWidth == dataBusWidth)
@@ -200,12 +272,41 @@ static void FSDIFHOST_EnableDDRMode(sdmmchost_t *host, bool enable, uint32_t nib
 
 static void FSDIFHOST_EnableHS400Mode(sdmmchost_t *host, bool enable)
 {
+    if (!(host->capability & kSDMMCHOST_SupportHS400))
+    {
+        return;
+    }
 
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+
+    FSdifSetCardHS400Mode(&dev->hc, enable ? TRUE : FALSE);
+    dev->hs400 = enable;
+    SDMMC_LOGD(TAG, "HS400 mode %s", enable ? "on" : "off");
 }
 
 static void FSDIFHOST_EnableStrobeDll(sdmmchost_t *host, bool enable)
 {
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    uint32_t phase_num;
+    uint32_t phase;
 
+    /* no data strobe input in this controller, sample HS400 data at the phase
+       found by HS200 tuning, which is reset when the clock changed for HS400 */
+    if (!enable || !dev->hs400 || (dev->tuned_phase_num == 0U))
+    {
+        return;
+    }
+
+    phase_num = FSdifGetSamplePhaseNum(&dev->hc);
+    phase = dev->tuned_phase * phase_num / dev->tuned_phase_num;
+
+    if (FSDIF_SUCCESS != FSdifSetSamplePhase(&dev->hc, phase))
+    {
+        SDMMC_LOGE(TAG, "Set HS400 sample phase %d failed", phase);
+        return;
+    }
+
+    SDMMC_LOGI(TAG, "HS400 sample phase %d of %d", phase, phase_num);
 }
 
 static status_t FSDIFHOST_StartBoot(sdmmchost_t *host,
@@ -442,6 +543,11 @@ static status_t FSDIFHOST_TransferFunction_Poll(sdmmchost_t *host, sdmmchost_tra
     FSdifCmdData *cmd_data = &(dev->cmd_pkg);
     FSdifData *trans_data = &(dev->dat_pkg);
 
+    if (FSDIFHOST_AsyncBusy(dev))
+    {
+        return kStatus_Busy;
+    }
+
     status = FSDIFHOST_PreCommand(host, content);
     if (kStatus_Success != status)
     {
@@ -508,9 +614,12 @@ static status_t FSDIFHOST_TransferFunction_Poll(sdmmchost_t *host, sdmmchost_tra
     (void)SDMMC_OSAEventWait(&dev->hc_evt, err_events, 0, &events, SDMMC_OSA_EVENT_FLAG_OR);
     if (events)
     {
-        SDMMC_LOGE(TAG, "Finish command with error 0x%x!!!", events);
+        if (!dev->tuning)
+        {
+            SDMMC_LOGE(TAG, "Finish command with error 0x%x!!!", events);
+            FSdifDumpRegister(dev->hc.config.base_addr);
+        }
         status = kStatus_Timeout;
-        FSdifDumpRegister(dev->hc.config.base_addr);
         (void)SDMMC_OSAEventClear(&dev->hc_evt, events);
         return status;
     }
@@ -547,6 +656,11 @@ static status_t FSDIFHOST_TransferFunction_Irq(sdmmchost_t *host, sdmmchost_tran
     FSdifData *trans_data = &(dev->dat_pkg);
     int32_t timeout = FSDIF_COMMAND_TIMEOUT;
 
+    if (FSDIFHOST_AsyncBusy(dev))
+    {
+        return kStatus_Busy;
+    }
+
     status = FSDIFHOST_PreCommand(host, content);
     if (kStatus_Success != status)
     {
@@ -602,30 +716,45 @@ static status_t FSDIFHOST_TransferFunction_Irq(sdmmchost_t *host, sdmmchost_tran
     uint32_t complete_events = (cmd_data->data_p) ? 
                          (SDMMC_OSA_EVENT_TRANSFER_CMD_SUCCESS | SDMMC_OSA_EVENT_TRANSFER_DATA_SUCCESS) : 
                          SDMMC_OSA_EVENT_TRANSFER_CMD_SUCCESS;
+    uint32_t wait_events = complete_events | FSDIF_TRANS_ERR_EVENTS;
+    uint32_t got_events = 0;
     uint32_t events = 0;
-    if ((SDMMC_OSAEventWait(&dev->hc_evt, complete_events, timeout, &events, SDMMC_OSA_EVENT_FLAG_AND) != kStatus_Success) ||
-        (events != complete_events))
+
+    /* wake up on error events too, otherwise a failed transfer waits until timeout */
+    while (true)
     {
-        SDMMC_LOGE(TAG, "Wait command done timeout !!!");
-        status = kStatus_Timeout;
-        FSdifDumpRegister(dev->hc.config.base_addr);
-        (void)SDMMC_OSAEventClear(&dev->hc_evt, events);
-        return status;
+        (void)SDMMC_OSAEventGet(&dev->hc_evt, wait_events, &events);
+        got_events |= events;
+        if (((got_events & complete_events) == complete_events) ||
+            (got_events & FSDIF_TRANS_ERR_EVENTS))
+        {
+            break;
+        }
+
+        events = 0;
+        if (SDMMC_OSAEventWait(&dev->hc_evt, wait_events, timeout, &events, SDMMC_OSA_EVENT_FLAG_OR) != kStatus_Success)
+        {
+            SDMMC_LOGE(TAG, "Wait command done timeout !!!");
+            status = kStatus_Timeout;
+            FSdifDumpRegister(dev->hc.config.base_addr);
+            (void)SDMMC_OSAEventClear(&dev->hc_evt, got_events | events);
+            return status;
+        }
+        got_events |= events;
     }
-    
-    (void)SDMMC_OSAEventClear(&dev->hc_evt, events);
+
+    (void)SDMMC_OSAEventClear(&dev->hc_evt, got_events);
 
     /* check if any error events */
-    uint32_t err_events = FSDIF_TRANS_ERR_EVENTS;
-    events = 0;
-    (void)SDMMC_OSAEventWait(&dev->hc_evt, err_events, 0, &events, SDMMC_OSA_EVENT_FLAG_OR);
-    if (events)
+    if (got_events & FSDIF_TRANS_ERR_EVENTS)
     {
-        SDMMC_LOGE(TAG, "Finish command with error 0x%x!!!", events);
+        if (!dev->tuning)
+        {
+            SDMMC_LOGE(TAG, "Finish command with error 0x%x!!!", got_events);
+            FSdifDumpRegister(dev->hc.config.base_addr);
+        }
         status = kStatus_Timeout;
-        FSdifDumpRegister(dev->hc.config.base_addr);
-        (void)SDMMC_OSAEventClear(&dev->hc_evt, events);
-        return status;        
+        return status;
     }
 
     /* in IRQ mode, read PIO data after recv DTO flag */
@@ -659,8 +788,124 @@ static status_t FSDIFHOST_TransferFunction_Irq(sdmmchost_t *host, sdmmchost_tran
     return status;
 }
 
+static bool FSDIFHOST_TuningPhase(sdmmchost_t *host, uint32_t tuningCmd, uint32_t *revBuf, uint32_t blockSize)
+{
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    const uint32_t *pattern = (blockSize == 128U) ? SDMMC_TuningBlockPattern8Bit : SDMMC_TuningBlockPattern4Bit;
+    sdmmchost_transfer_t content = {0};
+    sdmmchost_cmd_t command = {0};
+    sdmmchost_data_t data = {0};
+    status_t status;
+
+    command.index = tuningCmd;
+    command.argument = 0U;
+    command.responseType = kCARD_ResponseTypeR1;
+    data.blockSize = blockSize;
+    data.blockCount = 1U;
+    data.rxData = revBuf;
+    content.command = &command;
+    content.data = &data;
+
+    memset(revBuf, 0U, blockSize);
+    status = SDMMCHOST_TransferFunction(host, &content);
+    if (kStatus_Success != status)
+    {
+        /* drop the data left by the failed transfer before try next phase */
+        (void)FSdifResetCtrl(dev->hc.config.base_addr, FSDIF_CNTRL_FIFO_RESET | FSDIF_CNTRL_DMA_RESET);
+        FSdifResetIDMA(dev->hc.config.base_addr);
+        (void)SDMMC_OSAEventClear(&dev->hc_evt, FSDIF_TRANS_EVENTS);
+        return false;
+    }
+
+    for (uint32_t i = 0U; i < blockSize / sizeof(uint32_t); i++)
+    {
+        if (SWAP_WORD_BYTE_SEQUENCE(revBuf[i]) != pattern[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static status_t FSDIFHOST_ExecuteTuning(sdmmchost_t *host, uint32_t tuningCmd, uint32_t *revBuf, uint32_t blockSize)
 {
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    uint32_t phase_num = FSdifGetSamplePhaseNum(&dev->hc);
+    uint32_t pass_map[FSDIF_MAX_SAMPLE_PHASE_NUM / 32U] = {0U};
+    uint32_t best_start = 0U, best_len = 0U;
+    uint32_t start = 0U, len = 0U;
+    uint32_t phase;
+
+    if ((blockSize != 64U) && (blockSize != 128U))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    if (phase_num <= 1U)
+    {
+        /* sample phase can not be adjusted at this clock */
+        return kStatus_Success;
+    }
+
+    dev->tuning = true;
+    for (phase = 0U; phase < phase_num; phase++)
+    {
+        if ((FSDIF_SUCCESS == FSdifSetSamplePhase(&dev->hc, phase)) &&
+            FSDIFHOST_TuningPhase(host, tuningCmd, revBuf, blockSize))
+        {
+            pass_map[phase / 32U] |= (1U << (phase % 32U));
+        }
+    }
+    dev->tuning = false;
+
+    /* find the longest passing window, which may wrap around the clock period */
+    for (phase = 0U; phase < 2U * phase_num; phase++)
+    {
+        uint32_t index = phase % phase_num;
+
+        if (pass_map[index / 32U] & (1U << (index % 32U)))
+        {
+            if (len == 0U)
+            {
+                start = index;
+            }
+
+            if (++len > best_len)
+            {
+                best_start = start;
+                best_len = len;
+            }
+
+            if (len == phase_num)
+            {
+                break;
+            }
+        }
+        else
+        {
+            len = 0U;
+        }
+    }
+
+    if (best_len == 0U)
+    {
+        SDMMC_LOGE(TAG, "Tuning failed, no sample phase passed in %d phases", phase_num);
+        (void)FSdifSetSamplePhase(&dev->hc, 0U);
+        return kStatus_SDMMC_TuningFail;
+    }
+
+    /* sample at the middle of the window */
+    phase = (best_start + best_len / 2U) % phase_num;
+    if (FSDIF_SUCCESS != FSdifSetSamplePhase(&dev->hc, phase))
+    {
+        return kStatus_SDMMC_TuningFail;
+    }
+
+    dev->tuned_phase = phase;
+    dev->tuned_phase_num = phase_num;
+    SDMMC_LOGI(TAG, "Tuning done, sample phase %d, pass %d of %d phases", phase, best_len, phase_num);
+
     return kStatus_Success;
 }
 
@@ -700,6 +945,717 @@ static void FSDIFHOST_ConvertDataToLittleEndian(sdmmchost_t *host, uint32_t *dat
     }
 }
 
+static inline uint32_t FSDIFHOST_AsyncAddress(fsdifhost_async_t *async, uint32_t block)
+{
+    return async->config.byteAddress ? (block * async->config.blockSize) : block;
+}
+
+static void FSDIFHOST_AsyncKick(fsdifhost_async_t *async)
+{
+    if (async->config.kick)
+    {
+        async->config.kick(async->config.kickParam);
+    }
+}
+
+static void FSDIFHOST_AsyncFail(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot, status_t status)
+{
+    slot->stage = FSDIFHOST_ASYNC_STAGE_ERROR;
+    slot->status = status;
+    dev->async->progress++;
+    FSDIFHOST_AsyncKick(dev->async);
+}
+
+/* fill the descriptors and commands of slot with the requests at the head of queue */
+static void FSDIFHOST_AsyncPrepare(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    fsdifhost_async_t *async = dev->async;
+    fsdifhost_async_req_t *req = async->pendHead;
+    fsdifhost_async_req_t *last = req;
+    fsdifhost_async_req_t *cur;
+    FSdifDMASeg segs[FSDIFHOST_ASYNC_MAX_PACKED + 1U];
+    FSdifDMASeg hdr_seg;
+    uint32_t block_size = async->config.blockSize;
+    uint32_t max_packed = req->write ? async->config.maxPackedWrites : async->config.maxPackedReads;
+    uint32_t num = 1U;
+    uint32_t total = req->blockCount;
+    uint32_t seg_num = 0U;
+    uint32_t i;
+    FError ret;
+
+    /* pack the following requests of same direction, the header takes one more block */
+    if (!req->noPack)
+    {
+        while ((num < max_packed) && (last->next != NULL) && (!last->next->noPack) &&
+               (last->next->write == req->write) &&
+               (total + last->next->blockCount < dev->instance->maxBlockCount))
+        {
+            last = last->next;
+            total += last->blockCount;
+            num++;
+        }
+    }
+
+    async->pendHead = last->next;
+    if (async->pendHead == NULL)
+    {
+        async->pendTail = NULL;
+    }
+    last->next = NULL;
+
+    slot->reqs = req;
+    slot->packed = (num > 1U);
+    slot->stage = FSDIFHOST_ASYNC_STAGE_IDLE;
+    slot->status = kStatus_Success;
+    slot->curPhase = 0U;
+
+    if (!slot->packed)
+    {
+        segs[0].buf_dma = (uintptr)req->buffer;
+        segs[0].len = req->blockCount * block_size;
+
+        /* card without CMD23 takes an open-ended transfer */
+        slot->phase[0].sbcArg = ((req->blockCount > 1U) && async->config.setBlockCount) ? req->blockCount : 0U;
+        slot->phase[0].stop = (req->blockCount > 1U) && !async->config.setBlockCount;
+        if (req->write)
+        {
+            slot->phase[0].cmdIndex = (req->blockCount > 1U) ? kSDMMC_WriteMultipleBlock : kSDMMC_WriteSingleBlock;
+        }
+        else
+        {
+            slot->phase[0].cmdIndex = (req->blockCount > 1U) ? kSDMMC_ReadMultipleBlock : kSDMMC_ReadSingleBlock;
+        }
+        slot->phase[0].cmdArg = FSDIFHOST_AsyncAddress(async, req->block);
+        slot->phase[0].blockCount = req->blockCount;
+        slot->phase[0].write = req->write;
+        slot->phase[0].descList = &slot->dataList;
+        slot->phaseNum = 1U;
+
+        ret = FSdifPrepareDMADescriptor(&dev->hc, &slot->dataList, segs, 1U, block_size);
+    }
+    else
+    {
+        /* packed header, entry i holds the CMD23 and read/write argument of request i */
+        memset(slot->packedHdr, 0U, block_size);
+        slot->packedHdr[0] = (num << 16U) |
+                             ((req->write ? FSDIFHOST_PACKED_WRITE : FSDIFHOST_PACKED_READ) << 8U) |
+                             FSDIFHOST_PACKED_VERSION;
+        for (cur = req, i = 1U; cur != NULL; cur = cur->next, i++)
+        {
+            slot->packedHdr[2U * i] = cur->blockCount;
+            slot->packedHdr[2U * i + 1U] = FSDIFHOST_AsyncAddress(async, cur->block);
+        }
+
+        hdr_seg.buf_dma = (uintptr)slot->packedHdr;
+        hdr_seg.len = block_size;
+        if (req->write)
+        {
+            segs[seg_num++] = hdr_seg;
+        }
+
+        for (cur = req; cur != NULL; cur = cur->next)
+        {
+            segs[seg_num].buf_dma = (uintptr)cur->buffer;
+            segs[seg_num].len = cur->blockCount * block_size;
+            seg_num++;
+        }
+
+        if (req->write)
+        {
+            /* header and data of all requests in one write */
+            slot->phase[0].sbcArg = FSDIFHOST_PACKED_CMD | (total + 1U);
+            slot->phase[0].stop = false;
+            slot->phase[0].cmdIndex = kSDMMC_WriteMultipleBlock;
+            slot->phase[0].cmdArg = FSDIFHOST_AsyncAddress(async, req->block);
+            slot->phase[0].blockCount = total + 1U;
+            slot->phase[0].write = true;
+            slot->phase[0].descList = &slot->dataList;
+            slot->phaseNum = 1U;
+
+            ret = FSdifPrepareDMADescriptor(&dev->hc, &slot->dataList, segs, seg_num, block_size);
+        }
+        else
+        {
+            /* write the header, then read the data of all requests */
+            slot->phase[0].sbcArg = FSDIFHOST_PACKED_CMD | 1U;
+            slot->phase[0].stop = false;
+            slot->phase[0].cmdIndex = kSDMMC_WriteMultipleBlock;
+            slot->phase[0].cmdArg = FSDIFHOST_AsyncAddress(async, req->block);
+            slot->phase[0].blockCount = 1U;
+            slot->phase[0].write = true;
+            slot->phase[0].descList = &slot->hdrList;
+            slot->phase[1].sbcArg = FSDIFHOST_PACKED_CMD | total;
+            slot->phase[1].stop = false;
+            slot->phase[1].cmdIndex = kSDMMC_ReadMultipleBlock;
+            slot->phase[1].cmdArg = FSDIFHOST_AsyncAddress(async, req->block);
+            slot->phase[1].blockCount = total;
+            slot->phase[1].write = false;
+            slot->phase[1].descList = &slot->dataList;
+            slot->phaseNum = 2U;
+
+            ret = FSdifPrepareDMADescriptor(&dev->hc, &slot->hdrList, &hdr_seg, 1U, block_size);
+            if (FSDIF_SUCCESS == ret)
+            {
+                ret = FSdifPrepareDMADescriptor(&dev->hc, &slot->dataList, segs, seg_num, block_size);
+            }
+        }
+
+        async->stats.packed++;
+        async->stats.packedRequests += num;
+    }
+
+    if (FSDIF_SUCCESS != ret)
+    {
+        SDMMC_LOGE(TAG, "Prepare descriptors of block %d failed, 0x%x", req->block, ret);
+        slot->status = kStatus_SDMMC_TransferFailed;
+    }
+}
+
+static void FSDIFHOST_AsyncStartData(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    fsdifhost_async_phase_t *phase = &slot->phase[slot->curPhase];
+
+    memset(&slot->cmd, 0U, sizeof(slot->cmd));
+    memset(&slot->data, 0U, sizeof(slot->data));
+
+    slot->data.buf = (void *)slot->reqs->buffer;
+    slot->data.blksz = dev->async->config.blockSize;
+    slot->data.blkcnt = phase->blockCount;
+    slot->data.datalen = phase->blockCount * dev->async->config.blockSize;
+    slot->data.desc_list = phase->descList;
+
+    slot->cmd.cmdidx = phase->cmdIndex;
+    slot->cmd.cmdarg = phase->cmdArg;
+    slot->cmd.rawcmd = FSDIF_CMD_INDX_SET(phase->cmdIndex) | FSDIF_CMD_RESP_EXP |
+                       FSDIF_CMD_RESP_CRC | FSDIF_CMD_DAT_EXP;
+    if (phase->write)
+    {
+        slot->cmd.rawcmd |= FSDIF_CMD_DAT_WRITE;
+    }
+    slot->cmd.data_p = &slot->data;
+
+    slot->stage = FSDIFHOST_ASYNC_STAGE_DATA;
+    dev->async->progress++;
+    dev->async->stats.transfers++;
+
+    if (FSDIF_SUCCESS != FSdifDMATransfer(&dev->hc, &slot->cmd))
+    {
+        FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_TransferFailed);
+    }
+}
+
+static void FSDIFHOST_AsyncStartStop(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    memset(&slot->cmd, 0U, sizeof(slot->cmd));
+    slot->cmd.cmdidx = kSDMMC_StopTransmission;
+    slot->cmd.cmdarg = 0U;
+    slot->cmd.rawcmd = FSDIF_CMD_INDX_SET(kSDMMC_StopTransmission) | FSDIF_CMD_RESP_EXP |
+                       FSDIF_CMD_RESP_CRC | FSDIF_CMD_STOP_ABORT;
+    slot->cmd.data_p = NULL;
+
+    slot->stage = FSDIFHOST_ASYNC_STAGE_STOP;
+    dev->async->progress++;
+
+    if (FSDIF_SUCCESS != FSdifDMATransfer(&dev->hc, &slot->cmd))
+    {
+        FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_StopTransmissionFailed);
+    }
+}
+
+/* start current phase of slot, or leave it to FSDIFHOST_AsyncPoll if the card is busy */
+static void FSDIFHOST_AsyncStartPhase(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    fsdifhost_async_phase_t *phase = &slot->phase[slot->curPhase];
+
+    if (kStatus_Success != slot->status)
+    {
+        FSDIFHOST_AsyncFail(dev, slot, slot->status);
+        return;
+    }
+
+    /* the card is busy programming after write */
+    if (FSdifCheckCardBusy(&dev->hc))
+    {
+        if (FSDIFHOST_ASYNC_STAGE_BUSY != slot->stage)
+        {
+            slot->stage = FSDIFHOST_ASYNC_STAGE_BUSY;
+            dev->async->busyPolls = 0U;
+            dev->async->stats.busyWaits++;
+        }
+        FSDIFHOST_AsyncKick(dev->async);
+        return;
+    }
+
+    if (0U == phase->sbcArg)
+    {
+        FSDIFHOST_AsyncStartData(dev, slot);
+        return;
+    }
+
+    memset(&slot->cmd, 0U, sizeof(slot->cmd));
+    slot->cmd.cmdidx = kSDMMC_SetBlockCount;
+    slot->cmd.cmdarg = phase->sbcArg;
+    slot->cmd.rawcmd = FSDIF_CMD_INDX_SET(kSDMMC_SetBlockCount) | FSDIF_CMD_RESP_EXP | FSDIF_CMD_RESP_CRC;
+    slot->cmd.data_p = NULL;
+
+    slot->stage = FSDIFHOST_ASYNC_STAGE_SBC;
+    dev->async->progress++;
+
+    if (FSDIF_SUCCESS != FSdifDMATransfer(&dev->hc, &slot->cmd))
+    {
+        FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_SetBlockCountFailed);
+    }
+}
+
+/* prepare the queued requests into free slot, and start the prepared slot if the bus is free */
+static void FSDIFHOST_AsyncSchedule(fsdifhost_dev_t *dev)
+{
+    fsdifhost_async_t *async = dev->async;
+    uint32_t i;
+
+    for (;;)
+    {
+        if ((NULL == async->ready) && (NULL != async->pendHead))
+        {
+            for (i = 0U; i < FSDIFHOST_ASYNC_SLOT_NUM; i++)
+            {
+                if (NULL == async->slot[i].reqs)
+                {
+                    FSDIFHOST_AsyncPrepare(dev, &async->slot[i]);
+                    async->ready = &async->slot[i];
+                    break;
+                }
+            }
+        }
+
+        if ((NULL == async->active) && (NULL != async->ready))
+        {
+            async->active = async->ready;
+            async->ready = NULL;
+            FSDIFHOST_AsyncStartPhase(dev, async->active);
+            continue;
+        }
+
+        break;
+    }
+}
+
+/* free the slot, return its requests */
+static fsdifhost_async_req_t *FSDIFHOST_AsyncFinish(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    fsdifhost_async_req_t *reqs = slot->reqs;
+
+    slot->reqs = NULL;
+    slot->stage = FSDIFHOST_ASYNC_STAGE_IDLE;
+    if (dev->async->active == slot)
+    {
+        dev->async->active = NULL;
+    }
+
+    return reqs;
+}
+
+static void FSDIFHOST_AsyncCount(fsdifhost_async_t *async, fsdifhost_async_req_t *req)
+{
+    for (; req != NULL; req = req->next)
+    {
+        async->stats.requests++;
+    }
+}
+
+static void FSDIFHOST_AsyncComplete(fsdifhost_async_req_t *req, status_t status)
+{
+    fsdifhost_async_req_t *next;
+
+    for (; req != NULL; req = next)
+    {
+        next = req->next;
+        req->next = NULL;
+        req->callback(req, status);
+    }
+}
+
+/* current phase done, start the next one or finish the slot */
+static void FSDIFHOST_AsyncPhaseDone(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    fsdifhost_async_req_t *reqs;
+
+    if (++slot->curPhase < slot->phaseNum)
+    {
+        FSDIFHOST_AsyncStartPhase(dev, slot);
+        return;
+    }
+
+    /* start the prepared slot before complete the requests */
+    reqs = FSDIFHOST_AsyncFinish(dev, slot);
+    FSDIFHOST_AsyncCount(dev->async, reqs);
+    FSDIFHOST_AsyncSchedule(dev);
+    FSDIFHOST_AsyncComplete(reqs, kStatus_Success);
+}
+
+static void FSDIFHOST_AsyncCmdDone(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot)
+{
+    if (FSDIFHOST_ASYNC_STAGE_STOP == slot->stage)
+    {
+        (void)FSdifGetCmdResponse(&dev->hc, &slot->cmd);
+        if (slot->cmd.response[0] & SDMMC_R1_ALL_ERROR_FLAG)
+        {
+            SDMMC_LOGE(TAG, "Stop transmission failed, R1: 0x%x", slot->cmd.response[0]);
+            FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_StopTransmissionFailed);
+            return;
+        }
+
+        FSDIFHOST_AsyncPhaseDone(dev, slot);
+        return;
+    }
+
+    /* read/write command done, wait for data done */
+    if (FSDIFHOST_ASYNC_STAGE_SBC != slot->stage)
+    {
+        return;
+    }
+
+    (void)FSdifGetCmdResponse(&dev->hc, &slot->cmd);
+    if (slot->cmd.response[0] & SDMMC_R1_ALL_ERROR_FLAG)
+    {
+        SDMMC_LOGE(TAG, "Set block count 0x%x failed, R1: 0x%x", slot->cmd.cmdarg, slot->cmd.response[0]);
+        FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_SetBlockCountFailed);
+        return;
+    }
+
+    FSDIFHOST_AsyncStartData(dev, slot);
+}
+
+static void FSDIFHOST_AsyncDataDone(fsdifhost_dev_t *dev, fsdifhost_async_slot_t *slot, u32 status)
+{
+    if ((FSDIFHOST_ASYNC_STAGE_DATA != slot->stage) || !(status & FSDIF_INT_DTO_BIT))
+    {
+        return;
+    }
+
+    (void)FSdifGetCmdResponse(&dev->hc, &slot->cmd);
+    if (slot->cmd.response[0] & SDMMC_R1_ALL_ERROR_FLAG)
+    {
+        SDMMC_LOGE(TAG, "CMD%d arg 0x%x failed, R1: 0x%x", slot->cmd.cmdidx, slot->cmd.cmdarg, slot->cmd.response[0]);
+        FSDIFHOST_AsyncFail(dev, slot, kStatus_SDMMC_TransferFailed);
+        return;
+    }
+
+    if (slot->phase[slot->curPhase].stop)
+    {
+        FSDIFHOST_AsyncStartStop(dev, slot);
+        return;
+    }
+
+    FSDIFHOST_AsyncPhaseDone(dev, slot);
+}
+
+/* stop the failed transfer, the interrupt handles commands synchronously here */
+static void FSDIFHOST_AsyncRecover(sdmmchost_t *host)
+{
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    uintptr base_addr = dev->hc.config.base_addr;
+    sdmmchost_transfer_t content = {0};
+    sdmmchost_cmd_t command = {0};
+    uint32_t timeout;
+
+    (void)FSdifResetCtrl(base_addr, FSDIF_CNTRL_FIFO_RESET | FSDIF_CNTRL_DMA_RESET);
+    FSdifResetIDMA(base_addr);
+    (void)SDMMC_OSAEventClear(&dev->hc_evt, FSDIF_TRANS_EVENTS);
+
+    for (timeout = FSDIF_COMMAND_TIMEOUT; FSdifCheckCardBusy(&dev->hc) && (timeout > 0U); timeout--)
+    {
+        SDMMC_OSADelay(1U);
+    }
+
+    /* the card may stay in data state, CMD12 fails if it is back to transfer state already */
+    command.index = (uint32_t)kSDMMC_StopTransmission;
+    command.argument = 0U;
+    command.type = kCARD_CommandTypeAbort;
+    command.responseType = kCARD_ResponseTypeR1b;
+    content.command = &command;
+    content.data = NULL;
+    (void)SDMMCHOST_TransferFunction(host, &content);
+
+    for (timeout = FSDIF_COMMAND_TIMEOUT; FSdifCheckCardBusy(&dev->hc) && (timeout > 0U); timeout--)
+    {
+        SDMMC_OSADelay(1U);
+    }
+}
+
+static void FSDIFHOST_AsyncFree(fsdifhost_async_t *async)
+{
+    SDMMC_OSAMutexDestroy(&async->lock);
+    SDMMC_OSAMemoryFree(async->descs);
+    SDMMC_OSAMemoryFree(async->hdrs);
+    SDMMC_OSAMemoryFree(async);
+}
+
+status_t FSDIFHOST_AsyncEnable(sdmmchost_t *host, const fsdifhost_async_config_t *config)
+{
+    assert(host && config);
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async;
+    /* data may split in each request of packed command, and the header takes one */
+    uint32_t data_desc_num = host->config.maxTransSize / FSDIF_IDMAC_MAX_BUF_SIZE + FSDIFHOST_ASYNC_MAX_PACKED + 2U;
+    uint32_t slot_desc_num = data_desc_num + 1U;
+    uint32_t i;
+
+    if ((NULL != dev->async) || !host->config.enableDMA || !host->config.enableIrq ||
+        (config->blockSize == 0U) || (config->blockSize % FSDIF_DMA_BUF_ALIGMENT))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    async = SDMMC_OSAMemoryAllocate(sizeof(fsdifhost_async_t));
+    if (NULL == async)
+    {
+        return kStatus_OutOfRange;
+    }
+
+    memset(async, 0U, sizeof(*async));
+    async->config = *config;
+
+    /* packed command is eMMC only, it needs CMD23, and its header shall fit in one block */
+    if ((kSDMMCHOST_CARD_TYPE_EMMC != host->config.cardType) || !config->setBlockCount ||
+        ((2U * FSDIFHOST_ASYNC_MAX_PACKED + 2U) * sizeof(uint32_t) > config->blockSize))
+    {
+        async->config.maxPackedWrites = 0U;
+        async->config.maxPackedReads = 0U;
+    }
+    async->config.maxPackedWrites = MIN(async->config.maxPackedWrites, FSDIFHOST_ASYNC_MAX_PACKED);
+    async->config.maxPackedReads = MIN(async->config.maxPackedReads, FSDIFHOST_ASYNC_MAX_PACKED);
+
+    async->descs = SDMMC_OSAMemoryAlignedAllocate(sizeof(FSdifIDmaDesc) * slot_desc_num * FSDIFHOST_ASYNC_SLOT_NUM,
+                                                  host->config.defBlockSize);
+    async->hdrs = SDMMC_OSAMemoryAlignedAllocate(config->blockSize * FSDIFHOST_ASYNC_SLOT_NUM,
+                                                 host->config.defBlockSize);
+    if ((NULL == async->descs) || (NULL == async->hdrs) ||
+        (kStatus_Success != SDMMC_OSAMutexCreate(&async->lock)))
+    {
+        SDMMC_OSAMemoryFree(async->descs);
+        SDMMC_OSAMemoryFree(async->hdrs);
+        SDMMC_OSAMemoryFree(async);
+        return kStatus_OutOfRange;
+    }
+
+    for (i = 0U; i < FSDIFHOST_ASYNC_SLOT_NUM; i++)
+    {
+        fsdifhost_async_slot_t *slot = &async->slot[i];
+        FSdifIDmaDesc *desc = &async->descs[i * slot_desc_num];
+
+        slot->dataList.first_desc = desc;
+        slot->dataList.first_desc_dma = (uintptr)desc; /* physical address equals with virtual address */
+        slot->dataList.desc_num = data_desc_num;
+        slot->dataList.desc_trans_sz = FSDIF_IDMAC_MAX_BUF_SIZE;
+        slot->hdrList.first_desc = desc + data_desc_num;
+        slot->hdrList.first_desc_dma = (uintptr)(desc + data_desc_num);
+        slot->hdrList.desc_num = 1U;
+        slot->hdrList.desc_trans_sz = FSDIF_IDMAC_MAX_BUF_SIZE;
+        slot->packedHdr = &async->hdrs[i * config->blockSize / sizeof(uint32_t)];
+    }
+
+    InterruptMask(dev->hc.config.irq_num);
+    dev->async = async;
+    InterruptUmask(dev->hc.config.irq_num);
+
+    SDMMC_LOGI(TAG, "Async transfer enabled, CMD23 %d, packed write %d, packed read %d",
+               async->config.setBlockCount, async->config.maxPackedWrites, async->config.maxPackedReads);
+    return kStatus_Success;
+}
+
+status_t FSDIFHOST_AsyncDisable(sdmmchost_t *host)
+{
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async = dev->async;
+
+    if (NULL == async)
+    {
+        return kStatus_Success;
+    }
+
+    (void)SDMMC_OSAMutexLock(&async->lock, osaWaitForever_c);
+    if (!FSDIFHOST_AsyncIdle(host))
+    {
+        (void)SDMMC_OSAMutexUnlock(&async->lock);
+        return kStatus_Busy;
+    }
+
+    InterruptMask(dev->hc.config.irq_num);
+    dev->async = NULL;
+    InterruptUmask(dev->hc.config.irq_num);
+    (void)SDMMC_OSAMutexUnlock(&async->lock);
+
+    FSDIFHOST_AsyncFree(async);
+    return kStatus_Success;
+}
+
+status_t FSDIFHOST_AsyncSubmit(sdmmchost_t *host, fsdifhost_async_req_t *req)
+{
+    assert(host);
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async = dev->async;
+
+    if ((NULL == async) || (NULL == req) || (NULL == req->callback) || (NULL == req->buffer) ||
+        ((uintptr)req->buffer % FSDIF_DMA_BUF_ALIGMENT) ||
+        (req->blockCount == 0U) || (req->blockCount > host->maxBlockCount))
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    req->next = NULL;
+    req->noPack = false;
+
+    (void)SDMMC_OSAMutexLock(&async->lock, osaWaitForever_c);
+    InterruptMask(dev->hc.config.irq_num);
+
+    if (NULL == async->pendTail)
+    {
+        async->pendHead = req;
+    }
+    else
+    {
+        async->pendTail->next = req;
+    }
+    async->pendTail = req;
+
+    FSDIFHOST_AsyncSchedule(dev);
+
+    InterruptUmask(dev->hc.config.irq_num);
+    (void)SDMMC_OSAMutexUnlock(&async->lock);
+
+    return kStatus_Success;
+}
+
+void FSDIFHOST_AsyncPoll(sdmmchost_t *host)
+{
+    assert(host);
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async = dev->async;
+    fsdifhost_async_slot_t *slot;
+    fsdifhost_async_req_t *reqs = NULL;
+    fsdifhost_async_req_t *last;
+    status_t status = kStatus_Success;
+
+    if (NULL == async)
+    {
+        return;
+    }
+
+    (void)SDMMC_OSAMutexLock(&async->lock, osaWaitForever_c);
+    InterruptMask(dev->hc.config.irq_num);
+
+    slot = async->active;
+    if ((NULL != slot) &&
+        ((FSDIFHOST_ASYNC_STAGE_SBC == slot->stage) || (FSDIFHOST_ASYNC_STAGE_DATA == slot->stage) ||
+         (FSDIFHOST_ASYNC_STAGE_STOP == slot->stage)))
+    {
+        if (async->progress == async->lastProgress)
+        {
+            SDMMC_LOGE(TAG, "CMD%d arg 0x%x timeout", slot->cmd.cmdidx, slot->cmd.cmdarg);
+            FSdifDumpRegister(dev->hc.config.base_addr);
+            slot->stage = FSDIFHOST_ASYNC_STAGE_ERROR;
+            slot->status = kStatus_Timeout;
+        }
+        async->lastProgress = async->progress;
+    }
+    else if ((NULL != slot) && (FSDIFHOST_ASYNC_STAGE_BUSY == slot->stage))
+    {
+        if (++async->busyPolls > FSDIFHOST_ASYNC_BUSY_RETRIES)
+        {
+            SDMMC_LOGE(TAG, "Wait card not busy timeout");
+            slot->stage = FSDIFHOST_ASYNC_STAGE_ERROR;
+            slot->status = kStatus_Timeout;
+        }
+        else
+        {
+            FSDIFHOST_AsyncStartPhase(dev, slot);
+        }
+    }
+
+    if ((NULL != slot) && (FSDIFHOST_ASYNC_STAGE_ERROR == slot->stage))
+    {
+        /* stop the bus with interrupt on, nothing starts until the slot is finished */
+        async->active = NULL;
+        InterruptUmask(dev->hc.config.irq_num);
+        FSDIFHOST_AsyncRecover(host);
+        InterruptMask(dev->hc.config.irq_num);
+
+        async->stats.errors++;
+        status = slot->status;
+        reqs = FSDIFHOST_AsyncFinish(dev, slot);
+
+        if (slot->packed)
+        {
+            /* requeue the requests one by one, and stop packing in this direction */
+            SDMMC_LOGE(TAG, "Packed %s failed, retry without packed command", reqs->write ? "write" : "read");
+            if (reqs->write)
+            {
+                async->config.maxPackedWrites = 0U;
+            }
+            else
+            {
+                async->config.maxPackedReads = 0U;
+            }
+
+            for (last = reqs; ; last = last->next)
+            {
+                last->noPack = true;
+                async->stats.retries++;
+                if (NULL == last->next)
+                {
+                    break;
+                }
+            }
+
+            last->next = async->pendHead;
+            async->pendHead = reqs;
+            if (NULL == async->pendTail)
+            {
+                async->pendTail = last;
+            }
+            reqs = NULL;
+        }
+
+        FSDIFHOST_AsyncCount(async, reqs);
+        FSDIFHOST_AsyncSchedule(dev);
+    }
+
+    InterruptUmask(dev->hc.config.irq_num);
+    (void)SDMMC_OSAMutexUnlock(&async->lock);
+
+    FSDIFHOST_AsyncComplete(reqs, status);
+}
+
+bool FSDIFHOST_AsyncIdle(sdmmchost_t *host)
+{
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async = dev->async;
+
+    return (NULL == async) ||
+           ((NULL == async->active) && (NULL == async->ready) && (NULL == async->pendHead));
+}
+
+void FSDIFHOST_AsyncGetStats(sdmmchost_t *host, fsdifhost_async_stats_t *stats, bool reset)
+{
+    fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
+    fsdifhost_async_t *async = dev->async;
+
+    memset(stats, 0U, sizeof(*stats));
+    if (NULL == async)
+    {
+        return;
+    }
+
+    InterruptMask(dev->hc.config.irq_num);
+    *stats = async->stats;
+    if (reset)
+    {
+        memset(&async->stats, 0U, sizeof(async->stats));
+    }
+    InterruptUmask(dev->hc.config.irq_num);
+}
+
 static void FSDIFHOST_SetupIrq(FSdif *ctrl_p)
 {
     u32 cpu_id = 0;
@@ -738,6 +1694,13 @@ static void FSDIFHOST_CmdDone(FSdif *const instance_p, void *args, u32 status, u
 {
     fsdifhost_dev_t *dev = (fsdifhost_dev_t *)args;
     SDMMC_LOGD(TAG, "CMD done !!!");
+
+    if (FSDIFHOST_AsyncBusy(dev))
+    {
+        FSDIFHOST_AsyncCmdDone(dev, dev->async->active);
+        return;
+    }
+
     (void)SDMMC_OSAEventSet(&dev->hc_evt, SDMMC_OSA_EVENT_TRANSFER_CMD_SUCCESS);
 }
 
@@ -746,6 +1709,12 @@ static void FSDIFHOST_DataDone(FSdif *const instance_p, void *args, u32 status,
     fsdifhost_dev_t *dev = (fsdifhost_dev_t *)args;
     SDMMC_LOGD(TAG, "Data done !!!");
 
+    if (FSDIFHOST_AsyncBusy(dev))
+    {
+        FSDIFHOST_AsyncDataDone(dev, dev->async->active, status);
+        return;
+    }
+
     uint32_t check_status = status & (FSDIF_INT_DTO_BIT | FSDIF_INT_RCRC_BIT |
                                         FSDIF_INT_DCRC_BIT | FSDIF_INT_RE_BIT |
                                         FSDIF_INT_DRTO_BIT | FSDIF_INT_EBE_BIT |
@@ -762,7 +1731,7 @@ static void FSDIFHOST_DataDone(FSdif *const instance_p, void *args, u32 status,
         {
             (void)SDMMC_OSAEventSet(&dev->hc_evt, SDMMC_OSA_EVENT_TRANSFER_DATA_SUCCESS);
         } 
-        else 
+        else if (!dev->tuning)
         {
             SDMMC_LOGE(TAG, "Xfer data error, status: 0x%x, dmac status: 0x%x", 
                        check_status, check_dmac);
@@ -773,30 +1742,51 @@ static void FSDIFHOST_DataDone(FSdif *const instance_p, void *args, u32 status,
 static void FSDIFHOST_ErrorOccur(FSdif *const instance_p, void *args, u32 status, u32 dmac_status)
 {
     fsdifhost_dev_t *dev = (fsdifhost_dev_t *)args;
-    SDMMC_LOGE(TAG, "Error occur !!!");
-    SDMMC_LOGE(TAG, "Status: 0x%x, dmac status: 0x%x.", status, dmac_status);
 
-    if (status & FSDIF_INT_RE_BIT)
-        SDMMC_LOGE(TAG, "Response err. 0x%x", FSDIF_INT_RE_BIT);
+    /* errors are expected at the phases out of the passing window when tuning */
+    if (!dev->tuning)
+    {
+        SDMMC_LOGE(TAG, "Error occur !!!");
+        SDMMC_LOGE(TAG, "Status: 0x%x, dmac status: 0x%x.", status, dmac_status);
+
+        if (status & FSDIF_INT_RE_BIT)
+            SDMMC_LOGE(TAG, "Response err. 0x%x", FSDIF_INT_RE_BIT);
 
-    if (status & FSDIF_INT_RTO_BIT)
-        SDMMC_LOGE(TAG, "Response timeout. 0x%x", FSDIF_INT_RTO_BIT);
+        if (status & FSDIF_INT_RTO_BIT)
+            SDMMC_LOGE(TAG, "Response timeout. 0x%x", FSDIF_INT_RTO_BIT);
 
-    if (dmac_status & FSDIF_DMAC_STATUS_DU)
-        SDMMC_LOGE(TAG, "Descriptor un-readable. 0x%x", FSDIF_DMAC_STATUS_DU);
+        if (dmac_status & FSDIF_DMAC_STATUS_DU)
+            SDMMC_LOGE(TAG, "Descriptor un-readable. 0x%x", FSDIF_DMAC_STATUS_DU);
 
-    if (status & FSDIF_INT_DCRC_BIT)
-        SDMMC_LOGE(TAG, "Data CRC error. 0x%x", FSDIF_INT_DCRC_BIT);
+        if (status & FSDIF_INT_DCRC_BIT)
+            SDMMC_LOGE(TAG, "Data CRC error. 0x%x", FSDIF_INT_DCRC_BIT);
 
-    if (status & FSDIF_INT_RCRC_BIT)
-        SDMMC_LOGE(TAG, "Data CRC error. 0x%x", FSDIF_INT_RCRC_BIT);
+        if (status & FSDIF_INT_RCRC_BIT)
+            SDMMC_LOGE(TAG, "Data CRC error. 0x%x", FSDIF_INT_RCRC_BIT);
 
-    FSdifDumpRegister(instance_p->config.base_addr);
+        if (status & FSDIF_INT_DRTO_BIT)
+            SDMMC_LOGE(TAG, "Data read timeout. 0x%x", FSDIF_INT_DRTO_BIT);
+
+        FSdifDumpRegister(instance_p->config.base_addr);
+    }
+
+    /* the failed asynchronous transfer is recovered in task */
+    if (FSDIFHOST_AsyncBusy(dev))
+    {
+        if ((FSDIFHOST_ASYNC_STAGE_SBC == dev->async->active->stage) ||
+            (FSDIFHOST_ASYNC_STAGE_DATA == dev->async->active->stage) ||
+            (FSDIFHOST_ASYNC_STAGE_STOP == dev->async->active->stage))
+        {
+            FSDIFHOST_AsyncFail(dev, dev->async->active, kStatus_SDMMC_TransferFailed);
+        }
+        return;
+    }
 
     if ((status & FSDIF_INT_RE_BIT) || (status & FSDIF_INT_RTO_BIT))
         (void)SDMMC_OSAEventSet(&dev->hc_evt, SDMMC_OSA_EVENT_TRANSFER_CMD_FAIL);
 
-    if ((dmac_status & FSDIF_DMAC_STATUS_DU) || (status & FSDIF_INT_DCRC_BIT) || (status & FSDIF_INT_RCRC_BIT))
+    if ((dmac_status & FSDIF_DMAC_STATUS_DU) || (status & FSDIF_INT_DCRC_BIT) || (status & FSDIF_INT_RCRC_BIT) ||
+        (status & FSDIF_INT_DRTO_BIT) || (status & FSDIF_INT_SBE_BCI_BIT) || (status & FSDIF_INT_EBE_BIT))
         (void)SDMMC_OSAEventSet(&dev->hc_evt, SDMMC_OSA_EVENT_TRANSFER_DATA_FAIL);
 }
 
@@ -899,6 +1889,11 @@ static void FSDIFHOST_Deinit(sdmmchost_t *host)
     fsdifhost_dev_t *dev = (fsdifhost_dev_t *)host->dev;
 
     FSDIFHOST_RevokeIrq(&dev->hc);
+    if (dev->async)
+    {
+        FSDIFHOST_AsyncFree(dev->async);
+        dev->async = NULL;
+    }
     FSdifDeInitialize(&dev->hc);
     SDMMC_OSAEventDestroy(&dev->hc_evt);
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 Phytium Information Technology, Inc.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FSL_HC_FSDIF_H
+#define _FSL_HC_FSDIF_H
+
+#include "fsl_sdmmc_host.h"
+
+/*!
+ * @addtogroup sdmmchost_fsdif
+ * @ingroup sdmmchost
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief requests on the bus at the same time, one in flight and one prepared */
+#define FSDIFHOST_ASYNC_SLOT_NUM   2U
+/*! @brief max requests packed in one eMMC packed command */
+#define FSDIFHOST_ASYNC_MAX_PACKED 8U
+
+typedef struct _fsdifhost_async_req fsdifhost_async_req_t;
+
+/*! @brief request done call-back, status is kStatus_Success or the error of transfer */
+typedef void (*fsdifhost_async_callback_t)(fsdifhost_async_req_t *req, status_t status);
+
+/*!@brief asynchronous read/write request of card blocks */
+struct _fsdifhost_async_req
+{
+    bool write;                          /*!< write buffer to card, otherwise read card to buffer */
+    uint32_t block;                      /*!< first block to transfer */
+    uint32_t blockCount;                 /*!< num of blocks, no more than host maxBlockCount */
+    uint8_t *buffer;                     /*!< data buffer, 4 bytes aligned */
+    fsdifhost_async_callback_t callback; /*!< called in interrupt or in FSDIFHOST_AsyncPoll */
+    void *userData;                      /*!< for the owner of request */
+
+    /* private, used by the host */
+    fsdifhost_async_req_t *next;
+    bool noPack;                         /*!< retry without packed command */
+};
+
+/*!@brief asynchronous transfer configuration */
+typedef struct _fsdifhost_async_config
+{
+    uint32_t blockSize;       /*!< card block size */
+    bool byteAddress;         /*!< standard capacity card, command argument in bytes */
+    bool setBlockCount;       /*!< card supports CMD23, otherwise multi-block transfer is stopped by CMD12 */
+    uint32_t maxPackedWrites; /*!< max requests in packed write, 0 or 1 to disable */
+    uint32_t maxPackedReads;  /*!< max requests in packed read, 0 or 1 to disable */
+    /*! called in interrupt when the queue needs FSDIFHOST_AsyncPoll in task context,
+        to wait the card not busy or to recover from error */
+    void (*kick)(void *param);
+    void *kickParam;
+} fsdifhost_async_config_t;
+
+/*!@brief asynchronous transfer statistics */
+typedef struct _fsdifhost_async_stats
+{
+    uint32_t requests;       /*!< requests done */
+    uint32_t transfers;      /*!< read/write commands issued, a packed read takes two */
+    uint32_t packed;         /*!< packed commands */
+    uint32_t packedRequests; /*!< requests carried by packed commands */
+    uint32_t busyWaits;      /*!< commands started after waiting card busy in task */
+    uint32_t errors;         /*!< failed transfers */
+    uint32_t retries;        /*!< packed requests retried one by one */
+} fsdifhost_async_stats_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*!
+ * @brief enable asynchronous transfer of host, works in DMA and interrupt mode.
+ * the card shall be initialized and in transfer state, synchronous transfers of
+ * host are refused while any asynchronous request is on the bus.
+ * @param host host handler
+ * @param config asynchronous transfer configuration
+ * @retval kStatus_Success or kStatus_OutOfRange if no memory
+ */
+status_t FSDIFHOST_AsyncEnable(sdmmchost_t *host, const fsdifhost_async_config_t *config);
+
+/*!
+ * @brief disable asynchronous transfer of host.
+ * @param host host handler
+ * @retval kStatus_Busy if any request is not done yet
+ */
+status_t FSDIFHOST_AsyncDisable(sdmmchost_t *host);
+
+/*!
+ * @brief queue a read/write request, which starts at once if the bus is free.
+ * the descriptors of next request are prepared while the current one is in flight,
+ * queued requests of same direction are packed on eMMC if enabled.
+ * @param host host handler
+ * @param req request, owned by host until the call-back
+ * @retval kStatus_Success or kStatus_InvalidArgument
+ */
+status_t FSDIFHOST_AsyncSubmit(sdmmchost_t *host, fsdifhost_async_req_t *req);
+
+/*!
+ * @brief poll asynchronous transfer in task context, start the request waiting for
+ * card not busy, recover the failed transfer, and time out the transfer without
+ * progress since the last poll.
+ * @param host host handler
+ */
+void FSDIFHOST_AsyncPoll(sdmmchost_t *host);
+
+/*!
+ * @brief check if asynchronous requests are all done.
+ * @param host host handler
+ * @retval true if no request is queued or on the bus
+ */
+bool FSDIFHOST_AsyncIdle(sdmmchost_t *host);
+
+/*!
+ * @brief get statistics of asynchronous transfer.
+ * @param host host handler
+ * @param stats buffer of statistics
+ * @param reset clear statistics after copy
+ */
+void FSDIFHOST_AsyncGetStats(sdmmchost_t *host, fsdifhost_async_stats_t *stats, bool reset);
+
+#if defined(__cplusplus)
+}
+#endif
+/*! @} */
+#endif /* _FSL_HC_FSDIF_H */
@@ -6,6 +6,10 @@ ifdef CONFIG_USE_BAREMETAL
 BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fsl_sdmmc/osa
 endif
 
+ifdef CONFIG_FSL_SDMMC_USE_FSDIF
+BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fsl_sdmmc/host/fsdif
+endif
+
 ifdef CONFIG_FSL_SDMMC_ENABLE_SD
 BUILD_INC_PATH_DIR += $(SDK_DIR)/third-party/fsl_sdmmc/sd
 endif
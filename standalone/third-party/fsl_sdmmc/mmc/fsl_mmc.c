@@ -270,6 +270,16 @@ static status_t MMC_SwitchToHS400(mmc_card_t *card);
  */
 static status_t MMC_SwitchToHS200(mmc_card_t *card, uint32_t freq);
 
+/*!
+ * @brief get back to legacy timing and an SDR bus after switch to a high speed timing failed.
+ *
+ * @param card Card descriptor.
+ * @retval kStatus_SDMMC_ConfigureExtendedCsdFailed Configure extended CSD failed.
+ * @retval kStatus_SDMMC_SetDataBusWidthFailed switch bus width fail.
+ * @retval kStatus_Success Operate successfully.
+ */
+static status_t MMC_ResetBusTiming(mmc_card_t *card);
+
 /*!
  * @brief switch to HS400 mode.
  *
@@ -1009,6 +1019,8 @@ static void MMC_DecodeExtendedCsd(mmc_card_t *card, uint32_t *rawExtendedCsd)
                              (((uint32_t)buffer[250U]) << 8) | (((uint32_t)buffer[249U]));
 
     extendedCsd->genericCMD6Timeout  = buffer[248U] * 10UL;
+    extendedCsd->maxPackedWriteCmd   = buffer[500U];
+    extendedCsd->maxPackedReadCmd    = buffer[501U];
     extendedCsd->supportedCommandSet = buffer[504U];
 }
 
@@ -1686,6 +1698,49 @@ static status_t MMC_SwitchToHS400(mmc_card_t *card)
     return kStatus_Success;
 }
 
+static status_t MMC_ResetBusTiming(mmc_card_t *card)
+{
+    assert(card != NULL);
+
+    /* host side HS400/DDR may be enabled by the failed switch */
+    SDMMCHOST_EnableHS400Mode(card->host, false);
+    SDMMCHOST_EnableDDRMode(card->host, false, 0U);
+    card->busTiming   = kMMC_HighSpeedTimingNone;
+    card->busClock_Hz = SDMMCHOST_SetCardClock(card->host, MMC_CLOCK_26MHZ);
+    if (card->usrParam.ioStrength != NULL)
+    {
+        card->usrParam.ioStrength(MMC_CLOCK_26MHZ);
+    }
+
+    if (kStatus_Success != MMC_SwitchHSTiming(card, (uint8_t)kMMC_HighSpeedTimingNone, kMMC_DriverStrength0))
+    {
+        return kStatus_SDMMC_ConfigureExtendedCsdFailed;
+    }
+
+    /* the failed HS400 switch leaves BUS_WIDTH at DDR, HS200 tuning needs an SDR bus */
+    if ((card->extendedCsd.dataBusWidth == (uint8_t)kMMC_DataBusWidth8bitDDR) ||
+        (card->extendedCsd.dataBusWidth == (uint8_t)kMMC_DataBusWidth8bitDDRSTROBE))
+    {
+        SDMMCHOST_SetCardBusWidth(card->host, kSDMMC_BusWdith8Bit);
+        if (kStatus_Success != MMC_SetDataBusWidth(card, kMMC_DataBusWidth8bit))
+        {
+            return kStatus_SDMMC_SetDataBusWidthFailed;
+        }
+        card->busWidth = kMMC_DataBusWidth8bit;
+    }
+    else if (card->extendedCsd.dataBusWidth == (uint8_t)kMMC_DataBusWidth4bitDDR)
+    {
+        SDMMCHOST_SetCardBusWidth(card->host, kSDMMC_BusWdith4Bit);
+        if (kStatus_Success != MMC_SetDataBusWidth(card, kMMC_DataBusWidth4bit))
+        {
+            return kStatus_SDMMC_SetDataBusWidthFailed;
+        }
+        card->busWidth = kMMC_DataBusWidth4bit;
+    }
+
+    return kStatus_Success;
+}
+
 static status_t MMC_SelectBusTiming(mmc_card_t *card)
 {
     assert(card != NULL);
@@ -1720,11 +1775,17 @@ static status_t MMC_SelectBusTiming(mmc_card_t *card)
             {
                 /* switch to HS400 */
                 SDMMC_LOGD(TAG, "Set HS400 timing");
-                if (kStatus_Success != MMC_SwitchToHS400(card))
+                if (kStatus_Success == MMC_SwitchToHS400(card))
+                {
+                    break;
+                }
+
+                /* fall back to HS200 */
+                SDMMC_LOGW(TAG, "Switch to HS400 failed, try HS200 timing");
+                if (kStatus_Success != MMC_ResetBusTiming(card))
                 {
                     return kStatus_SDMMC_SwitchBusTimingFailed;
                 }
-                break;
             }
 
             card->busTiming = kMMC_HighSpeed200Timing;
@@ -1739,12 +1800,18 @@ static status_t MMC_SelectBusTiming(mmc_card_t *card)
                         ((uint32_t)kMMC_SupportHS200200MHZ180VFlag | (uint32_t)kMMC_SupportHS200200MHZ120VFlag))))
             {
                 SDMMC_LOGD(TAG, "Set HS200 timing");
-                if (kStatus_Success !=
+                if (kStatus_Success ==
                     MMC_SwitchToHS200(card, FSL_SDMMC_CARD_MAX_BUS_FREQ(card->usrParam.maxFreq, MMC_CLOCK_HS200)))
+                {
+                    break;
+                }
+
+                /* fall back to high speed */
+                SDMMC_LOGW(TAG, "Switch to HS200 failed, try high speed timing");
+                if (kStatus_Success != MMC_ResetBusTiming(card))
                 {
                     return kStatus_SDMMC_SwitchBusTimingFailed;
                 }
-                break;
             }
 
             card->busTiming = kMMC_HighSpeedTiming;
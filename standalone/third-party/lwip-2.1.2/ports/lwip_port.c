@@ -25,6 +25,7 @@
  *  1.0    huanghe     2022/10/20            first release
  *  1.1   liuzhihong   2022/11/7     function and variable naming adjustment  
  *  1.2   huangjin     2025/01/06            add e1000e
+ *  1.3    phytium     2026/10/19     no rx thread when the driver workqueue delivers the frames
  */
 
 #include <string.h>
@@ -218,7 +219,9 @@ struct netif *LwipPortAdd(struct netif *netif, ip_addr_t *ipaddr, ip_addr_t *net
 #if !NO_SYS
 
     char detect_thread_name[LWIP_MAX_NAME_LENGTH] = {0}; /* detect thread name ,name + netif name */
+#if defined(CONFIG_LWIP_PORT_USE_RECEIVE_THREAD) && !defined(CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE)
     char rx_thread_name[LWIP_MAX_NAME_LENGTH] = {0}; /* detect thread name ,name + netif name */
+#endif
 
     /* Start thread to detect link periodically for Hot Plug autodetect */
     if (netif_p)
@@ -239,12 +242,17 @@ struct netif *LwipPortAdd(struct netif *netif, ip_addr_t *ipaddr, ip_addr_t *net
         sys_countingsem_create(&lwip_port->sem_rx_data_available, SEMAPHORE_MAXCOUNT,
                                SEMAPHORE_INITIALCOUNT);
 
+#if defined(CONFIG_FREERTOS_DRIVERS_USE_WORKQUEUE)
+        /* the mac drivers move the received frames into lwip from the workqueue */
+        lwip_port->rx_thread_handle = NULL;
+#else
         memcpy(rx_thread_name, netif->name, 2);
         strcpy(&rx_thread_name[2], LWIP_RX_THREAD_NAME);
 
         lwip_port->rx_thread_handle = sys_thread_new(rx_thread_name, (lwip_thread_fn)LwipPortInputThread,
                                                      netif, CONFIG_LWIP_PORT_RECEIVE_THREAD_STACKSIZE,
                                                      CONFIG_LWIP_PORT_RECEIVE_THREAD_PRIORITY);
+#endif
 #endif
 
         if (lwip_port->ops.eth_start)
@@ -436,7 +444,10 @@ void LwipPortStop(struct netif *netif, u32 dhcp_en)
     }
 #if !NO_SYS
     /* delete rx thread */
-    sys_thread_delete(emac->rx_thread_handle);
+    if (emac->rx_thread_handle)
+    {
+        sys_thread_delete(emac->rx_thread_handle);
+    }
     /* delete detect thread */
     sys_thread_delete(emac->detect_thread_handle);
     sys_sem_free(&emac->sem_rx_data_available);
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+#
+# Licensed under the BSD 3-Clause License (the "License"); you may not use
+# this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://opensource.org/licenses/BSD-3-Clause
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# FilePath: freertos_trace_json.py
+# Date: 2026-10-19 10:00:00
+# LastEditTime: 2026-10-19 10:00:00
+# Description:  This file is for converting FreeRTOS kernel trace events to Chrome trace JSON
+#
+# Modify History:
+#  Ver   Who        Date         Changes
+# ----- ------     --------    --------------------------------------
+# 1.0   phytium    2026/10/19   first release
+#
+# usage:
+#   build with CONFIG_FREERTOS_USE_KERNEL_TRACE, dump the trace memory like for ftrace_decode.py
+#       freertos_trace_json.py trace.bin --elf freertos.elf -o trace.json
+#   open trace.json in https://ui.perfetto.dev or chrome://tracing
+#   each core is a process, each task a thread, interrupts run on their own "irq" thread
+
+import argparse
+import json
+import struct
+import sys
+
+from ftrace_decode import EVENT_PRINTF, format_record, iter_rings, load_elfs
+
+EVENT_KERNEL = 0x80
+TASK_SWITCH = EVENT_KERNEL + 0
+TASK_CREATE = EVENT_KERNEL + 1
+TASK_DELETE = EVENT_KERNEL + 2
+TASK_READY = EVENT_KERNEL + 3
+TASK_DELAY = EVENT_KERNEL + 4
+TASK_SUSPEND = EVENT_KERNEL + 5
+PRIORITY_INHERIT = EVENT_KERNEL + 6
+PRIORITY_DISINHERIT = EVENT_KERNEL + 7
+QUEUE_CREATE = EVENT_KERNEL + 8
+QUEUE_REGISTRY = EVENT_KERNEL + 9
+QUEUE_SEND = EVENT_KERNEL + 10
+QUEUE_RECEIVE = EVENT_KERNEL + 11
+QUEUE_FAILED = EVENT_KERNEL + 12
+BLOCK_QUEUE_SEND = EVENT_KERNEL + 13
+BLOCK_QUEUE_RECEIVE = EVENT_KERNEL + 14
+BLOCK_NOTIFY = EVENT_KERNEL + 15
+BLOCK_EVENT_GROUP = EVENT_KERNEL + 16
+ISR_ENTER = EVENT_KERNEL + 17
+ISR_EXIT = EVENT_KERNEL + 18
+
+IRQ_TID = 0
+
+
+class CoreTimeline:
+    """turn the records of one core into trace events"""
+
+    def __init__(self, ring, elf, out):
+        self.pid = ring["core_id"]
+        self.freq = ring["timer_freq"] or 1
+        self.elf = elf
+        self.out = out
+        self.tasks = {}
+        self.queues = {}
+        self.current = None
+        self.irq_depth = 0
+        out.append({"ph": "M", "name": "process_name", "pid": self.pid,
+                    "args": {"name": "core %u" % self.pid}})
+        out.append({"ph": "M", "name": "thread_name", "pid": self.pid, "tid": IRQ_TID,
+                    "args": {"name": "irq"}})
+
+    def us(self, timestamp):
+        return timestamp * 1000000.0 / self.freq
+
+    def task_name(self, tcb):
+        return self.tasks.get(tcb, "task 0x%x" % tcb)
+
+    def queue_name(self, queue):
+        return self.queues.get(queue, "0x%x" % queue)
+
+    def name_task(self, tcb, name):
+        self.tasks[tcb] = name
+        self.out.append({"ph": "M", "name": "thread_name", "pid": self.pid, "tid": tcb,
+                         "args": {"name": name}})
+
+    def instant(self, ts, tid, name, args=None):
+        event = {"ph": "i", "s": "t", "name": name, "pid": self.pid, "tid": tid, "ts": self.us(ts)}
+        if args:
+            event["args"] = args
+        self.out.append(event)
+
+    def slice_begin(self, ts, tid, name, args=None):
+        event = {"ph": "B", "name": name, "pid": self.pid, "tid": tid, "ts": self.us(ts)}
+        if args:
+            event["args"] = args
+        self.out.append(event)
+
+    def slice_end(self, ts, tid):
+        self.out.append({"ph": "E", "pid": self.pid, "tid": tid, "ts": self.us(ts)})
+
+    def record(self, ts, event_id, level, fmt_addr, args):
+        args = list(args) + [0] * (5 - len(args))
+        # events of interrupt handlers belong to the irq thread
+        running = self.current if (self.current is not None and not self.irq_depth) else IRQ_TID
+
+        if event_id == TASK_SWITCH:
+            nxt, prio = args[1], args[2]
+            if self.current is not None:
+                self.slice_end(ts, self.current)
+            if nxt not in self.tasks:
+                self.name_task(nxt, self.task_name(nxt))
+            self.slice_begin(ts, nxt, self.task_name(nxt), {"priority": prio})
+            self.current = nxt
+        elif event_id == TASK_CREATE:
+            name = struct.pack("<3Q", *args[2:5]).split(b"\0", 1)[0].decode("utf-8", "replace")
+            self.name_task(args[0], name or "task 0x%x" % args[0])
+            self.instant(ts, running, "create " + self.task_name(args[0]), {"priority": args[1]})
+        elif event_id == TASK_DELETE:
+            self.instant(ts, args[0], "delete")
+        elif event_id == TASK_READY:
+            self.instant(ts, args[0], "ready")
+        elif event_id == TASK_DELAY:
+            self.instant(ts, running, "delay until" if args[1] else "delay", {"ticks": args[0]})
+        elif event_id == TASK_SUSPEND:
+            self.instant(ts, args[0], "suspend")
+        elif event_id in (PRIORITY_INHERIT, PRIORITY_DISINHERIT):
+            name = "inherit priority" if event_id == PRIORITY_INHERIT else "disinherit priority"
+            self.instant(ts, args[0], name, {"priority": args[1], "by": self.task_name(running)})
+            self.out.append({"ph": "C", "name": "priority " + self.task_name(args[0]), "pid": self.pid,
+                             "ts": self.us(ts), "args": {"priority": args[1]}})
+        elif event_id == QUEUE_CREATE:
+            self.instant(ts, running, "queue create", {"queue": "0x%x" % args[0], "length": args[1]})
+        elif event_id == QUEUE_REGISTRY:
+            name = self.elf.string(args[1]) if self.elf else None
+            if name:
+                self.queues[args[0]] = name
+        elif event_id in (QUEUE_SEND, QUEUE_RECEIVE):
+            name = "send" if event_id == QUEUE_SEND else "receive"
+            self.instant(ts, running, "%s %s" % (name, self.queue_name(args[0])), {"waiting": args[1]})
+            self.out.append({"ph": "C", "name": "queue " + self.queue_name(args[0]), "pid": self.pid,
+                             "ts": self.us(ts), "args": {"waiting": args[1]}})
+        elif event_id == QUEUE_FAILED:
+            name = "receive failed" if args[1] else "send failed"
+            self.instant(ts, running, "%s %s" % (name, self.queue_name(args[0])))
+        elif event_id in (BLOCK_QUEUE_SEND, BLOCK_QUEUE_RECEIVE):
+            name = "block on send" if event_id == BLOCK_QUEUE_SEND else "block on receive"
+            self.instant(ts, running, "%s %s" % (name, self.queue_name(args[0])))
+        elif event_id == BLOCK_NOTIFY:
+            self.instant(ts, running, "block on notify", {"index": args[0]})
+        elif event_id == BLOCK_EVENT_GROUP:
+            self.instant(ts, running, "block on event group 0x%x" % args[0], {"bits": "0x%x" % args[1]})
+        elif event_id == ISR_ENTER:
+            self.irq_depth += 1
+            self.slice_begin(ts, IRQ_TID, "irq %u" % args[0])
+        elif event_id == ISR_EXIT:
+            if self.irq_depth > 0:
+                self.irq_depth -= 1
+                self.slice_end(ts, IRQ_TID)
+        else:
+            # ftrace_printk and user events show up as instants of the running context
+            fmt = self.elf.string(fmt_addr) if self.elf else None
+            if fmt is None:
+                text = "fmt@0x%x" % fmt_addr
+            elif event_id == EVENT_PRINTF and args[0]:
+                text = format_record(fmt, args[1:], self.elf)
+            else:
+                text = format_record(fmt, args, self.elf)
+            self.instant(ts, running, text.strip() or "event 0x%x" % event_id)
+
+    def finish(self, ts):
+        if self.current is not None:
+            self.slice_end(ts, self.current)
+        while self.irq_depth > 0:
+            self.irq_depth -= 1
+            self.slice_end(ts, IRQ_TID)
+
+
+def main():
+    parser = argparse.ArgumentParser("freertos_trace_json - convert kernel trace rings to Chrome trace JSON")
+    parser.add_argument("dump", help="raw dump of the trace memory")
+    parser.add_argument("--elf", help="image used to resolve strings of all cores")
+    parser.add_argument("--core-elf", action="append", default=[],
+                        help="image of one core, as <core>=<path>")
+    parser.add_argument("-o", "--output", help="output file, stdout by default")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    default_elf, elfs = load_elfs(args.elf, args.core_elf)
+
+    events = []
+    try:
+        for ring, records in iter_rings(dump):
+            timeline = CoreTimeline(ring, elfs.get(ring["core_id"], default_elf), events)
+            for timestamp, event_id, level, fmt_addr, rec_args in records:
+                timeline.record(timestamp, event_id, level, fmt_addr, rec_args)
+            if records:
+                timeline.finish(records[-1][0])
+            sys.stderr.write("core %u: %u records, %u dropped, %u overwritten\n" %
+                             (ring["core_id"], len(records), ring["dropped"], ring["lost"]))
+    except ValueError as e:
+        sys.exit("%s: %s" % (args.dump, e))
+
+    trace = {"traceEvents": events, "displayTimeUnit": "ns"}
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+#
+# Licensed under the BSD 3-Clause License (the "License"); you may not use
+# this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://opensource.org/licenses/BSD-3-Clause
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# FilePath: ftrace_decode.py
+# Date: 2026-10-19 10:00:00
+# LastEditTime: 2026-10-19 10:00:00
+# Description:  This file is for decoding the binary trace rings of ftrace_printk
+#
+# Modify History:
+#  Ver   Who        Date         Changes
+# ----- ------     --------    --------------------------------------
+# 1.0   phytium    2026/10/19   first release
+#
+# usage:
+#   dump the trace memory (CONFIG_TRACE_RING_BASE, CONFIG_TRACE_RING_SIZE), e.g. in gdb
+#       dump binary memory trace.bin 0xC8000000 0xC8100000
+#   then decode it with the image of each core
+#       ftrace_decode.py trace.bin --elf freertos.elf
+#       ftrace_decode.py trace.bin --core-elf 0=core0.elf --core-elf 1=core1.elf
+
+import argparse
+import re
+import struct
+import sys
+
+RING_MAGIC = 0x42525446
+RING_HEADER_SIZE = 128
+RING_FLAG_OVERWRITE = 0x1
+
+EVENT_PRINTK = 0
+EVENT_PRINTF = 1
+
+LEVELS = ["DEBUG", "INFO", "WARN", "ERROR", "CRITICAL"]
+
+# magic, version, record_size, region_size, capacity, flags, core_id, timer_freq, head, dropped
+HEADER_FMT = "<IHHIIIIQII"
+# timestamp, event_id, nargs, level, seq, fmt, args[5]
+RECORD_FMT = "<QHBBIQ5Q"
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaA%])")
+
+
+class ElfImage:
+    """load segments of an elf image, to read the strings the records point to"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an elf file" % path)
+        self.segments = []
+        is64 = self.data[4] == 2
+        if is64:
+            phoff, = struct.unpack_from("<Q", self.data, 0x20)
+            phentsize, phnum = struct.unpack_from("<HH", self.data, 0x36)
+        else:
+            phoff, = struct.unpack_from("<I", self.data, 0x1C)
+            phentsize, phnum = struct.unpack_from("<HH", self.data, 0x2A)
+        for i in range(phnum):
+            off = phoff + i * phentsize
+            if is64:
+                p_type, _, p_offset, p_vaddr, _, p_filesz = struct.unpack_from("<IIQQQQ", self.data, off)
+            else:
+                p_type, p_offset, p_vaddr, _, p_filesz = struct.unpack_from("<IIIII", self.data, off)
+            if p_type == 1:  # PT_LOAD
+                self.segments.append((p_vaddr, p_offset, p_filesz))
+
+    def string(self, addr):
+        for vaddr, offset, size in self.segments:
+            if vaddr <= addr < vaddr + size:
+                start = offset + addr - vaddr
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("utf-8", "replace")
+        return None
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def format_record(fmt, args, elf):
+    """apply the C format string to the raw 64 bit arguments"""
+    out = []
+    pos = 0
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(to_signed(next_arg(), 32))
+        if prec == "*":
+            prec = str(to_signed(next_arg(), 32))
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        value = next_arg()
+        bits = 64 if length in ("l", "ll", "j", "z", "t") else 32
+        if conv in "di":
+            out.append((spec + "d") % to_signed(value, bits))
+        elif conv in "uoxX":
+            out.append((spec + conv.replace("u", "d")) % (value & ((1 << bits) - 1)))
+        elif conv == "c":
+            out.append((spec + "c") % chr(value & 0xFF))
+        elif conv == "p":
+            out.append((spec + "s") % ("0x%x" % value))
+        elif conv == "s":
+            text = elf.string(value) if elf else None
+            out.append((spec + "s") % (text if text is not None else "<0x%x>" % value))
+        else:
+            out.append((spec + conv) % struct.unpack("<d", struct.pack("<Q", value))[0])
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def read_ring(dump, offset):
+    """parse the ring at offset, returns its header and the records still in it"""
+    fields = struct.unpack_from(HEADER_FMT, dump, offset)
+    ring = dict(zip(("magic", "version", "record_size", "region_size", "capacity",
+                     "flags", "core_id", "timer_freq", "head", "dropped"), fields))
+    ring["tail"], = struct.unpack_from("<I", dump, offset + 64)
+    head, tail, capacity = ring["head"], ring["tail"], ring["capacity"]
+
+    first = (head - capacity) & 0xFFFFFFFF if (head - tail) & 0xFFFFFFFF > capacity else tail
+    ring["lost"] = (head - tail - capacity) & 0xFFFFFFFF if first != tail else 0
+
+    records = []
+    idx = first
+    while idx != head:
+        slot = idx & (capacity - 1)
+        rec = struct.unpack_from(RECORD_FMT, dump, offset + RING_HEADER_SIZE + slot * ring["record_size"])
+        timestamp, event_id, nargs, level, seq, fmt_addr = rec[:6]
+        if seq == idx:
+            records.append((timestamp, event_id, level, fmt_addr, rec[6:6 + nargs]))
+        idx = (idx + 1) & 0xFFFFFFFF
+    return ring, records
+
+
+def iter_rings(dump):
+    """yield the header and records of every core in a dump of the trace memory"""
+    offset = 0
+    region_size = 0
+    while offset + RING_HEADER_SIZE <= len(dump):
+        magic, = struct.unpack_from("<I", dump, offset)
+        if magic == RING_MAGIC:
+            ring, records = read_ring(dump, offset)
+            region_size = ring["region_size"]
+            yield ring, records
+        elif region_size == 0:
+            raise ValueError("no trace ring found at offset 0x%x" % offset)
+        # a core that never traced keeps the region size of the previous one
+        offset += region_size
+
+
+def decode_ring(ring, records, elf):
+    core_id = ring["core_id"]
+    timer_freq = ring["timer_freq"]
+    print("# core %u: %u records, %u dropped, %u overwritten, %s" %
+          (core_id, len(records), ring["dropped"], ring["lost"],
+           "overwrite" if ring["flags"] & RING_FLAG_OVERWRITE else "drop"))
+
+    lines = []
+    for timestamp, event_id, level, fmt_addr, args in records:
+        fmt = elf.string(fmt_addr) if elf else None
+        if fmt is None:
+            text = "fmt@0x%x %s" % (fmt_addr, " ".join("0x%x" % a for a in args))
+        elif event_id == EVENT_PRINTF and args:
+            func = elf.string(args[0]) or "0x%x" % args[0]
+            text = "[%s]: %s" % (func, format_record(fmt, args[1:], elf))
+        else:
+            text = format_record(fmt, args, elf)
+        if event_id > EVENT_PRINTF:
+            text = "[event 0x%x] %s" % (event_id, text)
+        seconds = timestamp / timer_freq if timer_freq else 0
+        lvl = LEVELS[level] if level < len(LEVELS) else "UNKNOWN"
+        lines.append((timestamp, "[%u] [%14.6f] [%s] %s" % (core_id, seconds, lvl, text.rstrip("\r\n"))))
+
+    return lines
+
+
+def load_elfs(default_path, core_paths):
+    default_elf = ElfImage(default_path) if default_path else None
+    elfs = {}
+    for item in core_paths:
+        core, path = item.split("=", 1)
+        elfs[int(core, 0)] = ElfImage(path)
+    return default_elf, elfs
+
+
+def main():
+    parser = argparse.ArgumentParser("ftrace_decode - decode the binary trace rings of ftrace_printk")
+    parser.add_argument("dump", help="raw dump of the trace memory")
+    parser.add_argument("--elf", help="image used to resolve format strings of all cores")
+    parser.add_argument("--core-elf", action="append", default=[],
+                        help="image of one core, as <core>=<path>")
+    parser.add_argument("--merge", action="store_true", help="merge the cores sorted by timestamp")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+
+    default_elf, elfs = load_elfs(args.elf, args.core_elf)
+
+    all_lines = []
+    try:
+        for ring, records in iter_rings(dump):
+            lines = decode_ring(ring, records, elfs.get(ring["core_id"], default_elf))
+            if args.merge:
+                all_lines.extend(lines)
+            else:
+                for _, line in lines:
+                    print(line)
+    except ValueError as e:
+        sys.exit("%s: %s" % (args.dump, e))
+
+    for _, line in sorted(all_lines):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
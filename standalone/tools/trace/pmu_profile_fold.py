@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+#
+# Licensed under the BSD 3-Clause License (the "License"); you may not use
+# this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://opensource.org/licenses/BSD-3-Clause
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# FilePath: pmu_profile_fold.py
+# Date: 2026-10-19 10:00:00
+# LastEditTime: 2026-10-19 10:00:00
+# Description:  This file is for folding the samples of the PMU profiler into flamegraph stacks
+#
+# Modify History:
+#  Ver   Who        Date         Changes
+# ----- ------     --------    --------------------------------------
+# 1.0   phytium    2026/10/19   first release
+#
+# usage:
+#   build with CONFIG_FREERTOS_USE_PMU_PROFILER, for call stacks also with
+#   CONFIG_FRAME_POINTER and CONFIG_FREERTOS_PROFILER_STACK_DEPTH > 0
+#       prof start -e cycles -p 1000000
+#       ... run the workload ...
+#       prof dump
+#   save the serial log, then
+#       pmu_profile_fold.py serial.log --elf freertos.elf > prof.folded
+#       flamegraph.pl prof.folded > prof.svg
+
+import argparse
+import bisect
+import collections
+import re
+import struct
+import sys
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+LINE = re.compile(r"prof-(begin|task|sample|end)\b\s*(.*)")
+
+
+class ElfSymbols:
+    """function symbols of an elf image, sorted by address"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an elf file" % path)
+        is64 = data[4] == 2
+        if is64:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x3A)
+            sh_fmt, sym_fmt = "<IIQQQQIIQQ", "<IBBHQQ"
+        else:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+            sh_fmt, sym_fmt = "<IIIIIIIIII", "<IIIBBH"
+        sections = [struct.unpack_from(sh_fmt, data, shoff + i * shentsize) for i in range(shnum)]
+
+        symbols = {}
+        for sh in sections:
+            if sh[1] != SHT_SYMTAB:
+                continue
+            offset, size, link, entsize = sh[4], sh[5], sh[6], sh[9]
+            strtab = sections[link]
+            for off in range(offset, offset + size, entsize):
+                if is64:
+                    name, info, _, _, value, sym_size = struct.unpack_from(sym_fmt, data, off)
+                else:
+                    name, value, sym_size, info, _, _ = struct.unpack_from(sym_fmt, data, off)
+                if info & 0xF != STT_FUNC or value == 0:
+                    continue
+                start = strtab[4] + name
+                end = data.find(b"\0", start)
+                symbols[value] = (sym_size, data[start:end].decode("utf-8", "replace"))
+
+        self.addrs = sorted(symbols)
+        self.entries = [symbols[addr] for addr in self.addrs]
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        size, name = self.entries[i]
+        # assembly symbols often have no size, accept them up to the next symbol
+        if size and addr >= self.addrs[i] + size:
+            return None
+        return name
+
+
+class Profile:
+    """samples and task names read from a serial log"""
+
+    def __init__(self):
+        self.tasks = {}
+        self.samples = []
+        self.event = None
+
+    def parse(self, lines):
+        for line in lines:
+            m = LINE.search(line)
+            if not m:
+                continue
+            kind, fields = m.group(1), m.group(2).split()
+            if kind == "begin":
+                self.event = " ".join(fields)
+            elif kind == "task" and len(fields) >= 2:
+                self.tasks[int(fields[0], 16)] = fields[1]
+            elif kind == "sample" and len(fields) >= 3:
+                try:
+                    values = [int(v, 16) for v in fields]
+                except ValueError:
+                    continue  # line mangled by other output
+                self.samples.append((values[0], values[1], values[2], values[3:]))
+
+
+def fold(profile, symbols, with_task, with_lr):
+    stacks = collections.Counter()
+
+    def name(addr):
+        sym = symbols.lookup(addr) if symbols else None
+        return sym or "0x%x" % addr
+
+    for task, pc, lr, callers in profile.samples:
+        frames = [name(pc)]
+        # a leaf function, or one interrupted before its prologue, is not in the
+        # frame records yet, its caller is only in LR
+        if with_lr and lr and (not callers or callers[0] != lr - 4):
+            caller = name(lr - 4)
+            if caller != frames[0]:
+                frames.append(caller)
+        frames.extend(name(addr) for addr in callers)
+        frames.reverse()
+        if with_task:
+            frames.insert(0, profile.tasks.get(task, "task 0x%x" % task) if task else "no task")
+        stacks[";".join(frames)] += 1
+
+    return stacks
+
+
+def main():
+    parser = argparse.ArgumentParser("pmu_profile_fold - fold profiler samples for flamegraph.pl")
+    parser.add_argument("log", nargs="+", help="serial log holding the output of 'prof dump'")
+    parser.add_argument("--elf", help="image the samples were taken on")
+    parser.add_argument("--no-task", action="store_true", help="do not split the stacks by task")
+    parser.add_argument("--no-lr", action="store_true", help="do not add the caller found in LR")
+    args = parser.parse_args()
+
+    symbols = ElfSymbols(args.elf) if args.elf else None
+
+    profile = Profile()
+    for path in args.log:
+        with open(path, "r", errors="replace") as f:
+            profile.parse(f)
+
+    if not profile.samples:
+        sys.exit("no prof-sample lines found")
+
+    stacks = fold(profile, symbols, not args.no_task, not args.no_lr)
+    for stack, count in sorted(stacks.items()):
+        sys.stdout.write("%s %u\n" % (stack, count))
+    sys.stderr.write("%s: %u samples, %u stacks\n" % (profile.event or "profile",
+                                                     len(profile.samples), len(stacks)))
+
+
+if __name__ == "__main__":
+    main()
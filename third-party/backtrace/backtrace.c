@@ -144,6 +144,46 @@ static void unwind_stack(struct frame_record *fr, uintptr_t current_pc,
 	printf("ERROR: Max backtrace depth reached\n");
 }
 
+/*
+ * Collect the call sites of up to max frame records, starting from the frame
+ * record fp points to. Nothing is printed, so it can run in an interrupt
+ * handler, e.g. to unwind the context interrupted by a profiling sample.
+ *
+ * The stack grows down, so a parent frame record must sit above its child and
+ * within max_frame_size bytes of it. This stops the walk at the end of the
+ * list and at most corrupted frame pointers, but fp must point into the stack.
+ */
+unsigned int backtrace_collect(void *fp, uintptr_t *addrs, unsigned int max,
+			       size_t max_frame_size)
+{
+	struct frame_record *fr = adjust_frame_record(fp);
+	uintptr_t call_site;
+	unsigned int i;
+
+	for (i = 0U; i < max; i++)
+	{
+		if (!is_valid_frame_record(fr))
+			break;
+
+		call_site = fr->return_addr - 4U;
+		if (!is_valid_jump_address(call_site))
+			break;
+
+		addrs[i] = call_site;
+
+		if (((uintptr_t)fr->parent <= (uintptr_t)fr) ||
+		    ((uintptr_t)fr->parent - (uintptr_t)fr > max_frame_size))
+		{
+			i++;
+			break;
+		}
+
+		fr = adjust_frame_record(fr->parent);
+	}
+
+	return i;
+}
+
 /*
  * Display a backtrace. The cookie string parameter is displayed along the
  * trace to help filter the log messages.
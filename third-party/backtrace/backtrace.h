@@ -1,6 +1,12 @@
 #ifndef _BACKTRACE_H
 #define _BACKTRACE_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 void backtrace(const char *cookie);
 
+unsigned int backtrace_collect(void *fp, uintptr_t *addrs, unsigned int max,
+			       size_t max_frame_size);
+
 #endif /* _BACKTRACE_H */
\ No newline at end of file
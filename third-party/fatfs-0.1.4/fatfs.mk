@@ -21,4 +21,9 @@ ifdef CONFIG_USE_FREERTOS
 		INC_DIR += $(FATFS_OS_DIR)/port/fusb
 		SRC_DIR += $(FATFS_OS_DIR)/port/fusb
 	endif
+
+	ifdef CONFIG_FATFS_BLOCK_LAYER
+		INC_DIR += $(FATFS_OS_DIR)/port/fblock
+		SRC_DIR += $(FATFS_OS_DIR)/port/fblock
+	endif
 endif #CONFIG_USE_FREERTOS
\ No newline at end of file
@@ -177,6 +177,11 @@ QWORD ff_systimer_get_tick(void)
 	return (QWORD)xTaskGetTickCount();
 }
 
+QWORD ff_systimer_get_tick_rate(void)
+{
+	return (QWORD)configTICK_RATE_HZ;
+}
+
 void ff_systimer_tick_to_time(QWORD ticks, DWORD *sec, DWORD *msec)
 {
 	
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: diskio_block.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the fatfs diskio port on the FreeRTOS block device layer,
+ * the disk read and write of a drive go through the block device, which keeps the i/o statistics.
+ * Fatfs waits for each of them under the drive lock, so they are never merged or reordered.
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   64 bit sector numbers
+ */
+
+#include <string.h>
+#include <errno.h>
+#include "fdebug.h"
+#include "fassert.h"
+#include "diskio.h"
+#include "ffconf.h"
+#include "ff.h"
+#include "sdkconfig.h"
+
+#include "fblock_os.h"
+
+#define FF_DEBUG_TAG "DISKIO-BLOCK"
+#define FF_ERROR(format, ...)   FT_DEBUG_PRINT_E(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_INFO(format, ...)    FT_DEBUG_PRINT_I(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_DEBUG(format, ...)   FT_DEBUG_PRINT_D(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FF_WARN(format, ...)    FT_DEBUG_PRINT_W(FF_DEBUG_TAG, format, ##__VA_ARGS__)
+
+typedef struct
+{
+    const ff_diskio_driver_t *drv;  /* diskio driver under the block device, NULL for a native block device */
+    FFreeRTOSBlockDev *bdev;        /* block device of the drive, NULL before the drive is initialized */
+    FFreeRTOSBlockDev dev;          /* block device over drv */
+    char name[FFREERTOS_BLOCK_NAME_LEN];
+} ff_block_disk;
+
+static ff_block_disk block_disk[FF_VOLUMES];
+
+static const ff_diskio_driver_t block_disk_drv;
+
+/*****************************************************************************/
+
+/* backend over a diskio driver, the driver call blocks the dispatch task until the transfer ends,
+   queue depth 1 is all a wrapped drive gets */
+static int block_disk_drv_submit(FFreeRTOSBlockDev *dev, FFreeRTOSBlockIo *io)
+{
+    BYTE pdrv = (BYTE)(uintptr)dev->priv;
+    const ff_diskio_driver_t *drv = block_disk[pdrv].drv;
+    DRESULT res;
+
+    /* the sector count came from the driver as LBA_t, so the sectors fit in it */
+    switch (io->op)
+    {
+        case FFREERTOS_BLOCK_OP_READ:
+            res = drv->read(pdrv, io->buf, (LBA_t)io->sector, io->count);
+            break;
+        case FFREERTOS_BLOCK_OP_WRITE:
+            res = drv->write(pdrv, io->buf, (LBA_t)io->sector, io->count);
+            break;
+        case FFREERTOS_BLOCK_OP_FLUSH:
+            res = drv->ioctl(pdrv, CTRL_SYNC, NULL);
+            break;
+        default:
+            res = RES_PARERR;
+            break;
+    }
+
+    FFreeRTOSBlockIoDone(io, (res == RES_OK) ? 0 : -EIO);
+    return 0;
+}
+
+static const FFreeRTOSBlockOps block_disk_drv_ops =
+{
+    .submit = block_disk_drv_submit,
+    .poll = NULL
+};
+
+/*-----------------------------------------------------------------------*/
+/* Get Drive Status                                                      */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS block_disk_status(
+    BYTE pdrv       /* Physical drive nmuber to identify the drive */
+)
+{
+    ff_block_disk *disk = &block_disk[pdrv];
+
+    if (disk->drv != NULL)
+    {
+        return disk->drv->status(pdrv);
+    }
+
+    return (disk->bdev != NULL) ? 0 : STA_NOINIT;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Inidialize a Drive                                                    */
+/*-----------------------------------------------------------------------*/
+
+static DSTATUS block_disk_initialize(
+    BYTE pdrv       /* Physical drive nmuber to identify the drive */
+)
+{
+    ff_block_disk *disk = &block_disk[pdrv];
+    FFreeRTOSBlockDev *dev = &disk->dev;
+    LBA_t sector_count = 0;
+    WORD sector_size = 0;
+    DSTATUS status;
+
+    if (disk->drv == NULL)
+    {
+        return block_disk_status(pdrv);
+    }
+
+    status = disk->drv->init(pdrv);
+    if (status & STA_NOINIT)
+    {
+        return status;
+    }
+
+    if ((disk->drv->ioctl(pdrv, GET_SECTOR_COUNT, &sector_count) != RES_OK) ||
+        (disk->drv->ioctl(pdrv, GET_SECTOR_SIZE, &sector_size) != RES_OK))
+    {
+        FF_ERROR("Get size of drive-%d failed.", pdrv);
+        return STA_NOINIT;
+    }
+
+    if (disk->bdev != NULL)
+    {
+        /* initialized again, the medium may have changed */
+        dev->sector_count = sector_count;
+        dev->sector_size = sector_size;
+        return status;
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    strncpy(dev->name, disk->name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    dev->sector_size = sector_size;
+    dev->sector_count = sector_count;
+    dev->queue_depth = 1;
+    dev->max_sectors = 0;
+    dev->ops = &block_disk_drv_ops;
+    dev->priv = (void *)(uintptr)pdrv;
+
+    if (FFreeRTOSBlockRegister(dev) != 0)
+    {
+        return STA_NOINIT;
+    }
+
+    disk->bdev = dev;
+    FF_INFO("Drive-%d on block device %s, %llu sectors of %u bytes.",
+            pdrv, dev->name, (unsigned long long)dev->sector_count, dev->sector_size);
+    return status;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)                                                        */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT block_disk_read(
+    BYTE pdrv,      /* Physical drive nmuber to identify the drive */
+    BYTE *buff,     /* Data buffer to store read data */
+    LBA_t sector,   /* Start sector in LBA */
+    UINT count      /* Number of sectors to read */
+)
+{
+    ff_block_disk *disk = &block_disk[pdrv];
+
+    if (disk->bdev == NULL)
+    {
+        return RES_NOTRDY;
+    }
+
+    return (FFreeRTOSBlockRead(disk->bdev, buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT block_disk_write(
+    BYTE pdrv,          /* Physical drive nmuber to identify the drive */
+    const BYTE *buff,   /* Data to be written */
+    LBA_t sector,       /* Start sector in LBA */
+    UINT count          /* Number of sectors to write */
+)
+{
+    ff_block_disk *disk = &block_disk[pdrv];
+
+    if (disk->bdev == NULL)
+    {
+        return RES_NOTRDY;
+    }
+
+    return (FFreeRTOSBlockWrite(disk->bdev, buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+}
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+/*-----------------------------------------------------------------------*/
+
+static DRESULT block_disk_ioctl(
+    BYTE pdrv,      /* Physical drive nmuber (0..) */
+    BYTE cmd,       /* Control code */
+    void *buff      /* Buffer to send/receive control data */
+)
+{
+    ff_block_disk *disk = &block_disk[pdrv];
+
+    if (disk->bdev == NULL)
+    {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC:         /* Wait for the queued writes and flush the disk cache */
+            return (FFreeRTOSBlockFlush(disk->bdev) == 0) ? RES_OK : RES_ERROR;
+
+        case GET_SECTOR_COUNT:  /* Get number of sectors on the drive */
+#if FF_LBA64
+            *(LBA_t *)buff = disk->bdev->sector_count;
+#else
+            /* a 32 bit LBA only reaches the first 2^32 - 1 sectors */
+            *(LBA_t *)buff = (disk->bdev->sector_count > 0xFFFFFFFFULL) ?
+                             0xFFFFFFFFU : (LBA_t)disk->bdev->sector_count;
+#endif
+            return RES_OK;
+
+        case GET_SECTOR_SIZE:   /* Get size of sector for generic read/write */
+            *(WORD *)buff = (WORD)disk->bdev->sector_size;
+            return RES_OK;
+
+        default:
+            break;
+    }
+
+    if (disk->drv != NULL)
+    {
+        return disk->drv->ioctl(pdrv, cmd, buff);
+    }
+
+    if (cmd == GET_BLOCK_SIZE)
+    {
+        *(DWORD *)buff = 1;
+        return RES_OK;
+    }
+
+    return RES_PARERR;
+}
+
+static const ff_diskio_driver_t block_disk_drv =
+{
+    .init = &block_disk_initialize,
+    .status = &block_disk_status,
+    .read = &block_disk_read,
+    .write = &block_disk_write,
+    .ioctl = &block_disk_ioctl
+};
+
+int ff_diskio_block_attach(BYTE pdrv, const char *name)
+{
+    ff_block_disk *disk;
+    const ff_diskio_driver_t *drv;
+
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+
+    disk = &block_disk[pdrv];
+    drv = ff_diskio_get_driver(pdrv);
+    if (drv == NULL)
+    {
+        FF_ERROR("No driver registered as drive-%d.", pdrv);
+        return -ENODEV;
+    }
+
+    if (drv == &block_disk_drv)
+    {
+        return 0;
+    }
+
+    /* a re-registered driver replaces the old one under the same block device */
+    disk->drv = drv;
+    if (disk->bdev == NULL)
+    {
+        memset(disk->name, 0, sizeof(disk->name));
+        strncpy(disk->name, name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    }
+    ff_diskio_register(pdrv, &block_disk_drv);
+
+    FF_INFO("Drive-%d goes through block device %s.", pdrv, disk->name);
+    return 0;
+}
+
+void ff_diskio_register_block(BYTE pdrv, FFreeRTOSBlockDev *dev)
+{
+    ff_block_disk *disk;
+
+    FASSERT_MSG(pdrv < FF_VOLUMES, "pdrv = %d", pdrv);
+    FASSERT(dev);
+
+    disk = &block_disk[pdrv];
+    disk->drv = NULL;
+    disk->bdev = dev;
+    memset(disk->name, 0, sizeof(disk->name));
+    strncpy(disk->name, dev->name, FFREERTOS_BLOCK_NAME_LEN - 1);
+    ff_diskio_register(pdrv, &block_disk_drv);
+
+    FF_INFO("Create block device %s as driver-%d.", dev->name, pdrv);
+}
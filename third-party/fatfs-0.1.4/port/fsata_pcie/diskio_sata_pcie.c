@@ -26,15 +26,19 @@
 #define FSATA_INFO(format, ...)    FT_DEBUG_PRINT_I(FSATA_DEBUG_TAG, format, ##__VA_ARGS__)
 #define FSATA_DEBUG(format, ...)   FT_DEBUG_PRINT_D(FSATA_DEBUG_TAG, format, ##__VA_ARGS__)
 
-/* 64位需要预留给内存池更大的空间 */
-static u8 mem[50000] __attribute__((aligned(1024))) = {0};
-
 #define PCI_CLASS_STORAGE_SATA_AHCI 0x010601
 
 #define SATA_HOST_MAX_NUM   PLAT_AHCI_HOST_MAX_COUNT
 
 #define ADDR_ALIGNMENT 1024
 
+/* each started port takes one command table per slot, see FSATA_AHCI_PORT_PRIV_DMA_SZ */
+#define SATA_PORT_MEM_SIZE PALIGN_UP(FSATA_AHCI_PORT_PRIV_DMA_SZ, ADDR_ALIGNMENT)
+#define SATA_PORT_MEM_MAX_COUNT 4
+
+/* 64位需要预留给内存池更大的空间 */
+static u8 mem[SATA_PORT_MEM_SIZE * SATA_PORT_MEM_MAX_COUNT] __attribute__((aligned(1024))) = {0};
+
 static FSataCtrl sata_device[SATA_HOST_MAX_NUM];//最多支持16个ahci控制器，可以自行定义个数
 static s32 sata_host_count = 0;
 
@@ -228,9 +232,15 @@ static int FSataInit(void)
                 continue;
             }
 
+            if (port_mem_count >= SATA_PORT_MEM_MAX_COUNT)
+            {
+                FSATA_ERROR("No dma memory left for port %d.", port);
+                break;
+            }
+
             /* command list address must be 1K-byte aligned */
             ret = FSataAhciPortStart(instance_p, port,
-                                     (uintptr)mem + PALIGN_UP(FSATA_AHCI_PORT_PRIV_DMA_SZ, ADDR_ALIGNMENT) * port_mem_count);
+                                     (uintptr)mem + SATA_PORT_MEM_SIZE * port_mem_count);
 
             port_mem_count++;
             if (FSATA_SUCCESS != ret)
@@ -246,7 +256,12 @@ static int FSataInit(void)
                 FSATA_ERROR("FSataAhciReadInfo failed, ret: 0x%x.", status);
                 continue;
             }
+        }
 
+        /* issued commands complete in the intx handler, polling still works without it */
+        if (instance_p->is_ready == FT_COMPONENT_IS_READY)
+        {
+            FSataIrqEnable(instance_p, FSATA_PORT_IRQ_D2H_REG_FIS | FSATA_PORT_IRQ_SDB_FIS | FSATA_PORT_IRQ_ERROR);
         }
     }
 
@@ -322,7 +337,7 @@ DSTATUS sata_pcie_disk_initialize(
 DRESULT sata_pcie_disk_read(
     BYTE pdrv,      /* Physical drive nmuber to identify the drive */
     BYTE *buff,     /* Data buffer to store read data */
-    DWORD sector,   /* Start sector in LBA */
+    LBA_t sector,   /* Start sector in LBA */
     UINT count      /* Number of sectors to read */
 )
 {
@@ -330,7 +345,8 @@ DRESULT sata_pcie_disk_read(
     BYTE *io_buf = buff;
     UINT err = FSATA_SUCCESS;
 
-    err = FSataReadWrite(&sata_device[host_num], port_num, sector, count, io_buf, FALSE, FALSE);
+    err = FSataReadWrite(&sata_device[host_num], port_num, sector, count, io_buf,
+                         FSataIsNcqSupported(&sata_device[host_num], port_num), FALSE);
 
     if (FSATA_SUCCESS != err)
     {
@@ -348,7 +364,7 @@ DRESULT sata_pcie_disk_read(
 DRESULT sata_pcie_disk_write(
     BYTE pdrv,          /* Physical drive nmuber to identify the drive */
     const BYTE *buff,   /* Data to be written */
-    DWORD sector,       /* Start sector in LBA */
+    LBA_t sector,       /* Start sector in LBA */
     UINT count          /* Number of sectors to write */
 )
 {
@@ -356,7 +372,8 @@ DRESULT sata_pcie_disk_write(
     const BYTE *io_buf = buff;
     UINT err = FSATA_SUCCESS;
 
-    err = FSataReadWrite(&sata_device[host_num], port_num, sector, count, (u8 *)io_buf, FALSE, TRUE);
+    err = FSataReadWrite(&sata_device[host_num], port_num, sector, count, (u8 *)io_buf,
+                         FSataIsNcqSupported(&sata_device[host_num], port_num), TRUE);
 
     if (FSATA_SUCCESS != err)
     {
@@ -388,12 +405,13 @@ DRESULT sata_pcie_disk_ioctl(
             break;
         /* 所有可用的扇区数目（逻辑寻址即LBA寻址方式） */
         case GET_SECTOR_COUNT:
-            *((DWORD *)buff) = sata_device[host_num].port[port_num].dev_info.lba512;
+            *((LBA_t *)buff) = sata_device[host_num].port[port_num].dev_info.lba512;
             res = RES_OK; /* 最多使用1000个sector */
             break;
-        /* 返回磁盘扇区大小, 只用于f_mkfs() */
+        /* 返回磁盘扇区大小, 驱动按 512 字节的逻辑扇区读写, 扇区数也以 512 字节计 */
         case GET_SECTOR_SIZE:
-            res = RES_PARERR;
+            *((WORD *)buff) = FSATA_SECT_SIZE;
+            res = RES_OK;
             break;
         /* 每个扇区有多少个字节 */
         case GET_BLOCK_SIZE:
@@ -134,7 +134,7 @@ static DSTATUS usb_disk_initialize(
 static DRESULT usb_disk_read(
     BYTE pdrv,      /* Physical drive nmuber to identify the drive */
     BYTE *buff,     /* Data buffer to store read data */
-    DWORD sector,   /* Start sector in LBA */
+    LBA_t sector,   /* Start sector in LBA */
     UINT count      /* Number of sectors to read */
 )
 {
@@ -165,7 +165,7 @@ static DRESULT usb_disk_read(
 static DRESULT usb_disk_write(
     BYTE pdrv,          /* Physical drive nmuber to identify the drive */
     const BYTE *buff,   /* Data to be written */
-    DWORD sector,       /* Start sector in LBA */
+    LBA_t sector,       /* Start sector in LBA */
     UINT count          /* Number of sectors to write */
 )
 {
@@ -216,7 +216,7 @@ DRESULT usb_disk_ioctl(
             break;
 
         case GET_SECTOR_COUNT:  /* Get number of sectors on the drive */
-            *(DWORD *)buff = msc_class->blocknum;
+            *(LBA_t *)buff = msc_class->blocknum;
             res = RES_OK;
             break;
 
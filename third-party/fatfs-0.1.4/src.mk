@@ -7,6 +7,10 @@ ifdef CONFIG_FATFS_USB
 	CSRCS_RELATIVE_FILES += $(wildcard port/fusb/*.c)
 endif
 
+ifdef CONFIG_FATFS_BLOCK_LAYER
+	CSRCS_RELATIVE_FILES += $(wildcard port/fblock/*.c)
+endif
+
 # ifdef CONFIG_FATFS_FSATA
 # 	CSRCS_RELATIVE_FILES += $(wildcard port/fsata_controller/*.c)
 # endif 
@@ -39,4 +43,8 @@ endif
 
 ifdef CONFIG_FATFS_SDMMC
 	ABSOLUTE_CFILES += $(wildcard $(FATFS_RT_C_DIR)/port/sdmmc/*.c)
-endif 
\ No newline at end of file
+endif 
+
+ifdef CONFIG_FATFS_NVME
+	ABSOLUTE_CFILES += $(wildcard $(FATFS_RT_C_DIR)/port/nvme/*.c)
+endif
\ No newline at end of file
@@ -80,6 +80,13 @@
 #ifdef CONFIG_FREERTOS_USE_TICKLESS_IDLE
     #define configUSE_TICKLESS_IDLE 1
     #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP           CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP
+    /* program the generic timer for the next wakeup instead of the periodic tick */
+    #define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) \
+        do \
+        { \
+            void vPortSuppressTicksAndSleep(TickType_t xIdleTime);\
+            vPortSuppressTicksAndSleep(xExpectedIdleTime); \
+        } while (0)
 #endif
 
 #define configTICK_RATE_HZ          ( CONFIG_FREERTOS_HZ )
@@ -96,6 +103,18 @@
 
 #define configUSE_TASK_FPU_SUPPORT (CONFIG_FREERTOS_TASK_FPU_SUPPORT)
 
+#ifdef CONFIG_FREERTOS_TASK_FPU_LAZY_SWITCH
+    #define configUSE_TASK_FPU_LAZY_SWITCH 1
+#else
+    #define configUSE_TASK_FPU_LAZY_SWITCH 0
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_PMU_PROFILER
+    #define configUSE_PMU_PROFILER 1
+#else
+    #define configUSE_PMU_PROFILER 0
+#endif
+
 
 /* 与宏 configUSE_TRACE_FACILITY 同时为 1 时会编译下面 3 个函数
 * prvWriteNameToBuffer()
@@ -162,10 +181,24 @@ is set to 1. */
     #define configGENERATE_RUN_TIME_STATS                   1
 #endif
 
-#ifndef __ASSEMBLER__ // skip when preprocess asm
-    extern volatile unsigned int gCpuRuntime;
-    #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() (gCpuRuntime = 0ul)
-    #define portGET_RUN_TIME_COUNTER_VALUE() gCpuRuntime
+#if defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_GENERIC_COUNTER) || defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES)
+    #define configRUN_TIME_COUNTER_TYPE uint64_t
+    #ifndef __ASSEMBLER__ // skip when preprocess asm
+        #include "freertos_runtime.h"
+        #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vRunTimeStatsSetup()
+        #define portGET_RUN_TIME_COUNTER_VALUE() ullRunTimeCounter()
+        #ifndef CONFIG_FREERTOS_USE_KERNEL_TRACE
+            /* count the context switches of each task, the kernel trace does it in its own hooks */
+            #define traceTASK_SWITCHED_OUT() runtimeTASK_SWITCHED_OUT()
+            #define traceTASK_SWITCHED_IN() runtimeTASK_SWITCHED_IN()
+        #endif
+    #endif
+#else
+    #ifndef __ASSEMBLER__ // skip when preprocess asm
+        extern volatile unsigned int gCpuRuntime;
+        #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() (gCpuRuntime = 0ul)
+        #define portGET_RUN_TIME_COUNTER_VALUE() gCpuRuntime
+    #endif
 #endif
 
 /* The size of the global output buffer that is available for use when there
@@ -226,7 +259,17 @@ QEMU-Virt. */
 #endif
 
 
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+    /* the last notification slot is reserved for vTaskDelayUs() */
+    #define configTASK_NOTIFICATION_ARRAY_ENTRIES 2
+#endif
+
 #define configUSE_POSIX_ERRNO   1
 #define configUSE_APPLICATION_TASK_TAG 1
 
+#ifdef CONFIG_FREERTOS_USE_KERNEL_TRACE
+    /* trace hook macros, must come last as they replace the empty defaults of FreeRTOS.h */
+    #include "freertos_trace.h"
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
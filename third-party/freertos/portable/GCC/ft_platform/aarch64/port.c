@@ -180,10 +180,36 @@ uint64_t ullPortYieldRequired = pdFALSE;
  * if the nesting depth is 0. */
 uint64_t ullPortInterruptNesting = 0;
 
+#if ( configUSE_PMU_PROFILER == 1 )
+
+/* Registers saved by FreeRTOS_IRQ_Handler for the interrupt being handled,
+ * ELR, SPSR, X29 and X30 from the lowest address up. */
+void * volatile pvPortInterruptFrame = NULL;
+
+#endif
+
 /* The space on the stack required to hold the FPU registers.  This is 32 128-bit
  * registers, that means (64 * 8) 64 double words */
 #define portFPU_REGISTER_DOUBLE_WORDS ( 64 )
 
+#if ( configUSE_TASK_FPU_LAZY_SWITCH == 1 )
+
+/* CPACR_EL1.FPEN (or CPTR_EL3.TFP) controls whether FP/SIMD accesses trap. */
+#define portCPACR_FPEN_MASK              ( 0x3ULL << 20 )
+#define portCPTR_EL3_TFP                 ( 0x1ULL << 10 )
+
+/* The task whose FPU registers are live in the hardware, NULL if nobody owns
+ * them.  Each core runs its own scheduler, so this is per core. */
+static void * volatile pxFPUOwner = NULL;
+
+extern void * volatile pxCurrentTCB;
+
+/* Implemented in portASM.S, stores Q0-Q31 in the layout popped by
+ * portRESTORE_CONTEXT. */
+extern void vPortLazyFPUSaveRegisters( StackType_t * pxArea );
+
+#endif /* configUSE_TASK_FPU_LAZY_SWITCH */
+
 /* Used in the ASM code. */
 volatile uint64_t ullMaxAPIPriorityMask = (configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT);
 
@@ -467,12 +493,111 @@ void FreeRTOS_Tick_Handler( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_FPU_LAZY_SWITCH == 1 )
+
+/* The functions below run while FP/SIMD access may be trapped, so the compiler
+ * must not use the FP registers in them. */
+#define portNO_FPU_CODE    __attribute__( ( target( "general-regs-only" ) ) )
+
+static portNO_FPU_CODE void prvFPUAccessEnable( BaseType_t xEnable )
+{
+    uint64_t ullValue;
+
+#if defined( GUEST )
+    __asm volatile ( "MRS %0, CPACR_EL1" : "=r" ( ullValue ) );
+    ullValue = ( xEnable != pdFALSE ) ? ( ullValue | portCPACR_FPEN_MASK ) : ( ullValue & ~portCPACR_FPEN_MASK );
+    __asm volatile ( "MSR CPACR_EL1, %0 \n"
+                     "ISB SY" :: "r" ( ullValue ) : "memory" );
+#else
+    __asm volatile ( "MRS %0, CPTR_EL3" : "=r" ( ullValue ) );
+    ullValue = ( xEnable != pdFALSE ) ? ( ullValue & ~portCPTR_EL3_TFP ) : ( ullValue | portCPTR_EL3_TFP );
+    __asm volatile ( "MSR CPTR_EL3, %0 \n"
+                     "ISB SY" :: "r" ( ullValue ) : "memory" );
+#endif
+}
+
+/* Push the live FPU registers into the frame of a switched out owner.  The
+ * frame grows by the 512 bytes an eager save would have used, and the
+ * context indicator makes portRESTORE_CONTEXT reload them with the task. */
+static portNO_FPU_CODE void prvFPUSpill( void * pxOwner )
+{
+    StackType_t ** ppxTopOfStack = ( StackType_t ** ) pxOwner; /* pxTopOfStack is the first TCB member. */
+    StackType_t * pxFrame = *ppxTopOfStack;
+    StackType_t uxCriticalNesting = pxFrame[ 1 ];
+
+    pxFrame -= portFPU_REGISTER_DOUBLE_WORDS;
+    vPortLazyFPUSaveRegisters( &pxFrame[ 2 ] );
+    pxFrame[ 1 ] = uxCriticalNesting;
+    pxFrame[ 0 ] = pdTRUE;
+    *ppxTopOfStack = pxFrame;
+}
+
+/* Called between vTaskSwitchContext() and portRESTORE_CONTEXT. */
+portNO_FPU_CODE void vPortLazyFPUSwitchIn( void )
+{
+    void * pxIncoming = pxCurrentTCB;
+    StackType_t * pxFrame = *( StackType_t ** ) pxIncoming;
+
+    prvFPUAccessEnable( pdTRUE );
+
+    if( pxFrame[ 0 ] != portNO_FLOATING_POINT_CONTEXT )
+    {
+        /* The incoming task had its registers spilled, they are reloaded by
+         * portRESTORE_CONTEXT so whoever holds the FPU gives it up first. */
+        if( ( pxFPUOwner != NULL ) && ( pxFPUOwner != pxIncoming ) )
+        {
+            prvFPUSpill( pxFPUOwner );
+        }
+
+        pxFPUOwner = pxIncoming;
+    }
+    else if( pxFPUOwner != pxIncoming )
+    {
+        /* Trap the first FP/SIMD access instead of switching the registers. */
+        prvFPUAccessEnable( pdFALSE );
+    }
+}
+
+/* Called on a trapped FP/SIMD access, from a task or from an interrupt handler
+ * which preempted a task that does not own the FPU. */
+portNO_FPU_CODE void vPortLazyFPUTrap( void )
+{
+    void * pxCurrent = pxCurrentTCB;
+
+    prvFPUAccessEnable( pdTRUE );
+
+    if( ( pxFPUOwner != NULL ) && ( pxFPUOwner != pxCurrent ) )
+    {
+        prvFPUSpill( pxFPUOwner );
+    }
+
+    pxFPUOwner = pxCurrent;
+}
+
+portNO_FPU_CODE void vPortCleanUpTCB( void * pxTCB )
+{
+    UBaseType_t uxSavedMask = uxPortSetInterruptMask();
+
+    if( pxFPUOwner == pxTCB )
+    {
+        pxFPUOwner = NULL;
+    }
+
+    vPortClearInterruptMask( uxSavedMask );
+}
+
+#endif /* configUSE_TASK_FPU_LAZY_SWITCH */
+/*-----------------------------------------------------------*/
+
 void vPortTaskUsesFPU( void )
 {
     /* A task is registering the fact that it needs an FPU context.  Set the
      * FPU flag (which is saved as part of the task context). */
     ullPortTaskHasFPUContext = pdTRUE;
 
+    /* With lazy switching every task gets the FPU on its first FP/SIMD access,
+     * so this only matters for the eager scheme. */
+
     /* Consider initialising the FPSR here - but probably not necessary in
      * AArch64. */
 }
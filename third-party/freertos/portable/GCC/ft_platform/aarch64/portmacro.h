@@ -141,6 +141,12 @@ void FreeRTOS_Tick_Handler( void );
 void vPortTaskUsesFPU( void );
 #define portTASK_USES_FLOATING_POINT()    vPortTaskUsesFPU()
 
+#if ( configUSE_TASK_FPU_LAZY_SWITCH == 1 )
+    /* A deleted task must not be left as the owner of the live FPU registers. */
+    void vPortCleanUpTCB( void * pxTCB );
+    #define portCLEAN_UP_TCB( pxTCB )    vPortCleanUpTCB( pxTCB )
+#endif
+
 #define portLOWEST_INTERRUPT_PRIORITY           ( ( ( uint32_t ) configUNIQUE_INTERRUPT_PRIORITIES ) - 1UL )
 #define portLOWEST_USABLE_INTERRUPT_PRIORITY    ( portLOWEST_INTERRUPT_PRIORITY - 1UL )
 
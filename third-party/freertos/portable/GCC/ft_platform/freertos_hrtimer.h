@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_hrtimer.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the high-resolution timer on the generic timer
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FREERTOS_HRTIMER_H
+#define FREERTOS_HRTIMER_H
+
+#include "FreeRTOS.h"
+#include "ftypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* callback runs in the hrtimer interrupt, it may only use FromISR APIs */
+#define HRTIMER_MODE_ISR        0U
+/* callback is deferred to the timer service task with xTimerPendFunctionCallFromISR */
+#define HRTIMER_MODE_DEFERRED   1U
+
+typedef void (*HrTimerCallback_t)(void *pvArg);
+
+typedef struct HrTimer
+{
+    struct HrTimer *pxNext;        /* next timer in the expiry sorted queue */
+    u64 ullExpires;                /* absolute counter value to expire at */
+    u64 ullPeriod;                 /* reload period in counter cycles, 0 for one-shot */
+    HrTimerCallback_t pxCallback;
+    void *pvArg;
+    u32 ulMode;                    /* HRTIMER_MODE_ISR or HRTIMER_MODE_DEFERRED */
+    volatile u32 ulActive;
+} HrTimer_t;
+
+/* setup the hrtimer compare timer of this core, called when the scheduler starts */
+void vHrTimerSetup(void);
+
+/* current counter value and conversions of the hrtimer time base */
+u64 ullHrTimerGetCount(void);
+u64 ullHrTimerUsToCount(u64 ullUs);
+u64 ullHrTimerCountToUs(u64 ullCount);
+
+/* initialize a timer, it must not be active */
+void vHrTimerInit(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvArg, u32 ulMode);
+
+/* start a timer relative to now, a non-zero period makes it periodic */
+BaseType_t xHrTimerStart(HrTimer_t *pxTimer, u64 ullTimeoutUs, u64 ullPeriodUs);
+
+/* start a one-shot timer at an absolute counter value */
+BaseType_t xHrTimerStartAt(HrTimer_t *pxTimer, u64 ullExpires);
+
+/* remove a timer from the queue, returns pdFALSE if it was not active */
+BaseType_t xHrTimerCancel(HrTimer_t *pxTimer);
+
+/* block the calling task for a number of microseconds */
+void vTaskDelayUs(u32 ulDelayUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_irq.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the fast interrupt dispatch and interrupt statistics
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   add handler time histograms
+ */
+
+#ifndef FREERTOS_IRQ_H
+#define FREERTOS_IRQ_H
+
+#include "FreeRTOS.h"
+#include "ftypes.h"
+#include "finterrupt.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* all LPIs share one statistics entry with this id */
+#define IRQ_STATS_LPI_ID    8192U
+
+/* log2 buckets of the handler time, see ulTimeHist */
+#define IRQ_STATS_HIST_NUM  24U
+
+typedef struct
+{
+    u32 ulIrqId;
+    u32 ulFast;
+    u64 ullCount;           /* number of times the handler ran */
+    u64 ullTotalTime;       /* handler time, in units of the statistics clock */
+    u64 ullMinTime;
+    u64 ullMaxTime;
+    u64 ullLatencyCount;    /* number of entry latency samples, generic timer interrupts only */
+    u64 ullTotalLatency;    /* entry latency, in generic counter cycles */
+    u64 ullMaxLatency;
+    u32 ulTimeHist[IRQ_STATS_HIST_NUM]; /* handler runs by time, bucket n counts 2^n to 2^(n+1) - 1
+                                           clock units, bucket 0 also counts 0 and the last one
+                                           everything longer */
+} IrqStats_t;
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+/* install a handler called straight from the interrupt entry, it must not call any FreeRTOS API */
+BaseType_t xIrqInstallFast(u32 ulIrqId, IrqHandler pxHandler, void *pvParam);
+
+/* remove a fast handler, the interrupt should be masked before */
+BaseType_t xIrqRemoveFast(u32 ulIrqId);
+
+/* run the fast handler of an interrupt, returns pdFALSE if it is not a fast interrupt */
+BaseType_t xIrqFastDispatch(u32 ulIrqId);
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+/* start the statistics clock of this core, called when the scheduler starts */
+void vIrqStatsSetup(void);
+
+/* statistics clock value and frequency */
+u64 ullIrqStatsClock(void);
+u64 ullIrqStatsClockFrequency(void);
+
+/* account one handler run of an interrupt, ullStart is the clock value at entry */
+void vIrqStatsRecord(u32 ulIrqId, u64 ullStart, u64 ullLatency);
+
+/* entry latency of a generic timer interrupt in counter cycles, 0 for other interrupts */
+u64 ullIrqStatsEntryLatency(u32 ulIrqId);
+
+/* copy the statistics of up to ulMaxNum interrupts, returns the number copied */
+u32 ulIrqStatsSnapshot(IrqStats_t *pxStats, u32 ulMaxNum);
+
+void vIrqStatsReset(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_log.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the deferred output of the FT_DEBUG_PRINT_* logs
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#ifndef FREERTOS_LOG_H
+#define FREERTOS_LOG_H
+
+#include "FreeRTOS.h"
+#include "ftypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* writes one formatted line, called by the drain task only */
+typedef void (*AsyncLogOutput_t)(const char *pcLine, u32 ulLength);
+
+typedef struct
+{
+    u32 ulWritten;                 /* records queued */
+    u32 ulDropped;                 /* records lost on a full ring */
+    u32 ulUsed;                    /* records waiting for the drain task */
+    u32 ulMaxUsed;                 /* high water mark of ulUsed */
+    u32 ulRecordNum;               /* ring size */
+} AsyncLogStats_t;
+
+/* create the drain task of this core, logs are printed at once before it runs */
+BaseType_t xAsyncLogInit(void);
+
+/* replace the output of the drain task, NULL restores the early uart */
+void vAsyncLogSetOutput(AsyncLogOutput_t pxOutput);
+
+/* level of a tag at run time, "*" sets the level of all tags without an own level */
+BaseType_t xAsyncLogSetLevel(const char *pcTag, u32 ulLevel);
+u32 ulAsyncLogGetLevel(const char *pcTag);
+
+/* walk the tags with an own level, returns pdFALSE after the last one */
+BaseType_t xAsyncLogGetTag(u32 ulIndex, const char **ppcTag, u32 *pulLevel);
+
+void vAsyncLogGetStats(AsyncLogStats_t *pxStats);
+
+/* print the queued records synchronously, for fault handlers */
+void vAsyncLogFlush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_profiler.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the PMU overflow sampling profiler
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FREERTOS_PROFILER_H
+#define FREERTOS_PROFILER_H
+
+#include "FreeRTOS.h"
+#include "ftypes.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define PROFILER_STACK_DEPTH    CONFIG_FREERTOS_PROFILER_STACK_DEPTH
+
+typedef struct
+{
+    u64 ullPc;              /* interrupted instruction */
+    u64 ullLr;              /* X30 of the interrupted context, the caller of a leaf function */
+    void *pvTask;           /* running task, NULL before the scheduler starts */
+    u32 ulDepth;            /* number of valid entries of uxStack */
+    u32 ulReserved;
+#if PROFILER_STACK_DEPTH > 0
+    uintptr uxStack[PROFILER_STACK_DEPTH]; /* call sites from the frame records, innermost first */
+#endif
+} ProfilerSample_t;
+
+typedef struct
+{
+    u32 ulRunning;
+    u32 ulEventId;          /* PMU event number, FPMU_xxx_ID */
+    u32 ulPeriod;           /* events between two samples */
+    u32 ulSampleNum;        /* samples in the buffer */
+    u32 ulSampleMax;
+    u32 ulCounterId;        /* event counter used for sampling */
+} ProfilerStatus_t;
+
+/* start sampling every ulPeriod events, the samples of the previous run are discarded */
+BaseType_t xProfilerStart(u32 ulEventId, u32 ulPeriod);
+
+/* stop sampling, the samples stay in the buffer */
+void vProfilerStop(void);
+
+void vProfilerGetStatus(ProfilerStatus_t *pxStatus);
+
+/* samples of this core, only read them while the profiler is stopped */
+const ProfilerSample_t *pxProfilerGetSamples(u32 *pulNum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_runtime.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the task run time counters on the generic timer or the PMU
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FREERTOS_RUNTIME_H
+#define FREERTOS_RUNTIME_H
+
+/* included from FreeRTOSConfig.h, so no kernel types can be used here */
+#include "ftypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* start the run time clock of this core, called when the scheduler starts */
+void vRunTimeStatsSetup(void);
+
+/* run time counter of the tasks, it does not advance while an interrupt is handled */
+u64 ullRunTimeCounter(void);
+
+/* time spent in interrupt handlers, in run time counter units */
+u64 ullRunTimeIsrTime(void);
+
+/* time since vRunTimeStatsSetup, in run time counter units */
+u64 ullRunTimeTotal(void);
+
+/* frequency of the run time counter in Hz, 0 when it counts cpu cycles */
+u64 ullRunTimeFrequency(void);
+
+/* called around the dispatch of an interrupt */
+void vRunTimeIsrEnter(void);
+void vRunTimeIsrExit(void);
+
+/*
+ * uxTaskNumber of the TCB is left to trace code by the kernel, it counts the
+ * times a task was switched in, read it with uxTaskGetTaskNumber()
+ */
+extern void *pvRunTimePrevTCB;
+
+#define runtimeTASK_SWITCHED_OUT()  (pvRunTimePrevTCB = (void *)pxCurrentTCB)
+#define runtimeTASK_SWITCHED_IN()                       \
+    do                                                  \
+    {                                                   \
+        if ((void *)pxCurrentTCB != pvRunTimePrevTCB)   \
+        {                                               \
+            pxCurrentTCB->uxTaskNumber++;               \
+        }                                               \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_trace.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for recording kernel events into the binary trace ring
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FREERTOS_TRACE_H
+#define FREERTOS_TRACE_H
+
+/* included at the end of FreeRTOSConfig.h, so no kernel types can be used here */
+#ifndef __ASSEMBLER__
+#include "ftypes.h"
+#include "ftrace_ring.h"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* kernel event ids in the trace ring, decoded by standalone/tools/trace/freertos_trace_json.py */
+#define TRACE_KERNEL_TASK_SWITCH        (FTRACE_EVENT_KERNEL + 0U)  /* previous tcb, next tcb, next priority */
+#define TRACE_KERNEL_TASK_CREATE        (FTRACE_EVENT_KERNEL + 1U)  /* tcb, priority, name packed in 3 args */
+#define TRACE_KERNEL_TASK_DELETE        (FTRACE_EVENT_KERNEL + 2U)  /* tcb */
+#define TRACE_KERNEL_TASK_READY         (FTRACE_EVENT_KERNEL + 3U)  /* tcb */
+#define TRACE_KERNEL_TASK_DELAY         (FTRACE_EVENT_KERNEL + 4U)  /* ticks or wake tick */
+#define TRACE_KERNEL_TASK_SUSPEND       (FTRACE_EVENT_KERNEL + 5U)  /* tcb */
+#define TRACE_KERNEL_PRIORITY_INHERIT   (FTRACE_EVENT_KERNEL + 6U)  /* mutex holder tcb, inherited priority */
+#define TRACE_KERNEL_PRIORITY_DISINHERIT (FTRACE_EVENT_KERNEL + 7U) /* mutex holder tcb, restored priority */
+#define TRACE_KERNEL_QUEUE_CREATE       (FTRACE_EVENT_KERNEL + 8U)  /* queue, length */
+#define TRACE_KERNEL_QUEUE_REGISTRY     (FTRACE_EVENT_KERNEL + 9U)  /* queue, name */
+#define TRACE_KERNEL_QUEUE_SEND         (FTRACE_EVENT_KERNEL + 10U) /* queue, messages waiting */
+#define TRACE_KERNEL_QUEUE_RECEIVE      (FTRACE_EVENT_KERNEL + 11U) /* queue, messages waiting */
+#define TRACE_KERNEL_QUEUE_FAILED       (FTRACE_EVENT_KERNEL + 12U) /* queue, 0 send 1 receive */
+#define TRACE_KERNEL_BLOCK_QUEUE_SEND   (FTRACE_EVENT_KERNEL + 13U) /* queue */
+#define TRACE_KERNEL_BLOCK_QUEUE_RECEIVE (FTRACE_EVENT_KERNEL + 14U) /* queue */
+#define TRACE_KERNEL_BLOCK_NOTIFY       (FTRACE_EVENT_KERNEL + 15U) /* notification index */
+#define TRACE_KERNEL_BLOCK_EVENT_GROUP  (FTRACE_EVENT_KERNEL + 16U) /* event group, bits */
+#define TRACE_KERNEL_ISR_ENTER          (FTRACE_EVENT_KERNEL + 17U) /* interrupt id */
+#define TRACE_KERNEL_ISR_EXIT           (FTRACE_EVENT_KERNEL + 18U) /* interrupt id */
+
+/* event classes, one bit each */
+#define TRACE_KERNEL_CLASS_TASK         BIT(0)
+#define TRACE_KERNEL_CLASS_QUEUE        BIT(1)
+#define TRACE_KERNEL_CLASS_BLOCK        BIT(2)
+#define TRACE_KERNEL_CLASS_ISR          BIT(3)
+#define TRACE_KERNEL_CLASS_ALL          (TRACE_KERNEL_CLASS_TASK | TRACE_KERNEL_CLASS_QUEUE | \
+                                         TRACE_KERNEL_CLASS_BLOCK | TRACE_KERNEL_CLASS_ISR)
+
+#ifndef __ASSEMBLER__
+
+extern volatile u32 ulTraceKernelMask;
+
+/* select the event classes to record, TRACE_KERNEL_CLASS_ALL after boot */
+void vTraceKernelSetMask(u32 ulMask);
+
+/* record the name of every existing task, for rings that overwrote the create events */
+void vTraceKernelDumpTasks(void);
+
+void vTraceKernelSwitchedOut(void *pvTCB);
+void vTraceKernelSwitchedIn(void *pvTCB, u32 ulPriority);
+void vTraceKernelTaskCreate(void *pvTCB, u32 ulPriority, const char *pcName);
+void vTraceKernelIsrEnter(u32 ulIrqId);
+void vTraceKernelIsrExit(u32 ulIrqId);
+
+static inline void vTraceKernelEvent(u32 ulClass, u16 usEvent, const char *pcFmt, u64 ullArg0, u64 ullArg1)
+{
+    if (ulTraceKernelMask & ulClass)
+    {
+        const u64 ullArgs[2] = {ullArg0, ullArg1};
+        FTraceRingWrite(usEvent, 0U, pcFmt, 2U, ullArgs);
+    }
+}
+
+/* the run time stats count context switches in the same hooks */
+#ifndef runtimeTASK_SWITCHED_OUT
+#define runtimeTASK_SWITCHED_OUT()
+#define runtimeTASK_SWITCHED_IN()
+#endif
+
+#define traceTASK_SWITCHED_OUT()                                                \
+    do                                                                          \
+    {                                                                           \
+        runtimeTASK_SWITCHED_OUT();                                             \
+        vTraceKernelSwitchedOut((void *)pxCurrentTCB);                          \
+    } while (0)
+#define traceTASK_SWITCHED_IN()                                                 \
+    do                                                                          \
+    {                                                                           \
+        runtimeTASK_SWITCHED_IN();                                              \
+        vTraceKernelSwitchedIn((void *)pxCurrentTCB, (u32)pxCurrentTCB->uxPriority); \
+    } while (0)
+#define traceTASK_CREATE(pxNewTCB)              vTraceKernelTaskCreate((void *)(pxNewTCB), (u32)(pxNewTCB)->uxPriority, (pxNewTCB)->pcTaskName)
+
+#define traceTASK_DELETE(pxTaskToDelete)                                                        \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_TASK_DELETE, "task delete %p",      \
+                      (u64)(uintptr)(pxTaskToDelete), 0U)
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)                                                   \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_TASK_READY, "task ready %p",        \
+                      (u64)(uintptr)(pxTCB), 0U)
+#define traceTASK_DELAY()                                                                       \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_TASK_DELAY, "task delay %lu ticks", \
+                      (u64)xTicksToDelay, 0U)
+#define traceTASK_DELAY_UNTIL(xTimeToWake)                                                      \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_TASK_DELAY, "task delay until tick %lu", \
+                      (u64)(xTimeToWake), 1U)
+#define traceTASK_SUSPEND(pxTaskToSuspend)                                                      \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_TASK_SUSPEND, "task suspend %p",    \
+                      (u64)(uintptr)(pxTaskToSuspend), 0U)
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority)                     \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_PRIORITY_INHERIT,                   \
+                      "task %p inherits priority %lu",                                          \
+                      (u64)(uintptr)(pxTCBOfMutexHolder), (u64)(uxInheritedPriority))
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority)                   \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_TASK, TRACE_KERNEL_PRIORITY_DISINHERIT,                \
+                      "task %p restores priority %lu",                                          \
+                      (u64)(uintptr)(pxTCBOfMutexHolder), (u64)(uxOriginalPriority))
+
+#define traceQUEUE_CREATE(pxNewQueue)                                                           \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_CREATE, "queue create %p length %lu", \
+                      (u64)(uintptr)(pxNewQueue), (u64)(pxNewQueue)->uxLength)
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName)                                            \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_REGISTRY, "queue %p is %s",  \
+                      (u64)(uintptr)(xQueue), (u64)(uintptr)(pcQueueName))
+#define traceQUEUE_SEND(pxQueue)                                                                \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_SEND, "queue send %p waiting %lu", \
+                      (u64)(uintptr)(pxQueue), (u64)(pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       traceQUEUE_SEND(pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)                                                             \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_RECEIVE, "queue receive %p waiting %lu", \
+                      (u64)(uintptr)(pxQueue), (u64)(pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    traceQUEUE_RECEIVE(pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue)                                                         \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_FAILED, "queue send %p failed", \
+                      (u64)(uintptr)(pxQueue), 0U)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue) traceQUEUE_SEND_FAILED(pxQueue)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)                                                      \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_QUEUE, TRACE_KERNEL_QUEUE_FAILED, "queue receive %p failed", \
+                      (u64)(uintptr)(pxQueue), 1U)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) traceQUEUE_RECEIVE_FAILED(pxQueue)
+
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)                                                    \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_BLOCK, TRACE_KERNEL_BLOCK_QUEUE_SEND, "block on send %p", \
+                      (u64)(uintptr)(pxQueue), 0U)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)                                                 \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_BLOCK, TRACE_KERNEL_BLOCK_QUEUE_RECEIVE, "block on receive %p", \
+                      (u64)(uintptr)(pxQueue), 0U)
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue)    traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)
+#define traceTASK_NOTIFY_TAKE_BLOCK(uxIndexToWait)                                              \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_BLOCK, TRACE_KERNEL_BLOCK_NOTIFY, "block on notify %lu", \
+                      (u64)(uxIndexToWait), 0U)
+#define traceTASK_NOTIFY_WAIT_BLOCK(uxIndexToWait) traceTASK_NOTIFY_TAKE_BLOCK(uxIndexToWait)
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK(xEventGroup, uxBitsToWaitFor)                          \
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_BLOCK, TRACE_KERNEL_BLOCK_EVENT_GROUP, "block on event group %p bits 0x%lx", \
+                      (u64)(uintptr)(xEventGroup), (u64)(uxBitsToWaitFor))
+#define traceEVENT_GROUP_SYNC_BLOCK(xEventGroup, uxBitsToSet, uxBitsToWaitFor)                  \
+    traceEVENT_GROUP_WAIT_BITS_BLOCK(xEventGroup, uxBitsToWaitFor)
+
+#endif /* __ASSEMBLER__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_workqueue.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the deferred work queues and their worker tasks
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FREERTOS_WORKQUEUE_H
+#define FREERTOS_WORKQUEUE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* worker task a work item runs on */
+#define WORKQUEUE_HIGH          0U
+#define WORKQUEUE_LOW           1U
+#define WORKQUEUE_NUM           2U
+
+/* state of a work item */
+#define WORK_STATE_IDLE         0U
+#define WORK_STATE_PENDING      1U  /* on the run list of its worker */
+#define WORK_STATE_DELAYED      2U  /* on the delayed list of its worker */
+
+typedef void (*WorkFunction_t)(void *pvArg);
+
+typedef struct Work
+{
+    struct Work *pxNext;
+    WorkFunction_t pxFunction;
+    void *pvArg;
+    TickType_t xWakeTick;          /* tick to move a delayed work to the run list */
+    u32 ulQueue;                   /* WORKQUEUE_HIGH or WORKQUEUE_LOW */
+    volatile u32 ulState;
+} Work_t;
+
+typedef struct
+{
+    u32 ulExecuted;                /* number of work functions run */
+    u32 ulCoalesced;               /* number of submissions merged into a pending work */
+} WorkQueueStats_t;
+
+/* create the worker tasks of this core, may be called more than once */
+BaseType_t xWorkQueueInit(void);
+
+/* initialize a work item, it must not be queued */
+void vWorkInit(Work_t *pxWork, WorkFunction_t pxFunction, void *pvArg, u32 ulQueue);
+
+/* queue a work item, returns pdFALSE if it was already pending, may be called from interrupts */
+BaseType_t xWorkQueue(Work_t *pxWork);
+
+/* queue a work item after a number of ticks, may be called from interrupts */
+BaseType_t xWorkQueueDelayed(Work_t *pxWork, TickType_t xDelay);
+
+/* remove a queued work item, returns pdFALSE if it was not queued */
+BaseType_t xWorkCancel(Work_t *pxWork);
+
+void vWorkQueueGetStats(u32 ulQueue, WorkQueueStats_t *pxStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
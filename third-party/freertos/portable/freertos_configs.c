@@ -40,6 +40,19 @@
 #include "fassert.h"
 #include "fexception.h"
 #include "sdkconfig.h"
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+#include "freertos_hrtimer.h"
+#endif
+#if defined(CONFIG_FREERTOS_USE_FAST_IRQ) || defined(CONFIG_FREERTOS_USE_IRQ_STATS)
+#include "freertos_irq.h"
+#endif
+#ifdef CONFIG_FREERTOS_USE_KERNEL_TRACE
+#include "freertos_trace.h"
+#endif
+#if defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_GENERIC_COUNTER) || defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES)
+#include "freertos_runtime.h"
+#define USE_RUN_TIME_COUNTER
+#endif
 
 #ifdef CONFIG_NON_SECURE_PHYSICAL_TIMER
     #define USING_GENERIC_TIMER_ID GENERIC_TIMER_ID0
@@ -82,6 +95,8 @@ u32 PlatformGetGicDistBase(void)
 }
 
 static u32 cntfrq; /* System frequency */
+static u64 tick_reload; /* Counter cycles per tick */
+static u64 next_tick_compare; /* Absolute compare value of the next tick interrupt */
 
 void vConfigureTickInterrupt(void)
 {
@@ -89,9 +104,11 @@ void vConfigureTickInterrupt(void)
     GenericTimerStop(USING_GENERIC_TIMER_ID);
     /* Get system frequency */
     cntfrq = GenericTimerFrequecy();
+    tick_reload = cntfrq / configTICK_RATE_HZ;
 
-    /* Set tick rate */
-    GenericTimerSetTimerValue(USING_GENERIC_TIMER_ID, cntfrq / configTICK_RATE_HZ);
+    /* Set the first tick as an absolute compare value, later ticks advance it by one period */
+    next_tick_compare = GenericTimerRead(USING_GENERIC_TIMER_ID) + tick_reload;
+    GenericTimerSetTimerCompareValue(USING_GENERIC_TIMER_ID, next_tick_compare);
     GenericTimerInterruptEnable(USING_GENERIC_TIMER_ID);
 
     /* Set as the lowest priority */
@@ -99,19 +116,110 @@ void vConfigureTickInterrupt(void)
     InterruptUmask(USING_GENERIC_TIMER_IRQ_ID);
 
     GenericTimerStart(USING_GENERIC_TIMER_ID);
+
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+    vHrTimerSetup();
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    vIrqStatsSetup();
+#endif
 }
 
 void vClearTickInterrupt(void)
 {
-    GenericTimerSetTimerValue(USING_GENERIC_TIMER_ID, cntfrq / configTICK_RATE_HZ);
+    /* Advance from the previous compare value rather than from the current count,
+       so interrupt entry latency does not accumulate as drift. If ticks were missed
+       the interrupt fires again at once until the tick count has caught up. */
+    next_tick_compare += tick_reload;
+    GenericTimerSetTimerCompareValue(USING_GENERIC_TIMER_ID, next_tick_compare);
+}
+
+#if (configUSE_TICKLESS_IDLE == 1)
+
+/* Upper bound of ticks suppressed at once, keeps the compare value arithmetic in range */
+#define TICKLESS_MAX_SUPPRESSED_TICKS 0xFFFFFFFFUL
+
+/**
+ * @name: vPortSuppressTicksAndSleep
+ * @msg:  Stop the periodic tick and sleep until the next task unblock time or
+ *        another interrupt, then compensate the tick count for the suppressed periods
+ * @param {TickType_t} xExpectedIdleTime, number of ticks no task needs to run for
+ * @return {void}
+ * @note: called by the idle task with the scheduler suspended
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    u64 wakeup_compare;
+    u64 now;
+    TickType_t xModifiableIdleTime;
+    TickType_t xCompleteTickPeriods;
+
+    if (xExpectedIdleTime > TICKLESS_MAX_SUPPRESSED_TICKS)
+    {
+        xExpectedIdleTime = TICKLESS_MAX_SUPPRESSED_TICKS;
+    }
+
+    /* Mask interrupts in the CPU, a pending interrupt still wakes up WFI */
+    portDISABLE_INTERRUPTS();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        portENABLE_INTERRUPTS();
+        return;
+    }
+
+    /* The tick at next_tick_compare is still counted by the tick interrupt,
+       so only the periods after it are suppressed */
+    wakeup_compare = next_tick_compare + (u64)(xExpectedIdleTime - 1) * tick_reload;
+    GenericTimerSetTimerCompareValue(USING_GENERIC_TIMER_ID, wakeup_compare);
+
+    xModifiableIdleTime = xExpectedIdleTime;
+    configPRE_SLEEP_PROCESSING(xModifiableIdleTime);
+    if (xModifiableIdleTime > 0)
+    {
+        __asm volatile("dsb sy" ::: "memory");
+        __asm volatile("wfi");
+        __asm volatile("isb sy" ::: "memory");
+    }
+    configPOST_SLEEP_PROCESSING(xExpectedIdleTime);
+
+    now = GenericTimerRead(USING_GENERIC_TIMER_ID);
+    if (now >= wakeup_compare)
+    {
+        /* The tick interrupt is pending and accounts for the last period */
+        xCompleteTickPeriods = xExpectedIdleTime - 1;
+        next_tick_compare = wakeup_compare;
+    }
+    else
+    {
+        /* Woken up early by another interrupt, count the tick boundaries passed
+           and move the compare value back onto the tick grid */
+        xCompleteTickPeriods = 0;
+        if (now >= next_tick_compare)
+        {
+            xCompleteTickPeriods = (TickType_t)((now - next_tick_compare) / tick_reload) + 1;
+        }
+        next_tick_compare += (u64)xCompleteTickPeriods * tick_reload;
+        GenericTimerSetTimerCompareValue(USING_GENERIC_TIMER_ID, next_tick_compare);
+    }
+
+    vTaskStepTick(xCompleteTickPeriods);
+
+    portENABLE_INTERRUPTS();
 }
 
+#endif
+
 volatile unsigned int gCpuRuntime;
 
 void vApplicationInterruptHandler(uint32_t ulICCIAR)
 {
-    is_in_irq ++;
-    
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    u64 ullStart = ullIrqStatsClock();
+    u64 ullLatency;
+#endif
+
     if (ulICCIAR < 8192)
     {
         /* Interrupts cannot be re-enabled until the source of the interrupt is
@@ -120,6 +228,32 @@ void vApplicationInterruptHandler(uint32_t ulICCIAR)
         ulICCIAR = ulICCIAR & 0x3FFUL;
     }
 
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    /* sample the timer compare value before the handler moves it */
+    ullLatency = ullIrqStatsEntryLatency(ulICCIAR);
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+    /* fast handlers do not touch the kernel, skip the in-irq accounting */
+    if (xIrqFastDispatch(ulICCIAR) == pdTRUE)
+    {
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+        vIrqStatsRecord(ulICCIAR, ullStart, ullLatency);
+#endif
+        return;
+    }
+#endif
+
+    is_in_irq ++;
+
+#ifdef USE_RUN_TIME_COUNTER
+    vRunTimeIsrEnter();
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_KERNEL_TRACE
+    vTraceKernelIsrEnter(ulICCIAR);
+#endif
+
     /* call handler function */
     if (ulICCIAR == USING_GENERIC_TIMER_IRQ_ID)
     {
@@ -131,6 +265,18 @@ void vApplicationInterruptHandler(uint32_t ulICCIAR)
     {
         FExceptionInterruptHandler((void *)(uintptr)ulICCIAR);
     }
+
+#ifdef CONFIG_FREERTOS_USE_KERNEL_TRACE
+    vTraceKernelIsrExit(ulICCIAR);
+#endif
+
+#ifdef USE_RUN_TIME_COUNTER
+    vRunTimeIsrExit();
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    vIrqStatsRecord(ulICCIAR, ullStart, ullLatency);
+#endif
     is_in_irq --;
 }
 
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_hrtimer.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the high-resolution timer on the generic timer
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FREERTOS_USE_HRTIMER
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "ftypes.h"
+#include "fparameters.h"
+#include "fgeneric_timer.h"
+#include "finterrupt.h"
+#include "fsleep.h"
+#include "fassert.h"
+#include "freertos_hrtimer.h"
+
+/* The tick owns one generic timer of the core, the hrtimer queue is multiplexed on the other one */
+#ifdef CONFIG_NON_SECURE_PHYSICAL_TIMER
+    #define HRTIMER_GENERIC_TIMER_ID GENERIC_TIMER_ID1
+    #define HRTIMER_GENERIC_TIMER_IRQ_ID GENERIC_VTIMER_IRQ_NUM
+#elif defined CONFIG_NON_SECURE_VIRTUAL_TIMER
+    #define HRTIMER_GENERIC_TIMER_ID GENERIC_TIMER_ID0
+    #define HRTIMER_GENERIC_TIMER_IRQ_ID GENERIC_TIMER_NS_IRQ_NUM
+#endif
+
+/* notification slot used by vTaskDelayUs, slot 0 is left to the application */
+#define HRTIMER_NOTIFY_INDEX        (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+
+#define HRTIMER_US_PER_SECOND       1000000ULL
+
+/* Each core runs its own image, so the queue below is per core, same as the banked generic timer */
+static HrTimer_t *hrtimer_queue = NULL; /* active timers sorted by expiry */
+static u64 hrtimer_freq = 0;
+
+u64 ullHrTimerGetCount(void)
+{
+    return GenericTimerRead(HRTIMER_GENERIC_TIMER_ID);
+}
+
+u64 ullHrTimerUsToCount(u64 ullUs)
+{
+    u64 freq = (hrtimer_freq != 0) ? hrtimer_freq : GenericTimerFrequecy();
+
+    /* split the product to avoid overflow on long timeouts */
+    return (ullUs / HRTIMER_US_PER_SECOND) * freq +
+           ((ullUs % HRTIMER_US_PER_SECOND) * freq) / HRTIMER_US_PER_SECOND;
+}
+
+u64 ullHrTimerCountToUs(u64 ullCount)
+{
+    u64 freq = (hrtimer_freq != 0) ? hrtimer_freq : GenericTimerFrequecy();
+
+    return (ullCount / freq) * HRTIMER_US_PER_SECOND +
+           ((ullCount % freq) * HRTIMER_US_PER_SECOND) / freq;
+}
+
+/* program the compare value for the queue head, must be called with the queue locked */
+static void HrTimerProgram(void)
+{
+    if (hrtimer_queue != NULL)
+    {
+        GenericTimerSetTimerCompareValue(HRTIMER_GENERIC_TIMER_ID, hrtimer_queue->ullExpires);
+        GenericTimerInterruptEnable(HRTIMER_GENERIC_TIMER_ID);
+    }
+    else
+    {
+        GenericTimerInterruptDisable(HRTIMER_GENERIC_TIMER_ID);
+    }
+}
+
+/* insert in expiry order, timers with equal expiry keep their start order */
+static BaseType_t HrTimerEnqueue(HrTimer_t *pxTimer)
+{
+    HrTimer_t **ppxLink = &hrtimer_queue;
+
+    while ((*ppxLink != NULL) && ((*ppxLink)->ullExpires <= pxTimer->ullExpires))
+    {
+        ppxLink = &(*ppxLink)->pxNext;
+    }
+
+    pxTimer->pxNext = *ppxLink;
+    *ppxLink = pxTimer;
+    pxTimer->ulActive = pdTRUE;
+
+    return (ppxLink == &hrtimer_queue) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t HrTimerDequeue(HrTimer_t *pxTimer)
+{
+    HrTimer_t **ppxLink = &hrtimer_queue;
+
+    while ((*ppxLink != NULL) && (*ppxLink != pxTimer))
+    {
+        ppxLink = &(*ppxLink)->pxNext;
+    }
+
+    if (*ppxLink == NULL)
+    {
+        return pdFALSE;
+    }
+
+    *ppxLink = pxTimer->pxNext;
+    pxTimer->pxNext = NULL;
+    pxTimer->ulActive = pdFALSE;
+
+    return pdTRUE;
+}
+
+static void HrTimerDeferredHandler(void *pvParameter1, uint32_t ulParameter2)
+{
+    HrTimer_t *pxTimer = (HrTimer_t *)pvParameter1;
+    (void)ulParameter2;
+
+    pxTimer->pxCallback(pxTimer->pvArg);
+}
+
+static void HrTimerIrqHandler(s32 vector, void *param)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    UBaseType_t uxSavedMask;
+    HrTimer_t *pxTimer;
+    HrTimerCallback_t pxCallback;
+    void *pvArg;
+    u32 ulMode;
+    u64 now;
+
+    (void)vector;
+    (void)param;
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+    now = ullHrTimerGetCount();
+
+    while ((hrtimer_queue != NULL) && (hrtimer_queue->ullExpires <= now))
+    {
+        pxTimer = hrtimer_queue;
+        hrtimer_queue = pxTimer->pxNext;
+        pxTimer->pxNext = NULL;
+        pxTimer->ulActive = pdFALSE;
+
+        /* sample the callback before the timer is handed back, a one-shot
+           timer may be reused by its owner as soon as the callback runs */
+        pxCallback = pxTimer->pxCallback;
+        pvArg = pxTimer->pvArg;
+        ulMode = pxTimer->ulMode;
+
+        if (pxTimer->ullPeriod != 0)
+        {
+            /* reload from the previous expiry so periodic timers do not drift */
+            pxTimer->ullExpires += pxTimer->ullPeriod;
+            if (pxTimer->ullExpires <= now)
+            {
+                pxTimer->ullExpires = now + pxTimer->ullPeriod;
+            }
+            (void)HrTimerEnqueue(pxTimer);
+        }
+
+        taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+        if (ulMode == HRTIMER_MODE_DEFERRED)
+        {
+            (void)xTimerPendFunctionCallFromISR(HrTimerDeferredHandler, pxTimer, 0, &xHigherPriorityTaskWoken);
+        }
+        else
+        {
+            pxCallback(pvArg);
+        }
+
+        uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+        now = ullHrTimerGetCount();
+    }
+
+    HrTimerProgram();
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @name: vHrTimerSetup
+ * @msg:  Setup the generic timer used by the hrtimer queue of this core
+ * @return {void}
+ * @note: the compare interrupt stays masked until a timer is started
+ */
+void vHrTimerSetup(void)
+{
+    GenericTimerStop(HRTIMER_GENERIC_TIMER_ID);
+    hrtimer_freq = GenericTimerFrequecy();
+    hrtimer_queue = NULL;
+
+    GenericTimerInterruptDisable(HRTIMER_GENERIC_TIMER_ID);
+
+    /* highest priority which may still call FromISR APIs */
+    InterruptSetPriority(HRTIMER_GENERIC_TIMER_IRQ_ID, configMAX_API_CALL_INTERRUPT_PRIORITY);
+    InterruptInstall(HRTIMER_GENERIC_TIMER_IRQ_ID, HrTimerIrqHandler, NULL, "hrtimer");
+    InterruptUmask(HRTIMER_GENERIC_TIMER_IRQ_ID);
+
+    GenericTimerStart(HRTIMER_GENERIC_TIMER_ID);
+}
+
+/**
+ * @name: vHrTimerInit
+ * @msg:  Initialize a timer before it is started
+ * @param {HrTimer_t} *pxTimer, timer instance
+ * @param {HrTimerCallback_t} pxCallback, function called on expiry
+ * @param {void} *pvArg, argument of the callback
+ * @param {u32} ulMode, HRTIMER_MODE_ISR or HRTIMER_MODE_DEFERRED
+ * @return {void}
+ */
+void vHrTimerInit(HrTimer_t *pxTimer, HrTimerCallback_t pxCallback, void *pvArg, u32 ulMode)
+{
+    FASSERT(pxTimer);
+    FASSERT(pxCallback);
+
+    pxTimer->pxNext = NULL;
+    pxTimer->ullExpires = 0;
+    pxTimer->ullPeriod = 0;
+    pxTimer->pxCallback = pxCallback;
+    pxTimer->pvArg = pvArg;
+    pxTimer->ulMode = ulMode;
+    pxTimer->ulActive = pdFALSE;
+}
+
+static BaseType_t HrTimerArm(HrTimer_t *pxTimer, u64 ullExpires, u64 ullPeriod)
+{
+    UBaseType_t uxSavedMask;
+
+    FASSERT(pxTimer);
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+
+    if (pxTimer->ulActive)
+    {
+        (void)HrTimerDequeue(pxTimer);
+    }
+
+    pxTimer->ullExpires = ullExpires;
+    pxTimer->ullPeriod = ullPeriod;
+
+    /* only a new queue head changes the compare value */
+    if (HrTimerEnqueue(pxTimer) == pdTRUE)
+    {
+        HrTimerProgram();
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    return pdPASS;
+}
+
+/**
+ * @name: xHrTimerStart
+ * @msg:  Start or restart a timer relative to now
+ * @param {HrTimer_t} *pxTimer, timer instance
+ * @param {u64} ullTimeoutUs, microseconds until the first expiry
+ * @param {u64} ullPeriodUs, reload period in microseconds, 0 for a one-shot timer
+ * @return {BaseType_t} pdPASS
+ * @note: may be called from tasks and from interrupts
+ */
+BaseType_t xHrTimerStart(HrTimer_t *pxTimer, u64 ullTimeoutUs, u64 ullPeriodUs)
+{
+    return HrTimerArm(pxTimer,
+                      ullHrTimerGetCount() + ullHrTimerUsToCount(ullTimeoutUs),
+                      ullHrTimerUsToCount(ullPeriodUs));
+}
+
+/**
+ * @name: xHrTimerStartAt
+ * @msg:  Start a one-shot timer at an absolute counter value
+ * @param {HrTimer_t} *pxTimer, timer instance
+ * @param {u64} ullExpires, value of ullHrTimerGetCount() to expire at
+ * @return {BaseType_t} pdPASS
+ */
+BaseType_t xHrTimerStartAt(HrTimer_t *pxTimer, u64 ullExpires)
+{
+    return HrTimerArm(pxTimer, ullExpires, 0);
+}
+
+/**
+ * @name: xHrTimerCancel
+ * @msg:  Stop a timer
+ * @param {HrTimer_t} *pxTimer, timer instance
+ * @return {BaseType_t} pdTRUE if the timer was removed before expiry
+ * @note: a deferred callback already pended to the timer task still runs
+ */
+BaseType_t xHrTimerCancel(HrTimer_t *pxTimer)
+{
+    UBaseType_t uxSavedMask;
+    BaseType_t xWasHead;
+    BaseType_t xRet = pdFALSE;
+
+    FASSERT(pxTimer);
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+
+    if (pxTimer->ulActive)
+    {
+        xWasHead = (hrtimer_queue == pxTimer) ? pdTRUE : pdFALSE;
+        xRet = HrTimerDequeue(pxTimer);
+        if (xWasHead)
+        {
+            HrTimerProgram();
+        }
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    return xRet;
+}
+
+static void HrTimerWakeTask(void *pvArg)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    vTaskNotifyGiveIndexedFromISR((TaskHandle_t)pvArg, HRTIMER_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/* blocking is only possible from a task with the scheduler running and no critical section held */
+static BaseType_t HrTimerCanBlock(void)
+{
+    if (xPortIsInsideInterrupt())
+    {
+        return pdFALSE;
+    }
+
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return pdFALSE;
+    }
+
+    if (InterruptGetPriorityMask() == (u32)(configMAX_API_CALL_INTERRUPT_PRIORITY << portPRIORITY_SHIFT))
+    {
+        return pdFALSE;
+    }
+
+    return pdTRUE;
+}
+
+/**
+ * @name: vTaskDelayUs
+ * @msg:  Delay the calling task for a number of microseconds
+ * @param {u32} ulDelayUs, delay in microseconds
+ * @return {void}
+ * @note: short delays and calls from contexts which cannot block fall back to busy waiting
+ */
+void vTaskDelayUs(u32 ulDelayUs)
+{
+    HrTimer_t xTimer;
+
+    if ((ulDelayUs < CONFIG_FREERTOS_HRTIMER_MIN_SLEEP_US) || (hrtimer_freq == 0) ||
+        (HrTimerCanBlock() == pdFALSE))
+    {
+        fsleep_microsec(ulDelayUs);
+        return;
+    }
+
+    vHrTimerInit(&xTimer, HrTimerWakeTask, xTaskGetCurrentTaskHandle(), HRTIMER_MODE_ISR);
+    (void)xHrTimerStart(&xTimer, ulDelayUs, 0);
+
+    /* the timer gives exactly one notification, a give before this point leaves it pending */
+    (void)ulTaskNotifyTakeIndexed(HRTIMER_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+}
+
+#endif /* CONFIG_FREERTOS_USE_HRTIMER */
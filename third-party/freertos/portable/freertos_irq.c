@@ -0,0 +1,527 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_irq.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the fast interrupt dispatch and interrupt statistics
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   reserve the fast slots, add handler time histograms
+ */
+#include "sdkconfig.h"
+
+#if defined(CONFIG_FREERTOS_USE_FAST_IRQ) || defined(CONFIG_FREERTOS_USE_IRQ_STATS)
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "fparameters.h"
+#include "fgeneric_timer.h"
+#include "finterrupt.h"
+#include "fpmu.h"
+#include "fpmu_perf.h"
+#include "freertos_irq.h"
+
+/* SGI, PPI and SPI ids, the same range as isr_table */
+#define IRQ_SLOT_MAP_SIZE       1024U
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+    #define IRQ_FAST_SLOT_NUM   CONFIG_FREERTOS_FAST_IRQ_MAX_NUM
+#else
+    #define IRQ_FAST_SLOT_NUM   0
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    #define IRQ_STATS_SLOT_NUM  CONFIG_FREERTOS_IRQ_STATS_MAX_NUM
+#else
+    #define IRQ_STATS_SLOT_NUM  0
+#endif
+
+/* the fast slots come first, so interrupts only seen by the statistics cannot use them up */
+#define IRQ_SLOT_NUM            (IRQ_FAST_SLOT_NUM + IRQ_STATS_SLOT_NUM)
+
+#ifdef CONFIG_NON_SECURE_PHYSICAL_TIMER
+    #define IRQ_STATS_GENERIC_TIMER_ID GENERIC_TIMER_ID0
+#elif defined CONFIG_NON_SECURE_VIRTUAL_TIMER
+    #define IRQ_STATS_GENERIC_TIMER_ID GENERIC_TIMER_ID1
+#endif
+
+/* one cache line per interrupt keeps the handler, its parameter and its counters together */
+typedef struct
+{
+    IrqHandler pxHandler;   /* fast handler, NULL when the interrupt is only tracked by statistics */
+    void *pvParam;
+    u32 ulIrqId;
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    IrqStats_t xStats;
+#endif
+} __attribute__((aligned(64))) IrqSlot_t;
+
+/* Each core runs its own image, so the table only describes the interrupts taken by this core */
+static IrqSlot_t irq_slots[IRQ_SLOT_NUM];
+static u16 irq_slot_map[IRQ_SLOT_MAP_SIZE]; /* slot index + 1, 0 when the interrupt has no slot */
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+static u32 irq_fast_used = 0;   /* fast slots handed out */
+static u32 irq_fast_num = 0;    /* fast handlers installed */
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+static u32 irq_stats_used = 0;  /* statistics slots handed out */
+static IrqSlot_t irq_lpi_slot;
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+static void IrqStatsClear(IrqStats_t *pxStats, u32 ulIrqId)
+{
+    u32 fast = pxStats->ulFast;
+
+    memset(pxStats, 0, sizeof(IrqStats_t));
+    pxStats->ulIrqId = ulIrqId;
+    pxStats->ulFast = fast;
+    pxStats->ullMinTime = ~0ULL;
+}
+#endif
+
+/* fill a free slot and map the interrupt to it, must be called with interrupts masked */
+static IrqSlot_t *IrqSlotSetup(u32 index, u32 ulIrqId)
+{
+    IrqSlot_t *slot = &irq_slots[index];
+
+    memset(slot, 0, sizeof(IrqSlot_t));
+    slot->ulIrqId = ulIrqId;
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+    IrqStatsClear(&slot->xStats, ulIrqId);
+#endif
+
+    /* the slot is only looked up by this core, publish it after it is filled */
+    portMEMORY_BARRIER();
+    irq_slot_map[ulIrqId] = (u16)(index + 1);
+
+    return slot;
+}
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+/* find or allocate the slot of a fast interrupt, must be called with interrupts masked */
+static IrqSlot_t *IrqFastSlotGet(u32 ulIrqId)
+{
+    u32 index;
+
+    if (irq_slot_map[ulIrqId] != 0)
+    {
+        /* a slot from either pool, the statistics slot of the interrupt takes the handler */
+        return &irq_slots[irq_slot_map[ulIrqId] - 1];
+    }
+
+    if (irq_fast_used < IRQ_FAST_SLOT_NUM)
+    {
+        return IrqSlotSetup(irq_fast_used++, ulIrqId);
+    }
+
+    /* all handed out, take one whose handler was removed, its statistics are lost */
+    for (index = 0; index < IRQ_FAST_SLOT_NUM; index++)
+    {
+        if (irq_slots[index].pxHandler == NULL)
+        {
+            irq_slot_map[irq_slots[index].ulIrqId] = 0;
+            return IrqSlotSetup(index, ulIrqId);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+/* find or allocate the slot of an interrupt seen by the statistics, must be called with interrupts masked */
+static IrqSlot_t *IrqStatsSlotGet(u32 ulIrqId)
+{
+    if (irq_slot_map[ulIrqId] != 0)
+    {
+        return &irq_slots[irq_slot_map[ulIrqId] - 1];
+    }
+
+    if (irq_stats_used >= IRQ_STATS_SLOT_NUM)
+    {
+        return NULL;
+    }
+
+    return IrqSlotSetup(IRQ_FAST_SLOT_NUM + irq_stats_used++, ulIrqId);
+}
+
+static inline boolean IrqSlotUsed(u32 index)
+{
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+    if (index < IRQ_FAST_SLOT_NUM)
+    {
+        return index < irq_fast_used;
+    }
+#endif
+
+    return (index - IRQ_FAST_SLOT_NUM) < irq_stats_used;
+}
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+/**
+ * @name: xIrqInstallFast
+ * @msg:  Install a fast interrupt handler, which is called straight from the interrupt entry
+ * @param {u32} ulIrqId, SGI, PPI or SPI id
+ * @param {IrqHandler} pxHandler, handler to call
+ * @param {void} *pvParam, handler parameter
+ * @return {BaseType_t} pdPASS on success, pdFAIL if the id is invalid or all fast slots are taken
+ * @note: The handler skips the FreeRTOS in-irq accounting, so it must not call any FreeRTOS API.
+ *        Give the interrupt a priority above configMAX_API_CALL_INTERRUPT_PRIORITY to let it
+ *        preempt critical sections.
+ */
+BaseType_t xIrqInstallFast(u32 ulIrqId, IrqHandler pxHandler, void *pvParam)
+{
+    IrqSlot_t *slot;
+    BaseType_t ret = pdFAIL;
+
+    if ((ulIrqId >= IRQ_SLOT_MAP_SIZE) || (pxHandler == NULL))
+    {
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    slot = (irq_slot_map[ulIrqId] != 0) ? &irq_slots[irq_slot_map[ulIrqId] - 1] : NULL;
+    if (((slot != NULL) && (slot->pxHandler != NULL)) || (irq_fast_num < IRQ_FAST_SLOT_NUM))
+    {
+        slot = IrqFastSlotGet(ulIrqId);
+        if (slot != NULL)
+        {
+            if (slot->pxHandler == NULL)
+            {
+                irq_fast_num++;
+            }
+            slot->pvParam = pvParam;
+            portMEMORY_BARRIER();
+            slot->pxHandler = pxHandler;
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+            slot->xStats.ulFast = pdTRUE;
+#endif
+            ret = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return ret;
+}
+
+/**
+ * @name: xIrqRemoveFast
+ * @msg:  Remove a fast interrupt handler, the interrupt goes back to the isr_table dispatch
+ * @param {u32} ulIrqId, SGI, PPI or SPI id
+ * @return {BaseType_t} pdPASS on success, pdFAIL if the interrupt has no fast handler
+ */
+BaseType_t xIrqRemoveFast(u32 ulIrqId)
+{
+    IrqSlot_t *slot;
+    BaseType_t ret = pdFAIL;
+
+    if (ulIrqId >= IRQ_SLOT_MAP_SIZE)
+    {
+        return pdFAIL;
+    }
+
+    taskENTER_CRITICAL();
+    if (irq_slot_map[ulIrqId] != 0)
+    {
+        /* keep the slot, so the statistics survive until another fast interrupt needs it */
+        slot = &irq_slots[irq_slot_map[ulIrqId] - 1];
+        if (slot->pxHandler != NULL)
+        {
+            slot->pxHandler = NULL;
+            irq_fast_num--;
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+            slot->xStats.ulFast = pdFALSE;
+#endif
+            ret = pdPASS;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return ret;
+}
+
+/**
+ * @name: xIrqFastDispatch
+ * @msg:  Call the fast handler of an interrupt
+ * @param {u32} ulIrqId, interrupt id acknowledged from the GIC
+ * @return {BaseType_t} pdTRUE if a fast handler ran, pdFALSE otherwise
+ */
+BaseType_t xIrqFastDispatch(u32 ulIrqId)
+{
+    IrqSlot_t *slot;
+    IrqHandler handler;
+    u16 index;
+
+    if (ulIrqId >= IRQ_SLOT_MAP_SIZE)
+    {
+        return pdFALSE;
+    }
+
+    index = irq_slot_map[ulIrqId];
+    if (index == 0)
+    {
+        return pdFALSE;
+    }
+
+    slot = &irq_slots[index - 1];
+    handler = slot->pxHandler;
+    if (handler == NULL)
+    {
+        return pdFALSE;
+    }
+
+    handler((s32)ulIrqId, slot->pvParam);
+
+    return pdTRUE;
+}
+#endif
+
+#ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+/**
+ * @name: vIrqStatsSetup
+ * @msg:  Start the statistics clock of this core
+ * @return {void}
+ */
+void vIrqStatsSetup(void)
+{
+    IrqStatsClear(&irq_lpi_slot.xStats, IRQ_STATS_LPI_ID);
+
+#ifdef CONFIG_FREERTOS_IRQ_STATS_CLOCK_PMU_CYCLES
+    /* count cycles at every exception level, with a 64 bit overflow */
+    FPmuPmccfiltrSet(0);
+    FPmuEnableCounter(1U << FPMU_CYCLE_COUNT_IDX);
+    FPmuPmcrWrire(FPmuPmcrRead() | FPMU_PMCR_E | FPMU_PMCR_LC);
+#endif
+}
+
+/**
+ * @name: ullIrqStatsClock
+ * @msg:  Read the statistics clock
+ * @return {u64} cpu cycles or generic counter value
+ */
+u64 ullIrqStatsClock(void)
+{
+#ifdef CONFIG_FREERTOS_IRQ_STATS_CLOCK_PMU_CYCLES
+    return FPmuPmccntrGet();
+#else
+    return GenericTimerRead(IRQ_STATS_GENERIC_TIMER_ID);
+#endif
+}
+
+/**
+ * @name: ullIrqStatsClockFrequency
+ * @msg:  Get the frequency of the statistics clock
+ * @return {u64} frequency in Hz, 0 when the clock counts cpu cycles
+ */
+u64 ullIrqStatsClockFrequency(void)
+{
+#ifdef CONFIG_FREERTOS_IRQ_STATS_CLOCK_PMU_CYCLES
+    return 0;
+#else
+    return GenericTimerFrequecy();
+#endif
+}
+
+/* bucket n counts the handler times from 2^n to 2^(n+1) - 1, the last bucket the longer ones */
+static inline u32 IrqStatsHistBucket(u64 elapsed)
+{
+    u32 bucket;
+
+    if (elapsed < 2U)
+    {
+        return 0;
+    }
+
+    bucket = 63U - (u32)__builtin_clzll(elapsed);
+
+    return (bucket < IRQ_STATS_HIST_NUM) ? bucket : (IRQ_STATS_HIST_NUM - 1U);
+}
+
+static inline boolean IrqIsGenericTimer(u32 ulIrqId)
+{
+    return (ulIrqId == GENERIC_TIMER_NS_IRQ_NUM) || (ulIrqId == GENERIC_VTIMER_IRQ_NUM);
+}
+
+/**
+ * @name: ullIrqStatsEntryLatency
+ * @msg:  Get how long ago the generic timer raising this interrupt reached its compare value
+ * @param {u32} ulIrqId, interrupt id acknowledged from the GIC
+ * @return {u64} latency in generic counter cycles, 0 for other interrupts
+ * @note: Must be called before the handler moves the compare value.
+ */
+u64 ullIrqStatsEntryLatency(u32 ulIrqId)
+{
+    u32 timer_id;
+    u64 now, compare;
+
+    if (ulIrqId == GENERIC_TIMER_NS_IRQ_NUM)
+    {
+        timer_id = GENERIC_TIMER_ID0;
+    }
+    else if (ulIrqId == GENERIC_VTIMER_IRQ_NUM)
+    {
+        timer_id = GENERIC_TIMER_ID1;
+    }
+    else
+    {
+        return 0;
+    }
+
+    now = GenericTimerRead(timer_id);
+    compare = GenericTimerGetTimerCompareValue(timer_id);
+
+    return (now > compare) ? (now - compare) : 0;
+}
+
+/**
+ * @name: vIrqStatsRecord
+ * @msg:  Account one handler run of an interrupt
+ * @param {u32} ulIrqId, interrupt id acknowledged from the GIC
+ * @param {u64} ullStart, statistics clock value at interrupt entry
+ * @param {u64} ullLatency, entry latency from ullIrqStatsEntryLatency
+ * @return {void}
+ * @note: The handler time includes the time spent in nested interrupts.
+ */
+void vIrqStatsRecord(u32 ulIrqId, u64 ullStart, u64 ullLatency)
+{
+    u64 elapsed = ullIrqStatsClock() - ullStart;
+    IrqSlot_t *slot;
+    IrqStats_t *stats;
+    UBaseType_t mask;
+
+    if (ulIrqId >= IRQ_STATS_LPI_ID)
+    {
+        /* LPIs of different priorities may nest, their shared entry is approximate */
+        slot = &irq_lpi_slot;
+    }
+    else if (ulIrqId >= IRQ_SLOT_MAP_SIZE)
+    {
+        return;
+    }
+    else if (irq_slot_map[ulIrqId] != 0)
+    {
+        slot = &irq_slots[irq_slot_map[ulIrqId] - 1];
+    }
+    else
+    {
+        /* first time this interrupt is seen, nested interrupts may allocate as well */
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        slot = IrqStatsSlotGet(ulIrqId);
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+        if (slot == NULL)
+        {
+            return;
+        }
+    }
+
+    /* an interrupt does not nest with itself, so its entry is only written from here */
+    stats = &slot->xStats;
+    stats->ullCount++;
+    stats->ullTotalTime += elapsed;
+    stats->ulTimeHist[IrqStatsHistBucket(elapsed)]++;
+    if (elapsed < stats->ullMinTime)
+    {
+        stats->ullMinTime = elapsed;
+    }
+    if (elapsed > stats->ullMaxTime)
+    {
+        stats->ullMaxTime = elapsed;
+    }
+
+    if (IrqIsGenericTimer(ulIrqId))
+    {
+        stats->ullLatencyCount++;
+        stats->ullTotalLatency += ullLatency;
+        if (ullLatency > stats->ullMaxLatency)
+        {
+            stats->ullMaxLatency = ullLatency;
+        }
+    }
+}
+
+/**
+ * @name: ulIrqStatsSnapshot
+ * @msg:  Copy the statistics of the interrupts taken by this core
+ * @param {IrqStats_t} *pxStats, buffer to copy to
+ * @param {u32} ulMaxNum, number of entries in the buffer
+ * @return {u32} number of entries copied
+ */
+u32 ulIrqStatsSnapshot(IrqStats_t *pxStats, u32 ulMaxNum)
+{
+    u32 i, num = 0;
+
+    for (i = 0; (i < IRQ_SLOT_NUM) && (num < ulMaxNum); i++)
+    {
+        if (!IrqSlotUsed(i))
+        {
+            continue;
+        }
+
+        taskENTER_CRITICAL();
+        pxStats[num] = irq_slots[i].xStats;
+        taskEXIT_CRITICAL();
+        num++;
+    }
+
+    if ((num < ulMaxNum) && (irq_lpi_slot.xStats.ullCount != 0))
+    {
+        taskENTER_CRITICAL();
+        pxStats[num] = irq_lpi_slot.xStats;
+        taskEXIT_CRITICAL();
+        num++;
+    }
+
+    return num;
+}
+
+/**
+ * @name: vIrqStatsReset
+ * @msg:  Clear the statistics of all interrupts, fast handlers stay installed
+ * @return {void}
+ */
+void vIrqStatsReset(void)
+{
+    u32 i;
+
+    for (i = 0; i < IRQ_SLOT_NUM; i++)
+    {
+        if (!IrqSlotUsed(i))
+        {
+            continue;
+        }
+
+        taskENTER_CRITICAL();
+        IrqStatsClear(&irq_slots[i].xStats, irq_slots[i].xStats.ulIrqId);
+        taskEXIT_CRITICAL();
+    }
+
+    taskENTER_CRITICAL();
+    IrqStatsClear(&irq_lpi_slot.xStats, IRQ_STATS_LPI_ID);
+    taskEXIT_CRITICAL();
+}
+#endif
+
+#endif
@@ -0,0 +1,441 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_log.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the deferred output of the FT_DEBUG_PRINT_* logs
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FREERTOS_USE_ASYNC_LOG
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "faarch.h"
+#include "fdebug.h"
+#include "fearly_uart.h"
+#include "fcpu_info.h"
+#include "freertos_log.h"
+
+#define LOG_IRQ_FIQ_MASK        0xC0U /* Mask IRQ and FIQ interrupts in cpsr */
+#define LOG_TAG_NAME_LEN        24U
+#define LOG_LINE_EXTRA_LEN      128U  /* color, tag, core number and file name around the text */
+
+/* state of a record */
+#define LOG_RECORD_FREE         0U
+#define LOG_RECORD_RESERVED     1U    /* the caller is still formatting the text */
+#define LOG_RECORD_READY        2U
+
+typedef struct
+{
+    volatile u32 ulState;
+    u32 ulLine;
+    const char *pcTag;             /* tags, colors and file names are string literals */
+    const char *pcColor;
+    const char *pcFile;            /* NULL without CONFIG_LOG_EXTRA_INFO */
+    char cText[CONFIG_FREERTOS_ASYNC_LOG_LINE_SIZE];
+} LogRecord_t;
+
+typedef struct
+{
+    char cName[LOG_TAG_NAME_LEN];
+    u32 ulLevel;
+} LogTag_t;
+
+/*
+ * Each core runs its own image, so the ring below is per core and only shared
+ * between the tasks and interrupt handlers of one core. A caller reserves a
+ * record with the interrupts masked for a few instructions and formats the
+ * text after unmasking them, the drain task prints the records in order.
+ */
+static LogRecord_t log_ring[CONFIG_FREERTOS_ASYNC_LOG_RECORD_NUM];
+static u32 log_head = 0;           /* next record to reserve */
+static u32 log_tail = 0;           /* next record to print */
+static AsyncLogStats_t log_stats = {.ulRecordNum = CONFIG_FREERTOS_ASYNC_LOG_RECORD_NUM};
+static TaskHandle_t log_task = NULL;
+static AsyncLogOutput_t log_output = NULL;
+
+static LogTag_t log_tags[CONFIG_FREERTOS_ASYNC_LOG_TAG_NUM];
+static volatile u32 log_tag_num = 0;
+static volatile u32 log_default_level = LOG_LOCAL_LEVEL;
+
+/* only used by the drain task, or by the caller before the task runs */
+static char log_line[CONFIG_FREERTOS_ASYNC_LOG_LINE_SIZE + LOG_LINE_EXTRA_LEN];
+
+static inline u32 LogNext(u32 ulIndex)
+{
+    return (ulIndex + 1U == CONFIG_FREERTOS_ASYNC_LOG_RECORD_NUM) ? 0U : ulIndex + 1U;
+}
+
+static void LogEarlyUartOutput(const char *pcLine, u32 ulLength)
+{
+    u32 i;
+
+    if (printf_call == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < ulLength; i++)
+    {
+        printf_call((s8)pcLine[i]);
+    }
+}
+
+static void LogOutput(const char *pcLine, u32 ulLength)
+{
+    AsyncLogOutput_t output = log_output;
+
+    if (output != NULL)
+    {
+        output(pcLine, ulLength);
+    }
+    else
+    {
+        LogEarlyUartOutput(pcLine, ulLength);
+    }
+}
+
+static u32 LogTagLevel(const char *pcTag)
+{
+    u32 num = log_tag_num;
+    u32 i;
+
+    for (i = 0; i < num; i++)
+    {
+        if (strncmp(log_tags[i].cName, pcTag, LOG_TAG_NAME_LEN) == 0)
+        {
+            return log_tags[i].ulLevel;
+        }
+    }
+
+    return log_default_level;
+}
+
+/* format a record the way FtDumpLogInfo and FtDumpExtraLogInfo print it */
+static u32 LogCompose(const LogRecord_t *pxRecord, char *pcLine, u32 ulSize)
+{
+    int len = 0;
+
+#if defined(CONFIG_LOG_DISPALY_CORE_NUM)
+    u32 cpu_id;
+
+    GetCpuId(&cpu_id);
+    len = snprintf(pcLine, ulSize, "cpu%d:", (int)cpu_id);
+#endif
+
+    if (pxRecord->pcFile != NULL)
+    {
+        len += snprintf(pcLine + len, ulSize - len, "\033[%sm%s:%s @%s:%d\033[0m \r\n",
+                        pxRecord->pcColor, pxRecord->pcTag, pxRecord->cText,
+                        pxRecord->pcFile, (int)pxRecord->ulLine);
+    }
+    else
+    {
+        len += snprintf(pcLine + len, ulSize - len, "\033[%sm%s:%s\033[0m \r\n",
+                        pxRecord->pcColor, pxRecord->pcTag, pxRecord->cText);
+    }
+
+    return ((u32)len < ulSize) ? (u32)len : ulSize - 1U;
+}
+
+static void LogWrite(const char *pcTag, u32 ulLevel, const char *pcColor, const char *pcFile,
+                     u32 ulLine, const char *pcFormat, va_list xArgs)
+{
+    LogRecord_t *record;
+    LogRecord_t sync_record;
+    u32 currmask;
+    u32 len;
+
+    if (ulLevel > LogTagLevel(pcTag))
+    {
+        return;
+    }
+
+    if (log_task == NULL)
+    {
+        /* no drain task yet, print at once like the default backend */
+        record = &sync_record;
+    }
+    else
+    {
+        currmask = MFCPSR();
+        MTCPSR(currmask | LOG_IRQ_FIQ_MASK);
+
+        if (log_stats.ulUsed == CONFIG_FREERTOS_ASYNC_LOG_RECORD_NUM)
+        {
+            log_stats.ulDropped++;
+            MTCPSR(currmask);
+            return;
+        }
+
+        record = &log_ring[log_head];
+        record->ulState = LOG_RECORD_RESERVED;
+        log_head = LogNext(log_head);
+        log_stats.ulWritten++;
+        log_stats.ulUsed++;
+        if (log_stats.ulUsed > log_stats.ulMaxUsed)
+        {
+            log_stats.ulMaxUsed = log_stats.ulUsed;
+        }
+
+        MTCPSR(currmask);
+    }
+
+    record->pcTag = pcTag;
+    record->pcColor = pcColor;
+    record->pcFile = pcFile;
+    record->ulLine = ulLine;
+    vsnprintf(record->cText, sizeof(record->cText), pcFormat, xArgs);
+
+    if (record == &sync_record)
+    {
+        LOG_SPIN_LOCK();
+        len = LogCompose(record, log_line, sizeof(log_line));
+        LogOutput(log_line, len);
+        LOG_SPIN_UNLOCK();
+        return;
+    }
+
+    /* the drain task must not see the state before the text */
+    __asm__ __volatile__("" ::: "memory");
+    record->ulState = LOG_RECORD_READY;
+}
+
+void FtDumpLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
+                   const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    LogWrite(tag, log_level, log_tag_letter, NULL, 0, fmt, ap);
+    va_end(ap);
+}
+
+void FtDumpExtraLogInfo(const char *tag, u32 log_level, const char *log_tag_letter,
+                        const char *file_name, u32 line, const char *fmt, ...)
+{
+    va_list ap;
+
+    va_start(ap, fmt);
+    LogWrite(tag, log_level, log_tag_letter, file_name, line, fmt, ap);
+    va_end(ap);
+}
+
+/* the oldest record if its text is complete */
+static LogRecord_t *LogPeek(void)
+{
+    LogRecord_t *record = NULL;
+    u32 currmask;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | LOG_IRQ_FIQ_MASK);
+    if ((log_stats.ulUsed != 0) && (log_ring[log_tail].ulState == LOG_RECORD_READY))
+    {
+        record = &log_ring[log_tail];
+    }
+    MTCPSR(currmask);
+
+    return record;
+}
+
+static void LogRelease(LogRecord_t *pxRecord)
+{
+    u32 currmask;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | LOG_IRQ_FIQ_MASK);
+    pxRecord->ulState = LOG_RECORD_FREE;
+    log_tail = LogNext(log_tail);
+    log_stats.ulUsed--;
+    MTCPSR(currmask);
+}
+
+static void LogDrainTask(void *pvParameters)
+{
+    u32 reported_drops = 0;
+    LogRecord_t *record;
+    u32 dropped;
+    u32 len;
+
+    (void)pvParameters;
+
+    for (;;)
+    {
+        /* the callers never wake the task up, so logging does not change their timing */
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_FREERTOS_ASYNC_LOG_PERIOD_MS));
+
+        dropped = log_stats.ulDropped;
+        if (dropped != reported_drops)
+        {
+            len = (u32)snprintf(log_line, sizeof(log_line), "\033[%sm%s:%lu records dropped\033[0m \r\n",
+                                LOG_COLOR_BROWN, "ASYNC_LOG", (unsigned long)(dropped - reported_drops));
+            LOG_SPIN_LOCK();
+            LogOutput(log_line, len);
+            LOG_SPIN_UNLOCK();
+            reported_drops = dropped;
+        }
+
+        /* stop at a record whose caller was preempted while formatting, keeps the order */
+        while ((record = LogPeek()) != NULL)
+        {
+            len = LogCompose(record, log_line, sizeof(log_line));
+            LOG_SPIN_LOCK();
+            LogOutput(log_line, len);
+            LOG_SPIN_UNLOCK();
+            LogRelease(record);
+        }
+    }
+}
+
+/**
+ * @name: xAsyncLogInit
+ * @msg: Create the task that prints the queued logs of this core
+ * @return {BaseType_t} pdPASS, or pdFAIL if the task could not be created
+ * @note: may be called more than once, the logs are printed synchronously before
+ */
+BaseType_t xAsyncLogInit(void)
+{
+    TaskHandle_t task;
+
+    if (log_task != NULL)
+    {
+        return pdPASS;
+    }
+
+    if (xTaskCreate(LogDrainTask, "log", CONFIG_FREERTOS_ASYNC_LOG_TASK_STACK_DEPTH, NULL,
+                    CONFIG_FREERTOS_ASYNC_LOG_TASK_PRIORITY, &task) != pdPASS)
+    {
+        return pdFAIL;
+    }
+
+    log_task = task;
+
+    return pdPASS;
+}
+
+void vAsyncLogSetOutput(AsyncLogOutput_t pxOutput)
+{
+    log_output = pxOutput;
+}
+
+/**
+ * @name: xAsyncLogSetLevel
+ * @msg: Set the level a tag is printed up to
+ * @param {char} *pcTag, tag of FT_DEBUG_PRINT_*, "*" for the tags without an own level
+ * @param {u32} ulLevel, FT_LOG_NONE to FT_LOG_VERBOSE
+ * @return {BaseType_t} pdPASS, or pdFAIL if the tag table is full
+ * @note: messages above the build level LOG_LOCAL_LEVEL stay compiled out
+ */
+BaseType_t xAsyncLogSetLevel(const char *pcTag, u32 ulLevel)
+{
+    u32 num = log_tag_num;
+    u32 i;
+
+    if (strcmp(pcTag, "*") == 0)
+    {
+        log_default_level = ulLevel;
+        return pdPASS;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if (strncmp(log_tags[i].cName, pcTag, LOG_TAG_NAME_LEN) == 0)
+        {
+            log_tags[i].ulLevel = ulLevel;
+            return pdPASS;
+        }
+    }
+
+    if (num == CONFIG_FREERTOS_ASYNC_LOG_TAG_NUM)
+    {
+        return pdFAIL;
+    }
+
+    /* entries are only appended, the callers read the table without a lock */
+    strncpy(log_tags[num].cName, pcTag, LOG_TAG_NAME_LEN - 1U);
+    log_tags[num].ulLevel = ulLevel;
+    __asm__ __volatile__("" ::: "memory");
+    log_tag_num = num + 1U;
+
+    return pdPASS;
+}
+
+u32 ulAsyncLogGetLevel(const char *pcTag)
+{
+    return (strcmp(pcTag, "*") == 0) ? log_default_level : LogTagLevel(pcTag);
+}
+
+BaseType_t xAsyncLogGetTag(u32 ulIndex, const char **ppcTag, u32 *pulLevel)
+{
+    if (ulIndex >= log_tag_num)
+    {
+        return pdFALSE;
+    }
+
+    *ppcTag = log_tags[ulIndex].cName;
+    *pulLevel = log_tags[ulIndex].ulLevel;
+
+    return pdTRUE;
+}
+
+void vAsyncLogGetStats(AsyncLogStats_t *pxStats)
+{
+    u32 currmask;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | LOG_IRQ_FIQ_MASK);
+    *pxStats = log_stats;
+    MTCPSR(currmask);
+}
+
+/**
+ * @name: vAsyncLogFlush
+ * @msg: Print the queued records at once with the interrupts masked
+ * @return {void}
+ * @note: for fault handlers, it neither takes the log lock nor waits for the
+ *        drain task, a line the task is printing may show up twice
+ */
+void vAsyncLogFlush(void)
+{
+    LogRecord_t *record;
+    u32 currmask;
+    u32 len;
+
+    currmask = MFCPSR();
+    MTCPSR(currmask | LOG_IRQ_FIQ_MASK);
+
+    while ((record = LogPeek()) != NULL)
+    {
+        len = LogCompose(record, log_line, sizeof(log_line));
+        LogOutput(log_line, len);
+        LogRelease(record);
+    }
+
+    MTCPSR(currmask);
+}
+
+#endif
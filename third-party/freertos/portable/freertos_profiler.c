@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_profiler.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the PMU overflow sampling profiler
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FREERTOS_USE_PMU_PROFILER
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "faarch.h"
+#include "fparameters.h"
+#include "finterrupt.h"
+#include "fpmu.h"
+#include "fpmu_perf.h"
+#include "freertos_profiler.h"
+#if PROFILER_STACK_DEPTH > 0
+#include "backtrace.h"
+#endif
+
+#define PROFILER_SAMPLE_NUM         CONFIG_FREERTOS_PROFILER_SAMPLE_NUM
+
+/* largest stack frame the unwind steps over */
+#define PROFILER_MAX_FRAME_SIZE     0x10000U
+
+/* registers pushed by FreeRTOS_IRQ_Handler, see portASM.S */
+#define PROFILER_FRAME_ELR          0
+#define PROFILER_FRAME_SPSR         1
+#define PROFILER_FRAME_X29          2
+#define PROFILER_FRAME_X30          3
+
+/* SPSR.M[0], the interrupted context ran on SP_ELx */
+#define PROFILER_SPSR_SPX           0x1U
+
+extern void * volatile pvPortInterruptFrame;
+
+/*
+ * Each core runs its own image, so the buffer holds the samples of this core.
+ * The PMU cycle counter keeps running for the run time and interrupt
+ * statistics, sampling takes the last event counter and leaves the others to
+ * FPmu users.
+ */
+static ProfilerSample_t profiler_samples[PROFILER_SAMPLE_NUM];
+static volatile u32 profiler_sample_num = 0;
+static volatile u32 profiler_running = 0;
+static u32 profiler_event_id = 0;
+static u32 profiler_period = 0;
+static u32 profiler_counter_id = 0;
+static u32 profiler_irq_installed = 0;
+
+#if PROFILER_STACK_DEPTH > 0
+static u32 ProfilerUnwind(const u64 *frame, uintptr *stack)
+{
+    uintptr fp = (uintptr)frame[PROFILER_FRAME_X29];
+    uintptr sp;
+
+    /* tasks run on SP_EL0, interrupted code on SP_ELx sits above the frame */
+    if (frame[PROFILER_FRAME_SPSR] & PROFILER_SPSR_SPX)
+    {
+        sp = (uintptr)frame;
+    }
+    else
+    {
+        sp = (uintptr)AARCH64_READ_SYSREG(sp_el0);
+    }
+
+    /* X29 may hold anything in code built without frame pointers */
+    if ((fp < sp) || (fp - sp > PROFILER_MAX_FRAME_SIZE))
+    {
+        return 0;
+    }
+
+    return backtrace_collect((void *)fp, stack, PROFILER_STACK_DEPTH, PROFILER_MAX_FRAME_SIZE);
+}
+#endif
+
+static void ProfilerIrqHandler(s32 vector, void *param)
+{
+    u32 mask = 1U << profiler_counter_id;
+    const u64 *frame;
+    ProfilerSample_t *sample;
+
+    (void)vector;
+    (void)param;
+
+    if ((FPmuGetRestIrqFlags() & mask) == 0)
+    {
+        return;
+    }
+
+    /* keep the events counted since the overflow */
+    FPmuWriteCycleCnt(profiler_counter_id,
+                      FPMU_PERIOD_CALC_32BIT(profiler_period) + FPmuReadCycleCnt(profiler_counter_id));
+
+    frame = (const u64 *)pvPortInterruptFrame;
+    if (!profiler_running || (frame == NULL))
+    {
+        return;
+    }
+
+    sample = &profiler_samples[profiler_sample_num];
+    sample->ullPc = frame[PROFILER_FRAME_ELR];
+    sample->ullLr = frame[PROFILER_FRAME_X30];
+    sample->pvTask = (void *)xTaskGetCurrentTaskHandle();
+#if PROFILER_STACK_DEPTH > 0
+    sample->ulDepth = ProfilerUnwind(frame, sample->uxStack);
+#else
+    sample->ulDepth = 0;
+#endif
+
+    if (++profiler_sample_num >= PROFILER_SAMPLE_NUM)
+    {
+        /* the buffer is full, keep the samples */
+        FPmuDisableCounterMask(mask);
+        FPmuDisableIntens(mask);
+        profiler_running = 0;
+    }
+}
+
+static BaseType_t ProfilerEventSupported(u32 event_id)
+{
+    u64 pmceid;
+
+    if (event_id >= 64U)
+    {
+        return pdFALSE;
+    }
+
+    pmceid = (event_id < 32U) ? FPmuPmceid0() : FPmuPmceid1();
+
+    return ((pmceid >> (event_id % 32U)) & 0x1U) ? pdTRUE : pdFALSE;
+}
+
+/**
+ * @name: xProfilerStart
+ * @msg: Start sampling the interrupted context every ulPeriod PMU events
+ * @param {u32} ulEventId, PMU event number, e.g. FPMU_CPU_CYCLES_ID or FPMU_L1D_CACHE_REFILL_ID
+ * @param {u32} ulPeriod, events between two samples
+ * @return {BaseType_t} pdPASS, or pdFAIL when the PMU has no event counter or lacks the event
+ * @note: the samples of the previous run are discarded, sampling stops when the buffer is full
+ */
+BaseType_t xProfilerStart(u32 ulEventId, u32 ulPeriod)
+{
+    u32 counter_num = PMCR_GET_N(FPmuPmcrRead());
+    u32 mask;
+
+    if ((counter_num == 0) || (ulPeriod == 0) || (ProfilerEventSupported(ulEventId) != pdTRUE))
+    {
+        return pdFAIL;
+    }
+
+    vProfilerStop();
+
+    profiler_counter_id = counter_num - 1U;
+    profiler_event_id = ulEventId;
+    profiler_period = ulPeriod;
+    profiler_sample_num = 0;
+    mask = 1U << profiler_counter_id;
+
+    if (!profiler_irq_installed)
+    {
+        InterruptSetPriority(FPMU_IRQ_NUM, configMAX_API_CALL_INTERRUPT_PRIORITY);
+        InterruptInstall(FPMU_IRQ_NUM, ProfilerIrqHandler, NULL, "profiler");
+        profiler_irq_installed = 1;
+    }
+
+    /* count at EL0 and EL1, do not reset the other counters */
+    FPmuDisableCounterMask(mask);
+    FPmuDisableIntens(mask);
+    FPmuWriteEventType(profiler_counter_id, ulEventId & FPMU_EVTYPE_EVENT);
+    FPmuWriteCycleCnt(profiler_counter_id, FPMU_PERIOD_CALC_32BIT(ulPeriod));
+
+    profiler_running = 1;
+    FPmuEnableEventIrq(mask);
+    FPmuEnableCounter(mask);
+    FPmuPmcrWrire(FPmuPmcrRead() | FPMU_PMCR_E);
+    InterruptUmask(FPMU_IRQ_NUM);
+
+    return pdPASS;
+}
+
+/**
+ * @name: vProfilerStop
+ * @msg: Stop sampling, the samples stay in the buffer until the next start
+ * @return {void}
+ */
+void vProfilerStop(void)
+{
+    u32 mask = 1U << profiler_counter_id;
+
+    if (!profiler_irq_installed)
+    {
+        return;
+    }
+
+    InterruptMask(FPMU_IRQ_NUM);
+    FPmuDisableCounterMask(mask);
+    FPmuDisableIntens(mask);
+    profiler_running = 0;
+}
+
+void vProfilerGetStatus(ProfilerStatus_t *pxStatus)
+{
+    configASSERT(pxStatus != NULL);
+
+    pxStatus->ulRunning = profiler_running;
+    pxStatus->ulEventId = profiler_event_id;
+    pxStatus->ulPeriod = profiler_period;
+    pxStatus->ulSampleNum = profiler_sample_num;
+    pxStatus->ulSampleMax = PROFILER_SAMPLE_NUM;
+    pxStatus->ulCounterId = profiler_counter_id;
+}
+
+const ProfilerSample_t *pxProfilerGetSamples(u32 *pulNum)
+{
+    configASSERT(pulNum != NULL);
+
+    *pulNum = profiler_sample_num;
+
+    return profiler_samples;
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_runtime.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the task run time counters on the generic timer or the PMU
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sdkconfig.h"
+
+#if defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_GENERIC_COUNTER) || defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES)
+
+#include "ftypes.h"
+#include "fgeneric_timer.h"
+#include "fpmu.h"
+#include "fpmu_perf.h"
+#include "freertos_runtime.h"
+
+#ifdef CONFIG_NON_SECURE_PHYSICAL_TIMER
+    #define RUN_TIME_GENERIC_TIMER_ID GENERIC_TIMER_ID0
+#elif defined CONFIG_NON_SECURE_VIRTUAL_TIMER
+    #define RUN_TIME_GENERIC_TIMER_ID GENERIC_TIMER_ID1
+#endif
+
+void *pvRunTimePrevTCB = NULL;
+
+/* each core runs its own image, so these describe the calling core */
+static u64 run_time_start = 0;
+static u64 run_time_isr = 0;        /* accumulated interrupt time */
+static u64 run_time_isr_entry = 0;  /* clock at the entry of the outermost interrupt */
+static u32 run_time_isr_nesting = 0;
+
+static inline u64 RunTimeClock(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES
+    return FPmuPmccntrGet();
+#else
+    return GenericTimerRead(RUN_TIME_GENERIC_TIMER_ID);
+#endif
+}
+
+/**
+ * @name: vRunTimeStatsSetup
+ * @msg:  Start the run time clock of this core
+ * @return {void}
+ */
+void vRunTimeStatsSetup(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES
+    /* count cycles at every exception level, with a 64 bit overflow */
+    FPmuPmccfiltrSet(0);
+    FPmuEnableCounter(1U << FPMU_CYCLE_COUNT_IDX);
+    FPmuPmcrWrire(FPmuPmcrRead() | FPMU_PMCR_E | FPMU_PMCR_LC);
+#endif
+
+    run_time_isr = 0;
+    run_time_isr_nesting = 0;
+    run_time_start = RunTimeClock();
+}
+
+/**
+ * @name: ullRunTimeCounter
+ * @msg:  Read the counter the kernel charges to the running task
+ * @return {u64} clock value with the interrupt time taken out
+ * @note: inside an interrupt the counter stays at the value of the interrupt entry
+ */
+u64 ullRunTimeCounter(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_EXCLUDE_ISR
+    UBaseType_t saved_mask;
+    u64 counter;
+
+    saved_mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if (run_time_isr_nesting != 0)
+    {
+        counter = run_time_isr_entry - run_time_isr;
+    }
+    else
+    {
+        counter = RunTimeClock() - run_time_isr;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved_mask);
+
+    return counter - run_time_start;
+#else
+    return RunTimeClock() - run_time_start;
+#endif
+}
+
+u64 ullRunTimeIsrTime(void)
+{
+    return run_time_isr;
+}
+
+u64 ullRunTimeTotal(void)
+{
+    return RunTimeClock() - run_time_start;
+}
+
+u64 ullRunTimeFrequency(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES
+    return 0;
+#else
+    return GenericTimerFrequecy();
+#endif
+}
+
+void vRunTimeIsrEnter(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_EXCLUDE_ISR
+    if (run_time_isr_nesting++ == 0)
+    {
+        run_time_isr_entry = RunTimeClock();
+    }
+#endif
+}
+
+void vRunTimeIsrExit(void)
+{
+#ifdef CONFIG_FREERTOS_RUN_TIME_STATS_EXCLUDE_ISR
+    if (--run_time_isr_nesting == 0)
+    {
+        run_time_isr += RunTimeClock() - run_time_isr_entry;
+    }
+#endif
+}
+
+#endif
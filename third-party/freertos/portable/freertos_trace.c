@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_trace.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for recording kernel events into the binary trace ring
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FREERTOS_USE_KERNEL_TRACE
+
+#include "freertos_trace.h"
+
+/* number of args holding the task name of a create event */
+#define TRACE_TASK_NAME_ARGS    3U
+
+volatile u32 ulTraceKernelMask = TRACE_KERNEL_CLASS_ALL;
+
+/* task switched out by the context switch in progress */
+static void *trace_prev_tcb = NULL;
+
+void vTraceKernelSetMask(u32 ulMask)
+{
+    ulTraceKernelMask = ulMask;
+}
+
+/**
+ * @name: vTraceKernelSwitchedOut
+ * @msg: remember the task leaving the cpu, the switch is recorded when the next task is known
+ * @param {void} *pvTCB, current task
+ */
+void vTraceKernelSwitchedOut(void *pvTCB)
+{
+    trace_prev_tcb = pvTCB;
+}
+
+/**
+ * @name: vTraceKernelSwitchedIn
+ * @msg: record a context switch, nothing is recorded when the same task keeps running
+ * @param {void} *pvTCB, task selected to run
+ * @param {u32} ulPriority, its priority
+ */
+void vTraceKernelSwitchedIn(void *pvTCB, u32 ulPriority)
+{
+    u64 ullArgs[3];
+
+    if ((pvTCB == trace_prev_tcb) || !(ulTraceKernelMask & TRACE_KERNEL_CLASS_TASK))
+    {
+        return;
+    }
+
+    ullArgs[0] = (u64)(uintptr)trace_prev_tcb;
+    ullArgs[1] = (u64)(uintptr)pvTCB;
+    ullArgs[2] = ulPriority;
+    FTraceRingWrite(TRACE_KERNEL_TASK_SWITCH, 0U, "switch %p -> %p prio %lu", 3U, ullArgs);
+
+    trace_prev_tcb = pvTCB;
+}
+
+/**
+ * @name: vTraceKernelTaskCreate
+ * @msg: record a new task, the name is copied into the record as it lives in the tcb
+ * @param {void} *pvTCB, new task
+ * @param {u32} ulPriority, its priority
+ * @param {const char} *pcName, its name
+ */
+void vTraceKernelTaskCreate(void *pvTCB, u32 ulPriority, const char *pcName)
+{
+    u64 ullArgs[2 + TRACE_TASK_NAME_ARGS] = {0};
+
+    if (!(ulTraceKernelMask & TRACE_KERNEL_CLASS_TASK))
+    {
+        return;
+    }
+
+    ullArgs[0] = (u64)(uintptr)pvTCB;
+    ullArgs[1] = ulPriority;
+    strncpy((char *)&ullArgs[2], pcName, TRACE_TASK_NAME_ARGS * sizeof(u64) - 1);
+    FTraceRingWrite(TRACE_KERNEL_TASK_CREATE, 0U, "task create %p prio %lu", 2U + TRACE_TASK_NAME_ARGS, ullArgs);
+}
+
+void vTraceKernelIsrEnter(u32 ulIrqId)
+{
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_ISR, TRACE_KERNEL_ISR_ENTER, "irq %lu enter", ulIrqId, 0U);
+}
+
+void vTraceKernelIsrExit(u32 ulIrqId)
+{
+    vTraceKernelEvent(TRACE_KERNEL_CLASS_ISR, TRACE_KERNEL_ISR_EXIT, "irq %lu exit", ulIrqId, 0U);
+}
+
+/**
+ * @name: vTraceKernelDumpTasks
+ * @msg: record a create event for every existing task
+ * @return {*}
+ * @note: call it before a ring is dumped when the create events may have been overwritten
+ */
+void vTraceKernelDumpTasks(void)
+{
+#if (configUSE_TRACE_FACILITY == 1)
+    TaskStatus_t *pxStatus;
+    UBaseType_t uxNum, i;
+
+    uxNum = uxTaskGetNumberOfTasks();
+    pxStatus = pvPortMalloc(uxNum * sizeof(TaskStatus_t));
+    if (pxStatus == NULL)
+    {
+        return;
+    }
+
+    uxNum = uxTaskGetSystemState(pxStatus, uxNum, NULL);
+    for (i = 0; i < uxNum; i++)
+    {
+        vTraceKernelTaskCreate((void *)pxStatus[i].xHandle, (u32)pxStatus[i].uxCurrentPriority,
+                               pxStatus[i].pcTaskName);
+    }
+
+    vPortFree(pxStatus);
+#endif
+}
+
+#endif
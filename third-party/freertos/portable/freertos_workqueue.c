@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: freertos_workqueue.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the deferred work queues and their worker tasks
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include "sdkconfig.h"
+
+#ifdef CONFIG_FREERTOS_USE_WORKQUEUE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "fassert.h"
+#include "freertos_workqueue.h"
+
+typedef struct
+{
+    Work_t *pxHead;                 /* run list, in submission order */
+    Work_t *pxTail;
+    Work_t *pxDelayed;              /* delayed list, sorted by wake tick */
+    TaskHandle_t xTask;
+    WorkQueueStats_t xStats;
+} WorkQueue_t;
+
+static const char *const workqueue_name[WORKQUEUE_NUM] = {"wq_high", "wq_low"};
+static const UBaseType_t workqueue_priority[WORKQUEUE_NUM] =
+{
+    CONFIG_FREERTOS_WORKQUEUE_HIGH_PRIORITY,
+    CONFIG_FREERTOS_WORKQUEUE_LOW_PRIORITY
+};
+
+/* Each core runs its own image, so the worker tasks and lists below are per core */
+static WorkQueue_t workqueue[WORKQUEUE_NUM];
+
+/* a tick at or before now has been reached, the difference handles the tick count wrap */
+static inline BaseType_t WorkTickReached(TickType_t xTick, TickType_t xNow)
+{
+    return ((TickType_t)(xNow - xTick) < (portMAX_DELAY >> 1)) ? pdTRUE : pdFALSE;
+}
+
+/* the helpers below must be called with the queue locked */
+static void WorkAppend(WorkQueue_t *pxQueue, Work_t *pxWork)
+{
+    pxWork->pxNext = NULL;
+    if (pxQueue->pxTail != NULL)
+    {
+        pxQueue->pxTail->pxNext = pxWork;
+    }
+    else
+    {
+        pxQueue->pxHead = pxWork;
+    }
+    pxQueue->pxTail = pxWork;
+    pxWork->ulState = WORK_STATE_PENDING;
+}
+
+static void WorkInsertDelayed(WorkQueue_t *pxQueue, Work_t *pxWork, TickType_t xNow)
+{
+    Work_t **ppxLink = &pxQueue->pxDelayed;
+
+    /* compare the remaining time, so the order survives the tick count wrap */
+    while ((*ppxLink != NULL) &&
+           ((TickType_t)((*ppxLink)->xWakeTick - xNow) <= (TickType_t)(pxWork->xWakeTick - xNow)))
+    {
+        ppxLink = &(*ppxLink)->pxNext;
+    }
+
+    pxWork->pxNext = *ppxLink;
+    *ppxLink = pxWork;
+    pxWork->ulState = WORK_STATE_DELAYED;
+}
+
+static BaseType_t WorkUnlink(Work_t **ppxHead, Work_t *pxWork, Work_t **ppxPrev)
+{
+    Work_t **ppxLink = ppxHead;
+    Work_t *prev = NULL;
+
+    while ((*ppxLink != NULL) && (*ppxLink != pxWork))
+    {
+        prev = *ppxLink;
+        ppxLink = &(*ppxLink)->pxNext;
+    }
+
+    if (*ppxLink == NULL)
+    {
+        return pdFALSE;
+    }
+
+    *ppxLink = pxWork->pxNext;
+    pxWork->pxNext = NULL;
+    if (ppxPrev != NULL)
+    {
+        *ppxPrev = prev;
+    }
+
+    return pdTRUE;
+}
+
+static void WorkRemove(WorkQueue_t *pxQueue, Work_t *pxWork)
+{
+    Work_t *prev = NULL;
+
+    if (pxWork->ulState == WORK_STATE_PENDING)
+    {
+        if ((WorkUnlink(&pxQueue->pxHead, pxWork, &prev) == pdTRUE) && (pxQueue->pxTail == pxWork))
+        {
+            pxQueue->pxTail = prev;
+        }
+    }
+    else if (pxWork->ulState == WORK_STATE_DELAYED)
+    {
+        (void)WorkUnlink(&pxQueue->pxDelayed, pxWork, NULL);
+    }
+
+    pxWork->ulState = WORK_STATE_IDLE;
+}
+
+static void WorkQueueWake(WorkQueue_t *pxQueue)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (pxQueue->xTask == NULL)
+    {
+        /* the worker drains its lists when it is created */
+        return;
+    }
+
+    if (xPortIsInsideInterrupt())
+    {
+        vTaskNotifyGiveFromISR(pxQueue->xTask, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    else
+    {
+        (void)xTaskNotifyGive(pxQueue->xTask);
+    }
+}
+
+/* run what is due, returns the ticks to wait for the next delayed work */
+static TickType_t WorkQueueProcess(WorkQueue_t *pxQueue)
+{
+    UBaseType_t uxSavedMask;
+    WorkFunction_t function;
+    TickType_t now, timeout;
+    Work_t *work;
+    void *arg;
+
+    for (;;)
+    {
+        uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+        now = xTaskGetTickCountFromISR();
+
+        while ((pxQueue->pxDelayed != NULL) && WorkTickReached(pxQueue->pxDelayed->xWakeTick, now))
+        {
+            work = pxQueue->pxDelayed;
+            pxQueue->pxDelayed = work->pxNext;
+            WorkAppend(pxQueue, work);
+        }
+
+        work = pxQueue->pxHead;
+        if (work == NULL)
+        {
+            timeout = (pxQueue->pxDelayed != NULL) ? (TickType_t)(pxQueue->pxDelayed->xWakeTick - now) : portMAX_DELAY;
+            taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+            return timeout;
+        }
+
+        pxQueue->pxHead = work->pxNext;
+        if (pxQueue->pxHead == NULL)
+        {
+            pxQueue->pxTail = NULL;
+        }
+        work->pxNext = NULL;
+
+        /* idle before it runs, so a submission from now on runs it again */
+        function = work->pxFunction;
+        arg = work->pvArg;
+        work->ulState = WORK_STATE_IDLE;
+        pxQueue->xStats.ulExecuted++;
+        taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+        function(arg);
+    }
+}
+
+static void WorkQueueTask(void *pvParameters)
+{
+    WorkQueue_t *queue = (WorkQueue_t *)pvParameters;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, WorkQueueProcess(queue));
+    }
+}
+
+/**
+ * @name: xWorkQueueInit
+ * @msg:  Create the worker tasks of this core
+ * @return {BaseType_t} pdPASS on success, pdFAIL if a worker task could not be created
+ * @note: Drivers call it at init, only the first call creates the tasks.
+ */
+BaseType_t xWorkQueueInit(void)
+{
+    BaseType_t ret = pdPASS;
+    TaskHandle_t task;
+    u32 i;
+
+    vTaskSuspendAll();
+    for (i = 0; i < WORKQUEUE_NUM; i++)
+    {
+        if (workqueue[i].xTask != NULL)
+        {
+            continue;
+        }
+
+        if (xTaskCreate(WorkQueueTask, workqueue_name[i], CONFIG_FREERTOS_WORKQUEUE_STACK_DEPTH,
+                        &workqueue[i], workqueue_priority[i], &task) != pdPASS)
+        {
+            ret = pdFAIL;
+            break;
+        }
+
+        taskENTER_CRITICAL();
+        workqueue[i].xTask = task;
+        taskEXIT_CRITICAL();
+    }
+    (void)xTaskResumeAll();
+
+    return ret;
+}
+
+/**
+ * @name: vWorkInit
+ * @msg:  Initialize a work item before it is queued
+ * @param {Work_t} *pxWork, work item
+ * @param {WorkFunction_t} pxFunction, function run by the worker task
+ * @param {void} *pvArg, argument of the function
+ * @param {u32} ulQueue, WORKQUEUE_HIGH or WORKQUEUE_LOW
+ * @return {void}
+ */
+void vWorkInit(Work_t *pxWork, WorkFunction_t pxFunction, void *pvArg, u32 ulQueue)
+{
+    FASSERT(pxWork);
+    FASSERT(pxFunction);
+    FASSERT(ulQueue < WORKQUEUE_NUM);
+
+    pxWork->pxNext = NULL;
+    pxWork->pxFunction = pxFunction;
+    pxWork->pvArg = pvArg;
+    pxWork->xWakeTick = 0;
+    pxWork->ulQueue = ulQueue;
+    pxWork->ulState = WORK_STATE_IDLE;
+}
+
+/**
+ * @name: xWorkQueue
+ * @msg:  Queue a work item to run on its worker task
+ * @param {Work_t} *pxWork, work item
+ * @return {BaseType_t} pdTRUE if queued, pdFALSE if it was already pending and the submission is merged
+ * @note: may be called from tasks and from interrupts, a delayed work is pulled in to run now
+ */
+BaseType_t xWorkQueue(Work_t *pxWork)
+{
+    WorkQueue_t *queue;
+    UBaseType_t uxSavedMask;
+    BaseType_t ret = pdTRUE;
+
+    FASSERT(pxWork);
+    queue = &workqueue[pxWork->ulQueue];
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+    if (pxWork->ulState == WORK_STATE_PENDING)
+    {
+        queue->xStats.ulCoalesced++;
+        ret = pdFALSE;
+    }
+    else
+    {
+        WorkRemove(queue, pxWork);
+        WorkAppend(queue, pxWork);
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    if (ret == pdTRUE)
+    {
+        WorkQueueWake(queue);
+    }
+
+    return ret;
+}
+
+/**
+ * @name: xWorkQueueDelayed
+ * @msg:  Queue a work item to run after a number of ticks
+ * @param {Work_t} *pxWork, work item
+ * @param {TickType_t} xDelay, ticks to wait, 0 queues it at once
+ * @return {BaseType_t} pdTRUE if queued, pdFALSE if it was already queued to run no later
+ * @note: may be called from tasks and from interrupts
+ */
+BaseType_t xWorkQueueDelayed(Work_t *pxWork, TickType_t xDelay)
+{
+    WorkQueue_t *queue;
+    UBaseType_t uxSavedMask;
+    BaseType_t ret = pdTRUE;
+    BaseType_t wake = pdFALSE;
+    TickType_t now;
+
+    FASSERT(pxWork);
+
+    if (xDelay == 0)
+    {
+        return xWorkQueue(pxWork);
+    }
+
+    queue = &workqueue[pxWork->ulQueue];
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+    now = xTaskGetTickCountFromISR();
+
+    if ((pxWork->ulState == WORK_STATE_PENDING) ||
+        ((pxWork->ulState == WORK_STATE_DELAYED) &&
+         ((TickType_t)(pxWork->xWakeTick - now) <= xDelay)))
+    {
+        queue->xStats.ulCoalesced++;
+        ret = pdFALSE;
+    }
+    else
+    {
+        WorkRemove(queue, pxWork);
+        pxWork->xWakeTick = now + xDelay;
+        WorkInsertDelayed(queue, pxWork, now);
+        /* only a new list head changes how long the worker sleeps */
+        wake = (queue->pxDelayed == pxWork) ? pdTRUE : pdFALSE;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    if (wake == pdTRUE)
+    {
+        WorkQueueWake(queue);
+    }
+
+    return ret;
+}
+
+/**
+ * @name: xWorkCancel
+ * @msg:  Remove a work item which has not started to run
+ * @param {Work_t} *pxWork, work item
+ * @return {BaseType_t} pdTRUE if it was queued, pdFALSE otherwise
+ * @note: a work function already running is not waited for
+ */
+BaseType_t xWorkCancel(Work_t *pxWork)
+{
+    WorkQueue_t *queue;
+    UBaseType_t uxSavedMask;
+    BaseType_t ret;
+
+    FASSERT(pxWork);
+    queue = &workqueue[pxWork->ulQueue];
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+    ret = (pxWork->ulState != WORK_STATE_IDLE) ? pdTRUE : pdFALSE;
+    WorkRemove(queue, pxWork);
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+
+    return ret;
+}
+
+/**
+ * @name: vWorkQueueGetStats
+ * @msg:  Get the counters of a worker task
+ * @param {u32} ulQueue, WORKQUEUE_HIGH or WORKQUEUE_LOW
+ * @param {WorkQueueStats_t} *pxStats, buffer to copy to
+ * @return {void}
+ */
+void vWorkQueueGetStats(u32 ulQueue, WorkQueueStats_t *pxStats)
+{
+    UBaseType_t uxSavedMask;
+
+    FASSERT(ulQueue < WORKQUEUE_NUM);
+    FASSERT(pxStats);
+
+    uxSavedMask = taskENTER_CRITICAL_FROM_ISR();
+    *pxStats = workqueue[ulQueue].xStats;
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedMask);
+}
+
+#endif /* CONFIG_FREERTOS_USE_WORKQUEUE */
@@ -10,6 +10,10 @@ ifdef CONFIG_USE_FREERTOS
 BUILD_INC_PATH_DIR += $(FSL_SDMMC_OS_DIR)/osa
 endif
 
+ifdef CONFIG_FSL_SDMMC_USE_FSDIF
+BUILD_INC_PATH_DIR += $(FSL_SDMMC_BM_DIR)/host/fsdif
+endif
+
 ifdef CONFIG_FSL_SDMMC_ENABLE_SD
 BUILD_INC_PATH_DIR += $(FSL_SDMMC_BM_DIR)/sd
 endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_blk.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the blk command functions, it shows the block devices and their i/o statistics
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "ftypes.h"
+#include "fgeneric_timer.h"
+#include "fblock_os.h"
+#include "../src/shell.h"
+
+static const char *const blk_op_name[FFREERTOS_BLOCK_OP_NUM] = {"read", "write", "flush"};
+
+static void BlkCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    blk [-r] [name]   show block devices and their i/o statistics\r\n");
+    printf("        -r         reset the statistics after they are shown\r\n");
+    printf("        name       only show this device\r\n");
+}
+
+/* average of total generic timer counts over num, in us */
+static unsigned long BlkAverageUs(u64 total, u32 num)
+{
+    if (num == 0)
+    {
+        return 0;
+    }
+
+    return (unsigned long)((total * 1000000ULL / GenericTimerFrequecy()) / num);
+}
+
+static void BlkShowDev(FFreeRTOSBlockDev *dev, boolean reset)
+{
+    FFreeRTOSBlockStats stats;
+    u32 op;
+
+    FFreeRTOSBlockGetStats(dev, &stats, reset);
+
+    printf("%s: %llu sectors of %lu bytes, queue depth %lu, queued %lu (max %lu), in flight %lu\r\n",
+           dev->name, (unsigned long long)dev->sector_count, (unsigned long)dev->sector_size,
+           (unsigned long)dev->queue_depth, (unsigned long)stats.queued,
+           (unsigned long)stats.max_queued, (unsigned long)stats.in_flight);
+    printf("    %-6s %10s %10s %10s %12s %10s %10s\r\n",
+           "op", "reqs", "ios", "merges", "KiB", "io(us)", "wait(us)");
+    for (op = 0; op < FFREERTOS_BLOCK_OP_NUM; op++)
+    {
+        printf("    %-6s %10lu %10lu %10lu %12llu %10lu %10lu\r\n",
+               blk_op_name[op],
+               (unsigned long)stats.reqs[op],
+               (unsigned long)stats.ios[op],
+               (unsigned long)stats.merges[op],
+               (unsigned long long)(stats.sectors[op] * dev->sector_size / 1024),
+               BlkAverageUs(stats.io_time[op], stats.ios[op]),
+               BlkAverageUs(stats.wait_time[op], stats.reqs[op]));
+    }
+    printf("    errors %lu, deadline expired %lu\r\n",
+           (unsigned long)stats.errors, (unsigned long)stats.expired);
+}
+
+static int BlkCmdEntry(int argc, char *argv[])
+{
+    FFreeRTOSBlockDev *dev;
+    const char *name = NULL;
+    boolean reset = FALSE;
+    u32 i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp(argv[arg], "-r"))
+        {
+            reset = TRUE;
+        }
+        else if ((argv[arg][0] != '-') && (name == NULL))
+        {
+            name = argv[arg];
+        }
+        else
+        {
+            BlkCmdUsage();
+            return -1;
+        }
+    }
+
+    if (name != NULL)
+    {
+        dev = FFreeRTOSBlockFind(name);
+        if (dev == NULL)
+        {
+            printf("No block device %s.\r\n", name);
+            return -1;
+        }
+
+        BlkShowDev(dev, reset);
+        return 0;
+    }
+
+    for (i = 0; (dev = FFreeRTOSBlockGet(i)) != NULL; i++)
+    {
+        BlkShowDev(dev, reset);
+    }
+
+    if (i == 0)
+    {
+        printf("No block device registered.\r\n");
+    }
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), blk, BlkCmdEntry, show block device statistics);
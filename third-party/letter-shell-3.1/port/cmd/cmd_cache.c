@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_cache.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the cache command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "fcache.h"
+#include "fgeneric_timer.h"
+#include "../src/shell.h"
+
+#define CACHE_BENCH_MIN_SIZE    0x1000U
+#define CACHE_BENCH_MAX_SIZE    0x800000U
+#define CACHE_BENCH_ROUNDS      4U
+
+typedef void (*CacheBenchRange)(intptr adr, fsize_t len);
+
+static void CacheCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    cache                       show the line size and the set/way threshold\r\n");
+    printf("    cache threshold <bytes>     take the whole cache from this range size on, 0 never\r\n");
+    printf("    cache bench [max bytes]     time the range operations by address and by set/way\r\n");
+}
+
+static void CacheShow(void)
+{
+    printf("dcache line %lu bytes, set/way threshold 0x%lx\r\n",
+           (unsigned long)FCacheDCacheGetLineSize(),
+           (unsigned long)FCacheDCacheGetRangeThreshold());
+}
+
+static u64 CacheBenchNs(u64 ticks)
+{
+    return ticks * 1000000000ULL / GenericTimerFrequecy();
+}
+
+/* average time of one operation on a dirty buffer, the buffer is written before each round */
+static u64 CacheBenchRangeNs(CacheBenchRange op, u8 *buf, fsize_t len)
+{
+    u64 total = 0;
+    u64 start;
+    u32 i;
+
+    for (i = 0; i < CACHE_BENCH_ROUNDS; i++)
+    {
+        memset(buf, (int)i, len);
+        start = GenericTimerRead(GENERIC_TIMER_ID0);
+        op((intptr)buf, len);
+        total += GenericTimerRead(GENERIC_TIMER_ID0) - start;
+    }
+
+    return CacheBenchNs(total / CACHE_BENCH_ROUNDS);
+}
+
+static u64 CacheBenchSetWayNs(u8 *buf, fsize_t len)
+{
+    u64 total = 0;
+    u64 start;
+    u32 i;
+
+    for (i = 0; i < CACHE_BENCH_ROUNDS; i++)
+    {
+        memset(buf, (int)i, len);
+        start = GenericTimerRead(GENERIC_TIMER_ID0);
+        FCacheDCacheFlush();
+        total += GenericTimerRead(GENERIC_TIMER_ID0) - start;
+    }
+
+    return CacheBenchNs(total / CACHE_BENCH_ROUNDS);
+}
+
+static void CacheBench(fsize_t max_size)
+{
+    fsize_t threshold = FCacheDCacheGetRangeThreshold();
+    fsize_t suggest = 0;
+    fsize_t len;
+    u64 clean_ns, civac_ns, setway_ns;
+    u8 *buf;
+
+    buf = pvPortMalloc(max_size);
+    if (buf == NULL)
+    {
+        printf("cache bench: no memory for 0x%lx bytes\r\n", (unsigned long)max_size);
+        return;
+    }
+
+    /* time the by address loops without the set/way switch */
+    FCacheDCacheSetRangeThreshold(0);
+
+    printf("%10s %14s %14s %14s\r\n", "size", "clean (ns)", "clean+inv (ns)", "set/way (ns)");
+    for (len = CACHE_BENCH_MIN_SIZE; len <= max_size; len <<= 1)
+    {
+        clean_ns = CacheBenchRangeNs(FCacheDCacheFlushRange, buf, len);
+        civac_ns = CacheBenchRangeNs(FCacheDCacheInvalidateRange, buf, len);
+        setway_ns = CacheBenchSetWayNs(buf, len);
+
+        printf("%10lu %14llu %14llu %14llu\r\n", (unsigned long)len, (unsigned long long)clean_ns,
+               (unsigned long long)civac_ns, (unsigned long long)setway_ns);
+
+        if ((suggest == 0) && (setway_ns < clean_ns))
+        {
+            suggest = len;
+        }
+    }
+
+    FCacheDCacheSetRangeThreshold(threshold);
+    vPortFree(buf);
+
+    if (suggest != 0)
+    {
+        printf("set/way is faster from 0x%lx bytes, 'cache threshold 0x%lx' or CONFIG_FCACHE_RANGE_THRESHOLD\r\n",
+               (unsigned long)suggest, (unsigned long)suggest);
+    }
+    else
+    {
+        printf("set/way is not faster up to 0x%lx bytes\r\n", (unsigned long)max_size);
+    }
+}
+
+static int CacheCmdEntry(int argc, char *argv[])
+{
+    fsize_t max_size = CACHE_BENCH_MAX_SIZE;
+
+    if (argc < 2)
+    {
+        CacheShow();
+        return 0;
+    }
+
+    if (!strcmp(argv[1], "threshold") && (argc == 3))
+    {
+        FCacheDCacheSetRangeThreshold((fsize_t)strtoul(argv[2], NULL, 0));
+        CacheShow();
+    }
+    else if (!strcmp(argv[1], "bench") && (argc <= 3))
+    {
+        if (argc == 3)
+        {
+            max_size = (fsize_t)strtoul(argv[2], NULL, 0);
+        }
+
+        if (max_size < CACHE_BENCH_MIN_SIZE)
+        {
+            CacheCmdUsage();
+            return -1;
+        }
+
+        CacheBench(max_size);
+    }
+    else
+    {
+        CacheCmdUsage();
+        return -1;
+    }
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), cache, CacheCmdEntry, data cache range threshold and bench);
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_irq.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the irqstat command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ * 1.1   phytium    2026/10/19   add irqstat -t to show handler time histograms
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "fgeneric_timer.h"
+#include "freertos_irq.h"
+#include "../src/shell.h"
+
+/* every slot of the per-core table plus the shared LPI entry */
+#ifdef CONFIG_FREERTOS_USE_FAST_IRQ
+#define IRQSTAT_MAX_NUM     (CONFIG_FREERTOS_IRQ_STATS_MAX_NUM + CONFIG_FREERTOS_FAST_IRQ_MAX_NUM + 1)
+#else
+#define IRQSTAT_MAX_NUM     (CONFIG_FREERTOS_IRQ_STATS_MAX_NUM + 1)
+#endif
+
+static IrqStats_t irq_stats[IRQSTAT_MAX_NUM];
+
+static void IrqStatCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    irqstat         show the interrupt statistics of this core\r\n");
+    printf("    irqstat -t      show the handler time histograms of this core\r\n");
+    printf("    irqstat -r      clear the interrupt statistics\r\n");
+}
+
+/* convert a count of the given clock to ns, clocks of unknown frequency are printed as is */
+static unsigned long long IrqStatToNs(u64 value, u64 freq)
+{
+    if (freq == 0)
+    {
+        return value;
+    }
+
+    return (value / freq) * 1000000000ULL + ((value % freq) * 1000000000ULL) / freq;
+}
+
+static void IrqStatPrintId(const IrqStats_t *stats)
+{
+    if (stats->ulIrqId == IRQ_STATS_LPI_ID)
+    {
+        printf("lpi     ");
+    }
+    else
+    {
+        printf("%-7lu ", (unsigned long)stats->ulIrqId);
+    }
+}
+
+/* one line per non-empty bucket, with the upper bound of the bucket */
+static void IrqStatPrintHist(const IrqStats_t *stats, u64 freq)
+{
+    u32 i;
+
+    for (i = 0; i < IRQ_STATS_HIST_NUM; i++)
+    {
+        if (stats->ulTimeHist[i] == 0)
+        {
+            continue;
+        }
+
+        if (i == IRQ_STATS_HIST_NUM - 1U)
+        {
+            printf("        >= %-11llu %10lu\r\n", IrqStatToNs(1ULL << i, freq),
+                   (unsigned long)stats->ulTimeHist[i]);
+        }
+        else
+        {
+            printf("        <  %-11llu %10lu\r\n", IrqStatToNs(2ULL << i, freq),
+                   (unsigned long)stats->ulTimeHist[i]);
+        }
+    }
+}
+
+static int IrqStatCmdEntry(int argc, char *argv[])
+{
+    u64 freq = ullIrqStatsClockFrequency();
+    u64 cnt_freq = GenericTimerFrequecy();
+    u32 num, i;
+    IrqStats_t *stats;
+    boolean hist = FALSE;
+
+    if (argc > 1)
+    {
+        if (!strcmp(argv[1], "-r"))
+        {
+            vIrqStatsReset();
+            return 0;
+        }
+        else if (!strcmp(argv[1], "-t"))
+        {
+            hist = TRUE;
+        }
+        else
+        {
+            IrqStatCmdUsage();
+            return -1;
+        }
+    }
+
+    num = ulIrqStatsSnapshot(irq_stats, IRQSTAT_MAX_NUM);
+
+    if (hist)
+    {
+        printf("---------------------------------------------------------------------------\r\n");
+        printf("handler time unit: %s\r\n", (freq == 0) ? "cpu cycles" : "ns");
+        printf("irq     time             count\r\n");
+        for (i = 0; i < num; i++)
+        {
+            if (irq_stats[i].ullCount == 0)
+            {
+                continue;
+            }
+
+            IrqStatPrintId(&irq_stats[i]);
+            printf("\r\n");
+            IrqStatPrintHist(&irq_stats[i], freq);
+        }
+        printf("---------------------------------------------------------------------------\r\n");
+
+        return 0;
+    }
+
+    printf("---------------------------------------------------------------------------\r\n");
+    printf("handler time unit: %s, latency unit: ns\r\n", (freq == 0) ? "cpu cycles" : "ns");
+    printf("irq     fast  count         min         avg         max    avg_lat    max_lat\r\n");
+    for (i = 0; i < num; i++)
+    {
+        stats = &irq_stats[i];
+        if (stats->ullCount == 0)
+        {
+            continue;
+        }
+
+        IrqStatPrintId(stats);
+        printf("%-4s %6llu %11llu %11llu %11llu",
+               stats->ulFast ? "y" : "n",
+               (unsigned long long)stats->ullCount,
+               IrqStatToNs(stats->ullMinTime, freq),
+               IrqStatToNs(stats->ullTotalTime / stats->ullCount, freq),
+               IrqStatToNs(stats->ullMaxTime, freq));
+
+        if (stats->ullLatencyCount != 0)
+        {
+            printf(" %10llu %10llu\r\n",
+                   IrqStatToNs(stats->ullTotalLatency / stats->ullLatencyCount, cnt_freq),
+                   IrqStatToNs(stats->ullMaxLatency, cnt_freq));
+        }
+        else
+        {
+            printf("          -          -\r\n");
+        }
+    }
+    printf("---------------------------------------------------------------------------\r\n");
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), irqstat, IrqStatCmdEntry, show interrupt statistics);
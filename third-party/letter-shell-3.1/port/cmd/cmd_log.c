@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_log.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the log command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "fdebug.h"
+#include "freertos_log.h"
+#include "../src/shell.h"
+
+static const char *const log_level_name[] = {"none", "error", "warn", "info", "debug", "verbose"};
+
+static void LogCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    log                         show the log ring and the tag levels\r\n");
+    printf("    log level <tag|*> <level>   print tag up to level, * for all other tags\r\n");
+    printf("    levels: none error warn info debug verbose, up to %s in this build\r\n",
+           log_level_name[LOG_LOCAL_LEVEL]);
+}
+
+static int LogParseLevel(const char *name, u32 *level)
+{
+    u32 i;
+
+    for (i = 0; i < sizeof(log_level_name) / sizeof(log_level_name[0]); i++)
+    {
+        if (!strcmp(name, log_level_name[i]))
+        {
+            *level = i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static void LogShow(void)
+{
+    AsyncLogStats_t stats;
+    const char *tag;
+    u32 level;
+    u32 i;
+
+    vAsyncLogGetStats(&stats);
+    printf("log: written %lu, dropped %lu, queued %lu/%lu, max queued %lu\r\n",
+           (unsigned long)stats.ulWritten, (unsigned long)stats.ulDropped,
+           (unsigned long)stats.ulUsed, (unsigned long)stats.ulRecordNum,
+           (unsigned long)stats.ulMaxUsed);
+
+    printf("%-24s %s\r\n", "tag", "level");
+    printf("%-24s %s\r\n", "*", log_level_name[ulAsyncLogGetLevel("*")]);
+    for (i = 0; xAsyncLogGetTag(i, &tag, &level) == pdTRUE; i++)
+    {
+        printf("%-24s %s\r\n", tag, log_level_name[level]);
+    }
+}
+
+static int LogCmdEntry(int argc, char *argv[])
+{
+    u32 level;
+
+    if (argc < 2)
+    {
+        LogShow();
+        return 0;
+    }
+
+    if (!strcmp(argv[1], "level") && (argc == 4))
+    {
+        if (LogParseLevel(argv[3], &level) != 0)
+        {
+            LogCmdUsage();
+            return -1;
+        }
+
+        if (xAsyncLogSetLevel(argv[2], level) != pdPASS)
+        {
+            printf("log: no room for tag %s\r\n", argv[2]);
+            return -1;
+        }
+    }
+    else
+    {
+        LogCmdUsage();
+        return -1;
+    }
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), log, LogCmdEntry, deferred log levels and statistics);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_perfstat.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the perfstat command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <string.h>
+#include "fkernel.h"
+#include "fperf_stat.h"
+#include "../src/shell.h"
+
+static void PerfStatCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    perfstat        show the PMU event counts of the annotated code regions\r\n");
+    printf("    perfstat -r     clear the results\r\n");
+}
+
+static void PerfStatShow(void)
+{
+    FPerfStatRegion *region;
+    FPerfStatRegion copy;
+    u32 mask;
+    u32 i;
+
+    if (FPerfStatInit() != FT_SUCCESS)
+    {
+        printf("perfstat: PMU not available\r\n");
+        return;
+    }
+
+    mask = FPerfStatEventMask();
+    printf("%-24s %10s %-14s %12s %12s %12s\r\n", "region", "count", "event", "min", "avg", "max");
+
+    for (region = FPerfStatRegionList(); region != NULL; region = region->next)
+    {
+        /* the region keeps running, print one consistent copy */
+        memcpy(&copy, region, sizeof(copy));
+        if (copy.count == 0)
+        {
+            continue;
+        }
+
+        printf("%-24s %10llu\r\n", copy.name, (unsigned long long)copy.count);
+        for (i = 0; i < FPERF_STAT_EVENT_NUM; i++)
+        {
+            if (!(mask & BIT(i)))
+            {
+                continue;
+            }
+
+            printf("%-24s %10s %-14s %12llu %12llu %12llu\r\n", "", "",
+                   FPerfStatEventName((FPerfStatEvent)i),
+                   (unsigned long long)copy.min[i],
+                   (unsigned long long)(copy.sum[i] / copy.count),
+                   (unsigned long long)copy.max[i]);
+        }
+
+        if ((mask & BIT(FPERF_STAT_CYCLES)) && (mask & BIT(FPERF_STAT_INSTRUCTIONS)) &&
+            (copy.sum[FPERF_STAT_CYCLES] != 0))
+        {
+            u64 ipc = copy.sum[FPERF_STAT_INSTRUCTIONS] * 100ULL / copy.sum[FPERF_STAT_CYCLES];
+
+            printf("%-24s %10s %-14s %9llu.%02llu\r\n", "", "", "ipc",
+                   (unsigned long long)(ipc / 100), (unsigned long long)(ipc % 100));
+        }
+    }
+}
+
+static int PerfStatCmdEntry(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        if (!strcmp(argv[1], "-r"))
+        {
+            FPerfStatReset();
+            return 0;
+        }
+
+        PerfStatCmdUsage();
+        return -1;
+    }
+
+    PerfStatShow();
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), perfstat, PerfStatCmdEntry, show pmu event counts of code regions);
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_prof.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the prof command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fpmu_perf.h"
+#include "freertos_profiler.h"
+#include "../src/shell.h"
+
+#define PROF_DEFAULT_PERIOD     1000000U
+#define PROF_MAX_TASK_NUM       64
+
+typedef struct
+{
+    const char *name;
+    u32 event_id;
+} ProfEvent;
+
+static const ProfEvent prof_events[] =
+{
+    {"cycles", FPMU_CPU_CYCLES_ID},
+    {"instructions", FPMU_INST_RETIRED_ID},
+    {"l1d-miss", FPMU_L1D_CACHE_REFILL_ID},
+    {"l1i-miss", FPMU_L1I_CACHE_REFILL_ID},
+    {"l2d-miss", FPMU_L2D_CACHE_REFILL_ID},
+    {"branch-miss", FPMU_BR_MIS_PRED_ID},
+};
+
+#if (configUSE_TRACE_FACILITY == 1)
+static TaskStatus_t prof_tasks[PROF_MAX_TASK_NUM];
+#endif
+
+static void ProfCmdUsage(void)
+{
+    u32 i;
+
+    printf("usage:\r\n");
+    printf("    prof start [-e event] [-p period]   sample this core every period events, default cycles %u\r\n",
+           PROF_DEFAULT_PERIOD);
+    printf("    prof stop                           stop sampling\r\n");
+    printf("    prof status                         show the sampling state\r\n");
+    printf("    prof dump                           stop and print the samples for pmu_profile_fold.py\r\n");
+    printf("    events:");
+    for (i = 0; i < sizeof(prof_events) / sizeof(prof_events[0]); i++)
+    {
+        printf(" %s", prof_events[i].name);
+    }
+    printf(", or a raw event number\r\n");
+}
+
+static const char *ProfEventName(u32 event_id)
+{
+    u32 i;
+
+    for (i = 0; i < sizeof(prof_events) / sizeof(prof_events[0]); i++)
+    {
+        if (prof_events[i].event_id == event_id)
+        {
+            return prof_events[i].name;
+        }
+    }
+
+    return "raw";
+}
+
+static int ProfParseEvent(const char *name, u32 *event_id)
+{
+    char *end;
+    u32 i;
+
+    for (i = 0; i < sizeof(prof_events) / sizeof(prof_events[0]); i++)
+    {
+        if (!strcmp(name, prof_events[i].name))
+        {
+            *event_id = prof_events[i].event_id;
+            return 0;
+        }
+    }
+
+    *event_id = (u32)strtoul(name, &end, 0);
+
+    return (*end == '\0') ? 0 : -1;
+}
+
+static void ProfPrintStatus(void)
+{
+    ProfilerStatus_t status;
+
+    vProfilerGetStatus(&status);
+    printf("prof: %s, event %s (0x%lx) period %lu on counter %lu, samples %lu/%lu\r\n",
+           status.ulRunning ? "running" : "stopped", ProfEventName(status.ulEventId),
+           (unsigned long)status.ulEventId, (unsigned long)status.ulPeriod,
+           (unsigned long)status.ulCounterId, (unsigned long)status.ulSampleNum,
+           (unsigned long)status.ulSampleMax);
+}
+
+static void ProfDump(void)
+{
+    const ProfilerSample_t *samples;
+    ProfilerStatus_t status;
+    u32 num, i, j;
+
+    vProfilerStop();
+    vProfilerGetStatus(&status);
+    samples = pxProfilerGetSamples(&num);
+
+    printf("prof-begin event %s period %lu samples %lu\r\n", ProfEventName(status.ulEventId),
+           (unsigned long)status.ulPeriod, (unsigned long)num);
+
+#if (configUSE_TRACE_FACILITY == 1)
+    {
+        UBaseType_t task_num = uxTaskGetSystemState(prof_tasks, PROF_MAX_TASK_NUM, NULL);
+
+        for (i = 0; i < task_num; i++)
+        {
+            printf("prof-task %p %s\r\n", (void *)prof_tasks[i].xHandle, prof_tasks[i].pcTaskName);
+        }
+    }
+#endif
+
+    for (i = 0; i < num; i++)
+    {
+        printf("prof-sample %p 0x%llx 0x%llx", samples[i].pvTask,
+               (unsigned long long)samples[i].ullPc, (unsigned long long)samples[i].ullLr);
+#if PROFILER_STACK_DEPTH > 0
+        for (j = 0; j < samples[i].ulDepth; j++)
+        {
+            printf(" 0x%lx", (unsigned long)samples[i].uxStack[j]);
+        }
+#else
+        (void)j;
+#endif
+        printf("\r\n");
+    }
+
+    printf("prof-end\r\n");
+}
+
+static int ProfCmdEntry(int argc, char *argv[])
+{
+    u32 event_id = FPMU_CPU_CYCLES_ID;
+    u32 period = PROF_DEFAULT_PERIOD;
+    int arg;
+
+    if (argc < 2)
+    {
+        ProfCmdUsage();
+        return -1;
+    }
+
+    if (!strcmp(argv[1], "start"))
+    {
+        for (arg = 2; arg < argc; arg++)
+        {
+            if (!strcmp(argv[arg], "-e") && (arg + 1 < argc))
+            {
+                if (ProfParseEvent(argv[++arg], &event_id) != 0)
+                {
+                    ProfCmdUsage();
+                    return -1;
+                }
+            }
+            else if (!strcmp(argv[arg], "-p") && (arg + 1 < argc))
+            {
+                period = (u32)strtoul(argv[++arg], NULL, 0);
+            }
+            else
+            {
+                ProfCmdUsage();
+                return -1;
+            }
+        }
+
+        if (xProfilerStart(event_id, period) != pdPASS)
+        {
+            printf("prof: event 0x%lx or period %lu not supported\r\n",
+                   (unsigned long)event_id, (unsigned long)period);
+            return -1;
+        }
+        ProfPrintStatus();
+    }
+    else if (!strcmp(argv[1], "stop"))
+    {
+        vProfilerStop();
+        ProfPrintStatus();
+    }
+    else if (!strcmp(argv[1], "status"))
+    {
+        ProfPrintStatus();
+    }
+    else if (!strcmp(argv[1], "dump"))
+    {
+        ProfDump();
+    }
+    else
+    {
+        ProfCmdUsage();
+        return -1;
+    }
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), prof, ProfCmdEntry, pmu sampling profiler);
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: cmd_top.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the top command functions
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "../src/shell.h"
+
+#define TOP_MAX_TASK_NUM        64
+#define TOP_DEFAULT_DELAY_MS    1000
+
+typedef struct
+{
+    TaskStatus_t status;
+    UBaseType_t switches;
+} TopTask;
+
+typedef struct
+{
+    TopTask tasks[TOP_MAX_TASK_NUM];
+    UBaseType_t num;
+    configRUN_TIME_COUNTER_TYPE total;  /* wall time */
+    configRUN_TIME_COUNTER_TYPE isr;    /* interrupt time */
+} TopSnapshot;
+
+static TaskStatus_t top_status[TOP_MAX_TASK_NUM];
+static TopSnapshot top_snapshots[2];
+static TopTask *top_sorted[TOP_MAX_TASK_NUM];
+static configRUN_TIME_COUNTER_TYPE top_delta[TOP_MAX_TASK_NUM];
+static UBaseType_t top_switch_delta[TOP_MAX_TASK_NUM];
+
+static void TopCmdUsage(void)
+{
+    printf("usage:\r\n");
+    printf("    top [-d ms] [-n count]   show cpu usage, context switches and stack high-water marks of the tasks\r\n");
+    printf("        -d ms      sample interval, default %d ms\r\n", TOP_DEFAULT_DELAY_MS);
+    printf("        -n count   number of reports, default 1\r\n");
+}
+
+static void TopTakeSnapshot(TopSnapshot *snapshot)
+{
+    configRUN_TIME_COUNTER_TYPE total;
+    UBaseType_t i;
+
+    vTaskSuspendAll();
+    snapshot->num = uxTaskGetSystemState(top_status, TOP_MAX_TASK_NUM, &total);
+    for (i = 0; i < snapshot->num; i++)
+    {
+        snapshot->tasks[i].status = top_status[i];
+        snapshot->tasks[i].switches = uxTaskGetTaskNumber(top_status[i].xHandle);
+    }
+#if defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_GENERIC_COUNTER) || defined(CONFIG_FREERTOS_RUN_TIME_STATS_CLOCK_PMU_CYCLES)
+    snapshot->total = ullRunTimeTotal();
+    snapshot->isr = ullRunTimeIsrTime();
+#else
+    snapshot->total = total;
+    snapshot->isr = 0;
+#endif
+    (void)xTaskResumeAll();
+}
+
+static const TopTask *TopFindTask(const TopSnapshot *snapshot, UBaseType_t task_number)
+{
+    UBaseType_t i;
+
+    for (i = 0; i < snapshot->num; i++)
+    {
+        if (snapshot->tasks[i].status.xTaskNumber == task_number)
+        {
+            return &snapshot->tasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* per mille of part in whole */
+static unsigned int TopPermille(configRUN_TIME_COUNTER_TYPE part, configRUN_TIME_COUNTER_TYPE whole)
+{
+    if (whole == 0)
+    {
+        return 0;
+    }
+
+    return (unsigned int)(((unsigned long long)part * 1000ULL) / whole);
+}
+
+static char TopStateChar(eTaskState state)
+{
+    switch (state)
+    {
+        case eRunning: return 'X';
+        case eReady: return 'R';
+        case eBlocked: return 'B';
+        case eSuspended: return 'S';
+        case eDeleted: return 'D';
+        default: return '?';
+    }
+}
+
+static void TopReport(const TopSnapshot *prev, const TopSnapshot *cur)
+{
+    configRUN_TIME_COUNTER_TYPE total = cur->total - prev->total;
+    configRUN_TIME_COUNTER_TYPE isr = cur->isr - prev->isr;
+    configRUN_TIME_COUNTER_TYPE idle = 0;
+    TaskHandle_t idle_handle = xTaskGetIdleTaskHandle();
+    const TopTask *old;
+    UBaseType_t i, j, num = 0;
+    unsigned int load;
+
+    for (i = 0; i < cur->num; i++)
+    {
+        old = TopFindTask(prev, cur->tasks[i].status.xTaskNumber);
+        top_sorted[num] = (TopTask *)&cur->tasks[i];
+        top_delta[num] = cur->tasks[i].status.ulRunTimeCounter - (old ? old->status.ulRunTimeCounter : 0);
+        top_switch_delta[num] = cur->tasks[i].switches - (old ? old->switches : 0);
+        if (cur->tasks[i].status.xHandle == idle_handle)
+        {
+            idle = top_delta[num];
+        }
+        num++;
+    }
+
+    /* busiest first */
+    for (i = 1; i < num; i++)
+    {
+        for (j = i; (j > 0) && (top_delta[j] > top_delta[j - 1]); j--)
+        {
+            TopTask *task = top_sorted[j];
+            configRUN_TIME_COUNTER_TYPE delta = top_delta[j];
+            UBaseType_t switches = top_switch_delta[j];
+
+            top_sorted[j] = top_sorted[j - 1];
+            top_delta[j] = top_delta[j - 1];
+            top_switch_delta[j] = top_switch_delta[j - 1];
+            top_sorted[j - 1] = task;
+            top_delta[j - 1] = delta;
+            top_switch_delta[j - 1] = switches;
+        }
+    }
+
+    load = 1000 - TopPermille(idle, total);
+    if (load > 1000)
+    {
+        load = 0;
+    }
+
+    printf("---------------------------------------------------------------------------\r\n");
+    printf("cpu load: %u.%u%%  irq: %u.%u%%  tasks: %lu\r\n",
+           load / 10, load % 10, TopPermille(isr, total) / 10, TopPermille(isr, total) % 10,
+           (unsigned long)cur->num);
+    printf("%-*s state prio   cpu%%  switches  stack_min\r\n", configMAX_TASK_NAME_LEN, "name");
+    for (i = 0; i < num; i++)
+    {
+        const TaskStatus_t *status = &top_sorted[i]->status;
+        unsigned int cpu = TopPermille(top_delta[i], total);
+
+        printf("%-*s   %c   %4lu %3u.%u%% %9lu %10lu\r\n",
+               configMAX_TASK_NAME_LEN, status->pcTaskName,
+               TopStateChar(status->eCurrentState),
+               (unsigned long)status->uxCurrentPriority,
+               cpu / 10, cpu % 10,
+               (unsigned long)top_switch_delta[i],
+               (unsigned long)status->usStackHighWaterMark);
+    }
+}
+
+static int TopCmdEntry(int argc, char *argv[])
+{
+    u32 delay_ms = TOP_DEFAULT_DELAY_MS;
+    u32 count = 1;
+    u32 i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (!strcmp(argv[arg], "-d") && (arg + 1 < argc))
+        {
+            delay_ms = (u32)strtoul(argv[++arg], NULL, 0);
+        }
+        else if (!strcmp(argv[arg], "-n") && (arg + 1 < argc))
+        {
+            count = (u32)strtoul(argv[++arg], NULL, 0);
+        }
+        else
+        {
+            TopCmdUsage();
+            return -1;
+        }
+    }
+
+    if ((delay_ms == 0) || (count == 0))
+    {
+        TopCmdUsage();
+        return -1;
+    }
+
+    TopTakeSnapshot(&top_snapshots[0]);
+    for (i = 0; i < count; i++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        TopTakeSnapshot(&top_snapshots[(i + 1) & 1]);
+        TopReport(&top_snapshots[i & 1], &top_snapshots[(i + 1) & 1]);
+    }
+    printf("---------------------------------------------------------------------------\r\n");
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), top, TopCmdEntry, show task cpu usage);
@@ -20,4 +20,32 @@ SHELL_CSRCS += cmd_bootelf.c \
 				cmd_sleep.c \
 				cmd_version.c \
 				cmd_ps.c \
-				cmd_mmu.c
\ No newline at end of file
+				cmd_mmu.c
+
+ifdef CONFIG_FREERTOS_USE_IRQ_STATS
+SHELL_CSRCS += cmd_irq.c
+endif
+
+ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+SHELL_CSRCS += cmd_top.c
+endif
+
+ifdef CONFIG_FREERTOS_USE_PMU_PROFILER
+SHELL_CSRCS += cmd_prof.c
+endif
+
+ifdef CONFIG_USE_PERF_STAT
+SHELL_CSRCS += cmd_perfstat.c
+endif
+
+ifdef CONFIG_FREERTOS_USE_BLOCK
+SHELL_CSRCS += cmd_blk.c
+endif
+
+ifdef CONFIG_FREERTOS_USE_ASYNC_LOG
+SHELL_CSRCS += cmd_log.c
+endif
+
+ifdef CONFIG_ARCH_ARMV8_AARCH64
+SHELL_CSRCS += cmd_cache.c
+endif
@@ -23,6 +23,7 @@
  *  Ver   Who  Date   Changes
  * ----- ------  -------- --------------------------------------
  * 1.0   huangjin  2025/10/21  first release
+ * 1.1   phytium   2026/10/19  keep the netif in the driver for the workqueue
  */
 
 
@@ -359,6 +360,7 @@ static err_t low_level_init(struct netif *netif)
     lwip_port->state = (void *)instance_p;
     netif->state = (void *)lwip_port; /* update state */
     instance_p->stack_pointer = lwip_port;
+    instance_p->netif = (void *)netif;
 
     /* maximum transfer unit */
     if (instance_p->feature & FE1000E_OS_CONFIG_JUMBO)
@@ -24,6 +24,7 @@
  * ----- ------        --------   --------------------------------------
  * 1.0   wangxiaodong  2022/6/20  first release
  * 2.0   liuzhihong    2022/1/12  restructure
+ * 2.1   phytium       2026/10/19 keep the netif in the driver for the workqueue
  */
 
 
@@ -294,6 +295,7 @@ static err_t low_level_init(struct netif *netif)
     gmac_netif_p->state = (void *)instance_p;
     netif->state = (void *)gmac_netif_p; /* update state */
     instance_p->stack_pointer = gmac_netif_p;
+    instance_p->netif = (void *)netif;
 
     /* maximum transfer unit */
     if(instance_p->feature & FGMAC_OS_CONFIG_JUMBO)
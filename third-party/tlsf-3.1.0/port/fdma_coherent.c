@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fdma_coherent.c
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the DMA coherent memory pool API implementation
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#include "sdkconfig.h"
+
+#ifdef CONFIG_USE_DMA_COHERENT_POOL
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ftypes.h"
+#include "fassert.h"
+#include "fdebug.h"
+#include "fcache.h"
+#include "fmmu.h"
+
+#include "fmemory_pool.h"
+#include "fdma_coherent.h"
+
+#define FDMA_DEBUG_TAG "FDMA"
+#define FDMA_ERROR(format, ...)   FT_DEBUG_PRINT_E(FDMA_DEBUG_TAG, format, ##__VA_ARGS__)
+#define FDMA_INFO(format, ...)    FT_DEBUG_PRINT_I(FDMA_DEBUG_TAG, format, ##__VA_ARGS__)
+
+#ifndef CONFIG_DMA_COHERENT_POOL_SIZE
+#define CONFIG_DMA_COHERENT_POOL_SIZE   0x40000
+#endif
+
+FASSERT_STATIC((CONFIG_DMA_COHERENT_POOL_SIZE % CONFIG_MMU_PAGE_SIZE) == 0);
+
+/* the pool takes whole pages, the mapping of them is changed as one */
+static u8 dma_pool_buf[CONFIG_DMA_COHERENT_POOL_SIZE] __attribute__((aligned(CONFIG_MMU_PAGE_SIZE)));
+static FMemp dma_pool;
+static volatile boolean dma_pool_ready = FALSE;
+static boolean dma_pool_uncached = FALSE;
+
+static inline boolean FDmaInPool(uintptr addr, fsize_t len)
+{
+    return (addr >= (uintptr)dma_pool_buf) &&
+           (addr + len <= (uintptr)dma_pool_buf + sizeof(dma_pool_buf));
+}
+
+/**
+ * @name: FDmaCoherentInit
+ * @msg: 初始化一致性内存池, 将内存池映射为Normal Non-cacheable
+ * @return {FError} FDMA_COHERENT_SUCCESS表示成功
+ * @note: 映射前清除并无效内存池的cache行, 避免脏数据在映射后写回覆盖设备数据,
+ *        映射后再次无效, 丢弃映射切换期间预取的cache行
+ */
+FError FDmaCoherentInit(void)
+{
+    FError ret = FDMA_COHERENT_SUCCESS;
+
+    vTaskSuspendAll();
+    if (dma_pool_ready)
+    {
+        (void)xTaskResumeAll();
+        return ret;
+    }
+
+#ifdef CONFIG_DMA_COHERENT_NON_CACHEABLE
+    FCacheDCacheInvalidateRange((intptr)dma_pool_buf, sizeof(dma_pool_buf));
+    if (FMmuMap((uintptr)dma_pool_buf, (uintptr)dma_pool_buf, sizeof(dma_pool_buf),
+                MT_NORMAL_NC | MT_P_RW_U_RW | MT_NS) != 0)
+    {
+        FDMA_ERROR("Map dma pool %p non-cacheable failed.", dma_pool_buf);
+        ret = FDMA_COHERENT_ERR_MAP;
+        goto err_ret;
+    }
+    FCacheDCacheInvalidateRange((intptr)dma_pool_buf, sizeof(dma_pool_buf));
+    dma_pool_uncached = TRUE;
+#endif
+
+    ret = FMempInit(&dma_pool, dma_pool_buf, dma_pool_buf + sizeof(dma_pool_buf));
+    if (ret != FMEMP_SUCCESS)
+    {
+        FDMA_ERROR("Init dma pool failed, 0x%x.", ret);
+        goto err_ret;
+    }
+
+    dma_pool_ready = TRUE;
+    FDMA_INFO("Dma pool %p size 0x%x, %s.", dma_pool_buf, sizeof(dma_pool_buf),
+              dma_pool_uncached ? "non-cacheable" : "cacheable");
+
+err_ret:
+    (void)xTaskResumeAll();
+    return ret;
+}
+
+/**
+ * @name: FDmaAllocCoherent
+ * @msg: 从一致性内存池按指定对齐方式申请一段空间
+ * @return {void *} 申请到的空间, 失败返回NULL
+ * @param {fsize_t} size, 申请的字节数
+ * @param {fsize_t} align, 对齐字节数, 2的幂
+ * @note: 内存按平坦映射, 返回的地址同时是设备访问的总线地址
+ */
+void *FDmaAllocCoherent(fsize_t size, fsize_t align)
+{
+    if ((!dma_pool_ready) && (FDmaCoherentInit() != FDMA_COHERENT_SUCCESS))
+    {
+        return NULL;
+    }
+
+    return FMempMallocAlign(&dma_pool, size, align);
+}
+
+/**
+ * @name: FDmaFreeCoherent
+ * @msg: 释放一段从一致性内存池申请的空间
+ * @return {*}
+ * @param {void} *ptr, FDmaAllocCoherent返回的地址
+ */
+void FDmaFreeCoherent(void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    FASSERT(dma_pool_ready && FDmaInPool((uintptr)ptr, 1));
+    FMempFree(&dma_pool, ptr);
+}
+
+/**
+ * @name: FDmaIsCoherent
+ * @msg: 判断一段地址是否位于非cache的一致性内存中
+ * @return {boolean} TRUE表示不需要cache维护
+ * @param {uintptr} addr, 起始地址
+ * @param {fsize_t} len, 字节数
+ */
+boolean FDmaIsCoherent(uintptr addr, fsize_t len)
+{
+    return dma_pool_uncached && FDmaInPool(addr, len);
+}
+
+/**
+ * @name: FDmaMapSingle
+ * @msg: 设备访问缓冲区之前调用, 按方向维护cache
+ * @return {*}
+ * @param {uintptr} addr, 缓冲区起始地址
+ * @param {fsize_t} len, 缓冲区字节数
+ * @param {FDmaDirection} dir, 数据方向
+ * @note: 设备写入的缓冲区同样做清除并无效, 避免脏行在设备写入后被逐出
+ */
+void FDmaMapSingle(uintptr addr, fsize_t len, FDmaDirection dir)
+{
+    if (FDmaIsCoherent(addr, len))
+    {
+        return;
+    }
+
+    if (dir == FDMA_TO_DEVICE)
+    {
+        FCacheDCacheFlushRange((intptr)addr, len);
+    }
+    else
+    {
+        FCacheDCacheInvalidateRange((intptr)addr, len);
+    }
+}
+
+/**
+ * @name: FDmaUnmapSingle
+ * @msg: 设备访问缓冲区之后调用, 丢弃cpu在传输期间预取的cache行
+ * @return {*}
+ * @param {uintptr} addr, 缓冲区起始地址
+ * @param {fsize_t} len, 缓冲区字节数
+ * @param {FDmaDirection} dir, 数据方向
+ */
+void FDmaUnmapSingle(uintptr addr, fsize_t len, FDmaDirection dir)
+{
+    if ((dir == FDMA_TO_DEVICE) || FDmaIsCoherent(addr, len))
+    {
+        return;
+    }
+
+    FCacheDCacheInvalidateRange((intptr)addr, len);
+}
+
+/**
+ * @name: FDmaCoherentProbe
+ * @msg: 跟踪一致性内存池的使用情况
+ * @return {*}
+ * @param {u32} *total, 内存池总字节数
+ * @param {u32} *used, 已使用字节数
+ * @param {u32} *max_used, 最大使用字节数
+ */
+void FDmaCoherentProbe(u32 *total, u32 *used, u32 *max_used)
+{
+    if (!dma_pool_ready)
+    {
+        *total = 0;
+        *used = 0;
+        *max_used = 0;
+        return;
+    }
+
+    FMemProbe(&dma_pool, total, used, max_used);
+}
+
+#endif /* CONFIG_USE_DMA_COHERENT_POOL */
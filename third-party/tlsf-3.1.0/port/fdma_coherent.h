@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026, Phytium Technology Co., Ltd.   All Rights Reserved.
+ *
+ * Licensed under the BSD 3-Clause License (the "License"); you may not use
+ * this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ * FilePath: fdma_coherent.h
+ * Date: 2026-10-19 10:00:00
+ * LastEditTime: 2026-10-19 10:00:00
+ * Description:  This file is for the DMA coherent memory pool API definition
+ *
+ * Modify History:
+ *  Ver   Who        Date         Changes
+ * ----- ------     --------    --------------------------------------
+ * 1.0   phytium    2026/10/19   first release
+ */
+
+#ifndef FDMA_COHERENT_H
+#define FDMA_COHERENT_H
+
+#include "ftypes.h"
+#include "ferror_code.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FDMA_COHERENT_SUCCESS       FT_SUCCESS
+#define FDMA_COHERENT_ERR_MAP       FT_MAKE_ERRCODE(ErrorModGeneral, ErrCommMemp, 4)
+
+typedef enum
+{
+    FDMA_TO_DEVICE = 0,     /* cpu writes, device reads */
+    FDMA_FROM_DEVICE,       /* device writes, cpu reads */
+    FDMA_BIDIRECTIONAL      /* both of them */
+} FDmaDirection; /* direction of a streaming mapping */
+
+/* 初始化一致性内存池, 首次申请时也会自动初始化 */
+FError FDmaCoherentInit(void);
+
+/* 从一致性内存池按指定对齐方式申请一段空间, 地址同时用于cpu和设备 */
+void *FDmaAllocCoherent(fsize_t size, fsize_t align);
+
+/* 释放一段从一致性内存池申请的空间 */
+void FDmaFreeCoherent(void *ptr);
+
+/* 判断一段地址是否位于非cache的一致性内存中 */
+boolean FDmaIsCoherent(uintptr addr, fsize_t len);
+
+/* 设备访问缓冲区之前调用, 按方向维护cache, 一致性内存不做维护 */
+void FDmaMapSingle(uintptr addr, fsize_t len, FDmaDirection dir);
+
+/* 设备访问缓冲区之后调用, 丢弃cpu预取的旧数据, 一致性内存不做维护 */
+void FDmaUnmapSingle(uintptr addr, fsize_t len, FDmaDirection dir);
+
+/* 跟踪一致性内存池的使用情况 */
+void FDmaCoherentProbe(u32 *total, u32 *used, u32 *max_used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif